@@ -13,8 +13,6 @@ install(
 
 install(DIRECTORY ${CMAKE_CURRENT_SOURCE_DIR}/include/
         DESTINATION ${CMAKE_INSTALL_INCLUDEDIR})
-install(DIRECTORY ${CMAKE_CURRENT_SOURCE_DIR}/executables/include/
-        DESTINATION ${CMAKE_INSTALL_INCLUDEDIR})
 install(
   DIRECTORY ${CMAKE_CURRENT_BINARY_DIR}/eigen/include/eigen3
   DESTINATION ${CMAKE_INSTALL_INCLUDEDIR}
@@ -0,0 +1,100 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+/// \file algodiff_server.cpp
+/// \brief Serves the models of plugins over a Unix domain socket
+///
+/// Usage: algodiff_server [--socket PATH] [--window-us N] [--max-batch N]
+/// [--threads N] PLUGIN...
+
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "algodiff/gradient_service.hpp"
+#include "algodiff/server_plugin.hpp"
+
+namespace
+{
+algodiff::GradientServer *running_server{nullptr};
+
+extern "C" void handle_signal(int /*signal*/)
+{
+    if (running_server != nullptr) {
+        running_server->stop();
+    }
+}
+
+auto usage() -> int
+{
+    std::cerr << "Usage: algodiff_server [--socket PATH] [--window-us N] "
+                 "[--max-batch N] [--threads N] PLUGIN...\n";
+    return EXIT_FAILURE;
+}
+
+} // namespace
+
+auto main(int argc, char **argv) -> int
+{
+    std::string socket_path{"/tmp/algodiff.sock"};
+    algodiff::ServiceOptions options{};
+    std::vector<std::string> plugins{};
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            const std::string argument{argv[i]};
+            const bool has_value{i + 1 < argc};
+            if (argument == "--socket" && has_value) {
+                socket_path = argv[++i];
+            } else if (argument == "--window-us" && has_value) {
+                options.batch_window =
+                    std::chrono::microseconds{std::stoll(argv[++i])};
+            } else if (argument == "--max-batch" && has_value) {
+                options.max_batch = std::stoul(argv[++i]);
+            } else if (argument == "--threads" && has_value) {
+                options.threads =
+                    static_cast<unsigned>(std::stoul(argv[++i]));
+            } else if (argument.rfind("--", 0) == 0) {
+                return usage();
+            } else {
+                plugins.push_back(argument);
+            }
+        }
+    } catch (const std::logic_error &) {
+        return usage();
+    }
+    if (plugins.empty()) {
+        return usage();
+    }
+
+    try {
+        algodiff::ModelRegistry registry{};
+        for (const auto &plugin : plugins) {
+            algodiff::load_plugin(plugin, registry);
+        }
+        for (const auto &name : registry.names()) {
+            std::cout << "Serving " << name << '\n';
+        }
+
+        algodiff::GradientServer server{socket_path, registry, options};
+        running_server = &server;
+        std::signal(SIGINT, handle_signal);
+        std::signal(SIGTERM, handle_signal);
+        std::cout << "Listening on " << socket_path << std::endl;
+        server.run();
+        running_server = nullptr;
+
+        const auto statistics{server.statistics()};
+        std::cout << "Answered " << statistics.requests << " requests in "
+                  << statistics.batches << " batches\n";
+    } catch (const std::exception &error) {
+        std::cerr << "algodiff_server: " << error.what() << '\n';
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
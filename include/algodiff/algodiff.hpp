@@ -6,7 +6,41 @@
 /// \brief Header that includes everything
 #pragma once
 
+#include "algodiff_c.h"
+#include "async.hpp"
+#include "batch_jacobian.hpp"
+#include "cached_jacobian.hpp"
+#include "compressed_jacobian.hpp"
+#include "custom_function.hpp"
+#include "dual_array.hpp"
 #include "dual_number.hpp"
 #include "dual_number_eigen.hpp"
+#include "dual_number_kernels.hpp"
 #include "dual_number_ops.hpp"
 #include "forward_mode.hpp"
+#include "gradient_service.hpp"
+#include "interpolation_table.hpp"
+#include "jacobian_operator.hpp"
+#include "jacobian_stream.hpp"
+#include "linearity_tracer.hpp"
+#include "mapped_file.hpp"
+#include "model_registry.hpp"
+#include "parallel.hpp"
+#include "process_jacobian.hpp"
+#include "randomized_sketch.hpp"
+#include "reverse_mode.hpp"
+#include "sparse_dual_number.hpp"
+#include "sparse_dual_number_eigen.hpp"
+#include "sparse_dual_number_ops.hpp"
+#include "sparse_forward_mode.hpp"
+#include "sparse_hessian.hpp"
+#include "stencil_jacobian.hpp"
+#include "tape.hpp"
+#include "tape_batch.hpp"
+#include "tape_eigen.hpp"
+#include "tape_interpreter.hpp"
+#include "tape_ops.hpp"
+#include "tape_template.hpp"
+#include "thread_pool.hpp"
+#include "trajectory_jacobian.hpp"
+#include "vertex_elimination.hpp"
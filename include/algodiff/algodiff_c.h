@@ -0,0 +1,306 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+/** \file algodiff_c.h
+ *  \brief A C interface to algodiff for embedding in other languages
+ *
+ * Every function returns an algodiff_status instead of throwing; the message
+ * of the last failure on the calling thread is available from
+ * algodiff_last_error(). Vectors are passed as a pointer and a stride in
+ * elements, so element i of x is x[i * incx], and a matrix as a pointer and
+ * two strides, so element (i, j) of a is a[i * row_stride + j *
+ * column_stride]. Column-major storage with leading dimension ld (Fortran) is
+ * row_stride = 1, column_stride = ld and row-major storage is row_stride = ld,
+ * column_stride = 1. Contiguous vectors (stride 1) and column-major jacobians
+ * with column_stride = m are read and written by the model in place; other
+ * layouts are staged in a workspace, which is created once per model and
+ * thread and reused by every call. Forward models and tapes without external
+ * functions then evaluate without allocating, apart from what the function of
+ * a forward model allocates itself.
+ */
+#ifndef ALGODIFF_C_H
+#define ALGODIFF_C_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** The result of every call */
+typedef enum algodiff_status {
+    /** The call succeeded */
+    ALGODIFF_OK = 0,
+    /** A null, unknown or mismatched argument */
+    ALGODIFF_ERROR_INVALID_ARGUMENT = 1,
+    /** A gradient was requested from a model with several outputs */
+    ALGODIFF_ERROR_DIMENSION_MISMATCH = 2,
+    /** A plugin or model could not be found */
+    ALGODIFF_ERROR_NOT_FOUND = 3,
+    /** The model failed to evaluate */
+    ALGODIFF_ERROR_EVALUATION = 4,
+    /** An allocation failed */
+    ALGODIFF_ERROR_OUT_OF_MEMORY = 5,
+} algodiff_status;
+
+/** A recording of a function under construction */
+typedef struct algodiff_tape algodiff_tape;
+
+/** A function from R^n to R^m that can be differentiated */
+typedef struct algodiff_model algodiff_model;
+
+/** Scratch memory for evaluating one model on one thread */
+typedef struct algodiff_workspace algodiff_workspace;
+
+/** A value recorded on a tape */
+typedef uint32_t algodiff_var;
+
+/** Operations on one value */
+typedef enum algodiff_unary_op {
+    ALGODIFF_NEGATE,
+    ALGODIFF_ABS,
+    ALGODIFF_SQRT,
+    ALGODIFF_EXP,
+    ALGODIFF_LOG,
+    ALGODIFF_SIN,
+    ALGODIFF_COS,
+    ALGODIFF_TAN,
+    ALGODIFF_ASIN,
+    ALGODIFF_ACOS,
+    ALGODIFF_ATAN,
+    ALGODIFF_SINH,
+    ALGODIFF_COSH,
+    ALGODIFF_TANH,
+} algodiff_unary_op;
+
+/** Operations on two values */
+typedef enum algodiff_binary_op {
+    ALGODIFF_ADD,
+    ALGODIFF_SUBTRACT,
+    ALGODIFF_MULTIPLY,
+    ALGODIFF_DIVIDE,
+    ALGODIFF_POW,
+} algodiff_binary_op;
+
+/**
+ * \brief Returns a description of a status
+ *
+ * \param status The status
+ * \return A static string
+ */
+const char *algodiff_status_string(algodiff_status status);
+
+/**
+ * \brief Returns the message of the last failed call on this thread
+ *
+ * \return A string valid until the next failed call on this thread, empty
+ * if no call has failed
+ */
+const char *algodiff_last_error(void);
+
+/**
+ * \brief Creates an empty tape
+ *
+ * \param tape Receives the tape
+ * \return The status
+ */
+algodiff_status algodiff_tape_create(algodiff_tape **tape);
+
+/**
+ * \brief Destroys a tape; does nothing for NULL
+ *
+ * \param tape The tape
+ */
+void algodiff_tape_destroy(algodiff_tape *tape);
+
+/**
+ * \brief Records a new independent variable
+ *
+ * \param tape The tape
+ * \param value The value of the variable while recording
+ * \param out Receives the variable
+ * \return The status
+ */
+algodiff_status algodiff_tape_input(algodiff_tape *tape, double value,
+                                    algodiff_var *out);
+
+/**
+ * \brief Creates a constant; constants are folded into the operations that
+ * use them
+ *
+ * \param tape The tape
+ * \param value The value of the constant
+ * \param out Receives the constant
+ * \return The status
+ */
+algodiff_status algodiff_tape_constant(algodiff_tape *tape, double value,
+                                       algodiff_var *out);
+
+/**
+ * \brief Records an operation on one value
+ *
+ * \param tape The tape
+ * \param op The operation
+ * \param operand The operand
+ * \param out Receives the result
+ * \return The status
+ */
+algodiff_status algodiff_tape_unary(algodiff_tape *tape, algodiff_unary_op op,
+                                    algodiff_var operand, algodiff_var *out);
+
+/**
+ * \brief Records an operation on two values
+ *
+ * \param tape The tape
+ * \param op The operation
+ * \param lhs The left operand
+ * \param rhs The right operand
+ * \param out Receives the result
+ * \return The status
+ */
+algodiff_status algodiff_tape_binary(algodiff_tape *tape,
+                                     algodiff_binary_op op, algodiff_var lhs,
+                                     algodiff_var rhs, algodiff_var *out);
+
+/**
+ * \brief Marks a value as the next output of the function
+ *
+ * \param tape The tape
+ * \param output The value
+ * \return The status
+ */
+algodiff_status algodiff_tape_output(algodiff_tape *tape,
+                                     algodiff_var output);
+
+/**
+ * \brief Turns a finished recording into a model
+ *
+ * The recording moves into the model, so the tape is empty afterwards and
+ * must still be destroyed.
+ *
+ * \param tape The tape
+ * \param model Receives the model
+ * \return The status
+ */
+algodiff_status algodiff_model_from_tape(algodiff_tape *tape,
+                                         algodiff_model **model);
+
+/**
+ * \brief Loads a model registered by a plugin shared library
+ *
+ * The plugin defines its models with ALGODIFF_PLUGIN (see server_plugin.hpp)
+ * and stays loaded for the lifetime of the process.
+ *
+ * \param path The path of the plugin
+ * \param name The name the model is registered under
+ * \param model Receives the model
+ * \return The status
+ */
+algodiff_status algodiff_model_load_plugin(const char *path, const char *name,
+                                           algodiff_model **model);
+
+/**
+ * \brief Destroys a model; does nothing for NULL
+ *
+ * \param model The model
+ */
+void algodiff_model_destroy(algodiff_model *model);
+
+/**
+ * \brief Returns the dimensions of a model
+ *
+ * \param model The model
+ * \param input_size Receives n
+ * \param output_size Receives m
+ * \return The status
+ */
+algodiff_status algodiff_model_size(const algodiff_model *model,
+                                    size_t *input_size, size_t *output_size);
+
+/**
+ * \brief Creates the scratch memory for evaluating a model
+ *
+ * A workspace is used by one thread at a time and must not outlive its
+ * model.
+ *
+ * \param model The model
+ * \param workspace Receives the workspace
+ * \return The status
+ */
+algodiff_status algodiff_workspace_create(const algodiff_model *model,
+                                          algodiff_workspace **workspace);
+
+/**
+ * \brief Destroys a workspace; does nothing for NULL
+ *
+ * \param workspace The workspace
+ */
+void algodiff_workspace_destroy(algodiff_workspace *workspace);
+
+/**
+ * \brief Computes the gradient of a model with one output
+ *
+ * \param model The model
+ * \param workspace A workspace created for the model
+ * \param x The n inputs
+ * \param incx The stride of x
+ * \param value Receives the output; may be NULL
+ * \param gradient Receives the n partial derivatives
+ * \param incg The stride of gradient
+ * \return The status; ALGODIFF_ERROR_DIMENSION_MISMATCH if m is not 1
+ */
+algodiff_status algodiff_gradient(const algodiff_model *model,
+                                  algodiff_workspace *workspace,
+                                  const double *x, ptrdiff_t incx,
+                                  double *value, double *gradient,
+                                  ptrdiff_t incg);
+
+/**
+ * \brief Computes the jacobian of a model
+ *
+ * \param model The model
+ * \param workspace A workspace created for the model
+ * \param x The n inputs
+ * \param incx The stride of x
+ * \param y Receives the m outputs; may be NULL
+ * \param incy The stride of y
+ * \param jacobian Receives the m x n jacobian
+ * \param row_stride The distance between rows of jacobian
+ * \param column_stride The distance between columns of jacobian
+ * \return The status
+ */
+algodiff_status algodiff_jacobian(const algodiff_model *model,
+                                  algodiff_workspace *workspace,
+                                  const double *x, ptrdiff_t incx, double *y,
+                                  ptrdiff_t incy, double *jacobian,
+                                  ptrdiff_t row_stride,
+                                  ptrdiff_t column_stride);
+
+/**
+ * \brief Computes the jacobian of a model times a direction
+ *
+ * \param model The model
+ * \param workspace A workspace created for the model
+ * \param x The n inputs
+ * \param incx The stride of x
+ * \param v The n components of the direction
+ * \param incv The stride of v
+ * \param y Receives the m outputs; may be NULL
+ * \param incy The stride of y
+ * \param jv Receives the m components of the product
+ * \param incjv The stride of jv
+ * \return The status
+ */
+algodiff_status algodiff_jvp(const algodiff_model *model,
+                             algodiff_workspace *workspace, const double *x,
+                             ptrdiff_t incx, const double *v, ptrdiff_t incv,
+                             double *y, ptrdiff_t incy, double *jv,
+                             ptrdiff_t incjv);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ALGODIFF_C_H */
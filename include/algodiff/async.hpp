@@ -0,0 +1,319 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+/// \file async.hpp
+/// \brief Launches gradient and jacobian computations on an executor without
+/// blocking the caller
+#pragma once
+
+#include <exception>
+#include <future>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <coroutine>
+#define ALGODIFF_HAS_COROUTINES 1
+#endif
+
+#include "forward_mode.hpp"
+#include "thread_pool.hpp"
+
+namespace algodiff::forward
+{
+namespace internal
+{
+template <class Executor, class Work>
+auto submit_future(Executor &executor, Work work)
+    -> std::future<std::invoke_result_t<Work &>>
+{
+    using Result = std::invoke_result_t<Work &>;
+    auto task{std::make_shared<std::packaged_task<Result()>>(std::move(work))};
+    auto future{task->get_future()};
+    executor.submit([task] { (*task)(); });
+    return future;
+}
+
+template <class Executor, class Work, class Callback>
+auto submit_callback(Executor &executor, Work work, Callback callback) -> void
+{
+    using Result = std::invoke_result_t<Work &>;
+    executor.submit([work = std::move(work),
+                     callback = std::move(callback)]() mutable {
+        std::optional<Result> result{};
+        std::exception_ptr error{};
+        try {
+            result.emplace(work());
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        // Nothing waits on the task to rethrow to, and an exception leaving
+        // it would end the worker thread, so the callback's own are dropped
+        try {
+            callback(error, std::move(result));
+        } catch (...) {
+        }
+    });
+}
+
+template <class F, int InputSize> struct GradientWork {
+    F f;
+    Eigen::Matrix<double, InputSize, 1> u;
+
+    auto operator()() -> Eigen::Matrix<double, InputSize, 1>
+    {
+        return gradient(f, u);
+    }
+};
+
+template <int FunctionSize, class F> struct JacobianWork {
+    F f;
+    Eigen::VectorXd u;
+
+    auto operator()() -> Eigen::MatrixXd
+    {
+        return jacobian<FunctionSize>(f, u);
+    }
+};
+
+} // namespace internal
+
+/**
+ * \brief Starts computing the gradient of f at u on an executor
+ *
+ * f and u are copied into the task, so every task works on its own function
+ * state and dual number storage and the caller's copies can change freely.
+ *
+ * \tparam Executor Type with a member submit(std::function<void()>), such as
+ * ThreadPool
+ * \tparam F Function Type that takes as input a Eigen::Matrix<DualNumber,
+ * InputSize, 1> and outputs a DualNumber
+ * \tparam InputSize The dimension of the input vector
+ * \param executor The executor to run on
+ * \param f The function to take the gradient of
+ * \param u The point to evaluate the gradient at
+ * \return A future holding the gradient, or the exception thrown by f
+ */
+template <class Executor, class F, int InputSize>
+auto async_gradient(Executor &executor, F f,
+                    const Eigen::Matrix<double, InputSize, 1> &u)
+    -> std::future<Eigen::Matrix<double, InputSize, 1>>
+{
+    return internal::submit_future(
+        executor, internal::GradientWork<F, InputSize>{std::move(f), u});
+}
+
+/**
+ * \brief Starts computing the gradient of f at u on the default executor
+ *
+ * \tparam F Function Type that takes as input a Eigen::Matrix<DualNumber,
+ * InputSize, 1> and outputs a DualNumber
+ * \tparam InputSize The dimension of the input vector
+ * \param f The function to take the gradient of
+ * \param u The point to evaluate the gradient at
+ * \return A future holding the gradient, or the exception thrown by f
+ */
+template <class F, int InputSize>
+auto async_gradient(F f, const Eigen::Matrix<double, InputSize, 1> &u)
+    -> std::future<Eigen::Matrix<double, InputSize, 1>>
+{
+    return async_gradient(default_executor(), std::move(f), u);
+}
+
+/**
+ * \brief Computes the gradient of f at u on an executor and hands it to a
+ * completion callback
+ *
+ * \tparam Executor Type with a member submit(std::function<void()>)
+ * \tparam F Function Type that takes as input a Eigen::Matrix<DualNumber,
+ * InputSize, 1> and outputs a DualNumber
+ * \tparam InputSize The dimension of the input vector
+ * \tparam Callback Callable invoked on the executor as
+ * callback(std::exception_ptr error,
+ * std::optional<Eigen::Matrix<double, InputSize, 1>> gradient); the gradient
+ * is empty exactly when error is set. Exceptions thrown by the callback are
+ * caught and discarded
+ * \param executor The executor to run on
+ * \param f The function to take the gradient of
+ * \param u The point to evaluate the gradient at
+ * \param callback The completion callback
+ */
+template <class Executor, class F, int InputSize, class Callback>
+auto async_gradient(Executor &executor, F f,
+                    const Eigen::Matrix<double, InputSize, 1> &u,
+                    Callback callback) -> void
+{
+    internal::submit_callback(
+        executor, internal::GradientWork<F, InputSize>{std::move(f), u},
+        std::move(callback));
+}
+
+/**
+ * \brief Starts computing the jacobian of f at u on an executor
+ *
+ * f and u are copied into the task, so every task works on its own function
+ * state and dual number storage and the caller's copies can change freely.
+ *
+ * \tparam FunctionSize The dimension of the output of f
+ * \tparam Executor Type with a member submit(std::function<void()>), such as
+ * ThreadPool
+ * \tparam F Function Type that takes as input a Eigen::VectorX<DualNumber> and
+ * outputs a vector of DualNumbers of size FunctionSize
+ * \param executor The executor to run on
+ * \param f The function to take the jacobian of
+ * \param u The point to evaluate the jacobian at
+ * \return A future holding the jacobian, or the exception thrown by f
+ */
+template <int FunctionSize, class Executor, class F>
+auto async_jacobian(Executor &executor, F f, const Eigen::VectorXd &u)
+    -> std::future<Eigen::MatrixXd>
+{
+    return internal::submit_future(
+        executor, internal::JacobianWork<FunctionSize, F>{std::move(f), u});
+}
+
+/**
+ * \brief Starts computing the jacobian of f at u on the default executor
+ *
+ * \tparam FunctionSize The dimension of the output of f
+ * \tparam F Function Type that takes as input a Eigen::VectorX<DualNumber> and
+ * outputs a vector of DualNumbers of size FunctionSize
+ * \param f The function to take the jacobian of
+ * \param u The point to evaluate the jacobian at
+ * \return A future holding the jacobian, or the exception thrown by f
+ */
+template <int FunctionSize, class F>
+auto async_jacobian(F f, const Eigen::VectorXd &u)
+    -> std::future<Eigen::MatrixXd>
+{
+    return async_jacobian<FunctionSize>(default_executor(), std::move(f), u);
+}
+
+/**
+ * \brief Computes the jacobian of f at u on an executor and hands it to a
+ * completion callback
+ *
+ * \tparam FunctionSize The dimension of the output of f
+ * \tparam Executor Type with a member submit(std::function<void()>)
+ * \tparam F Function Type that takes as input a Eigen::VectorX<DualNumber> and
+ * outputs a vector of DualNumbers of size FunctionSize
+ * \tparam Callback Callable invoked on the executor as
+ * callback(std::exception_ptr error, std::optional<Eigen::MatrixXd>
+ * jacobian); the jacobian is empty exactly when error is set. Exceptions
+ * thrown by the callback are caught and discarded
+ * \param executor The executor to run on
+ * \param f The function to take the jacobian of
+ * \param u The point to evaluate the jacobian at
+ * \param callback The completion callback
+ */
+template <int FunctionSize, class Executor, class F, class Callback>
+auto async_jacobian(Executor &executor, F f, const Eigen::VectorXd &u,
+                    Callback callback) -> void
+{
+    internal::submit_callback(
+        executor, internal::JacobianWork<FunctionSize, F>{std::move(f), u},
+        std::move(callback));
+}
+
+#ifdef ALGODIFF_HAS_COROUTINES
+/**
+ * \brief An awaitable that runs work on an executor and resumes the awaiting
+ * coroutine there once the result is ready
+ *
+ * \tparam Executor Type with a member submit(std::function<void()>)
+ * \tparam Work Callable returning the result
+ */
+template <class Executor, class Work> class ExecutorAwaitable
+{
+public:
+    using Result = std::invoke_result_t<Work &>;
+
+    /**
+     * \brief Creates the awaitable; nothing runs until it is awaited
+     *
+     * \param executor The executor to run on
+     * \param work The work
+     */
+    ExecutorAwaitable(Executor &executor, Work work)
+        : m_executor{&executor}, m_work{std::move(work)}
+    {
+    }
+
+    auto await_ready() const noexcept -> bool
+    {
+        return false;
+    }
+
+    auto await_suspend(std::coroutine_handle<> handle) -> void
+    {
+        m_executor->submit([this, handle] {
+            try {
+                m_result.emplace(m_work());
+            } catch (...) {
+                m_error = std::current_exception();
+            }
+            handle.resume();
+        });
+    }
+
+    auto await_resume() -> Result
+    {
+        if (m_error) {
+            std::rethrow_exception(m_error);
+        }
+        return std::move(*m_result);
+    }
+
+private:
+    Executor *m_executor;
+    Work m_work;
+    std::optional<Result> m_result{};
+    std::exception_ptr m_error{};
+};
+
+/**
+ * \brief Returns an awaitable computing the gradient of f at u on an executor
+ *
+ * \tparam Executor Type with a member submit(std::function<void()>)
+ * \tparam F Function Type that takes as input a Eigen::Matrix<DualNumber,
+ * InputSize, 1> and outputs a DualNumber
+ * \tparam InputSize The dimension of the input vector
+ * \param executor The executor to run on
+ * \param f The function to take the gradient of
+ * \param u The point to evaluate the gradient at
+ * \return The awaitable; co_await yields the gradient
+ */
+template <class Executor, class F, int InputSize>
+auto await_gradient(Executor &executor, F f,
+                    const Eigen::Matrix<double, InputSize, 1> &u)
+{
+    return ExecutorAwaitable<Executor, internal::GradientWork<F, InputSize>>{
+        executor, internal::GradientWork<F, InputSize>{std::move(f), u}};
+}
+
+/**
+ * \brief Returns an awaitable computing the jacobian of f at u on an executor
+ *
+ * \tparam FunctionSize The dimension of the output of f
+ * \tparam Executor Type with a member submit(std::function<void()>)
+ * \tparam F Function Type that takes as input a Eigen::VectorX<DualNumber> and
+ * outputs a vector of DualNumbers of size FunctionSize
+ * \param executor The executor to run on
+ * \param f The function to take the jacobian of
+ * \param u The point to evaluate the jacobian at
+ * \return The awaitable; co_await yields the jacobian
+ */
+template <int FunctionSize, class Executor, class F>
+auto await_jacobian(Executor &executor, F f, const Eigen::VectorXd &u)
+{
+    return ExecutorAwaitable<Executor,
+                             internal::JacobianWork<FunctionSize, F>>{
+        executor, internal::JacobianWork<FunctionSize, F>{std::move(f), u}};
+}
+#endif
+
+} // namespace algodiff::forward
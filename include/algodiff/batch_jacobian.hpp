@@ -0,0 +1,217 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+/// \file batch_jacobian.hpp
+/// \brief Computes jacobians at every point of a memory-mapped dataset
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+
+#include "dual_number.hpp"
+#include "dual_number_eigen.hpp"
+#include "forward_mode.hpp"
+#include "mapped_file.hpp"
+#include "parallel.hpp"
+
+namespace algodiff::forward
+{
+/// Options for batch_jacobian
+struct BatchJacobianOptions {
+    /// The number of points evaluated as one unit of work and checkpointed
+    /// together
+    std::int64_t chunk_size{4096};
+
+    /// The number of worker threads, 0 for one per hardware thread
+    unsigned threads{0};
+
+    /// The file recording which chunks are complete. When empty the whole
+    /// dataset is always recomputed
+    std::string checkpoint_path{};
+};
+
+/// Summary of a batch_jacobian run
+struct BatchJacobianResult {
+    /// The number of points in the input file
+    std::int64_t points{0};
+
+    /// The number of chunks computed by this run
+    std::int64_t chunks_computed{0};
+
+    /// The number of chunks skipped because a previous run completed them
+    std::int64_t chunks_skipped{0};
+};
+
+namespace internal
+{
+/**
+ * \brief A memory-mapped record of the completed chunks of a batch run
+ *
+ * The file holds a small header describing the run followed by one byte per
+ * chunk. A chunk is only marked complete after its output has been written
+ * back, so a run killed at any point can be resumed.
+ */
+class BatchCheckpoint
+{
+public:
+    /**
+     * \brief Opens the checkpoint at path, starting a new one if the file is
+     * missing or describes a different run
+     *
+     * \param path The checkpoint file, empty for no checkpointing
+     * \param points The number of points in the run
+     * \param chunk_size The number of points per chunk
+     * \param point_bytes The size of one input point in bytes
+     * \param result_bytes The size of one output jacobian in bytes
+     */
+    BatchCheckpoint(const std::string &path, std::int64_t points,
+                    std::int64_t chunk_size, std::int64_t point_bytes,
+                    std::int64_t result_bytes);
+
+    /**
+     * \brief Returns true if this checkpoint continues an earlier run
+     *
+     * \return true if an earlier run with the same layout was found
+     */
+    auto resumed() const -> bool
+    {
+        return m_resumed;
+    }
+
+    /**
+     * \brief Returns true if chunk was completed
+     *
+     * \param chunk The chunk index
+     * \return true if chunk was completed
+     */
+    auto done(std::int64_t chunk) const -> bool;
+
+    /**
+     * \brief Marks chunk as completed
+     *
+     * \param chunk The chunk index
+     */
+    auto mark_done(std::int64_t chunk) -> void;
+
+    /// Forgets every completed chunk
+    auto reset() -> void;
+
+private:
+    /// The mapped checkpoint file, empty when not checkpointing
+    MappedFile m_file{};
+
+    /// Whether an earlier run was found
+    bool m_resumed{false};
+};
+
+} // namespace internal
+
+/**
+ * \brief Computes the jacobian of f at every point of a binary input file and
+ * writes them to a binary output file, both accessed through memory maps
+ *
+ * The input file holds the points back to back, each as InputSize native
+ * doubles. The output file receives one FunctionSize x InputSize column major
+ * jacobian per point, in the same order. Chunks of points are handed to the
+ * worker threads in file order, so both files are traversed close to
+ * sequentially. With a checkpoint path, chunks completed by an earlier run
+ * over the same files are skipped and the output file is reused.
+ *
+ * \throws std::invalid_argument if the input file size is not a whole number
+ * of points or chunk_size is not positive
+ * \throws std::system_error if a file cannot be mapped
+ *
+ * \tparam FunctionSize The dimension of the output of f
+ * \tparam InputSize The dimension of the input of f
+ * \tparam F Function Type that takes as input a Eigen::Vector<DualNumber,
+ * InputSize> and outputs a vector of DualNumbers of size FunctionSize. It is
+ * called concurrently from several threads
+ * \param f A multidimensional function that maps a point (in dual number
+ * representation) to the output space
+ * \param input_path The file of input points
+ * \param output_path The file the jacobians are written to
+ * \param options Chunking, threading and checkpoint options
+ * \return A summary of the work done
+ */
+template <int FunctionSize, int InputSize, class F>
+auto batch_jacobian(F &&f, const std::string &input_path,
+                    const std::string &output_path,
+                    const BatchJacobianOptions &options = {})
+    -> BatchJacobianResult
+{
+    static_assert(InputSize > 0 && FunctionSize > 0,
+                  "batch_jacobian requires fixed sizes");
+    constexpr auto point_bytes{
+        static_cast<std::int64_t>(InputSize * sizeof(double))};
+    constexpr auto result_bytes{
+        static_cast<std::int64_t>(FunctionSize * InputSize * sizeof(double))};
+
+    if (options.chunk_size < 1) {
+        throw std::invalid_argument("chunk_size must be positive");
+    }
+
+    const MappedFile input{input_path, MappedFile::Mode::ReadOnly};
+    if (input.size() % static_cast<std::size_t>(point_bytes) != 0) {
+        throw std::invalid_argument(input_path +
+                                    " is not a whole number of points");
+    }
+    input.advise_sequential();
+
+    BatchJacobianResult result{};
+    result.points = static_cast<std::int64_t>(input.size()) / point_bytes;
+    const auto chunks{(result.points + options.chunk_size - 1) /
+                      options.chunk_size};
+
+    const auto output_bytes{
+        static_cast<std::size_t>(result.points * result_bytes)};
+    internal::BatchCheckpoint checkpoint{options.checkpoint_path,
+                                         result.points, options.chunk_size,
+                                         point_bytes, result_bytes};
+    std::error_code ec{};
+    if (checkpoint.resumed() &&
+        std::filesystem::file_size(output_path, ec) != output_bytes) {
+        // The output of the earlier run is gone, so its progress is useless
+        checkpoint.reset();
+    }
+    const MappedFile output{output_path, MappedFile::Mode::ReadWrite,
+                            output_bytes};
+
+    const auto *points{reinterpret_cast<const double *>( // NOLINT
+        input.data())};
+    auto *jacobians{reinterpret_cast<double *>(output.data())}; // NOLINT
+
+    std::atomic<std::int64_t> computed{0};
+    algodiff::internal::parallel_for(
+        chunks, options.threads, [&](std::int64_t chunk) {
+            if (checkpoint.done(chunk)) {
+                return;
+            }
+            const auto first{chunk * options.chunk_size};
+            const auto last{
+                std::min(first + options.chunk_size, result.points)};
+            for (auto p = first; p < last; ++p) {
+                const Eigen::Vector<double, InputSize> u{
+                    Eigen::Map<const Eigen::Vector<double, InputSize>>(
+                        points + p * InputSize)};
+                Eigen::Map<Eigen::Matrix<double, FunctionSize, InputSize>>(
+                    jacobians + p * FunctionSize * InputSize) =
+                    jacobian<FunctionSize>(f, u);
+            }
+            output.sync(static_cast<std::size_t>(first * result_bytes),
+                        static_cast<std::size_t>((last - first) *
+                                                 result_bytes));
+            checkpoint.mark_done(chunk);
+            ++computed;
+        });
+
+    result.chunks_computed = computed;
+    result.chunks_skipped = chunks - result.chunks_computed;
+    return result;
+}
+
+} // namespace algodiff::forward
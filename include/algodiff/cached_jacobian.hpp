@@ -0,0 +1,185 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+/// \file cached_jacobian.hpp
+/// \brief Computes jacobians that reuse their constant entries instead of
+/// recomputing them on every call
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include "dual_number.hpp"
+#include "dual_number_eigen.hpp"
+#include "linearity_tracer.hpp"
+
+namespace algodiff::forward
+{
+/// How an entry of a jacobian depends on the point it is evaluated at
+enum class JacobianEntry : std::uint8_t {
+    /// The output does not depend on the input
+    Zero,
+
+    /// The output is affine in the input with a constant coefficient
+    Constant,
+
+    /// The partial derivative changes with the inputs
+    Varying,
+};
+
+/**
+ * \brief The jacobian of a function whose constant entries are computed once
+ *
+ * Construction runs f once on LinearityTracers to classify every entry of the
+ * jacobian, and stores the value of the constant ones. Later jacobians start
+ * from the stored entries and only seed the columns that contain a varying
+ * entry, so a function that is affine in most of its inputs needs few forward
+ * passes.
+ *
+ * \warning The classification follows the branches taken at the analysis
+ * point, so f must not change its control flow based on the input values
+ *
+ * \tparam FunctionSize The dimension of the output of f
+ * \tparam F Function Type callable with both a Eigen::VectorX<DualNumber> and a
+ * Eigen::VectorX<LinearityTracer> (for example a generic lambda), returning a
+ * vector of the same scalar type of size FunctionSize
+ */
+template <int FunctionSize, class F> class CachedJacobian
+{
+public:
+    /**
+     * \brief Analyzes f at u
+     *
+     * \param f The function
+     * \param u The point to trace f at
+     */
+    CachedJacobian(F f, const Eigen::VectorXd &u)
+        : m_f{std::move(f)}, m_constant{Eigen::MatrixXd::Zero(FunctionSize,
+                                                                u.size())},
+          m_entries(static_cast<size_t>(FunctionSize * u.size()),
+                    JacobianEntry::Zero)
+    {
+        Eigen::VectorX<LinearityTracer> tracers(u.size());
+        for (Eigen::Index i = 0; i < u.size(); ++i) {
+            tracers[i] = LinearityTracer::input(i, u[i]);
+        }
+        const Eigen::VectorX<LinearityTracer> result{m_f(tracers)};
+
+        std::vector<bool> varying(static_cast<size_t>(u.size()), false);
+        for (Eigen::Index row = 0; row < FunctionSize; ++row) {
+            for (const auto &[col, coefficient] : result[row].linear()) {
+                m_constant(row, col) = coefficient;
+                entry_at(row, col) = JacobianEntry::Constant;
+            }
+            for (const auto col : result[row].nonlinear()) {
+                entry_at(row, col) = JacobianEntry::Varying;
+                varying[static_cast<size_t>(col)] = true;
+            }
+        }
+        for (Eigen::Index col = 0; col < u.size(); ++col) {
+            if (varying[static_cast<size_t>(col)]) {
+                m_varying_columns.push_back(col);
+            }
+        }
+    }
+
+    /**
+     * \brief Returns the classification of an entry
+     *
+     * \param row The output
+     * \param col The input
+     * \return The classification
+     */
+    auto entry(Eigen::Index row, Eigen::Index col) const -> JacobianEntry
+    {
+        return m_entries[static_cast<size_t>(col * FunctionSize + row)];
+    }
+
+    /**
+     * \brief Returns the columns that are recomputed on every call
+     *
+     * \return The column indices in increasing order
+     */
+    auto varying_columns() const -> const std::vector<Eigen::Index> &
+    {
+        return m_varying_columns;
+    }
+
+    /**
+     * \brief Returns the constant entries, with zeros everywhere else
+     *
+     * \return The FunctionSize x input_size matrix
+     */
+    auto constant_entries() const -> const Eigen::MatrixXd &
+    {
+        return m_constant;
+    }
+
+    /**
+     * \brief Returns the jacobian of f evaluated at u
+     *
+     * \throws std::invalid_argument if u does not have the size of the
+     * analysis point
+     *
+     * \param u A vector of inputs that f will be evaluated at
+     * \return A matrix representing the jacobian of f at u
+     */
+    auto operator()(const Eigen::VectorXd &u) const -> Eigen::MatrixXd
+    {
+        if (u.size() != m_constant.cols()) {
+            throw std::invalid_argument(
+                "The input size differs from the analysis point");
+        }
+
+        Eigen::MatrixXd jac{m_constant};
+        Eigen::VectorX<DualNumber> dual_numbers(u.size());
+        for (Eigen::Index i = 0; i < u.size(); ++i) {
+            dual_numbers[i] = DualNumber{u[i], 0.0};
+        }
+        for (const auto col : m_varying_columns) {
+            dual_numbers[col].dual() = 1.0;
+            const Eigen::VectorX<DualNumber> result{m_f(dual_numbers)};
+            for (Eigen::Index row = 0; row < FunctionSize; ++row) {
+                jac(row, col) = result[row].dual();
+            }
+            dual_numbers[col].dual() = 0.0;
+        }
+        return jac;
+    }
+
+private:
+    auto entry_at(Eigen::Index row, Eigen::Index col) -> JacobianEntry &
+    {
+        return m_entries[static_cast<size_t>(col * FunctionSize + row)];
+    }
+
+    F m_f;
+    Eigen::MatrixXd m_constant;
+    std::vector<JacobianEntry> m_entries;
+    std::vector<Eigen::Index> m_varying_columns{};
+};
+
+/**
+ * \brief Analyzes f at u and returns a jacobian that caches its constant
+ * entries
+ *
+ * \tparam FunctionSize The dimension of the output of f
+ * \tparam F Function Type callable with both a Eigen::VectorX<DualNumber> and a
+ * Eigen::VectorX<LinearityTracer>
+ * \param f The function
+ * \param u The point to trace f at
+ * \return The cached jacobian
+ */
+template <int FunctionSize, class F>
+auto make_cached_jacobian(F f, const Eigen::VectorXd &u)
+    -> CachedJacobian<FunctionSize, F>
+{
+    return CachedJacobian<FunctionSize, F>{std::move(f), u};
+}
+
+} // namespace algodiff::forward
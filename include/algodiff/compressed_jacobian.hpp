@@ -0,0 +1,378 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+/// \file compressed_jacobian.hpp
+/// \brief Emits jacobians in compressed sparse (CSC/CSR) and on-disk formats
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <Eigen/SparseCore>
+
+#include "dual_number.hpp"
+#include "dual_number_eigen.hpp"
+#include "forward_mode.hpp"
+
+namespace algodiff::forward
+{
+/// The storage order of a CompressedJacobian
+enum class StorageOrder {
+    /// Compressed sparse column: outer index runs over columns
+    CSC,
+    /// Compressed sparse row: outer index runs over rows
+    CSR
+};
+
+/**
+ * \brief A jacobian in compressed sparse storage with plain index and value
+ * arrays, suitable for handing to solvers that do not use Eigen
+ *
+ * For CSC, the entries of column j are stored at positions
+ * [outer_index[j], outer_index[j + 1]) of inner_index (row indices) and values.
+ * For CSR the roles of rows and columns are swapped. Inner indices are sorted
+ * within each outer slice.
+ */
+struct CompressedJacobian {
+    /// The storage order of the arrays
+    StorageOrder order{StorageOrder::CSC};
+
+    /// The number of rows of the jacobian
+    std::int64_t rows{0};
+
+    /// The number of columns of the jacobian
+    std::int64_t cols{0};
+
+    /// Offsets into inner_index and values; one more entry than outer slices
+    std::vector<std::int64_t> outer_index{0};
+
+    /// The row (CSC) or column (CSR) index of each stored entry
+    std::vector<std::int64_t> inner_index{};
+
+    /// The value of each stored entry
+    std::vector<double> values{};
+
+    /**
+     * \brief Returns the number of stored entries
+     *
+     * \return The number of stored entries
+     */
+    auto nonZeros() const -> std::int64_t
+    {
+        return static_cast<std::int64_t>(values.size());
+    }
+};
+
+/**
+ * \brief Converts a CompressedJacobian to the other storage order
+ *
+ * \param jac The compressed jacobian
+ * \return The same jacobian stored as CSR if jac is CSC and vice versa
+ */
+auto transpose_storage(const CompressedJacobian &jac) -> CompressedJacobian;
+
+/**
+ * \brief Converts a CompressedJacobian to an Eigen sparse matrix
+ *
+ * \param jac The compressed jacobian
+ * \return A column major Eigen sparse matrix holding jac
+ */
+auto to_sparse_matrix(const CompressedJacobian &jac)
+    -> Eigen::SparseMatrix<double>;
+
+/**
+ * \brief Writes a jacobian column by column to a binary file
+ *
+ * The file starts with a fixed size header (magic "ADJC", format version,
+ * rows, cols and number of stored entries) followed by one record per
+ * written column: the column index, the number of entries and then that many
+ * (row index, value) pairs. Integers and values are 64 bit (IEEE 754 double
+ * values) and stored little endian on every host.
+ * The entry count in the header is patched when the writer is finished, so
+ * only the current column is ever held in memory.
+ */
+class BinaryJacobianWriter
+{
+public:
+    /**
+     * \brief Opens path for writing and emits the header
+     *
+     * \throws std::runtime_error if the file cannot be opened
+     *
+     * \param path The output file
+     * \param rows The number of rows of the jacobian
+     * \param cols The number of columns of the jacobian
+     * \param tolerance Entries with an absolute value at or below this are not
+     * stored
+     */
+    BinaryJacobianWriter(const std::string &path, std::int64_t rows,
+                         std::int64_t cols, double tolerance = 0.0);
+
+    BinaryJacobianWriter(const BinaryJacobianWriter &) = delete;
+    BinaryJacobianWriter(BinaryJacobianWriter &&) = default;
+    auto operator=(const BinaryJacobianWriter &)
+        -> BinaryJacobianWriter & = delete;
+    auto operator=(BinaryJacobianWriter &&) -> BinaryJacobianWriter & = default;
+
+    /// Finishes the file if finish() was not called
+    ~BinaryJacobianWriter();
+
+    /**
+     * \brief Appends the stored entries of a column
+     *
+     * \param col The column index
+     * \param column The dense values of the column
+     */
+    auto write_column(Eigen::Index col,
+                      const Eigen::Ref<const Eigen::VectorXd> &column) -> void;
+
+    /**
+     * \brief Patches the header and closes the file
+     *
+     * \throws std::runtime_error if the file could not be written
+     */
+    auto finish() -> void;
+
+    /**
+     * \brief Returns the number of entries written so far
+     *
+     * \return The number of entries written so far
+     */
+    auto nonZeros() const -> std::int64_t
+    {
+        return m_nnz;
+    }
+
+private:
+    /// The output stream
+    std::ofstream m_out;
+
+    /// The drop tolerance
+    double m_tolerance;
+
+    /// The number of entries written so far
+    std::int64_t m_nnz{0};
+
+    /// Scratch buffer for the rows of the current column
+    std::vector<std::int64_t> m_rows{};
+
+    /// Scratch buffer for the values of the current column
+    std::vector<double> m_values{};
+};
+
+/**
+ * \brief Reads a file written by BinaryJacobianWriter
+ *
+ * \throws std::runtime_error if the file is missing or malformed
+ *
+ * \param path The file to read
+ * \return The jacobian as a column major Eigen sparse matrix
+ */
+auto read_binary_jacobian(const std::string &path)
+    -> Eigen::SparseMatrix<double>;
+
+/**
+ * \brief Writes a jacobian column by column as a Matrix Market coordinate file
+ *
+ * The size line is written with padding and patched when the writer is
+ * finished, so entries can be appended as columns are produced.
+ */
+class MatrixMarketWriter
+{
+public:
+    /**
+     * \brief Opens path for writing and emits the banner
+     *
+     * \throws std::runtime_error if the file cannot be opened
+     *
+     * \param path The output file
+     * \param rows The number of rows of the jacobian
+     * \param cols The number of columns of the jacobian
+     * \param tolerance Entries with an absolute value at or below this are not
+     * stored
+     */
+    MatrixMarketWriter(const std::string &path, std::int64_t rows,
+                       std::int64_t cols, double tolerance = 0.0);
+
+    MatrixMarketWriter(const MatrixMarketWriter &) = delete;
+    MatrixMarketWriter(MatrixMarketWriter &&) = default;
+    auto operator=(const MatrixMarketWriter &) -> MatrixMarketWriter & = delete;
+    auto operator=(MatrixMarketWriter &&) -> MatrixMarketWriter & = default;
+
+    /// Finishes the file if finish() was not called
+    ~MatrixMarketWriter();
+
+    /**
+     * \brief Appends the stored entries of a column
+     *
+     * \param col The column index
+     * \param column The dense values of the column
+     */
+    auto write_column(Eigen::Index col,
+                      const Eigen::Ref<const Eigen::VectorXd> &column) -> void;
+
+    /**
+     * \brief Patches the size line and closes the file
+     *
+     * \throws std::runtime_error if the file could not be written
+     */
+    auto finish() -> void;
+
+    /**
+     * \brief Returns the number of entries written so far
+     *
+     * \return The number of entries written so far
+     */
+    auto nonZeros() const -> std::int64_t
+    {
+        return m_nnz;
+    }
+
+private:
+    /// The output stream
+    std::ofstream m_out;
+
+    /// The number of rows of the jacobian
+    std::int64_t m_rows;
+
+    /// The number of columns of the jacobian
+    std::int64_t m_cols;
+
+    /// The drop tolerance
+    double m_tolerance;
+
+    /// The number of entries written so far
+    std::int64_t m_nnz{0};
+
+    /// The stream offset of the size line
+    std::streampos m_size_line{};
+};
+
+/**
+ * \brief Returns the jacobian of f evaluated at u as plain compressed arrays
+ *
+ * Columns are compressed as soon as each forward pass finishes; the dense
+ * jacobian is never formed.
+ *
+ * \tparam FunctionSize The dimension of the output of f
+ * \tparam F Function Type that takes as input a Eigen::VectorX<DualNumber> and
+ * outputs a vector of DualNumbers of size FunctionSize
+ * \param f A multidimensional function that maps u (in dual number
+ * representation) to the output space
+ * \param u A vector of inputs that f will be evaluated at
+ * \param order The storage order of the result
+ * \param tolerance Entries with an absolute value at or below this are not
+ * stored
+ * \return The compressed jacobian of f at u
+ */
+template <int FunctionSize, class F>
+auto compressed_jacobian(F &&f, const Eigen::VectorXd &u,
+                         StorageOrder order = StorageOrder::CSC,
+                         double tolerance = 0.0) -> CompressedJacobian
+{
+    CompressedJacobian jac{};
+    jac.rows = FunctionSize;
+    jac.cols = u.size();
+    jac.outer_index.reserve(static_cast<size_t>(u.size()) + 1);
+    for_each_jacobian_column<FunctionSize>(
+        std::forward<F>(f), u,
+        [&](Eigen::Index, const Eigen::VectorXd &c) {
+            for (int row = 0; row < FunctionSize; ++row) {
+                if (std::abs(c[row]) > tolerance) {
+                    jac.inner_index.push_back(row);
+                    jac.values.push_back(c[row]);
+                }
+            }
+            jac.outer_index.push_back(jac.nonZeros());
+        });
+
+    if (order == StorageOrder::CSR) {
+        return transpose_storage(jac);
+    }
+    return jac;
+}
+
+/**
+ * \brief Returns the jacobian of f evaluated at u as a column major (CSC)
+ * Eigen sparse matrix
+ *
+ * \tparam FunctionSize The dimension of the output of f
+ * \tparam F Function Type that takes as input a Eigen::VectorX<DualNumber> and
+ * outputs a vector of DualNumbers of size FunctionSize
+ * \param f A multidimensional function that maps u (in dual number
+ * representation) to the output space
+ * \param u A vector of inputs that f will be evaluated at
+ * \param tolerance Entries with an absolute value at or below this are not
+ * stored
+ * \return The sparse jacobian of f at u
+ */
+template <int FunctionSize, class F>
+auto jacobian_csc(F &&f, const Eigen::VectorXd &u, double tolerance = 0.0)
+    -> Eigen::SparseMatrix<double, Eigen::ColMajor>
+{
+    Eigen::SparseMatrix<double, Eigen::ColMajor> jac(FunctionSize, u.size());
+    for_each_jacobian_column<FunctionSize>(
+        std::forward<F>(f), u,
+        [&](Eigen::Index col, const Eigen::VectorXd &c) {
+            jac.startVec(col);
+            for (int row = 0; row < FunctionSize; ++row) {
+                if (std::abs(c[row]) > tolerance) {
+                    jac.insertBack(row, col) = c[row];
+                }
+            }
+        });
+    jac.finalize();
+    return jac;
+}
+
+/**
+ * \brief Returns the jacobian of f evaluated at u as a row major (CSR) Eigen
+ * sparse matrix
+ *
+ * \tparam FunctionSize The dimension of the output of f
+ * \tparam F Function Type that takes as input a Eigen::VectorX<DualNumber> and
+ * outputs a vector of DualNumbers of size FunctionSize
+ * \param f A multidimensional function that maps u (in dual number
+ * representation) to the output space
+ * \param u A vector of inputs that f will be evaluated at
+ * \param tolerance Entries with an absolute value at or below this are not
+ * stored
+ * \return The sparse jacobian of f at u
+ */
+template <int FunctionSize, class F>
+auto jacobian_csr(F &&f, const Eigen::VectorXd &u, double tolerance = 0.0)
+    -> Eigen::SparseMatrix<double, Eigen::RowMajor>
+{
+    return jacobian_csc<FunctionSize>(std::forward<F>(f), u, tolerance);
+}
+
+/**
+ * \brief Streams the jacobian of f evaluated at u into a writer, one column
+ * per forward pass
+ *
+ * \tparam FunctionSize The dimension of the output of f
+ * \tparam F Function Type that takes as input a Eigen::VectorX<DualNumber> and
+ * outputs a vector of DualNumbers of size FunctionSize
+ * \tparam Writer A type with a write_column(Eigen::Index, const
+ * Eigen::Ref<const Eigen::VectorXd> &) member, e.g. BinaryJacobianWriter or
+ * MatrixMarketWriter
+ * \param f A multidimensional function that maps u (in dual number
+ * representation) to the output space
+ * \param u A vector of inputs that f will be evaluated at
+ * \param writer The destination of the columns
+ */
+template <int FunctionSize, class F, class Writer>
+auto write_jacobian(F &&f, const Eigen::VectorXd &u, Writer &writer) -> void
+{
+    for_each_jacobian_column<FunctionSize>(
+        std::forward<F>(f), u,
+        [&](Eigen::Index col, const Eigen::VectorXd &c) {
+            writer.write_column(col, c);
+        });
+}
+
+} // namespace algodiff::forward
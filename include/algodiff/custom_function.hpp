@@ -0,0 +1,398 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+/// \file custom_function.hpp
+/// \brief Wraps functions whose derivative is supplied by the user so that
+/// their implementation is never differentiated
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include "dual_number.hpp"
+#include "dual_number_eigen.hpp"
+#include "reverse_mode.hpp"
+#include "sparse_dual_number.hpp"
+#include "sparse_dual_number_eigen.hpp"
+#include "tape.hpp"
+
+namespace algodiff::forward
+{
+/**
+ * \brief A scalar function with a user supplied derivative
+ *
+ * Calling it with a double evaluates the primal only. Calling it with a
+ * DualNumber or SparseDualNumber evaluates the primal and the derivative on
+ * plain doubles and applies the chain rule, so it can be used inside any
+ * function passed to derivative, gradient or jacobian. Calling it with a
+ * reverse::Variable records one external call whose vjp scales the adjoint by
+ * the derivative.
+ *
+ * \tparam Primal Copyable callable double -> double
+ * \tparam Derivative Copyable callable double -> double returning the
+ * derivative
+ */
+template <class Primal, class Derivative> class CustomFunction
+{
+public:
+    /**
+     * \brief Creates a CustomFunction
+     *
+     * \param primal The function
+     * \param derivative The derivative of the function
+     */
+    CustomFunction(Primal primal, Derivative derivative)
+        : m_primal{std::move(primal)}, m_derivative{std::move(derivative)}
+    {
+        auto external{std::make_shared<reverse::ExternalFunction>()};
+        external->primal = [f = m_primal](const Eigen::VectorXd &x) {
+            return Eigen::VectorXd::Constant(1, f(x[0]));
+        };
+        external->vjp = [df = m_derivative](const Eigen::VectorXd &x,
+                                            const Eigen::VectorXd &,
+                                            const Eigen::VectorXd &w) {
+            return Eigen::VectorXd::Constant(1, df(x[0]) * w[0]);
+        };
+        m_external = std::move(external);
+    }
+
+    /**
+     * \brief Evaluates the function
+     *
+     * \param x The input
+     * \return The function evaluated at x
+     */
+    auto operator()(double x) const -> double
+    {
+        return m_primal(x);
+    }
+
+    /**
+     * \brief Evaluates the function and its derivative
+     *
+     * \param x The input
+     * \return The function evaluated at x, with the dual component
+     * propagated through the user supplied derivative
+     */
+    auto operator()(const DualNumber &x) const -> DualNumber
+    {
+        return DualNumber{m_primal(x.primal()),
+                          m_derivative(x.primal()) * x.dual()};
+    }
+
+    /**
+     * \brief Evaluates the function and its derivatives
+     *
+     * \param x The input
+     * \return The function evaluated at x, with the tangent scaled by the
+     * user supplied derivative
+     */
+    auto operator()(const SparseDualNumber &x) const -> SparseDualNumber
+    {
+        SparseDualNumber result{m_primal(x.primal()), x.tangent()};
+        result.tangent().scale(m_derivative(x.primal()));
+        return result;
+    }
+
+    /**
+     * \brief Evaluates the function on a Variable, recording it as a single
+     * node
+     *
+     * \param x The input
+     * \return The function evaluated at x; reverse sweeps multiply its
+     * adjoint by the user supplied derivative
+     */
+    auto operator()(const reverse::Variable &x) const -> reverse::Variable
+    {
+        const Eigen::VectorX<reverse::Variable> inputs{
+            Eigen::VectorX<reverse::Variable>::Constant(1, x)};
+        return reverse::call(m_external, inputs)[0];
+    }
+
+    /**
+     * \brief Returns the external function used with reverse::Variable inputs
+     *
+     * \return The external function, with a vjp built from the derivative
+     */
+    auto external() const
+        -> const std::shared_ptr<const reverse::ExternalFunction> &
+    {
+        return m_external;
+    }
+
+private:
+    Primal m_primal;
+    Derivative m_derivative;
+    std::shared_ptr<const reverse::ExternalFunction> m_external;
+};
+
+/**
+ * \brief Creates a scalar function with a user supplied derivative
+ *
+ * \tparam Primal Callable double -> double
+ * \tparam Derivative Callable double -> double
+ * \param primal The function
+ * \param derivative The derivative of the function
+ * \return The CustomFunction
+ */
+template <class Primal, class Derivative>
+auto make_custom_function(Primal &&primal, Derivative &&derivative)
+{
+    return CustomFunction<std::decay_t<Primal>, std::decay_t<Derivative>>{
+        std::forward<Primal>(primal), std::forward<Derivative>(derivative)};
+}
+
+/**
+ * \brief A vector function with a user supplied jacobian-vector product and,
+ * optionally, vector-jacobian product
+ *
+ * With DualNumber inputs a single call to jvp propagates the one seeded
+ * direction. With SparseDualNumber inputs jvp is called once per input index
+ * present in the tangents of x. With reverse::Variable inputs the call is
+ * recorded as one external call: its reverse sweeps call vjp if one is given,
+ * and otherwise use a jacobian built from one jvp per input at every
+ * evaluation.
+ *
+ * \tparam Primal Copyable callable Eigen::VectorXd -> Eigen::VectorXd
+ * \tparam Jvp Copyable callable (const Eigen::VectorXd &x, const
+ * Eigen::VectorXd &v) -> Eigen::VectorXd returning the jacobian at x times v
+ * \tparam Vjp Copyable callable (const Eigen::VectorXd &x, const
+ * Eigen::VectorXd &w) -> Eigen::VectorXd returning the transposed jacobian at
+ * x times w, or std::nullptr_t if there is none
+ */
+template <class Primal, class Jvp, class Vjp = std::nullptr_t>
+class CustomVectorFunction
+{
+public:
+    /**
+     * \brief Creates a CustomVectorFunction
+     *
+     * \param primal The function
+     * \param jvp The jacobian-vector product of the function
+     * \param vjp The vector-jacobian product of the function, if any
+     */
+    CustomVectorFunction(Primal primal, Jvp jvp, Vjp vjp = {})
+        : m_primal{std::move(primal)}, m_jvp{std::move(jvp)},
+          m_external{make_external(m_primal, m_jvp, std::move(vjp))}
+    {
+    }
+
+    /**
+     * \brief Evaluates the function
+     *
+     * \param x The input
+     * \return The function evaluated at x
+     */
+    auto operator()(const Eigen::VectorXd &x) const -> Eigen::VectorXd
+    {
+        return m_primal(x);
+    }
+
+    /**
+     * \brief Evaluates the function and its directional derivative
+     *
+     * \throws std::runtime_error if jvp does not return a vector of the size
+     * of the output
+     *
+     * \param x The input
+     * \return The function evaluated at x, with dual components given by the
+     * jacobian times the dual components of x
+     */
+    template <int Size>
+    auto operator()(const Eigen::Matrix<DualNumber, Size, 1> &x) const
+        -> Eigen::VectorX<DualNumber>
+    {
+        Eigen::VectorXd values(x.size());
+        Eigen::VectorXd direction(x.size());
+        for (Eigen::Index i = 0; i < x.size(); ++i) {
+            values[i] = x[i].primal();
+            direction[i] = x[i].dual();
+        }
+
+        const Eigen::VectorXd y{m_primal(values)};
+        const Eigen::VectorXd dy{m_jvp(values, direction)};
+        if (dy.size() != y.size()) {
+            throw std::runtime_error("jvp does not match the output size");
+        }
+
+        Eigen::VectorX<DualNumber> result(y.size());
+        for (Eigen::Index i = 0; i < y.size(); ++i) {
+            result[i] = DualNumber{y[i], dy[i]};
+        }
+        return result;
+    }
+
+    /**
+     * \brief Evaluates the function and its derivatives
+     *
+     * \throws std::runtime_error if jvp does not return a vector of the size
+     * of the output
+     *
+     * \param x The input
+     * \return The function evaluated at x, with tangents given by the jacobian
+     * times the tangents of x
+     */
+    auto operator()(const Eigen::VectorX<SparseDualNumber> &x) const
+        -> Eigen::VectorX<SparseDualNumber>
+    {
+        Eigen::VectorXd values(x.size());
+        std::vector<Eigen::Index> indices{};
+        for (Eigen::Index i = 0; i < x.size(); ++i) {
+            values[i] = x[i].primal();
+            for (const auto &entry : x[i].tangent()) {
+                indices.push_back(entry.index);
+            }
+        }
+        std::sort(indices.begin(), indices.end());
+        indices.erase(std::unique(indices.begin(), indices.end()),
+                      indices.end());
+
+        // One product per input index; the index order keeps tangents sorted
+        const Eigen::VectorXd y{m_primal(values)};
+        const auto count{static_cast<Eigen::Index>(indices.size())};
+        Eigen::MatrixXd products(y.size(), count);
+        Eigen::VectorXd direction(x.size());
+        for (Eigen::Index k = 0; k < count; ++k) {
+            const auto index{indices[static_cast<std::size_t>(k)]};
+            for (Eigen::Index i = 0; i < x.size(); ++i) {
+                direction[i] = x[i].tangent().coeff(index);
+            }
+            const Eigen::VectorXd dy{m_jvp(values, direction)};
+            if (dy.size() != y.size()) {
+                throw std::runtime_error("jvp does not match the output size");
+            }
+            products.col(k) = dy;
+        }
+
+        // Every tangent is built once from its row of products
+        Eigen::VectorX<SparseDualNumber> result(y.size());
+        std::vector<SparseTangent::Entry> entries(indices.size());
+        for (Eigen::Index i = 0; i < y.size(); ++i) {
+            for (Eigen::Index k = 0; k < count; ++k) {
+                entries[static_cast<std::size_t>(k)] = SparseTangent::Entry{
+                    indices[static_cast<std::size_t>(k)], products(i, k)};
+            }
+            result[i] = SparseDualNumber{
+                y[i], SparseTangent{entries.data(),
+                                    entries.data() + entries.size()}};
+        }
+        return result;
+    }
+
+    /**
+     * \brief Evaluates the function on Variables, recording it as one
+     * external call
+     *
+     * \throws std::invalid_argument if the inputs are on different tapes
+     *
+     * \param x The input
+     * \return The function evaluated at x; reverse sweeps use the vjp, or the
+     * jacobian built from the jvp
+     */
+    auto operator()(const Eigen::VectorX<reverse::Variable> &x) const
+        -> Eigen::VectorX<reverse::Variable>
+    {
+        return reverse::call(m_external, x);
+    }
+
+    /**
+     * \brief Returns the external function used with reverse::Variable inputs
+     *
+     * \return The external function
+     */
+    auto external() const
+        -> const std::shared_ptr<const reverse::ExternalFunction> &
+    {
+        return m_external;
+    }
+
+private:
+    static auto make_external(const Primal &primal, const Jvp &jvp, Vjp vjp)
+        -> std::shared_ptr<const reverse::ExternalFunction>
+    {
+        auto external{std::make_shared<reverse::ExternalFunction>()};
+        external->primal = primal;
+        if constexpr (std::is_same_v<Vjp, std::nullptr_t>) {
+            external->jacobian = [primal, jvp](const Eigen::VectorXd &x) {
+                if (x.size() == 0) {
+                    return Eigen::MatrixXd(primal(x).size(), 0);
+                }
+                Eigen::MatrixXd jac{};
+                for (Eigen::Index i = 0; i < x.size(); ++i) {
+                    const Eigen::VectorXd column{
+                        jvp(x, Eigen::VectorXd::Unit(x.size(), i))};
+                    if (i == 0) {
+                        jac.resize(column.size(), x.size());
+                    } else if (column.size() != jac.rows()) {
+                        throw std::runtime_error(
+                            "jvp does not match the output size");
+                    }
+                    jac.col(i) = column;
+                }
+                return jac;
+            };
+        } else {
+            external->vjp = [vjp = std::move(vjp)](const Eigen::VectorXd &x,
+                                                   const Eigen::VectorXd &,
+                                                   const Eigen::VectorXd &w) {
+                return Eigen::VectorXd{vjp(x, w)};
+            };
+        }
+        return external;
+    }
+
+    Primal m_primal;
+    Jvp m_jvp;
+    std::shared_ptr<const reverse::ExternalFunction> m_external;
+};
+
+/**
+ * \brief Creates a vector function with a user supplied jacobian-vector
+ * product
+ *
+ * \tparam Primal Callable Eigen::VectorXd -> Eigen::VectorXd
+ * \tparam Jvp Callable (const Eigen::VectorXd &x, const Eigen::VectorXd &v)
+ * -> Eigen::VectorXd
+ * \param primal The function
+ * \param jvp The jacobian-vector product of the function
+ * \return The CustomVectorFunction
+ */
+template <class Primal, class Jvp>
+auto make_custom_vector_function(Primal &&primal, Jvp &&jvp)
+{
+    return CustomVectorFunction<std::decay_t<Primal>, std::decay_t<Jvp>>{
+        std::forward<Primal>(primal), std::forward<Jvp>(jvp)};
+}
+
+/**
+ * \brief Creates a vector function with user supplied jacobian-vector and
+ * vector-jacobian products
+ *
+ * \tparam Primal Callable Eigen::VectorXd -> Eigen::VectorXd
+ * \tparam Jvp Callable (const Eigen::VectorXd &x, const Eigen::VectorXd &v)
+ * -> Eigen::VectorXd
+ * \tparam Vjp Callable (const Eigen::VectorXd &x, const Eigen::VectorXd &w)
+ * -> Eigen::VectorXd
+ * \param primal The function
+ * \param jvp The jacobian-vector product of the function
+ * \param vjp The vector-jacobian product of the function
+ * \return The CustomVectorFunction
+ */
+template <class Primal, class Jvp, class Vjp>
+auto make_custom_vector_function(Primal &&primal, Jvp &&jvp, Vjp &&vjp)
+{
+    return CustomVectorFunction<std::decay_t<Primal>, std::decay_t<Jvp>,
+                                std::decay_t<Vjp>>{
+        std::forward<Primal>(primal), std::forward<Jvp>(jvp),
+        std::forward<Vjp>(vjp)};
+}
+
+} // namespace algodiff::forward
@@ -0,0 +1,523 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+/// \file dual_array.hpp
+/// \brief Implements batches of dual numbers stored as separate primal and
+/// dual arrays, with branch-free selection between lanes
+#pragma once
+
+#include <Eigen/Core>
+
+#include "dual_number.hpp"
+#include "dual_number_eigen.hpp"
+
+namespace algodiff::forward
+{
+/// One flag per lane of a DualArray, as returned by its comparisons
+using DualMask = Eigen::Array<bool, Eigen::Dynamic, 1>;
+
+/**
+ * \brief A batch of DualNumbers, one per lane, stored as an array of primal
+ * components and an array of dual components
+ *
+ * Every operation runs on whole Eigen arrays, so it vectorizes across lanes.
+ * Piecewise functions are written with comparisons that return a DualMask
+ * and with select, where and clamp instead of if statements, so every lane
+ * takes its own branch without breaking the vectorization; each lane gets
+ * the derivative of the branch it selects.
+ */
+class DualArray
+{
+public:
+    /// Creates an empty batch
+    DualArray() = default;
+
+    /**
+     * \brief Creates a batch from its components
+     *
+     * \throws std::invalid_argument if the sizes differ
+     *
+     * \param primal The primal component of every lane
+     * \param dual The dual component of every lane
+     */
+    DualArray(Eigen::ArrayXd primal, Eigen::ArrayXd dual);
+
+    /**
+     * \brief Creates a batch with the same DualNumber in every lane
+     *
+     * \param size The number of lanes
+     * \param num The DualNumber
+     */
+    DualArray(Eigen::Index size, const DualNumber &num)
+        : m_primal{Eigen::ArrayXd::Constant(size, num.primal())},
+          m_dual{Eigen::ArrayXd::Constant(size, num.dual())}
+    {
+    }
+
+    /**
+     * \brief Creates a batch from a vector of DualNumbers
+     *
+     * \param x The DualNumber of every lane
+     */
+    explicit DualArray(const Eigen::VectorX<DualNumber> &x);
+
+    /**
+     * \brief Returns the number of lanes
+     *
+     * \return The number of lanes
+     */
+    auto size() const -> Eigen::Index
+    {
+        return m_primal.size();
+    }
+
+    /**
+     * \brief Returns the primal components
+     *
+     * \return The primal component of every lane
+     */
+    auto primal() const -> const Eigen::ArrayXd &
+    {
+        return m_primal;
+    }
+
+    /**
+     * \brief Returns the dual components
+     *
+     * \return The dual component of every lane
+     */
+    auto dual() const -> const Eigen::ArrayXd &
+    {
+        return m_dual;
+    }
+
+    /**
+     * \brief Returns the dual components, e.g. to seed a direction
+     *
+     * \return The dual component of every lane
+     */
+    auto dual() -> Eigen::ArrayXd &
+    {
+        return m_dual;
+    }
+
+    /**
+     * \brief Returns one lane
+     *
+     * \param lane The lane
+     * \return The DualNumber in the lane
+     */
+    auto operator[](Eigen::Index lane) const -> DualNumber
+    {
+        return DualNumber{m_primal[lane], m_dual[lane]};
+    }
+
+    /**
+     * \brief Returns the lanes as a vector of DualNumbers
+     *
+     * \return The DualNumber of every lane
+     */
+    auto to_vector() const -> Eigen::VectorX<DualNumber>;
+
+private:
+    Eigen::ArrayXd m_primal;
+    Eigen::ArrayXd m_dual;
+};
+
+// Arithmetic operators, applied lane by lane
+/**
+ * \brief Negates every lane
+ *
+ * \param x The batch
+ * \return The negated batch
+ */
+auto operator-(const DualArray &x) -> DualArray;
+
+/**
+ * \brief Adds two batches
+ *
+ * \throws std::invalid_argument if the sizes differ
+ *
+ * \param left A batch
+ * \param right The other batch
+ * \return The sum
+ */
+auto operator+(const DualArray &left, const DualArray &right) -> DualArray;
+
+/**
+ * \brief Adds a scalar to every lane
+ *
+ * \param x The batch
+ * \param n The scalar
+ * \return The sum
+ */
+auto operator+(const DualArray &x, double n) -> DualArray;
+
+/**
+ * \brief Adds a scalar to every lane
+ *
+ * \param n The scalar
+ * \param x The batch
+ * \return The sum
+ */
+auto operator+(double n, const DualArray &x) -> DualArray;
+
+/**
+ * \brief Subtracts right from left
+ *
+ * \throws std::invalid_argument if the sizes differ
+ *
+ * \param left The minuend batch
+ * \param right The subtrahend batch
+ * \return The difference
+ */
+auto operator-(const DualArray &left, const DualArray &right) -> DualArray;
+
+/**
+ * \brief Subtracts a scalar from every lane
+ *
+ * \param x The batch
+ * \param n The scalar
+ * \return The difference
+ */
+auto operator-(const DualArray &x, double n) -> DualArray;
+
+/**
+ * \brief Subtracts every lane from a scalar
+ *
+ * \param n The scalar
+ * \param x The batch
+ * \return The difference
+ */
+auto operator-(double n, const DualArray &x) -> DualArray;
+
+/**
+ * \brief Multiplies two batches
+ *
+ * \throws std::invalid_argument if the sizes differ
+ *
+ * \param left A batch
+ * \param right The other batch
+ * \return The product
+ */
+auto operator*(const DualArray &left, const DualArray &right) -> DualArray;
+
+/**
+ * \brief Multiplies every lane by a scalar
+ *
+ * \param x The batch
+ * \param scalar The scalar
+ * \return The product
+ */
+auto operator*(const DualArray &x, double scalar) -> DualArray;
+
+/**
+ * \brief Multiplies every lane by a scalar
+ *
+ * \param scalar The scalar
+ * \param x The batch
+ * \return The product
+ */
+auto operator*(double scalar, const DualArray &x) -> DualArray;
+
+/**
+ * \brief Divides left by right
+ *
+ * \throws std::invalid_argument if the sizes differ
+ *
+ * \param left The dividend batch
+ * \param right The divisor batch
+ * \return The quotient
+ */
+auto operator/(const DualArray &left, const DualArray &right) -> DualArray;
+
+/**
+ * \brief Divides every lane by a scalar
+ *
+ * \param x The dividend batch
+ * \param scalar The divisor
+ * \return The quotient
+ */
+auto operator/(const DualArray &x, double scalar) -> DualArray;
+
+/**
+ * \brief Divides a scalar by every lane
+ *
+ * \param scalar The dividend
+ * \param x The divisor batch
+ * \return The quotient
+ */
+auto operator/(double scalar, const DualArray &x) -> DualArray;
+
+// Comparisons of the primal components, applied lane by lane
+/**
+ * \brief Compares the primal components of two batches
+ *
+ * \throws std::invalid_argument if the sizes differ
+ *
+ * \param left A batch
+ * \param right The other batch
+ * \return The lanes where left is less than right
+ */
+auto operator<(const DualArray &left, const DualArray &right) -> DualMask;
+
+/**
+ * \brief Compares the primal components of a batch with a scalar
+ *
+ * \param x The batch
+ * \param n The scalar
+ * \return The lanes where x is less than n
+ */
+auto operator<(const DualArray &x, double n) -> DualMask;
+
+/**
+ * \brief Compares a scalar with the primal components of a batch
+ *
+ * \param n The scalar
+ * \param x The batch
+ * \return The lanes where n is less than x
+ */
+auto operator<(double n, const DualArray &x) -> DualMask;
+
+/**
+ * \brief Compares the primal components of two batches
+ *
+ * \throws std::invalid_argument if the sizes differ
+ *
+ * \param left A batch
+ * \param right The other batch
+ * \return The lanes where left is less than or equal to right
+ */
+auto operator<=(const DualArray &left, const DualArray &right) -> DualMask;
+
+/**
+ * \brief Compares the primal components of a batch with a scalar
+ *
+ * \param x The batch
+ * \param n The scalar
+ * \return The lanes where x is less than or equal to n
+ */
+auto operator<=(const DualArray &x, double n) -> DualMask;
+
+/**
+ * \brief Compares a scalar with the primal components of a batch
+ *
+ * \param n The scalar
+ * \param x The batch
+ * \return The lanes where n is less than or equal to x
+ */
+auto operator<=(double n, const DualArray &x) -> DualMask;
+
+/**
+ * \brief Compares the primal components of two batches
+ *
+ * \throws std::invalid_argument if the sizes differ
+ *
+ * \param left A batch
+ * \param right The other batch
+ * \return The lanes where left is greater than right
+ */
+auto operator>(const DualArray &left, const DualArray &right) -> DualMask;
+
+/**
+ * \brief Compares the primal components of a batch with a scalar
+ *
+ * \param x The batch
+ * \param n The scalar
+ * \return The lanes where x is greater than n
+ */
+auto operator>(const DualArray &x, double n) -> DualMask;
+
+/**
+ * \brief Compares a scalar with the primal components of a batch
+ *
+ * \param n The scalar
+ * \param x The batch
+ * \return The lanes where n is greater than x
+ */
+auto operator>(double n, const DualArray &x) -> DualMask;
+
+/**
+ * \brief Compares the primal components of two batches
+ *
+ * \throws std::invalid_argument if the sizes differ
+ *
+ * \param left A batch
+ * \param right The other batch
+ * \return The lanes where left is greater than or equal to right
+ */
+auto operator>=(const DualArray &left, const DualArray &right) -> DualMask;
+
+/**
+ * \brief Compares the primal components of a batch with a scalar
+ *
+ * \param x The batch
+ * \param n The scalar
+ * \return The lanes where x is greater than or equal to n
+ */
+auto operator>=(const DualArray &x, double n) -> DualMask;
+
+/**
+ * \brief Compares a scalar with the primal components of a batch
+ *
+ * \param n The scalar
+ * \param x The batch
+ * \return The lanes where n is greater than or equal to x
+ */
+auto operator>=(double n, const DualArray &x) -> DualMask;
+
+// Elementary functions, applied lane by lane
+/**
+ * \brief Computes the square root of every lane
+ *
+ * \param x The batch
+ * \return The square roots
+ */
+auto sqrt(const DualArray &x) -> DualArray;
+
+/**
+ * \brief Computes e raised to the power of every lane
+ *
+ * \param x The batch
+ * \return The exponentials
+ */
+auto exp(const DualArray &x) -> DualArray;
+
+/**
+ * \brief Computes the natural logarithm of every lane
+ *
+ * \param x The batch
+ * \return The logarithms
+ */
+auto log(const DualArray &x) -> DualArray;
+
+/**
+ * \brief Computes the sine of every lane
+ *
+ * \param x The batch
+ * \return The sines
+ */
+auto sin(const DualArray &x) -> DualArray;
+
+/**
+ * \brief Computes the cosine of every lane
+ *
+ * \param x The batch
+ * \return The cosines
+ */
+auto cos(const DualArray &x) -> DualArray;
+
+/**
+ * \brief Computes the hyperbolic tangent of every lane
+ *
+ * \param x The batch
+ * \return The hyperbolic tangents
+ */
+auto tanh(const DualArray &x) -> DualArray;
+
+/**
+ * \brief Raises every lane to a scalar power
+ *
+ * \param x The batch
+ * \param exponent The exponent
+ * \return The powers
+ */
+auto pow(const DualArray &x, double exponent) -> DualArray;
+
+/**
+ * \brief Computes the absolute value of every lane
+ *
+ * \note The derivative at zero is taken to be zero
+ *
+ * \param x The batch
+ * \return The absolute values
+ */
+auto abs(const DualArray &x) -> DualArray;
+
+// Branch-free selection
+/**
+ * \brief Takes every lane from a where mask holds and from b elsewhere
+ *
+ * \throws std::invalid_argument if the sizes differ
+ *
+ * \param mask The lanes to take from a
+ * \param a The batch selected where mask holds
+ * \param b The batch selected elsewhere
+ * \return The selected lanes, with the derivatives of the selected batch
+ */
+auto select(const DualMask &mask, const DualArray &a, const DualArray &b)
+    -> DualArray;
+
+/**
+ * \brief Takes every lane from a where mask holds and is the constant b
+ * elsewhere
+ *
+ * \throws std::invalid_argument if the sizes differ
+ *
+ * \param mask The lanes to take from a
+ * \param a The batch selected where mask holds
+ * \param b The constant selected elsewhere
+ * \return The selected lanes
+ */
+auto select(const DualMask &mask, const DualArray &a, double b) -> DualArray;
+
+/**
+ * \brief Is the constant a where mask holds and takes every other lane from b
+ *
+ * \throws std::invalid_argument if the sizes differ
+ *
+ * \param mask The lanes set to a
+ * \param a The constant selected where mask holds
+ * \param b The batch selected elsewhere
+ * \return The selected lanes
+ */
+auto select(const DualMask &mask, double a, const DualArray &b) -> DualArray;
+
+/**
+ * \brief Keeps the lanes where mask holds and zeroes the others
+ *
+ * Summing where() terms with disjoint masks builds a piecewise function.
+ *
+ * \throws std::invalid_argument if the sizes differ
+ *
+ * \param mask The lanes to keep
+ * \param x The batch
+ * \return The masked batch
+ */
+auto where(const DualMask &mask, const DualArray &x) -> DualArray;
+
+/**
+ * \brief Clamps every lane to an interval
+ *
+ * \param x The batch
+ * \param low The lower bound
+ * \param high The upper bound, not less than low
+ * \return The clamped lanes; clamped lanes have a zero derivative
+ */
+auto clamp(const DualArray &x, double low, double high) -> DualArray;
+
+/**
+ * \brief Clamps every lane to an interval that varies between lanes
+ *
+ * \throws std::invalid_argument if the sizes differ
+ *
+ * \param x The batch
+ * \param low The lower bounds
+ * \param high The upper bounds, not less than low
+ * \return The clamped lanes; clamped lanes take the derivative of their bound
+ */
+auto clamp(const DualArray &x, const DualArray &low, const DualArray &high)
+    -> DualArray;
+
+/**
+ * \brief Computes sqrt(x * x + epsilon * epsilon) - epsilon for every lane,
+ * a smooth approximation of the absolute value
+ *
+ * \param x The batch
+ * \param epsilon The positive width of the smoothed region around zero
+ * \return The smoothed absolute values
+ */
+auto smooth_abs(const DualArray &x, double epsilon) -> DualArray;
+
+} // namespace algodiff::forward
@@ -428,4 +428,171 @@ constexpr inline auto operator/(DualNumber num, const double scalar)
     return num;
 }
 
+/**
+ * \brief Returns whether the primal component of left is less than that of
+ * right
+ *
+ * \note Only the primal components are compared, so a branch on the result
+ * follows the point of evaluation
+ *
+ * \param left A DualNumber
+ * \param right The other DualNumber
+ * \return The result of the comparison
+ */
+constexpr inline auto operator<(const DualNumber &left, const DualNumber &right)
+    -> bool
+{
+    return left.primal() < right.primal();
+}
+
+/**
+ * \brief Returns whether the primal component of num is less than n
+ *
+ * \param num The DualNumber
+ * \param n The scalar
+ * \return The result of the comparison
+ */
+constexpr inline auto operator<(const DualNumber &num, const double n) -> bool
+{
+    return num.primal() < n;
+}
+
+/**
+ * \brief Returns whether n is less than the primal component of num
+ *
+ * \param n The scalar
+ * \param num The DualNumber
+ * \return The result of the comparison
+ */
+constexpr inline auto operator<(const double n, const DualNumber &num) -> bool
+{
+    return n < num.primal();
+}
+
+/**
+ * \brief Returns whether the primal component of left is less than or equal
+ * to that of right
+ *
+ * \note Only the primal components are compared, so a branch on the result
+ * follows the point of evaluation
+ *
+ * \param left A DualNumber
+ * \param right The other DualNumber
+ * \return The result of the comparison
+ */
+constexpr inline auto operator<=(const DualNumber &left,
+                                 const DualNumber &right) -> bool
+{
+    return left.primal() <= right.primal();
+}
+
+/**
+ * \brief Returns whether the primal component of num is less than or equal
+ * to n
+ *
+ * \param num The DualNumber
+ * \param n The scalar
+ * \return The result of the comparison
+ */
+constexpr inline auto operator<=(const DualNumber &num, const double n) -> bool
+{
+    return num.primal() <= n;
+}
+
+/**
+ * \brief Returns whether n is less than or equal to the primal component of num
+ *
+ * \param n The scalar
+ * \param num The DualNumber
+ * \return The result of the comparison
+ */
+constexpr inline auto operator<=(const double n, const DualNumber &num) -> bool
+{
+    return n <= num.primal();
+}
+
+/**
+ * \brief Returns whether the primal component of left is greater than that
+ * of right
+ *
+ * \note Only the primal components are compared, so a branch on the result
+ * follows the point of evaluation
+ *
+ * \param left A DualNumber
+ * \param right The other DualNumber
+ * \return The result of the comparison
+ */
+constexpr inline auto operator>(const DualNumber &left, const DualNumber &right)
+    -> bool
+{
+    return left.primal() > right.primal();
+}
+
+/**
+ * \brief Returns whether the primal component of num is greater than n
+ *
+ * \param num The DualNumber
+ * \param n The scalar
+ * \return The result of the comparison
+ */
+constexpr inline auto operator>(const DualNumber &num, const double n) -> bool
+{
+    return num.primal() > n;
+}
+
+/**
+ * \brief Returns whether n is greater than the primal component of num
+ *
+ * \param n The scalar
+ * \param num The DualNumber
+ * \return The result of the comparison
+ */
+constexpr inline auto operator>(const double n, const DualNumber &num) -> bool
+{
+    return n > num.primal();
+}
+
+/**
+ * \brief Returns whether the primal component of left is greater than or
+ * equal to that of right
+ *
+ * \note Only the primal components are compared, so a branch on the result
+ * follows the point of evaluation
+ *
+ * \param left A DualNumber
+ * \param right The other DualNumber
+ * \return The result of the comparison
+ */
+constexpr inline auto operator>=(const DualNumber &left,
+                                 const DualNumber &right) -> bool
+{
+    return left.primal() >= right.primal();
+}
+
+/**
+ * \brief Returns whether the primal component of num is greater than or
+ * equal to n
+ *
+ * \param num The DualNumber
+ * \param n The scalar
+ * \return The result of the comparison
+ */
+constexpr inline auto operator>=(const DualNumber &num, const double n) -> bool
+{
+    return num.primal() >= n;
+}
+
+/**
+ * \brief Returns whether n is greater than or equal to the primal component of
+ * num
+ *
+ * \param n The scalar
+ * \param num The DualNumber
+ * \return The result of the comparison
+ */
+constexpr inline auto operator>=(const double n, const DualNumber &num) -> bool
+{
+    return n >= num.primal();
+}
+
 } // namespace algodiff::forward
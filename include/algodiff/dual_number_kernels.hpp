@@ -0,0 +1,117 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+/// \file dual_number_kernels.hpp
+/// \brief Implements reductions and activations of vectors of dual numbers
+/// with closed-form derivatives
+#pragma once
+
+#include <Eigen/Core>
+
+#include "dual_number.hpp"
+#include "dual_number_eigen.hpp"
+
+namespace algodiff::forward
+{
+/// A read-only view of a vector of DualNumbers
+using DualVectorRef = Eigen::Ref<const Eigen::VectorX<DualNumber>>;
+
+/**
+ * \brief Returns the sum of the entries of a vector
+ *
+ * \param x The vector
+ * \return The sum, zero for an empty vector
+ */
+auto sum(const DualVectorRef &x) -> DualNumber;
+
+/**
+ * \brief Returns the product of the entries of a vector
+ *
+ * The derivative is accumulated alongside the running product, so it stays
+ * exact when entries are zero.
+ *
+ * \param x The vector
+ * \return The product, one for an empty vector
+ */
+auto prod(const DualVectorRef &x) -> DualNumber;
+
+/**
+ * \brief Returns the dot product of two vectors
+ *
+ * \throws std::invalid_argument if the sizes differ
+ *
+ * \param x The first vector
+ * \param y The second vector
+ * \return The dot product
+ */
+auto dot(const DualVectorRef &x, const DualVectorRef &y) -> DualNumber;
+
+/**
+ * \brief Returns the squared euclidean norm of a vector
+ *
+ * \param x The vector
+ * \return The sum of the squares of the entries
+ */
+auto squared_norm(const DualVectorRef &x) -> DualNumber;
+
+/**
+ * \brief Returns the euclidean norm of a vector
+ *
+ * The entries are scaled by the largest magnitude before squaring, so large
+ * or small entries neither overflow nor underflow. The derivative at the zero
+ * vector is taken to be zero.
+ *
+ * \param x The vector
+ * \return The norm
+ */
+auto norm(const DualVectorRef &x) -> DualNumber;
+
+/**
+ * \brief Returns log(sum(exp(x))) without overflowing
+ *
+ * The largest entry is subtracted before exponentiating. The derivative is
+ * the softmax-weighted sum of the derivatives of the entries, so exp is
+ * evaluated once per entry.
+ *
+ * \param x The vector
+ * \return The log of the sum of exponentials, -inf for an empty vector
+ */
+auto logsumexp(const DualVectorRef &x) -> DualNumber;
+
+/**
+ * \brief Returns exp(x) / sum(exp(x)) without overflowing
+ *
+ * \param x The vector
+ * \return The softmax, with entries that sum to one
+ */
+auto softmax(const DualVectorRef &x) -> Eigen::VectorX<DualNumber>;
+
+/**
+ * \brief Returns x - logsumexp(x), the log of the softmax
+ *
+ * \param x The vector
+ * \return The log-softmax
+ */
+auto log_softmax(const DualVectorRef &x) -> Eigen::VectorX<DualNumber>;
+
+/**
+ * \brief Returns the logistic function 1 / (1 + exp(-num))
+ *
+ * Only exponentials of non-positive numbers are taken, so the result neither
+ * overflows nor loses precision for inputs of large magnitude.
+ *
+ * \param num The DualNumber
+ * \return The logistic function of num
+ */
+auto sigmoid(const DualNumber &num) -> DualNumber;
+
+/**
+ * \brief Applies the logistic function to every entry of a vector
+ *
+ * \param x The vector
+ * \return The logistic function of every entry
+ */
+auto sigmoid(const DualVectorRef &x) -> Eigen::VectorX<DualNumber>;
+
+} // namespace algodiff::forward
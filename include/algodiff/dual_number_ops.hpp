@@ -6,6 +6,8 @@
 /// \brief Implements operations that can be performed on dual numbers
 #pragma once
 
+#include <type_traits>
+
 #include "dual_number.hpp"
 
 namespace algodiff::forward
@@ -132,6 +134,53 @@ auto pow(const DualNumber &num, double exponent) -> DualNumber;
  */
 auto pow(const DualNumber &num, const DualNumber &exponent) -> DualNumber;
 
+namespace internal
+{
+/**
+ * \brief Computes a DualNumber raised to an integer power by repeated
+ * squaring
+ *
+ * \param num The DualNumber
+ * \param exponent The integer exponent
+ * \return The DualNumber raised to the exponent
+ */
+auto integer_pow(const DualNumber &num, long long exponent) -> DualNumber;
+
+} // namespace internal
+
+/**
+ * \brief Computes a DualNumber raised to an integer power by repeated
+ * squaring, without calling std::pow
+ *
+ * \tparam Integer An integral type whose values fit in a long long
+ * \param num The DualNumber
+ * \param exponent The integer exponent
+ * \return The DualNumber raised to the exponent
+ */
+template <class Integer,
+          std::enable_if_t<std::is_integral_v<Integer>, int> = 0>
+auto pow(const DualNumber &num, Integer exponent) -> DualNumber
+{
+    return internal::integer_pow(num, static_cast<long long>(exponent));
+}
+
+/**
+ * \brief Computes the cube root of a DualNumber
+ *
+ * \param num The DualNumber
+ * \return The cube root of the DualNumber, also for negative numbers
+ */
+auto cbrt(const DualNumber &num) -> DualNumber;
+
+/**
+ * \brief Computes sqrt(x^2 + y^2) without overflow or underflow
+ *
+ * \param x The first DualNumber
+ * \param y The second DualNumber
+ * \return The hypotenuse
+ */
+auto hypot(const DualNumber &x, const DualNumber &y) -> DualNumber;
+
 /**
  * \brief Computes the square root of a DualNumber
  *
@@ -158,6 +207,15 @@ auto exp(const DualNumber &num) -> DualNumber;
  */
 auto exp2(const DualNumber &num) -> DualNumber;
 
+/**
+ * \brief Computes e raised to the power of a DualNumber, minus one, without
+ * losing precision for small numbers
+ *
+ * \param num The DualNumber
+ * \return e^num - 1
+ */
+auto expm1(const DualNumber &num) -> DualNumber;
+
 // Logarithms
 /**
  * \brief Computes the natural (base e) logarithm of a DualNumber
@@ -183,6 +241,15 @@ auto log2(const DualNumber &num) -> DualNumber;
  */
 auto log10(const DualNumber &num) -> DualNumber;
 
+/**
+ * \brief Computes the natural logarithm of one plus a DualNumber, without
+ * losing precision for small numbers
+ *
+ * \param num The DualNumber
+ * \return log(1 + num)
+ */
+auto log1p(const DualNumber &num) -> DualNumber;
+
 /**
  * \brief Computes the input base logarithm of a DualNumber
  *
@@ -242,6 +309,15 @@ auto asin(const DualNumber &num) -> DualNumber;
  */
 auto atan(const DualNumber &num) -> DualNumber;
 
+/**
+ * \brief Computes the angle of the point (x, y), in the correct quadrant
+ *
+ * \param y The second coordinate
+ * \param x The first coordinate
+ * \return The angle in [-pi, pi]
+ */
+auto atan2(const DualNumber &y, const DualNumber &x) -> DualNumber;
+
 // Hyperbolic functions
 /**
  * \brief Computes hyperbolic cosine of a DualNumber
@@ -292,6 +368,132 @@ auto asinh(const DualNumber &num) -> DualNumber;
  */
 auto atanh(const DualNumber &num) -> DualNumber;
 
+// Special functions
+/**
+ * \brief Computes the error function of a DualNumber
+ *
+ * \param num The DualNumber
+ * \return The error function of the DualNumber
+ */
+auto erf(const DualNumber &num) -> DualNumber;
+
+/**
+ * \brief Computes the complementary error function of a DualNumber, without
+ * losing precision for large numbers
+ *
+ * \param num The DualNumber
+ * \return 1 - erf(num)
+ */
+auto erfc(const DualNumber &num) -> DualNumber;
+
+/**
+ * \brief Computes the natural logarithm of the absolute value of the gamma
+ * function of a DualNumber
+ *
+ * \param num The DualNumber
+ * \return log|gamma(num)|, whose derivative is the digamma function
+ */
+auto lgamma(const DualNumber &num) -> DualNumber;
+
+/**
+ * \brief Computes the gamma function of a DualNumber
+ *
+ * \param num The DualNumber
+ * \return The gamma function of the DualNumber
+ */
+auto tgamma(const DualNumber &num) -> DualNumber;
+
+// Other functions
+/**
+ * \brief Computes x * y + z with a single rounding of the primal component
+ *
+ * \param x The first factor
+ * \param y The second factor
+ * \param z The addend
+ * \return x * y + z
+ */
+auto fma(const DualNumber &x, const DualNumber &y, const DualNumber &z)
+    -> DualNumber;
+
+/**
+ * \brief Returns the DualNumber with the smaller primal component; a NaN
+ * primal component is treated as missing data
+ *
+ * \param x The first DualNumber
+ * \param y The second DualNumber
+ * \return The smaller DualNumber, x on ties
+ */
+auto fmin(const DualNumber &x, const DualNumber &y) -> DualNumber;
+
+/**
+ * \brief Returns the DualNumber with the larger primal component; a NaN
+ * primal component is treated as missing data
+ *
+ * \param x The first DualNumber
+ * \param y The second DualNumber
+ * \return The larger DualNumber, x on ties
+ */
+auto fmax(const DualNumber &x, const DualNumber &y) -> DualNumber;
+
+// Branch-free selection
+/**
+ * \brief Returns a if cond holds and b otherwise, with the derivative of the
+ * DualNumber returned
+ *
+ * \param cond The condition
+ * \param a The DualNumber returned if cond holds
+ * \param b The DualNumber returned otherwise
+ * \return a or b
+ */
+auto select(bool cond, const DualNumber &a, const DualNumber &b)
+    -> DualNumber;
+
+/**
+ * \brief Returns num if cond holds and zero otherwise
+ *
+ * \param cond The condition
+ * \param num The DualNumber
+ * \return num or zero
+ */
+auto where(bool cond, const DualNumber &num) -> DualNumber;
+
+/**
+ * \brief Clamps a DualNumber to an interval
+ *
+ * \note A bound that is returned carries its own derivative
+ *
+ * \param num The DualNumber
+ * \param low The lower bound
+ * \param high The upper bound, not less than low
+ * \return low if num < low, high if high < num and num otherwise
+ */
+auto clamp(const DualNumber &num, const DualNumber &low,
+           const DualNumber &high) -> DualNumber;
+
+/**
+ * \brief Clamps a DualNumber to an interval with constant bounds
+ *
+ * \param num The DualNumber
+ * \param low The lower bound
+ * \param high The upper bound, not less than low
+ * \return num clamped to the interval; a clamped result has a zero
+ * derivative
+ */
+auto clamp(const DualNumber &num, double low, double high) -> DualNumber;
+
+/**
+ * \brief Computes sqrt(num * num + epsilon * epsilon) - epsilon, a smooth
+ * approximation of the absolute value
+ *
+ * Unlike abs, the derivative is defined and continuous at zero. The result is
+ * within epsilon of the absolute value.
+ *
+ * \param num The DualNumber
+ * \param epsilon The positive width of the smoothed region around zero
+ * \return The smoothed absolute value of num
+ */
+auto smooth_abs(const DualNumber &num, double epsilon) -> DualNumber;
+
 // Special case: this is just inverse; hence implemented here
 /**
  * \brief Computes the inverse of a DualNumber multiplied by a scalar
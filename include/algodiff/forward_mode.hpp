@@ -31,6 +31,42 @@ auto createVector(const Eigen::Matrix<U, Size, 1> &input)
 
 } // namespace internal
 
+/// The value of a function of one variable and its derivative
+struct ValueAndDerivative {
+    /// The function evaluated at the point
+    double value;
+
+    /// The derivative evaluated at the point
+    double derivative;
+};
+
+/**
+ * \brief The value of a scalar function and its gradient
+ *
+ * \tparam Gradient The vector type of the gradient
+ */
+template <class Gradient> struct ValueAndGradient {
+    /// The function evaluated at the point
+    double value;
+
+    /// The gradient evaluated at the point
+    Gradient gradient;
+};
+
+/**
+ * \brief The value of a vector function and its jacobian
+ *
+ * \tparam Value The vector type of the value
+ * \tparam Jacobian The matrix type of the jacobian
+ */
+template <class Value, class Jacobian> struct ValueAndJacobian {
+    /// The function evaluated at the point
+    Value value;
+
+    /// The jacobian evaluated at the point
+    Jacobian jacobian;
+};
+
 /**
  * \brief Returns the resultant DualNumber when a function f is evaluated at u.
  * The primal component is the function evaluated at u and the dual component is
@@ -61,6 +97,22 @@ template <class F> auto derivative(F &&f, double u) -> double
     return evaluate(std::forward<F>(f), u).dual();
 }
 
+/**
+ * \brief Returns f and its derivative evaluated at u from a single evaluation
+ *
+ * \tparam F Function Type that takes as input a single DualNumber and outputs
+ * a DualNumber
+ * \param f A single dimension function
+ * \param u The point to evaluate f at
+ * \return The value and the derivative of f at u
+ */
+template <class F>
+auto value_and_derivative(F &&f, double u) -> ValueAndDerivative
+{
+    const DualNumber result{evaluate(std::forward<F>(f), u)};
+    return ValueAndDerivative{result.primal(), result.dual()};
+}
+
 /**
  * \brief Returns a vector of DualNumbers representing the function f evaluated
  * at u. The primal component is the function evaluated at u and the dual
@@ -113,6 +165,46 @@ auto gradient(F &&f, const std::vector<double> &u) -> std::vector<double>
     return grad;
 }
 
+/**
+ * \brief Returns f and its gradient evaluated at u
+ *
+ * Every forward pass computes the same primal, so the value is read from the
+ * first pass; f is only evaluated an extra time when u is empty.
+ *
+ * \tparam F Function Type that takes as input a std::vector of DualNumber and
+ * outputs a DualNumber
+ * \param f A function that maps u (in DualNumber representation) to the output
+ * space
+ * \param u A vector of inputs that f will be evaluated at
+ * \return The value and the gradient of f at u
+ */
+template <class F>
+auto value_and_gradient(F &&f, const std::vector<double> &u)
+    -> ValueAndGradient<std::vector<double>>
+{
+    std::vector<DualNumber> dual_numbers{};
+    std::transform(u.cbegin(), u.cend(), std::back_inserter(dual_numbers),
+                   [](double x) {
+                       return DualNumber{x, 0.0};
+                   });
+
+    ValueAndGradient<std::vector<double>> result{0.0, {}};
+    result.gradient.reserve(u.size());
+    if (u.empty()) {
+        result.value = f(dual_numbers).primal();
+    }
+    for (auto &num : dual_numbers) {
+        num.dual() = 1.0;
+        const DualNumber evaluation{f(dual_numbers)};
+        num.dual() = 0.0;
+        if (result.gradient.empty()) {
+            result.value = evaluation.primal();
+        }
+        result.gradient.push_back(evaluation.dual());
+    }
+    return result;
+}
+
 /**
  * \brief Returns a vector of DualNumbers representing the function f evaluated
  * at u. The primal component is the function evaluated at u and the dual
@@ -171,6 +263,45 @@ auto gradient(F &&f, const Eigen::Matrix<double, InputSize, 1> &u)
     return grad;
 }
 
+/**
+ * \brief Returns f and its gradient evaluated at u
+ *
+ * \tparam F Function Type that takes as input a Eigen::Matrix<DualNumber,
+ * InputSize, 1> and outputs a DualNumber
+ * \tparam InputSize The dimension of the input vector
+ * \param f A function that maps u (in dual number representation) to the output
+ * space
+ * \param u A vector of inputs that f will be evaluated at
+ * \return The value and the gradient of f at u
+ */
+template <class F, int InputSize>
+auto value_and_gradient(F &&f, const Eigen::Matrix<double, InputSize, 1> &u)
+    -> ValueAndGradient<Eigen::Matrix<double, InputSize, 1>>
+{
+    Eigen::Matrix<DualNumber, InputSize, 1> dual_numbers{
+        internal::createVector<DualNumber>(u)};
+    std::transform(u.data(), u.data() + u.size(), dual_numbers.data(),
+                   [&](double x) {
+                       return DualNumber{x, 0.0};
+                   });
+
+    ValueAndGradient<Eigen::Matrix<double, InputSize, 1>> result{
+        0.0, internal::createVector<double>(u)};
+    if (u.size() == 0) {
+        result.value = f(dual_numbers).primal();
+    }
+    for (int i = 0; i < dual_numbers.size(); ++i) {
+        dual_numbers[i].dual() = 1.0;
+        const DualNumber evaluation{f(dual_numbers)};
+        dual_numbers[i].dual() = 0.0;
+        if (i == 0) {
+            result.value = evaluation.primal();
+        }
+        result.gradient[i] = evaluation.dual();
+    }
+    return result;
+}
+
 /**
  * \brief Returns the jacobian of f evaluated at u
  *
@@ -190,6 +321,32 @@ auto jacobian(const std::vector<F> &f, const std::vector<double> &u)
     return jac;
 }
 
+/**
+ * \brief Returns the values and the jacobian of f evaluated at u
+ *
+ * \tparam F Function Type that takes as input a std::vector<DualNumber> and
+ * outputs a DualNumber
+ * \param f A set of functions that map u (in dual number representation) to the
+ * output space
+ * \param u A vector of inputs that each element of f will be evaluated at
+ * \return The value of every function and the jacobian, one row per function
+ */
+template <class F>
+auto value_and_jacobian(const std::vector<F> &f, const std::vector<double> &u)
+    -> ValueAndJacobian<std::vector<double>, std::vector<std::vector<double>>>
+{
+    ValueAndJacobian<std::vector<double>, std::vector<std::vector<double>>>
+        result{};
+    result.value.reserve(f.size());
+    result.jacobian.reserve(f.size());
+    for (const auto &func : f) {
+        auto row{value_and_gradient(func, u)};
+        result.value.push_back(row.value);
+        result.jacobian.push_back(std::move(row.gradient));
+    }
+    return result;
+}
+
 /**
  * \brief Returns the jacobian of f evaluated at u
  *
@@ -211,8 +368,96 @@ auto jacobian(const std::vector<F> &f, const Eigen::VectorXd &u)
     return jacobian;
 }
 
+/**
+ * \brief Returns the values and the jacobian of f evaluated at u
+ *
+ * \tparam F Function Type that takes as input a Eigen::VectorX<DualNumber> and
+ * outputs a DualNumber
+ * \param f A set of functions that map u (in dual number representation) to the
+ * output space
+ * \param u A vector of inputs that each element of f will be evaluated at
+ * \return The value of every function and the jacobian, one row per function
+ */
+template <class F>
+auto value_and_jacobian(const std::vector<F> &f, const Eigen::VectorXd &u)
+    -> ValueAndJacobian<Eigen::VectorXd, Eigen::MatrixXd>
+{
+    ValueAndJacobian<Eigen::VectorXd, Eigen::MatrixXd> result{
+        Eigen::VectorXd(f.size()), Eigen::MatrixXd(f.size(), u.size())};
+    for (int i = 0; i < result.jacobian.rows(); ++i) {
+        const auto row{value_and_gradient(f[static_cast<size_t>(i)], u)};
+        result.value[i] = row.value;
+        result.jacobian.row(i) = row.gradient;
+    }
+    return result;
+}
+
 // TODO(kajananchinniah): consolidate the functions into one
 
+/**
+ * \brief Computes the columns [begin, end) of the jacobian of f at u, handing
+ * each column to sink as soon as its forward pass completes
+ *
+ * \tparam FunctionSize The dimension of the output of f
+ * \tparam F Function Type that takes as input a Eigen::VectorX<DualNumber> and
+ * outputs a vector of DualNumbers of size FunctionSize
+ * \tparam Sink Callable invoked as sink(Eigen::Index column, const
+ * Eigen::VectorXd &values)
+ * \param f A multidimensional function that maps u (in dual number
+ * representation) to the output space
+ * \param u A vector of inputs that f will be evaluated at
+ * \param begin The first column to compute
+ * \param end One past the last column to compute
+ * \param sink The consumer of the jacobian columns
+ */
+template <int FunctionSize, class F, class Sink>
+auto for_each_jacobian_column(F &&f, const Eigen::VectorXd &u,
+                              Eigen::Index begin, Eigen::Index end,
+                              Sink &&sink) -> void
+{
+    Eigen::VectorX<DualNumber> dual_numbers(u.size());
+    for (int i = 0; i < u.size(); ++i) {
+        dual_numbers[i] = DualNumber{u[i], 0.0};
+    }
+
+    Eigen::VectorXd column(FunctionSize);
+    for (Eigen::Index i = begin; i < end; ++i) {
+        dual_numbers[i].dual() = 1.0;
+        Eigen::VectorX<DualNumber> result{f(dual_numbers)};
+        for (int j = 0; j < FunctionSize; ++j) {
+            column[j] = result[j].dual();
+        }
+        dual_numbers[i].dual() = 0.0;
+        sink(i, column);
+    }
+}
+
+/**
+ * \brief Computes the jacobian of f at u one column at a time, handing each
+ * column to sink as soon as its forward pass completes
+ *
+ * The full jacobian is never stored, so this is the building block for
+ * consumers that write columns elsewhere (sparse storage, files, queues).
+ * Columns are produced in increasing order.
+ *
+ * \tparam FunctionSize The dimension of the output of f
+ * \tparam F Function Type that takes as input a Eigen::VectorX<DualNumber> and
+ * outputs a vector of DualNumbers of size FunctionSize
+ * \tparam Sink Callable invoked as sink(Eigen::Index column, const
+ * Eigen::VectorXd &values)
+ * \param f A multidimensional function that maps u (in dual number
+ * representation) to the output space
+ * \param u A vector of inputs that f will be evaluated at
+ * \param sink The consumer of the jacobian columns
+ */
+template <int FunctionSize, class F, class Sink>
+auto for_each_jacobian_column(F &&f, const Eigen::VectorXd &u, Sink &&sink)
+    -> void
+{
+    for_each_jacobian_column<FunctionSize>(std::forward<F>(f), u, 0, u.size(),
+                                           std::forward<Sink>(sink));
+}
+
 /**
  * \brief Returns the jacobian of f evaluated at u
  *
@@ -225,22 +470,60 @@ auto jacobian(const std::vector<F> &f, const Eigen::VectorXd &u)
  */
 template <int FunctionSize, class F>
 auto jacobian(F &&f, const Eigen::VectorXd &u) -> Eigen::MatrixXd
+{
+    Eigen::MatrixXd jac(FunctionSize, u.size());
+    for_each_jacobian_column<FunctionSize>(
+        std::forward<F>(f), u,
+        [&](Eigen::Index col, const Eigen::VectorXd &c) {
+            jac.col(col) = c;
+        });
+    return jac;
+}
+
+/**
+ * \brief Returns the value and the jacobian of f evaluated at u
+ *
+ * \tparam FunctionSize The dimension of the output of f
+ * \tparam F Function Type that takes as input a Eigen::VectorX<DualNumber> and
+ * outputs a vector of DualNumbers of size FunctionSize
+ * \param f A multidimensional function that maps u (in dual number
+ * representation) to the output space
+ * \param u A vector of inputs that f will be evaluated at
+ * \return The value and the jacobian of f at u
+ */
+template <int FunctionSize, class F>
+auto value_and_jacobian(F &&f, const Eigen::VectorXd &u)
+    -> ValueAndJacobian<Eigen::VectorXd, Eigen::MatrixXd>
 {
     Eigen::VectorX<DualNumber> dual_numbers(u.size());
     for (int i = 0; i < u.size(); ++i) {
         dual_numbers[i] = DualNumber{u[i], 0.0};
     }
 
-    Eigen::MatrixXd jac(FunctionSize, u.size());
-    for (int i = 0; i < jac.cols(); ++i) {
-        dual_numbers[i].dual() = 1.0;
-        Eigen::VectorX<DualNumber> result{f(dual_numbers)};
+    ValueAndJacobian<Eigen::VectorXd, Eigen::MatrixXd> result{
+        Eigen::VectorXd(FunctionSize), Eigen::MatrixXd(FunctionSize, u.size())};
+    auto store = [&](const Eigen::VectorX<DualNumber> &evaluation,
+                     Eigen::Index col) {
+        // The value is the primal of the first pass, or of the only
+        // evaluation when u is empty
         for (int j = 0; j < FunctionSize; ++j) {
-            jac.col(i)[j] = result[j].dual();
+            if (col <= 0) {
+                result.value[j] = evaluation[j].primal();
+            }
+            if (col >= 0) {
+                result.jacobian(j, col) = evaluation[j].dual();
+            }
         }
+    };
+    if (u.size() == 0) {
+        store(f(dual_numbers), -1);
+    }
+    for (Eigen::Index i = 0; i < u.size(); ++i) {
+        dual_numbers[i].dual() = 1.0;
+        store(f(dual_numbers), i);
         dual_numbers[i].dual() = 0.0;
     }
-    return jac;
+    return result;
 }
 
 /**
@@ -277,6 +560,55 @@ auto jacobian(F &&f, const Eigen::Vector<double, InputSize> &u)
     return jac;
 }
 
+/**
+ * \brief Returns the value and the jacobian of f evaluated at u
+ *
+ * \warning f MUST output a vector of size FunctionSize
+ *
+ * \tparam F Function Type that takes as input a Eigen::VectorX<DualNumber,
+ * InputSize> and outputs a vector of DualNumbers (type:
+ * Eigen::VectorX<DualNumber, FunctionSize>)
+ * \param f A multidimensional function that maps u (in dual number
+ * representation) to the output space
+ * \param u A vector of inputs that each element of f will be evaluated at
+ * \return The value and the jacobian of f at u
+ */
+template <int FunctionSize, class F, int InputSize>
+auto value_and_jacobian(F &&f, const Eigen::Vector<double, InputSize> &u)
+    -> ValueAndJacobian<Eigen::Vector<double, FunctionSize>,
+                        Eigen::Matrix<double, FunctionSize, InputSize>>
+{
+    Eigen::Vector<DualNumber, InputSize> dual_numbers{};
+    for (int i = 0; i < InputSize; ++i) {
+        dual_numbers(i) = DualNumber{u[i], 0.0};
+    }
+
+    ValueAndJacobian<Eigen::Vector<double, FunctionSize>,
+                     Eigen::Matrix<double, FunctionSize, InputSize>>
+        result{};
+    auto store = [&](const auto &evaluation, int col) {
+        // The value is the primal of the first pass, or of the only
+        // evaluation when u is empty
+        for (int j = 0; j < FunctionSize; ++j) {
+            if (col <= 0) {
+                result.value[j] = evaluation[j].primal();
+            }
+            if (col >= 0) {
+                result.jacobian(j, col) = evaluation[j].dual();
+            }
+        }
+    };
+    if (InputSize == 0) {
+        store(f(dual_numbers), -1);
+    }
+    for (int i = 0; i < InputSize; ++i) {
+        dual_numbers[i].dual() = 1.0;
+        store(f(dual_numbers), i);
+        dual_numbers[i].dual() = 0.0;
+    }
+    return result;
+}
+
 /// Convenience type alias
 using DualNumber_function = std::function<algodiff::forward::DualNumber(
     std::vector<algodiff::forward::DualNumber>)>;
@@ -0,0 +1,193 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+/// \file gradient_service.hpp
+/// \brief Serves jacobians of registered models to other processes over a Unix
+/// domain socket, batching concurrent requests
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <string>
+
+#include <Eigen/Core>
+
+#include "model_registry.hpp"
+#include "thread_pool.hpp"
+
+namespace algodiff
+{
+/// Tuning knobs of a GradientServer
+struct ServiceOptions {
+    /// How long the first request for a model may wait for others to join
+    /// its batch
+    std::chrono::microseconds batch_window{1000};
+
+    /// The number of requests that dispatches a batch without waiting for
+    /// the window to close
+    std::size_t max_batch{64};
+
+    /// The number of threads a batch is evaluated on, 0 for one per hardware
+    /// thread
+    unsigned threads{0};
+};
+
+/// Counters describing the work done by a GradientServer
+struct ServiceStatistics {
+    /// The number of evaluation requests answered
+    std::size_t requests{0};
+
+    /// The number of batches the requests were evaluated in
+    std::size_t batches{0};
+};
+
+/**
+ * \brief Answers jacobian requests for the models of a registry on a Unix
+ * domain socket
+ *
+ * Requests for the same model that arrive within the batch window are
+ * evaluated together on a pool of threads, so the cost of waking the server
+ * and the threads is shared by every request in the batch. The client sends a
+ * shared memory file descriptor with each request and the model writes its
+ * value and jacobian straight into it; only a small status message travels
+ * back over the socket.
+ *
+ * Client sockets are never read or written in a blocking call, so a client
+ * that stalls in the middle of a request or stops reading its answers only
+ * holds up itself. The server buffers at most one request per connection,
+ * and the input of an evaluation only once its size matches the model.
+ *
+ * \note Requires a POSIX system
+ */
+class GradientServer
+{
+public:
+    /**
+     * \brief Binds and listens on a socket; no request is read until run()
+     *
+     * \throws std::system_error if the socket cannot be created or bound
+     * \throws std::invalid_argument if the path is too long for a Unix
+     * domain socket
+     *
+     * \param socket_path The path of the socket; an existing file there is
+     * replaced
+     * \param registry The models to serve; must outlive the server
+     * \param options The batching options
+     */
+    GradientServer(std::string socket_path, const ModelRegistry &registry,
+                   ServiceOptions options = {});
+
+    GradientServer(const GradientServer &) = delete;
+    GradientServer(GradientServer &&) = delete;
+    auto operator=(const GradientServer &) -> GradientServer & = delete;
+    auto operator=(GradientServer &&) -> GradientServer & = delete;
+
+    /// Closes every connection and removes the socket file
+    ~GradientServer();
+
+    /**
+     * \brief Serves requests on the calling thread until stop() is called
+     *
+     * \throws std::system_error if waiting on the sockets fails
+     */
+    auto run() -> void;
+
+    /**
+     * \brief Makes run() return after its current iteration; safe to call
+     * from any thread or from a signal handler
+     */
+    auto stop() noexcept -> void;
+
+    /**
+     * \brief Returns the work done so far
+     *
+     * \return The statistics
+     */
+    auto statistics() const -> ServiceStatistics;
+
+private:
+    struct Batch;
+
+    auto dispatch(Batch &batch) -> void;
+
+    std::string m_socket_path;
+    const ModelRegistry *m_registry;
+    ServiceOptions m_options;
+    int m_listen_fd{-1};
+    int m_wake_fds[2]{-1, -1};
+    std::unique_ptr<ThreadPool> m_pool;
+    std::atomic<std::size_t> m_requests{0};
+    std::atomic<std::size_t> m_batches{0};
+};
+
+/// A view of a result in the shared memory of a GradientClient
+struct GradientView {
+    /// The value of the model
+    Eigen::Map<const Eigen::VectorXd> value;
+
+    /// The output_size x input_size jacobian of the model
+    Eigen::Map<const Eigen::MatrixXd> jacobian;
+};
+
+/**
+ * \brief A connection to a GradientServer
+ *
+ * The client keeps one shared memory buffer per model, so a result is read
+ * where the server wrote it. A client is not thread-safe; use one client per
+ * thread.
+ *
+ * \note Requires a POSIX system
+ */
+class GradientClient
+{
+public:
+    /**
+     * \brief Connects to a server
+     *
+     * \throws std::system_error if the connection fails
+     * \throws std::invalid_argument if the path is too long for a Unix
+     * domain socket
+     *
+     * \param socket_path The path of the server socket
+     */
+    explicit GradientClient(const std::string &socket_path);
+
+    GradientClient(const GradientClient &) = delete;
+    GradientClient(GradientClient &&) = delete;
+    auto operator=(const GradientClient &) -> GradientClient & = delete;
+    auto operator=(GradientClient &&) -> GradientClient & = delete;
+
+    /// Closes the connection and releases the shared memory
+    ~GradientClient();
+
+    /**
+     * \brief Evaluates a model and its jacobian at x on the server
+     *
+     * \throws std::invalid_argument if x does not have the input size of
+     * the model
+     * \throws std::runtime_error if the model does not exist, the model
+     * throws, or the connection breaks
+     * \throws std::system_error if the shared memory cannot be created
+     *
+     * \param model The name of the model
+     * \param x The point to evaluate at
+     * \return A view of the result, valid until the next call for the same
+     * model or until the client is destroyed
+     */
+    auto evaluate(const std::string &model, const Eigen::VectorXd &x)
+        -> GradientView;
+
+private:
+    struct Buffer;
+
+    auto buffer(const std::string &model) -> Buffer &;
+
+    int m_fd{-1};
+    std::map<std::string, std::shared_ptr<Buffer>> m_buffers{};
+};
+
+} // namespace algodiff
@@ -0,0 +1,577 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+/// \file interpolation_table.hpp
+/// \brief Implements interpolation tables that can be evaluated on
+/// DualNumbers, one query point at a time or in batches
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include "dual_number.hpp"
+#include "dual_number_eigen.hpp"
+
+namespace algodiff::forward
+{
+/// The cell found by the previous lookup along every axis, which the next
+/// lookup tries first
+template <std::size_t Dimension>
+using InterpolationHint = std::array<Eigen::Index, Dimension>;
+
+/**
+ * \brief The knots of a table along one axis
+ *
+ * Knots that are evenly spaced are found by direct indexing. Otherwise the
+ * cell of the previous lookup and its neighbours are tried before falling
+ * back to a binary search, so sorted or clustered queries stay cheap. Queries
+ * outside the knots are assigned to the first or last cell, which
+ * extrapolates the table.
+ */
+class InterpolationAxis
+{
+public:
+    /**
+     * \brief Creates an axis
+     *
+     * \throws std::invalid_argument if there are fewer than two knots or the
+     * knots are not strictly increasing
+     *
+     * \param knots The knots
+     */
+    explicit InterpolationAxis(std::vector<double> knots);
+
+    /**
+     * \brief Returns the knots
+     *
+     * \return The knots in increasing order
+     */
+    auto knots() const -> const std::vector<double> &
+    {
+        return m_knots;
+    }
+
+    /**
+     * \brief Returns the number of cells
+     *
+     * \return One less than the number of knots
+     */
+    auto cells() const -> Eigen::Index
+    {
+        return static_cast<Eigen::Index>(m_knots.size()) - 1;
+    }
+
+    /**
+     * \brief Returns whether the knots are evenly spaced
+     *
+     * \return true if cells are found by direct indexing
+     */
+    auto is_uniform() const -> bool
+    {
+        return m_uniform;
+    }
+
+    /**
+     * \brief Finds the cell of a query
+     *
+     * \param x The query
+     * \param hint The cell to try first, which receives the cell found
+     * \return The cell
+     */
+    auto locate(double x, Eigen::Index &hint) const -> Eigen::Index;
+
+    /**
+     * \brief Returns the position of a query within a cell
+     *
+     * \param x The query
+     * \param cell The cell
+     * \return 0 at the lower knot of the cell and 1 at the upper one
+     */
+    auto fraction(double x, Eigen::Index cell) const -> double
+    {
+        return (x - m_knots[static_cast<size_t>(cell)]) *
+               m_inverse_widths[static_cast<size_t>(cell)];
+    }
+
+    /**
+     * \brief Returns the derivative of fraction() with respect to the query
+     *
+     * \param cell The cell
+     * \return One over the width of the cell
+     */
+    auto inverse_width(Eigen::Index cell) const -> double
+    {
+        return m_inverse_widths[static_cast<size_t>(cell)];
+    }
+
+    /**
+     * \brief Finds the cells of a batch of queries
+     *
+     * Evenly spaced knots are indexed with vectorized array expressions;
+     * otherwise the queries are searched in order, each one starting from
+     * the cell of the one before.
+     *
+     * \param x The queries
+     * \param cells Receives the cell of every query
+     * \param fractions Receives the position of every query within its cell
+     * \param inverse_widths Receives one over the width of every cell
+     */
+    auto locate(const Eigen::ArrayXd &x, Eigen::ArrayX<Eigen::Index> &cells,
+                Eigen::ArrayXd &fractions,
+                Eigen::ArrayXd &inverse_widths) const -> void;
+
+private:
+    std::vector<double> m_knots;
+    std::vector<double> m_inverse_widths;
+    bool m_uniform{false};
+};
+
+namespace internal
+{
+/**
+ * \brief Splits a batch of DualNumbers into its primal and dual components
+ *
+ * \param x The batch
+ * \param primal Receives the primal components
+ * \param dual Receives the dual components
+ */
+auto split(const Eigen::Ref<const Eigen::ArrayX<DualNumber>> &x,
+           Eigen::ArrayXd &primal, Eigen::ArrayXd &dual) -> void;
+
+/**
+ * \brief Joins primal and dual components into a batch of DualNumbers
+ *
+ * \param primal The primal components
+ * \param dual The dual components
+ * \return The batch
+ */
+auto join(const Eigen::ArrayXd &primal, const Eigen::ArrayXd &dual)
+    -> Eigen::VectorX<DualNumber>;
+
+/**
+ * \brief Throws unless a table has one value per knot
+ *
+ * \throws std::invalid_argument if the sizes differ
+ *
+ * \param knots The number of knots
+ * \param values The number of values
+ */
+auto require_table_size(Eigen::Index knots, Eigen::Index values) -> void;
+
+// Creates the axis of every dimension from its knots
+template <std::size_t Dimension, std::size_t... I>
+auto make_axes(std::array<std::vector<double>, Dimension> &knots,
+               std::index_sequence<I...> /*indices*/)
+    -> std::array<InterpolationAxis, Dimension>
+{
+    return {InterpolationAxis{std::move(knots[I])}...};
+}
+
+} // namespace internal
+
+/**
+ * \brief A table of values on a rectilinear grid, interpolated linearly along
+ * every axis (bilinearly in 2D, trilinearly in 3D)
+ *
+ * The value and the derivatives are computed from the same corner values and
+ * weights, so a DualNumber lookup costs little more than a plain one.
+ *
+ * \tparam Dimension The number of axes
+ */
+template <std::size_t Dimension> class LinearTable
+{
+public:
+    /// The coordinates of a batch of query points, one column per point
+    template <class Scalar>
+    using Points = Eigen::Matrix<Scalar, static_cast<int>(Dimension),
+                                 Eigen::Dynamic>;
+
+    /**
+     * \brief Creates a table
+     *
+     * \throws std::invalid_argument if an axis is invalid or the number of
+     * values is not the product of the numbers of knots
+     *
+     * \param knots The knots along every axis
+     * \param values The value at every knot, with the first coordinate
+     * varying fastest
+     */
+    LinearTable(std::array<std::vector<double>, Dimension> knots,
+                Eigen::VectorXd values);
+
+    /**
+     * \brief Returns the axis of a dimension
+     *
+     * \param dimension The dimension
+     * \return The axis
+     */
+    auto axis(std::size_t dimension) const -> const InterpolationAxis &
+    {
+        return m_axes[dimension];
+    }
+
+    /**
+     * \brief Interpolates the table at a point
+     *
+     * \param x The coordinates of the point
+     * \param hint The cells to try first, which receive the cells found
+     * \param gradient If not null, receives the derivatives of the value
+     * with respect to the coordinates
+     * \return The interpolated value
+     */
+    auto value(const std::array<double, Dimension> &x,
+               InterpolationHint<Dimension> &hint,
+               std::array<double, Dimension> *gradient = nullptr) const
+        -> double;
+
+    /**
+     * \brief Interpolates the table at a point
+     *
+     * \param x The coordinates of the point
+     * \return The interpolated value
+     */
+    auto operator()(const std::array<double, Dimension> &x) const -> double
+    {
+        InterpolationHint<Dimension> hint{};
+        return value(x, hint);
+    }
+
+    /**
+     * \brief Interpolates the table at a point given as DualNumbers
+     *
+     * \param x The coordinates of the point
+     * \param hint The cells to try first, which receive the cells found
+     * \return The interpolated value and its derivative along the dual
+     * components of x
+     */
+    auto operator()(const std::array<DualNumber, Dimension> &x,
+                    InterpolationHint<Dimension> &hint) const -> DualNumber;
+
+    /**
+     * \brief Interpolates the table at a point given as DualNumbers
+     *
+     * \param x The coordinates of the point
+     * \return The interpolated value and its derivative along the dual
+     * components of x
+     */
+    auto operator()(const std::array<DualNumber, Dimension> &x) const
+        -> DualNumber
+    {
+        InterpolationHint<Dimension> hint{};
+        return (*this)(x, hint);
+    }
+
+    /**
+     * \brief Interpolates the table at a batch of points
+     *
+     * \param x The points, one per column
+     * \return The interpolated values
+     */
+    auto batch(const Points<double> &x) const -> Eigen::VectorXd;
+
+    /**
+     * \brief Interpolates the table at a batch of points given as
+     * DualNumbers
+     *
+     * \param x The points, one per column
+     * \return The interpolated values and their derivatives
+     */
+    auto batch(const Points<DualNumber> &x) const
+        -> Eigen::VectorX<DualNumber>;
+
+private:
+    static constexpr std::size_t corners{std::size_t{1} << Dimension};
+
+    // Interpolates at a batch of points given by their coordinates along
+    // every axis, filling gradient if it is not null
+    auto interpolate(const std::array<Eigen::ArrayXd, Dimension> &x,
+                     std::array<Eigen::ArrayXd, Dimension> *gradient) const
+        -> Eigen::ArrayXd;
+
+    std::array<InterpolationAxis, Dimension> m_axes;
+    std::array<Eigen::Index, Dimension> m_strides{};
+    Eigen::VectorXd m_values;
+};
+
+/**
+ * \brief A natural cubic spline through tabulated values
+ *
+ * The polynomial of every cell is stored in terms of the position within the
+ * cell, so the value and the derivative come from one set of coefficients.
+ * Queries outside the knots are extrapolated with the polynomial of the first
+ * or last cell.
+ */
+class CubicSpline
+{
+public:
+    /**
+     * \brief Creates the spline with zero second derivative at both ends
+     *
+     * \throws std::invalid_argument if the axis is invalid or the number of
+     * values differs from the number of knots
+     *
+     * \param knots The knots
+     * \param values The value at every knot
+     */
+    CubicSpline(std::vector<double> knots, const Eigen::VectorXd &values);
+
+    /**
+     * \brief Returns the axis of the spline
+     *
+     * \return The axis
+     */
+    auto axis() const -> const InterpolationAxis &
+    {
+        return m_axis;
+    }
+
+    /**
+     * \brief Evaluates the spline
+     *
+     * \param x The query
+     * \param hint The cell to try first, which receives the cell found
+     * \param derivative If not null, receives the derivative of the spline
+     * \return The value of the spline
+     */
+    auto value(double x, Eigen::Index &hint,
+               double *derivative = nullptr) const -> double;
+
+    /**
+     * \brief Evaluates the spline
+     *
+     * \param x The query
+     * \return The value of the spline
+     */
+    auto operator()(double x) const -> double
+    {
+        Eigen::Index hint{0};
+        return value(x, hint);
+    }
+
+    /**
+     * \brief Evaluates the spline at a DualNumber
+     *
+     * \param x The query
+     * \param hint The cell to try first, which receives the cell found
+     * \return The value of the spline and its derivative along x
+     */
+    auto operator()(const DualNumber &x, Eigen::Index &hint) const
+        -> DualNumber;
+
+    /**
+     * \brief Evaluates the spline at a DualNumber
+     *
+     * \param x The query
+     * \return The value of the spline and its derivative along x
+     */
+    auto operator()(const DualNumber &x) const -> DualNumber
+    {
+        Eigen::Index hint{0};
+        return (*this)(x, hint);
+    }
+
+    /**
+     * \brief Evaluates the spline at a batch of queries
+     *
+     * \param x The queries
+     * \return The values of the spline
+     */
+    auto batch(const Eigen::VectorXd &x) const -> Eigen::VectorXd;
+
+    /**
+     * \brief Evaluates the spline at a batch of DualNumbers
+     *
+     * \param x The queries
+     * \return The values of the spline and their derivatives
+     */
+    auto batch(const Eigen::VectorX<DualNumber> &x) const
+        -> Eigen::VectorX<DualNumber>;
+
+private:
+    // Evaluates at a batch of queries, filling derivative if it is not null
+    auto evaluate(const Eigen::ArrayXd &x, Eigen::ArrayXd *derivative) const
+        -> Eigen::ArrayXd;
+
+    InterpolationAxis m_axis;
+
+    // The coefficients of 1, t, t^2 and t^3 in every cell, where t is the
+    // position within the cell
+    Eigen::Matrix<double, 4, Eigen::Dynamic> m_coefficients;
+};
+
+template <std::size_t Dimension>
+LinearTable<Dimension>::LinearTable(
+    std::array<std::vector<double>, Dimension> knots, Eigen::VectorXd values)
+    : m_axes{internal::make_axes(knots,
+                                 std::make_index_sequence<Dimension>{})},
+      m_values{std::move(values)}
+{
+    Eigen::Index stride{1};
+    for (std::size_t d = 0; d < Dimension; ++d) {
+        m_strides[d] = stride;
+        stride *= m_axes[d].cells() + 1;
+    }
+    internal::require_table_size(stride, m_values.size());
+}
+
+template <std::size_t Dimension>
+auto LinearTable<Dimension>::value(const std::array<double, Dimension> &x,
+                                   InterpolationHint<Dimension> &hint,
+                                   std::array<double, Dimension> *gradient)
+    const -> double
+{
+    Eigen::Index base{0};
+    std::array<double, Dimension> fractions{};
+    for (std::size_t d = 0; d < Dimension; ++d) {
+        const auto cell{m_axes[d].locate(x[d], hint[d])};
+        fractions[d] = m_axes[d].fraction(x[d], cell);
+        base += cell * m_strides[d];
+    }
+
+    double result{0.0};
+    std::array<double, Dimension> slopes{};
+    for (std::size_t corner = 0; corner < corners; ++corner) {
+        Eigen::Index index{base};
+        std::array<double, Dimension> weights{};
+        for (std::size_t d = 0; d < Dimension; ++d) {
+            const bool upper{((corner >> d) & 1U) != 0};
+            weights[d] = upper ? fractions[d] : 1.0 - fractions[d];
+            index += upper ? m_strides[d] : 0;
+        }
+        const double corner_value{m_values[index]};
+        double weight{1.0};
+        for (const auto w : weights) {
+            weight *= w;
+        }
+        result += weight * corner_value;
+        if (gradient == nullptr) {
+            continue;
+        }
+        for (std::size_t d = 0; d < Dimension; ++d) {
+            double others{((corner >> d) & 1U) != 0 ? 1.0 : -1.0};
+            for (std::size_t e = 0; e < Dimension; ++e) {
+                others *= e == d ? 1.0 : weights[e];
+            }
+            slopes[d] += others * corner_value;
+        }
+    }
+    if (gradient != nullptr) {
+        for (std::size_t d = 0; d < Dimension; ++d) {
+            (*gradient)[d] = slopes[d] * m_axes[d].inverse_width(hint[d]);
+        }
+    }
+    return result;
+}
+
+template <std::size_t Dimension>
+auto LinearTable<Dimension>::operator()(
+    const std::array<DualNumber, Dimension> &x,
+    InterpolationHint<Dimension> &hint) const -> DualNumber
+{
+    std::array<double, Dimension> primal{};
+    for (std::size_t d = 0; d < Dimension; ++d) {
+        primal[d] = x[d].primal();
+    }
+    std::array<double, Dimension> gradient{};
+    const double result{value(primal, hint, &gradient)};
+    double tangent{0.0};
+    for (std::size_t d = 0; d < Dimension; ++d) {
+        tangent += gradient[d] * x[d].dual();
+    }
+    return DualNumber{result, tangent};
+}
+
+template <std::size_t Dimension>
+auto LinearTable<Dimension>::batch(const Points<double> &x) const
+    -> Eigen::VectorXd
+{
+    std::array<Eigen::ArrayXd, Dimension> coordinates{};
+    for (std::size_t d = 0; d < Dimension; ++d) {
+        coordinates[d] = x.row(static_cast<Eigen::Index>(d)).transpose();
+    }
+    return interpolate(coordinates, nullptr).matrix();
+}
+
+template <std::size_t Dimension>
+auto LinearTable<Dimension>::batch(const Points<DualNumber> &x) const
+    -> Eigen::VectorX<DualNumber>
+{
+    std::array<Eigen::ArrayXd, Dimension> primal{};
+    std::array<Eigen::ArrayXd, Dimension> dual{};
+    for (std::size_t d = 0; d < Dimension; ++d) {
+        internal::split(
+            x.row(static_cast<Eigen::Index>(d)).transpose().array(),
+            primal[d], dual[d]);
+    }
+    std::array<Eigen::ArrayXd, Dimension> gradient{};
+    const Eigen::ArrayXd result{interpolate(primal, &gradient)};
+    Eigen::ArrayXd tangent{Eigen::ArrayXd::Zero(x.cols())};
+    for (std::size_t d = 0; d < Dimension; ++d) {
+        tangent += gradient[d] * dual[d];
+    }
+    return internal::join(result, tangent);
+}
+
+template <std::size_t Dimension>
+auto LinearTable<Dimension>::interpolate(
+    const std::array<Eigen::ArrayXd, Dimension> &x,
+    std::array<Eigen::ArrayXd, Dimension> *gradient) const -> Eigen::ArrayXd
+{
+    const auto size{x[0].size()};
+    Eigen::ArrayX<Eigen::Index> base{Eigen::ArrayX<Eigen::Index>::Zero(size)};
+    std::array<Eigen::ArrayXd, Dimension> fractions{};
+    std::array<Eigen::ArrayXd, Dimension> inverse_widths{};
+    for (std::size_t d = 0; d < Dimension; ++d) {
+        Eigen::ArrayX<Eigen::Index> cells{};
+        m_axes[d].locate(x[d], cells, fractions[d], inverse_widths[d]);
+        base += cells * m_strides[d];
+    }
+
+    Eigen::ArrayXd result{Eigen::ArrayXd::Zero(size)};
+    if (gradient != nullptr) {
+        gradient->fill(Eigen::ArrayXd::Zero(size));
+    }
+    Eigen::ArrayXd corner_values(size);
+    for (std::size_t corner = 0; corner < corners; ++corner) {
+        Eigen::Index offset{0};
+        for (std::size_t d = 0; d < Dimension; ++d) {
+            offset += ((corner >> d) & 1U) != 0 ? m_strides[d] : 0;
+        }
+        for (Eigen::Index i = 0; i < size; ++i) {
+            corner_values[i] = m_values[base[i] + offset];
+        }
+
+        std::array<Eigen::ArrayXd, Dimension> weights{};
+        Eigen::ArrayXd weight{Eigen::ArrayXd::Ones(size)};
+        for (std::size_t d = 0; d < Dimension; ++d) {
+            weights[d] = ((corner >> d) & 1U) != 0 ? fractions[d]
+                                                   : 1.0 - fractions[d];
+            weight *= weights[d];
+        }
+        result += weight * corner_values;
+        if (gradient == nullptr) {
+            continue;
+        }
+        for (std::size_t d = 0; d < Dimension; ++d) {
+            Eigen::ArrayXd others{corner_values * inverse_widths[d]};
+            for (std::size_t e = 0; e < Dimension; ++e) {
+                if (e != d) {
+                    others *= weights[e];
+                }
+            }
+            if (((corner >> d) & 1U) != 0) {
+                (*gradient)[d] += others;
+            } else {
+                (*gradient)[d] -= others;
+            }
+        }
+    }
+    return result;
+}
+
+} // namespace algodiff::forward
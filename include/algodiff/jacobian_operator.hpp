@@ -0,0 +1,184 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+/// \file jacobian_operator.hpp
+/// \brief Contains a matrix-free jacobian that can be passed to Eigen's
+/// iterative solvers
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+
+#include "reverse_mode.hpp"
+#include "tape.hpp"
+
+namespace algodiff::reverse
+{
+class JacobianOperator;
+} // namespace algodiff::reverse
+
+namespace Eigen::internal
+{
+template <>
+struct traits<algodiff::reverse::JacobianOperator>
+    : public traits<Eigen::SparseMatrix<double>> {
+};
+} // namespace Eigen::internal
+
+namespace algodiff::reverse
+{
+/**
+ * \brief The jacobian of a function at a point, available only through its
+ * products with vectors
+ *
+ * The function is recorded once and the partial derivative of every recorded
+ * operation is stored, so the primal evaluation is shared by all products:
+ * J * v is one forward sweep over the stored partials and J^T * w one reverse
+ * sweep, each linear in the size of the recording. The operator models
+ * Eigen's matrix-free interface, so it can be handed directly to
+ * Eigen::BiCGSTAB, Eigen::ConjugateGradient or Eigen::GMRES together with
+ * Eigen::IdentityPreconditioner.
+ */
+class JacobianOperator : public Eigen::EigenBase<JacobianOperator>
+{
+public:
+    using Scalar = double;
+    using RealScalar = double;
+    using StorageIndex = int;
+
+    enum {
+        ColsAtCompileTime = Eigen::Dynamic,    // NOLINT
+        MaxColsAtCompileTime = Eigen::Dynamic, // NOLINT
+        IsRowMajor = false,                    // NOLINT
+    };
+
+    /**
+     * \brief Linearizes a recording at its recorded values
+     *
+     * The operator does not refer to the tape afterwards.
+     *
+     * \param tape A tape with registered inputs and outputs
+     */
+    explicit JacobianOperator(const Tape &tape)
+    {
+        linearize(tape);
+    }
+
+    /**
+     * \brief Linearizes f at u
+     *
+     * \tparam F Function Type that takes as input a Eigen::VectorX<Variable>
+     * and outputs a Eigen::VectorX<Variable>
+     * \param f The function
+     * \param u The linearization point
+     */
+    template <class F> JacobianOperator(F &&f, const Eigen::VectorXd &u)
+    {
+        Tape tape{};
+        record(tape, std::forward<F>(f), u);
+        linearize(tape);
+    }
+
+    /**
+     * \brief Returns the number of outputs
+     *
+     * \return The number of rows of the jacobian
+     */
+    auto rows() const -> Eigen::Index
+    {
+        return m_value.size();
+    }
+
+    /**
+     * \brief Returns the number of inputs
+     *
+     * \return The number of columns of the jacobian
+     */
+    auto cols() const -> Eigen::Index
+    {
+        return static_cast<Eigen::Index>(m_inputs.size());
+    }
+
+    /**
+     * \brief Returns the outputs of the function at the linearization point
+     *
+     * \return The outputs
+     */
+    auto value() const -> const Eigen::VectorXd &
+    {
+        return m_value;
+    }
+
+    /**
+     * \brief Returns the jacobian times a vector
+     *
+     * \throws std::invalid_argument if v does not have one entry per input
+     *
+     * \param v The vector
+     * \return J * v
+     */
+    auto jvp(const Eigen::Ref<const Eigen::VectorXd> &v) const
+        -> Eigen::VectorXd;
+
+    /**
+     * \brief Returns the transposed jacobian times a vector
+     *
+     * \throws std::invalid_argument if w does not have one entry per output
+     *
+     * \param w The vector
+     * \return J^T * w
+     */
+    auto vjp(const Eigen::Ref<const Eigen::VectorXd> &w) const
+        -> Eigen::VectorXd;
+
+    /**
+     * \brief Returns the lazy product with a vector, evaluated by jvp
+     *
+     * \param x The vector
+     * \return The product expression
+     */
+    template <class Rhs>
+    auto operator*(const Eigen::MatrixBase<Rhs> &x) const
+        -> Eigen::Product<JacobianOperator, Rhs, Eigen::AliasFreeProduct>
+    {
+        return Eigen::Product<JacobianOperator, Rhs, Eigen::AliasFreeProduct>(
+            *this, x.derived());
+    }
+
+private:
+    auto linearize(const Tape &tape) -> void;
+
+    Eigen::VectorXd m_value{};
+    std::vector<std::uint32_t> m_inputs{};
+    std::vector<std::uint32_t> m_outputs{};
+
+    /// The edges ending at node i are [m_offsets[i], m_offsets[i + 1])
+    std::vector<std::size_t> m_offsets{};
+    std::vector<std::uint32_t> m_operands{};
+    std::vector<double> m_partials{};
+};
+
+} // namespace algodiff::reverse
+
+namespace Eigen::internal
+{
+template <class Rhs>
+struct generic_product_impl<algodiff::reverse::JacobianOperator, Rhs,
+                            SparseShape, DenseShape, GemvProduct>
+    : generic_product_impl_base<
+          algodiff::reverse::JacobianOperator, Rhs,
+          generic_product_impl<algodiff::reverse::JacobianOperator, Rhs>> {
+    template <class Dest>
+    static void scaleAndAddTo(Dest &dst, // NOLINT
+                              const algodiff::reverse::JacobianOperator &lhs,
+                              const Rhs &rhs, const double &alpha)
+    {
+        dst.noalias() += alpha * lhs.jvp(rhs);
+    }
+};
+} // namespace Eigen::internal
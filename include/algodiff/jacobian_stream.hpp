@@ -0,0 +1,286 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+/// \file jacobian_stream.hpp
+/// \brief Streams jacobian columns to a consumer as they are computed
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "dual_number.hpp"
+#include "dual_number_eigen.hpp"
+#include "forward_mode.hpp"
+
+namespace algodiff::forward
+{
+namespace internal
+{
+/**
+ * \brief A fixed capacity blocking queue used to hand results from a producer
+ * thread to a consumer
+ *
+ * push() blocks while the queue is full, which is what throttles the producer
+ * when the consumer falls behind.
+ */
+template <typename T> class BoundedQueue
+{
+public:
+    /**
+     * \brief Creates an empty queue
+     *
+     * \param capacity The maximum number of queued items (at least 1)
+     */
+    explicit BoundedQueue(size_t capacity)
+        : m_capacity{std::max<size_t>(capacity, 1)}
+    {
+    }
+
+    /**
+     * \brief Appends item, waiting for space if the queue is full
+     *
+     * \param item The item to append
+     * \return false if the queue was closed, in which case item is dropped
+     */
+    auto push(T item) -> bool
+    {
+        std::unique_lock<std::mutex> lock{m_mutex};
+        m_not_full.wait(lock, [&] {
+            return m_closed || m_items.size() < m_capacity;
+        });
+        if (m_closed) {
+            return false;
+        }
+        m_items.push_back(std::move(item));
+        m_not_empty.notify_one();
+        return true;
+    }
+
+    /**
+     * \brief Removes the oldest item, waiting until one is available
+     *
+     * \return The oldest item, or an empty optional once the queue is closed
+     * and drained
+     */
+    auto pop() -> std::optional<T>
+    {
+        std::unique_lock<std::mutex> lock{m_mutex};
+        m_not_empty.wait(lock, [&] { return m_closed || !m_items.empty(); });
+        if (m_items.empty()) {
+            return std::nullopt;
+        }
+        std::optional<T> item{std::move(m_items.front())};
+        m_items.pop_front();
+        m_not_full.notify_one();
+        return item;
+    }
+
+    /// Wakes all waiters; later pushes fail and pops drain what is left
+    auto close() -> void
+    {
+        const std::lock_guard<std::mutex> lock{m_mutex};
+        m_closed = true;
+        m_not_full.notify_all();
+        m_not_empty.notify_all();
+    }
+
+private:
+    /// The maximum number of queued items
+    size_t m_capacity;
+
+    /// Whether close() has been called
+    bool m_closed{false};
+
+    /// The queued items
+    std::deque<T> m_items{};
+
+    /// Guards all members
+    std::mutex m_mutex{};
+
+    /// Signalled when an item is removed
+    std::condition_variable m_not_full{};
+
+    /// Signalled when an item is added
+    std::condition_variable m_not_empty{};
+};
+
+} // namespace internal
+
+/// Tuning options for streamed jacobians
+struct JacobianStreamOptions {
+    /// The number of columns computed before they are handed over together
+    Eigen::Index chunk_size{1};
+
+    /// The number of finished chunks that may wait for the consumer before
+    /// the producer blocks
+    size_t capacity{2};
+};
+
+/**
+ * \brief A block of consecutive jacobian columns
+ *
+ * \tparam FunctionSize The dimension of the output of the function
+ */
+template <int FunctionSize> struct JacobianChunk {
+    /// The index of the first column in the chunk
+    Eigen::Index first_column{0};
+
+    /// The columns [first_column, first_column + columns.cols())
+    Eigen::Matrix<double, FunctionSize, Eigen::Dynamic> columns{};
+};
+
+/**
+ * \brief A pull based generator of jacobian chunks
+ *
+ * The jacobian is computed on a background thread which runs at most
+ * options.capacity chunks ahead of the consumer, so memory use is bounded by
+ * (capacity + 2) * chunk_size columns regardless of the input dimension.
+ * Destroying the stream early stops the producer.
+ *
+ * \tparam FunctionSize The dimension of the output of the function
+ */
+template <int FunctionSize> class JacobianStream
+{
+public:
+    /**
+     * \brief Starts computing the jacobian of f at u
+     *
+     * \tparam F Function Type that takes as input a Eigen::VectorX<DualNumber>
+     * and outputs a vector of DualNumbers of size FunctionSize. It is copied
+     * (or moved) to the producer thread
+     * \param f A multidimensional function that maps u (in dual number
+     * representation) to the output space
+     * \param u A vector of inputs that f will be evaluated at
+     * \param options Chunking and buffering options
+     */
+    template <class F>
+    JacobianStream(F &&f, Eigen::VectorXd u,
+                   JacobianStreamOptions options = {})
+        : m_queue{options.capacity}
+    {
+        if (options.chunk_size < 1) {
+            throw std::invalid_argument("chunk_size must be positive");
+        }
+        m_producer = std::thread{
+            [this, func = std::decay_t<F>{std::forward<F>(f)},
+             point = std::move(u), chunk_size = options.chunk_size]() mutable {
+                produce(func, point, chunk_size);
+            }};
+    }
+
+    JacobianStream(const JacobianStream &) = delete;
+    JacobianStream(JacobianStream &&) = delete;
+    auto operator=(const JacobianStream &) -> JacobianStream & = delete;
+    auto operator=(JacobianStream &&) -> JacobianStream & = delete;
+
+    /// Stops the producer and waits for it to exit
+    ~JacobianStream()
+    {
+        m_queue.close();
+        m_producer.join();
+    }
+
+    /**
+     * \brief Returns the next chunk, waiting for it if necessary
+     *
+     * \throws Any exception thrown by the function, once all chunks computed
+     * before it have been consumed
+     *
+     * \return The next chunk, or an empty optional once every column has been
+     * returned
+     */
+    auto next() -> std::optional<JacobianChunk<FunctionSize>>
+    {
+        auto chunk{m_queue.pop()};
+        if (!chunk && m_error) {
+            std::rethrow_exception(std::exchange(m_error, nullptr));
+        }
+        return chunk;
+    }
+
+private:
+    /// Runs on the producer thread, pushing chunks until done or closed
+    template <class F>
+    auto produce(F &f, const Eigen::VectorXd &u, Eigen::Index chunk_size)
+        -> void
+    {
+        try {
+            for (Eigen::Index first = 0; first < u.size();
+                 first += chunk_size) {
+                const auto last{std::min(first + chunk_size, u.size())};
+                JacobianChunk<FunctionSize> chunk{};
+                chunk.first_column = first;
+                chunk.columns.resize(FunctionSize, last - first);
+                for_each_jacobian_column<FunctionSize>(
+                    f, u, first, last,
+                    [&](Eigen::Index col, const Eigen::VectorXd &c) {
+                        chunk.columns.col(col - first) = c;
+                    });
+                if (!m_queue.push(std::move(chunk))) {
+                    return;
+                }
+            }
+        } catch (...) {
+            // Published before close() so the consumer sees it after draining
+            m_error = std::current_exception();
+        }
+        m_queue.close();
+    }
+
+    /// Finished chunks waiting for the consumer
+    internal::BoundedQueue<JacobianChunk<FunctionSize>> m_queue;
+
+    /// The exception thrown by the function, if any
+    std::exception_ptr m_error{};
+
+    /// Computes the chunks
+    std::thread m_producer{};
+};
+
+/**
+ * \brief Computes the jacobian of f at u on a background thread and hands
+ * each chunk of columns to sink on the calling thread as soon as it is ready
+ *
+ * The producer runs at most options.capacity chunks ahead of sink; when sink
+ * is slower, the producer waits. If sink returns a value convertible to
+ * bool, returning false stops the computation early.
+ *
+ * \tparam FunctionSize The dimension of the output of f
+ * \tparam F Function Type that takes as input a Eigen::VectorX<DualNumber> and
+ * outputs a vector of DualNumbers of size FunctionSize
+ * \tparam Sink Callable invoked as sink(const JacobianChunk<FunctionSize> &)
+ * \param f A multidimensional function that maps u (in dual number
+ * representation) to the output space
+ * \param u A vector of inputs that f will be evaluated at
+ * \param sink The consumer of the jacobian chunks
+ * \param options Chunking and buffering options
+ */
+template <int FunctionSize, class F, class Sink>
+auto stream_jacobian(F &&f, const Eigen::VectorXd &u, Sink &&sink,
+                     JacobianStreamOptions options = {}) -> void
+{
+    JacobianStream<FunctionSize> stream{std::forward<F>(f), u, options};
+    while (auto chunk = stream.next()) {
+        using Result = std::invoke_result_t<
+            Sink &, const JacobianChunk<FunctionSize> &>;
+        if constexpr (std::is_convertible_v<Result, bool>) {
+            if (!sink(std::as_const(*chunk))) {
+                return;
+            }
+        } else {
+            sink(std::as_const(*chunk));
+        }
+    }
+}
+
+} // namespace algodiff::forward
@@ -0,0 +1,432 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+/// \file linearity_tracer.hpp
+/// \brief Contains a scalar that records which inputs a value depends on and
+/// whether it depends on them linearly
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include <Eigen/Core>
+
+namespace algodiff::forward
+{
+/**
+ * \brief A value together with the inputs it depends on, split into those it
+ * depends on affinely with a constant coefficient and all others
+ *
+ * Running a function on tracers once classifies every entry of its jacobian:
+ * an input in linear() has a constant partial derivative equal to its
+ * coefficient, an input in nonlinear() has a partial derivative that changes
+ * with the inputs, and any other input has a zero partial derivative.
+ *
+ * \warning The classification follows the branches taken at the traced point,
+ * so it only holds for functions whose control flow does not depend on the
+ * values of the inputs
+ */
+class LinearityTracer
+{
+public:
+    /// An input and its constant coefficient
+    using Term = std::pair<Eigen::Index, double>;
+
+    /// Creates a constant zero
+    LinearityTracer() = default;
+
+    /**
+     * \brief Creates a constant
+     *
+     * \param value The value
+     */
+    explicit LinearityTracer(double value) : m_value{value}
+    {
+    }
+
+    /**
+     * \brief Creates the tracer of an input
+     *
+     * \param index The index of the input
+     * \param value The value of the input at the traced point
+     * \return The tracer, linear in the input with coefficient 1
+     */
+    static auto input(Eigen::Index index, double value) -> LinearityTracer;
+
+    /**
+     * \brief Returns the value at the traced point
+     *
+     * \return The value
+     */
+    auto value() const -> double
+    {
+        return m_value;
+    }
+
+    /**
+     * \brief Returns the inputs the value depends on affinely, with their
+     * coefficients
+     *
+     * \return The terms sorted by input index
+     */
+    auto linear() const -> const std::vector<Term> &
+    {
+        return m_linear;
+    }
+
+    /**
+     * \brief Returns the inputs the value depends on in any other way
+     *
+     * \return The input indices in increasing order
+     */
+    auto nonlinear() const -> const std::vector<Eigen::Index> &
+    {
+        return m_nonlinear;
+    }
+
+    /**
+     * \brief Returns whether the value depends on no input
+     *
+     * \return true for constants
+     */
+    auto is_constant() const -> bool
+    {
+        return m_linear.empty() && m_nonlinear.empty();
+    }
+
+    /**
+     * \brief Returns the result of a function of this value that is not
+     * affine: every input it depends on becomes nonlinear
+     *
+     * \param value The value of the function at the traced point
+     * \return The result
+     */
+    auto nonlinear_function(double value) const -> LinearityTracer;
+
+    /**
+     * \brief Returns the negated value
+     *
+     * \return The negated value
+     */
+    auto operator-() const -> LinearityTracer;
+
+    /**
+     * \brief Adds another value
+     *
+     * \param other The value to add
+     * \return *this
+     */
+    auto operator+=(const LinearityTracer &other) -> LinearityTracer &;
+
+    /**
+     * \brief Adds a constant
+     *
+     * \param n The constant
+     * \return *this
+     */
+    auto operator+=(double n) -> LinearityTracer &
+    {
+        m_value += n;
+        return *this;
+    }
+
+    /**
+     * \brief Subtracts another value
+     *
+     * \param other The value to subtract
+     * \return *this
+     */
+    auto operator-=(const LinearityTracer &other) -> LinearityTracer &
+    {
+        return *this += -other;
+    }
+
+    /**
+     * \brief Subtracts a constant
+     *
+     * \param n The constant
+     * \return *this
+     */
+    auto operator-=(double n) -> LinearityTracer &
+    {
+        m_value -= n;
+        return *this;
+    }
+
+    /**
+     * \brief Multiplies by another value; the product stays affine only if
+     * one of the factors is constant
+     *
+     * \param other The factor
+     * \return *this
+     */
+    auto operator*=(const LinearityTracer &other) -> LinearityTracer &;
+
+    /**
+     * \brief Multiplies by a constant
+     *
+     * \param scalar The constant
+     * \return *this
+     */
+    auto operator*=(double scalar) -> LinearityTracer &;
+
+    /**
+     * \brief Divides by another value; the quotient stays affine only if the
+     * divisor is constant
+     *
+     * \param other The divisor
+     * \return *this
+     */
+    auto operator/=(const LinearityTracer &other) -> LinearityTracer &;
+
+    /**
+     * \brief Divides by a constant
+     *
+     * \param scalar The constant
+     * \return *this
+     */
+    auto operator/=(double scalar) -> LinearityTracer &
+    {
+        return *this *= 1.0 / scalar;
+    }
+
+private:
+    double m_value{0.0};
+    std::vector<Term> m_linear{};
+    std::vector<Eigen::Index> m_nonlinear{};
+};
+
+/// Compares the values at the traced point
+inline auto operator==(const LinearityTracer &left,
+                       const LinearityTracer &right) -> bool
+{
+    return left.value() == right.value();
+}
+
+/// Compares the values at the traced point
+inline auto operator!=(const LinearityTracer &left,
+                       const LinearityTracer &right) -> bool
+{
+    return left.value() != right.value();
+}
+
+/// Compares the values at the traced point
+inline auto operator<(const LinearityTracer &left, const LinearityTracer &right)
+    -> bool
+{
+    return left.value() < right.value();
+}
+
+/// Compares the values at the traced point
+inline auto operator>(const LinearityTracer &left, const LinearityTracer &right)
+    -> bool
+{
+    return left.value() > right.value();
+}
+
+/// Compares the values at the traced point
+inline auto operator<=(const LinearityTracer &left,
+                       const LinearityTracer &right) -> bool
+{
+    return left.value() <= right.value();
+}
+
+/// Compares the values at the traced point
+inline auto operator>=(const LinearityTracer &left,
+                       const LinearityTracer &right) -> bool
+{
+    return left.value() >= right.value();
+}
+
+/// Adds two values
+inline auto operator+(LinearityTracer left, const LinearityTracer &right)
+    -> LinearityTracer
+{
+    return left += right;
+}
+
+/// Adds a constant
+inline auto operator+(LinearityTracer num, double n) -> LinearityTracer
+{
+    return num += n;
+}
+
+/// Adds a constant
+inline auto operator+(double n, LinearityTracer num) -> LinearityTracer
+{
+    return num += n;
+}
+
+/// Subtracts two values
+inline auto operator-(LinearityTracer left, const LinearityTracer &right)
+    -> LinearityTracer
+{
+    return left -= right;
+}
+
+/// Subtracts a constant
+inline auto operator-(LinearityTracer num, double n) -> LinearityTracer
+{
+    return num -= n;
+}
+
+/// Subtracts from a constant
+inline auto operator-(double n, const LinearityTracer &num) -> LinearityTracer
+{
+    return -num + n;
+}
+
+/// Multiplies two values
+inline auto operator*(LinearityTracer left, const LinearityTracer &right)
+    -> LinearityTracer
+{
+    return left *= right;
+}
+
+/// Multiplies by a constant
+inline auto operator*(LinearityTracer num, double scalar) -> LinearityTracer
+{
+    return num *= scalar;
+}
+
+/// Multiplies by a constant
+inline auto operator*(double scalar, LinearityTracer num) -> LinearityTracer
+{
+    return num *= scalar;
+}
+
+/// Divides two values
+inline auto operator/(LinearityTracer left, const LinearityTracer &right)
+    -> LinearityTracer
+{
+    return left /= right;
+}
+
+/// Divides by a constant
+inline auto operator/(LinearityTracer num, double scalar) -> LinearityTracer
+{
+    return num /= scalar;
+}
+
+/// Divides a constant
+inline auto operator/(double scalar, const LinearityTracer &num)
+    -> LinearityTracer
+{
+    return num.nonlinear_function(scalar / num.value());
+}
+
+/**
+ * \brief Raises a value to a constant power; affine only for the exponents 0
+ * and 1
+ *
+ * \param num The base
+ * \param exponent The exponent
+ * \return The power
+ */
+auto pow(const LinearityTracer &num, double exponent) -> LinearityTracer;
+
+/**
+ * \brief Raises a value to the power of another
+ *
+ * \param num The base
+ * \param exponent The exponent
+ * \return The power
+ */
+auto pow(const LinearityTracer &num, const LinearityTracer &exponent)
+    -> LinearityTracer;
+
+/// Returns |num|
+auto abs(const LinearityTracer &num) -> LinearityTracer;
+
+/// Returns num * num
+auto abs2(const LinearityTracer &num) -> LinearityTracer;
+
+/// Returns the square root of num
+auto sqrt(const LinearityTracer &num) -> LinearityTracer;
+
+/// Returns e^num
+auto exp(const LinearityTracer &num) -> LinearityTracer;
+
+/// Returns 2^num
+auto exp2(const LinearityTracer &num) -> LinearityTracer;
+
+/// Returns the natural logarithm of num
+auto log(const LinearityTracer &num) -> LinearityTracer;
+
+/// Returns the base 2 logarithm of num
+auto log2(const LinearityTracer &num) -> LinearityTracer;
+
+/// Returns the base 10 logarithm of num
+auto log10(const LinearityTracer &num) -> LinearityTracer;
+
+/// Returns the sine of num
+auto sin(const LinearityTracer &num) -> LinearityTracer;
+
+/// Returns the cosine of num
+auto cos(const LinearityTracer &num) -> LinearityTracer;
+
+/// Returns the tangent of num
+auto tan(const LinearityTracer &num) -> LinearityTracer;
+
+/// Returns the inverse sine of num
+auto asin(const LinearityTracer &num) -> LinearityTracer;
+
+/// Returns the inverse cosine of num
+auto acos(const LinearityTracer &num) -> LinearityTracer;
+
+/// Returns the inverse tangent of num
+auto atan(const LinearityTracer &num) -> LinearityTracer;
+
+/// Returns the hyperbolic sine of num
+auto sinh(const LinearityTracer &num) -> LinearityTracer;
+
+/// Returns the hyperbolic cosine of num
+auto cosh(const LinearityTracer &num) -> LinearityTracer;
+
+/// Returns the hyperbolic tangent of num
+auto tanh(const LinearityTracer &num) -> LinearityTracer;
+
+/// Returns the inverse hyperbolic sine of num
+auto asinh(const LinearityTracer &num) -> LinearityTracer;
+
+/// Returns the inverse hyperbolic cosine of num
+auto acosh(const LinearityTracer &num) -> LinearityTracer;
+
+/// Returns the inverse hyperbolic tangent of num
+auto atanh(const LinearityTracer &num) -> LinearityTracer;
+
+} // namespace algodiff::forward
+
+namespace Eigen
+{
+template <>
+struct NumTraits<algodiff::forward::LinearityTracer> : NumTraits<double> {
+    typedef algodiff::forward::LinearityTracer Real;       // NOLINT
+    typedef algodiff::forward::LinearityTracer NonInteger; // NOLINT
+    typedef algodiff::forward::LinearityTracer Nested;     // NOLINT
+
+    enum {
+        IsComplex = 0,             // NOLINT
+        IsInteger = 0,             // NOLINT
+        IsSigned = 1,              // NOLINT
+        RequireInitialization = 1, // NOLINT
+        ReadCost = 1,              // NOLINT
+        AddCost = 8,               // NOLINT
+        MulCost = 8,               // NOLINT
+    };
+};
+
+template <typename BinaryOp>
+struct ScalarBinaryOpTraits<algodiff::forward::LinearityTracer, double,
+                            BinaryOp> {
+    typedef algodiff::forward::LinearityTracer ReturnType; // NOLINT
+};
+
+template <typename BinaryOp>
+struct ScalarBinaryOpTraits<double, algodiff::forward::LinearityTracer,
+                            BinaryOp> {
+    typedef algodiff::forward::LinearityTracer ReturnType; // NOLINT
+};
+
+} // namespace Eigen
@@ -0,0 +1,138 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+/// \file mapped_file.hpp
+/// \brief A memory-mapped file used by the batch drivers
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace algodiff
+{
+/**
+ * \brief An owning, move-only mapping of a whole file into memory
+ *
+ * \note Requires a POSIX system
+ */
+class MappedFile
+{
+public:
+    /// How the file is opened and mapped
+    enum class Mode {
+        /// Map an existing file read-only
+        ReadOnly,
+        /// Map a file read-write, creating it if needed; changes are written
+        /// back to the file
+        ReadWrite
+    };
+
+    /// Creates an empty mapping
+    MappedFile() = default;
+
+    /**
+     * \brief Maps the file at path
+     *
+     * \throws std::system_error if the file cannot be opened, resized or
+     * mapped
+     *
+     * \param path The file to map
+     * \param mode How to open the file
+     * \param size For ReadWrite, the size to resize the file to before
+     * mapping; ignored for ReadOnly
+     */
+    MappedFile(const std::string &path, Mode mode, std::size_t size = 0);
+
+    /**
+     * \brief Creates a zero-filled read-write mapping that is not backed by a
+     * file and stays shared with child processes created by fork
+     *
+     * \throws std::system_error if the memory cannot be mapped
+     *
+     * \param size The size of the mapping in bytes
+     * \return The mapping
+     */
+    static auto shared_memory(std::size_t size) -> MappedFile;
+
+    MappedFile(const MappedFile &) = delete;
+    auto operator=(const MappedFile &) -> MappedFile & = delete;
+
+    /**
+     * \brief Takes over the mapping of other, leaving it empty
+     *
+     * \param other The mapping to move from
+     */
+    MappedFile(MappedFile &&other) noexcept;
+
+    /**
+     * \brief Releases the current mapping and takes over the one of other
+     *
+     * \param other The mapping to move from
+     * \return *this
+     */
+    auto operator=(MappedFile &&other) noexcept -> MappedFile &;
+
+    /// Unmaps the file
+    ~MappedFile();
+
+    /**
+     * \brief Returns the start of the mapping
+     *
+     * \return The start of the mapping, nullptr if empty
+     */
+    auto data() const -> std::byte *
+    {
+        return m_data;
+    }
+
+    /**
+     * \brief Returns the size of the mapping in bytes
+     *
+     * \return The size of the mapping in bytes
+     */
+    auto size() const -> std::size_t
+    {
+        return m_size;
+    }
+
+    /**
+     * \brief Hints that the mapping will be read front to back so the kernel
+     * can read ahead aggressively and drop pages behind
+     */
+    auto advise_sequential() const -> void;
+
+    /**
+     * \brief Blocks until the bytes [offset, offset + length) are written to
+     * the file
+     *
+     * \throws std::system_error if the write back fails
+     *
+     * \param offset The first byte to write back
+     * \param length The number of bytes to write back
+     */
+    auto sync(std::size_t offset, std::size_t length) const -> void;
+
+    /**
+     * \brief Blocks until the whole mapping is written to the file
+     *
+     * \throws std::system_error if the write back fails
+     */
+    auto sync() const -> void
+    {
+        sync(0, m_size);
+    }
+
+private:
+    MappedFile(std::byte *data, std::size_t size) : m_data{data}, m_size{size}
+    {
+    }
+
+    /// The start of the mapping
+    std::byte *m_data{nullptr};
+
+    /// The size of the mapping in bytes
+    std::size_t m_size{0};
+};
+
+} // namespace algodiff
@@ -0,0 +1,240 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+/// \file model_registry.hpp
+/// \brief Named models that evaluate a function and its jacobian, as served by
+/// the gradient service
+#pragma once
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include "forward_mode.hpp"
+#include "tape.hpp"
+
+namespace algodiff
+{
+/**
+ * \brief A function from R^input_size to R^output_size together with its
+ * jacobian
+ *
+ * evaluate(x, value, jacobian) reads input_size doubles from x and writes
+ * output_size doubles to value and the output_size x input_size jacobian in
+ * column-major order to jacobian. The output pointers may point into shared
+ * memory, so implementations should write the results in place rather than
+ * build them elsewhere and copy. jvp(x, v, value, jv) optionally computes the
+ * value and the jacobian times the direction v without forming the jacobian.
+ *
+ * evaluate and jvp may be called from several threads, so a model that needs
+ * scratch storage allocates it per call. with_workspace optionally returns a
+ * copy of the model for a single thread whose functions keep that storage
+ * between calls instead.
+ */
+struct Model {
+    /// The dimension of the input
+    Eigen::Index input_size{0};
+
+    /// The dimension of the output
+    Eigen::Index output_size{0};
+
+    /// Whether evaluate may be called from several threads at once
+    bool thread_safe{true};
+
+    /// Evaluates the function and its jacobian
+    std::function<void(const double *x, double *value, double *jacobian)>
+        evaluate{};
+
+    /// Evaluates the function and a jacobian-vector product; may be empty
+    std::function<void(const double *x, const double *v, double *value,
+                       double *jv)>
+        jvp{};
+
+    /// Returns a copy that reuses its scratch storage across calls and is
+    /// not thread_safe; may be empty
+    std::function<Model()> with_workspace{};
+};
+
+/**
+ * \brief A thread-safe collection of models looked up by name
+ */
+class ModelRegistry
+{
+public:
+    /**
+     * \brief Registers a model under a name
+     *
+     * \throws std::invalid_argument if the name is empty or taken, or if the
+     * model has no evaluate function
+     *
+     * \param name The name clients request the model by
+     * \param model The model
+     */
+    auto add(const std::string &name, Model model) -> void;
+
+    /**
+     * \brief Returns the model registered under a name
+     *
+     * \param name The name of the model
+     * \return The model, or nullptr if there is none with that name
+     */
+    auto find(const std::string &name) const -> std::shared_ptr<const Model>;
+
+    /**
+     * \brief Returns the names of all registered models
+     *
+     * \return The names in lexicographic order
+     */
+    auto names() const -> std::vector<std::string>;
+
+private:
+    mutable std::mutex m_mutex{};
+    std::map<std::string, std::shared_ptr<const Model>> m_models{};
+};
+
+namespace forward
+{
+namespace internal
+{
+/// The dual numbers a forward model is evaluated with
+struct ModelScratch {
+    Eigen::VectorX<DualNumber> x;
+    Eigen::VectorX<DualNumber> y;
+};
+
+template <int FunctionSize, class F>
+auto evaluate_model(const F &f, ModelScratch &scratch, const double *x,
+                    double *value, double *jacobian) -> void
+{
+    const auto input_size{scratch.x.size()};
+    for (Eigen::Index i = 0; i < input_size; ++i) {
+        scratch.x[i] = DualNumber{x[i], 0.0};
+    }
+    Eigen::Map<Eigen::Matrix<double, FunctionSize, Eigen::Dynamic>> jac(
+        jacobian, FunctionSize, input_size);
+
+    // The primal part is the same on every pass, so it is taken from the
+    // first one instead of spending an extra evaluation on it
+    if (input_size == 0) {
+        scratch.y = f(scratch.x);
+        for (int j = 0; j < FunctionSize; ++j) {
+            value[j] = scratch.y[j].primal();
+        }
+        return;
+    }
+    for (Eigen::Index i = 0; i < input_size; ++i) {
+        scratch.x[i].dual() = 1.0;
+        scratch.y = f(scratch.x);
+        for (int j = 0; j < FunctionSize; ++j) {
+            jac(j, i) = scratch.y[j].dual();
+        }
+        if (i == 0) {
+            for (int j = 0; j < FunctionSize; ++j) {
+                value[j] = scratch.y[j].primal();
+            }
+        }
+        scratch.x[i].dual() = 0.0;
+    }
+}
+
+template <int FunctionSize, class F>
+auto evaluate_model_jvp(const F &f, ModelScratch &scratch, const double *x,
+                        const double *v, double *value, double *jv) -> void
+{
+    for (Eigen::Index i = 0; i < scratch.x.size(); ++i) {
+        scratch.x[i] = DualNumber{x[i], v[i]};
+    }
+    scratch.y = f(scratch.x);
+    for (int j = 0; j < FunctionSize; ++j) {
+        value[j] = scratch.y[j].primal();
+        jv[j] = scratch.y[j].dual();
+    }
+}
+
+} // namespace internal
+
+/**
+ * \brief Wraps a function of dual numbers as a model whose jacobian is
+ * computed in forward mode
+ *
+ * f is copied into the model and evaluated concurrently from several threads,
+ * so it must not modify shared state. The copy returned by with_workspace
+ * evaluates f on the same dual numbers every call, so it allocates nothing
+ * beyond what f itself does; a fixed-size return type avoids that too.
+ *
+ * \tparam FunctionSize The dimension of the output of f
+ * \tparam F Function Type that takes as input a Eigen::VectorX<DualNumber> and
+ * outputs a vector of DualNumbers of size FunctionSize
+ * \param f The function
+ * \param input_size The dimension of the input of f
+ * \return The model
+ */
+template <int FunctionSize, class F>
+auto make_model(F f, Eigen::Index input_size) -> Model
+{
+    auto scratch = [input_size] {
+        return internal::ModelScratch{Eigen::VectorX<DualNumber>(input_size),
+                                      Eigen::VectorX<DualNumber>(FunctionSize)};
+    };
+
+    Model model{};
+    model.input_size = input_size;
+    model.output_size = FunctionSize;
+    model.evaluate = [f, scratch](const double *x, double *value,
+                                  double *jacobian) {
+        auto local{scratch()};
+        internal::evaluate_model<FunctionSize>(f, local, x, value, jacobian);
+    };
+    model.jvp = [f, scratch](const double *x, const double *v, double *value,
+                             double *jv) {
+        auto local{scratch()};
+        internal::evaluate_model_jvp<FunctionSize>(f, local, x, v, value, jv);
+    };
+    model.with_workspace = [f = std::move(f), scratch, input_size] {
+        auto shared{std::make_shared<internal::ModelScratch>(scratch())};
+        Model bound{};
+        bound.input_size = input_size;
+        bound.output_size = FunctionSize;
+        bound.thread_safe = false;
+        bound.evaluate = [f, shared](const double *x, double *value,
+                                     double *jacobian) {
+            internal::evaluate_model<FunctionSize>(f, *shared, x, value,
+                                                   jacobian);
+        };
+        bound.jvp = [f, shared](const double *x, const double *v,
+                                double *value, double *jv) {
+            internal::evaluate_model_jvp<FunctionSize>(f, *shared, x, v, value,
+                                                       jv);
+        };
+        return bound;
+    };
+    return model;
+}
+
+} // namespace forward
+
+namespace reverse
+{
+/**
+ * \brief Wraps a recorded tape as a model that replays it at new inputs
+ *
+ * A tape holds its values, so calls on the model are serialized and the model
+ * is not thread_safe. Calls reuse the values of the tape and one set of
+ * adjoints, so they only allocate for external functions on the tape.
+ *
+ * \throws std::invalid_argument if tape is null
+ *
+ * \param tape A tape with registered inputs and outputs
+ * \return The model
+ */
+auto make_tape_model(std::shared_ptr<Tape> tape) -> Model;
+
+} // namespace reverse
+
+} // namespace algodiff
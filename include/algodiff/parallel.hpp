@@ -0,0 +1,93 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+/// \file parallel.hpp
+/// \brief Small threading helpers shared by the parallel drivers
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace algodiff::internal
+{
+/**
+ * \brief Returns the number of worker threads to use
+ *
+ * \param requested The requested number of threads, 0 for one per hardware
+ * thread
+ * \return The number of threads, at least 1
+ */
+inline auto thread_count(unsigned requested) -> unsigned
+{
+    if (requested != 0) {
+        return requested;
+    }
+    return std::max(1U, std::thread::hardware_concurrency());
+}
+
+/**
+ * \brief Calls fn(i) for every i in [0, count) on up to threads threads
+ *
+ * Indices are handed out in increasing order from a shared counter, so work
+ * that touches memory in index order stays close to sequential. The first
+ * exception thrown by fn stops the hand out of further indices and is rethrown
+ * once every thread has finished.
+ *
+ * \tparam Fn Callable invoked as fn(std::int64_t index)
+ * \param count The number of indices
+ * \param threads The number of threads, 0 for one per hardware thread
+ * \param fn The work for one index
+ */
+template <class Fn>
+auto parallel_for(std::int64_t count, unsigned threads, Fn &&fn) -> void
+{
+    const auto workers{static_cast<std::int64_t>(
+        std::min<std::int64_t>(thread_count(threads), count))};
+    if (workers <= 1) {
+        for (std::int64_t i = 0; i < count; ++i) {
+            fn(i);
+        }
+        return;
+    }
+
+    std::atomic<std::int64_t> next{0};
+    std::atomic<bool> failed{false};
+    std::exception_ptr error{};
+    std::mutex error_mutex{};
+
+    auto work = [&] {
+        for (auto i = next++; i < count && !failed; i = next++) {
+            try {
+                fn(i);
+            } catch (...) {
+                const std::lock_guard<std::mutex> lock{error_mutex};
+                if (!error) {
+                    error = std::current_exception();
+                }
+                failed = true;
+            }
+        }
+    };
+
+    std::vector<std::thread> pool{};
+    pool.reserve(static_cast<size_t>(workers - 1));
+    for (std::int64_t t = 1; t < workers; ++t) {
+        pool.emplace_back(work);
+    }
+    work();
+    for (auto &thread : pool) {
+        thread.join();
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+} // namespace algodiff::internal
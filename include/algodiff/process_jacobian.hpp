@@ -0,0 +1,122 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+/// \file process_jacobian.hpp
+/// \brief Computes jacobians of non-reentrant functions on several worker
+/// processes that write into shared memory
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+
+#include <Eigen/Core>
+
+#include "forward_mode.hpp"
+#include "mapped_file.hpp"
+#include "parallel.hpp"
+
+namespace algodiff::forward
+{
+/// Options of process_jacobian
+struct ProcessJacobianOptions {
+    /// The number of worker processes, 0 for one per hardware thread
+    unsigned processes{0};
+
+    /// The number of columns per shard, 0 to pick four shards per process
+    Eigen::Index shard_columns{0};
+
+    /// The number of times a shard is started before giving up
+    int max_attempts{3};
+};
+
+namespace internal
+{
+/**
+ * \brief Runs work(shard) for every shard in a forked child process, keeping
+ * up to processes children alive at a time
+ *
+ * A shard succeeds when its child calls work without throwing and exits
+ * normally. Failed shards (an exception, a non-zero exit or a crash) are
+ * queued again until they have been started max_attempts times.
+ *
+ * \note Requires a POSIX system. Children end with _Exit, so they neither
+ * flush stdio nor run exit handlers of the parent
+ *
+ * \throws std::system_error if a process cannot be created
+ * \throws std::runtime_error if a shard fails max_attempts times
+ *
+ * \param shards The number of shards
+ * \param processes The maximum number of concurrent children
+ * \param max_attempts The number of times a shard is started
+ * \param work The work of one shard, run in the child
+ */
+auto run_process_shards(std::int64_t shards, unsigned processes,
+                        int max_attempts,
+                        const std::function<void(std::int64_t)> &work)
+    -> void;
+
+} // namespace internal
+
+/**
+ * \brief Returns the jacobian of f at u, computing ranges of columns in
+ * forked worker processes
+ *
+ * Each worker gets its own copy of the address space, so functions that
+ * mutate global state (and are therefore unsafe to run on threads) scale
+ * across cores. Workers write their columns straight into an anonymous
+ * shared mapping; the parent only copies the finished matrix out of it.
+ * Shards whose worker crashes or throws are re-dispatched.
+ *
+ * \note Requires a POSIX system. Call it before starting other threads: only
+ * the calling thread exists in the workers
+ *
+ * \throws std::system_error if the shared memory or a worker cannot be
+ * created
+ * \throws std::runtime_error if a shard fails options.max_attempts times
+ *
+ * \tparam FunctionSize The dimension of the output of f
+ * \tparam F Function Type that takes as input a Eigen::VectorX<DualNumber> and
+ * outputs a vector of DualNumbers of size FunctionSize
+ * \param f The function to take the jacobian of
+ * \param u The point to evaluate the jacobian at
+ * \param options The number of processes, shard size and retry limit
+ * \return The jacobian of f at u
+ */
+template <int FunctionSize, class F>
+auto process_jacobian(F &&f, const Eigen::VectorXd &u,
+                      const ProcessJacobianOptions &options = {})
+    -> Eigen::MatrixXd
+{
+    const auto cols{u.size()};
+    const auto processes{algodiff::internal::thread_count(options.processes)};
+    auto shard_columns{options.shard_columns};
+    if (shard_columns <= 0) {
+        const auto shards{static_cast<Eigen::Index>(4 * processes)};
+        shard_columns = std::max<Eigen::Index>(1, (cols + shards - 1) / shards);
+    }
+    const auto shards{(cols + shard_columns - 1) / shard_columns};
+
+    const auto bytes{static_cast<std::size_t>(FunctionSize * cols) *
+                     sizeof(double)};
+    const MappedFile shared{MappedFile::shared_memory(bytes)};
+    auto *output{reinterpret_cast<double *>(shared.data())}; // NOLINT
+
+    internal::run_process_shards(
+        shards, processes, options.max_attempts, [&](std::int64_t shard) {
+            const auto begin{shard * shard_columns};
+            const auto end{std::min(cols, begin + shard_columns)};
+            for_each_jacobian_column<FunctionSize>(
+                f, u, begin, end,
+                [&](Eigen::Index col, const Eigen::VectorXd &c) {
+                    std::memcpy(output + col * FunctionSize, c.data(),
+                                FunctionSize * sizeof(double));
+                });
+        });
+
+    return Eigen::Map<const Eigen::MatrixXd>(output, FunctionSize, cols);
+}
+
+} // namespace algodiff::forward
@@ -0,0 +1,303 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+/// \file randomized_sketch.hpp
+/// \brief Estimates the range, trace and diagonal of a jacobian or hessian
+/// from a few jacobian-vector products
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <utility>
+
+#include <Eigen/Core>
+
+#include "dual_number.hpp"
+#include "dual_number_eigen.hpp"
+#include "forward_mode.hpp"
+
+namespace algodiff::forward
+{
+namespace internal
+{
+/**
+ * \brief Returns a matrix of independent random signs
+ *
+ * \param rows The number of rows
+ * \param cols The number of columns
+ * \param rng The random number generator
+ * \return The matrix
+ */
+auto rademacher(Eigen::Index rows, Eigen::Index cols, std::mt19937_64 &rng)
+    -> Eigen::MatrixXd;
+
+/**
+ * \brief Returns a matrix of independent standard normal entries
+ *
+ * \param rows The number of rows
+ * \param cols The number of columns
+ * \param rng The random number generator
+ * \return The matrix
+ */
+auto gaussian(Eigen::Index rows, Eigen::Index cols, std::mt19937_64 &rng)
+    -> Eigen::MatrixXd;
+
+/**
+ * \brief Returns an orthonormal basis of the column space of a matrix
+ *
+ * \param y A matrix with no more columns than rows
+ * \return The thin Q factor of y
+ */
+auto orthonormalize(const Eigen::MatrixXd &y) -> Eigen::MatrixXd;
+
+/**
+ * \brief Throws unless a function maps R^n to R^n
+ *
+ * \throws std::invalid_argument if the sizes differ
+ *
+ * \param function_size The number of outputs
+ * \param input_size The number of inputs
+ */
+auto require_square(Eigen::Index function_size, Eigen::Index input_size)
+    -> void;
+
+} // namespace internal
+
+/**
+ * \brief Returns the jacobian of f at u times a matrix of directions
+ *
+ * Each column costs one forward pass seeded with that column, so this is the
+ * k-pass building block of the randomized estimators below.
+ *
+ * \throws std::invalid_argument if directions does not have one row per input
+ *
+ * \tparam FunctionSize The dimension of the output of f
+ * \tparam F Function Type that takes as input a Eigen::VectorX<DualNumber> and
+ * outputs a vector of DualNumbers of size FunctionSize
+ * \param f A multidimensional function that maps u (in dual number
+ * representation) to the output space
+ * \param u A vector of inputs that f will be evaluated at
+ * \param directions The n x k matrix of directions
+ * \return The FunctionSize x k product
+ */
+template <int FunctionSize, class F>
+auto jacobian_sketch(F &&f, const Eigen::VectorXd &u,
+                     const Eigen::MatrixXd &directions) -> Eigen::MatrixXd
+{
+    if (directions.rows() != u.size()) {
+        throw std::invalid_argument("Expected one direction entry per input");
+    }
+
+    Eigen::MatrixXd sketch(FunctionSize, directions.cols());
+    Eigen::VectorX<DualNumber> dual_numbers(u.size());
+    for (Eigen::Index j = 0; j < directions.cols(); ++j) {
+        for (Eigen::Index i = 0; i < u.size(); ++i) {
+            dual_numbers[i] = DualNumber{u[i], directions(i, j)};
+        }
+        const Eigen::VectorX<DualNumber> result{f(dual_numbers)};
+        for (Eigen::Index row = 0; row < FunctionSize; ++row) {
+            sketch(row, j) = result[row].dual();
+        }
+    }
+    return sketch;
+}
+
+/**
+ * \brief Returns an orthonormal basis that approximately spans the dominant
+ * left singular subspace of the jacobian of f at u
+ *
+ * This is the randomized range finder of Halko, Martinsson and Tropp,
+ * "Finding structure with randomness", SIAM Review 53(2), 2011, algorithm
+ * 4.1: the jacobian is applied to rank + oversampling gaussian directions and
+ * the products are orthonormalized.
+ *
+ * \tparam FunctionSize The dimension of the output of f
+ * \tparam F Function Type that takes as input a Eigen::VectorX<DualNumber> and
+ * outputs a vector of DualNumbers of size FunctionSize
+ * \param f A multidimensional function that maps u (in dual number
+ * representation) to the output space
+ * \param u A vector of inputs that f will be evaluated at
+ * \param rank The dimension of the subspace of interest
+ * \param oversampling The number of extra directions
+ * \param seed The seed of the random directions
+ * \return A FunctionSize x min(rank + oversampling, FunctionSize, n) matrix
+ * with orthonormal columns
+ */
+template <int FunctionSize, class F>
+auto randomized_range(F &&f, const Eigen::VectorXd &u, Eigen::Index rank,
+                      Eigen::Index oversampling = 5, std::uint64_t seed = 0)
+    -> Eigen::MatrixXd
+{
+    std::mt19937_64 rng{seed};
+    const auto k{std::min(rank + oversampling,
+                          std::min<Eigen::Index>(FunctionSize, u.size()))};
+    return internal::orthonormalize(jacobian_sketch<FunctionSize>(
+        std::forward<F>(f), u, internal::gaussian(u.size(), k, rng)));
+}
+
+/**
+ * \brief Estimates the trace of the jacobian of f at u with Hutchinson's
+ * estimator
+ *
+ * The estimate is the mean of w^T J w over probes random sign vectors w. It
+ * is unbiased, with a standard deviation that falls as 1 / sqrt(probes). For
+ * the trace of a hessian, pass the gradient of the function as f.
+ *
+ * \throws std::invalid_argument if f does not map R^n to R^n or probes is not
+ * positive
+ *
+ * \tparam FunctionSize The dimension of the output of f
+ * \tparam F Function Type that takes as input a Eigen::VectorX<DualNumber> and
+ * outputs a vector of DualNumbers of size FunctionSize
+ * \param f A function from R^n to R^n (in dual number representation)
+ * \param u A vector of inputs that f will be evaluated at
+ * \param probes The number of forward passes
+ * \param seed The seed of the random probes
+ * \return The estimated trace
+ */
+template <int FunctionSize, class F>
+auto hutchinson_trace(F &&f, const Eigen::VectorXd &u, Eigen::Index probes,
+                      std::uint64_t seed = 0) -> double
+{
+    internal::require_square(FunctionSize, u.size());
+    if (probes < 1) {
+        throw std::invalid_argument("Expected at least one probe");
+    }
+
+    std::mt19937_64 rng{seed};
+    const Eigen::MatrixXd w{internal::rademacher(u.size(), probes, rng)};
+    const Eigen::MatrixXd jw{
+        jacobian_sketch<FunctionSize>(std::forward<F>(f), u, w)};
+    return w.cwiseProduct(jw).sum() / static_cast<double>(probes);
+}
+
+/**
+ * \brief Estimates the trace of the jacobian of f at u with Hutch++
+ *
+ * A third of the forward passes finds the dominant subspace, whose
+ * contribution to the trace is computed exactly with another third; the last
+ * third runs Hutchinson's estimator on the remainder. For matrices with a
+ * decaying spectrum the error falls as 1 / probes instead of 1 /
+ * sqrt(probes). See Meyer, Musco, Musco and Woodruff, "Hutch++: Optimal
+ * Stochastic Trace Estimation", SOSA 2021. For the trace of a hessian, pass
+ * the gradient of the function as f.
+ *
+ * \throws std::invalid_argument if f does not map R^n to R^n or probes is
+ * less than 3
+ *
+ * \tparam FunctionSize The dimension of the output of f
+ * \tparam F Function Type that takes as input a Eigen::VectorX<DualNumber> and
+ * outputs a vector of DualNumbers of size FunctionSize
+ * \param f A function from R^n to R^n (in dual number representation)
+ * \param u A vector of inputs that f will be evaluated at
+ * \param probes The number of forward passes
+ * \param seed The seed of the random probes
+ * \return The estimated trace
+ */
+template <int FunctionSize, class F>
+auto hutchpp_trace(F &&f, const Eigen::VectorXd &u, Eigen::Index probes,
+                   std::uint64_t seed = 0) -> double
+{
+    internal::require_square(FunctionSize, u.size());
+    if (probes < 3) {
+        throw std::invalid_argument("Expected at least three probes");
+    }
+
+    std::mt19937_64 rng{seed};
+    const auto third{std::min(probes / 3, u.size())};
+    const auto remaining{probes - 2 * third};
+    const Eigen::MatrixXd s{internal::rademacher(u.size(), third, rng)};
+    const Eigen::MatrixXd q{
+        internal::orthonormalize(jacobian_sketch<FunctionSize>(f, u, s))};
+    const Eigen::MatrixXd jq{jacobian_sketch<FunctionSize>(f, u, q)};
+
+    // The probes of the remainder are projected away from the subspace, so
+    // the two contributions do not overlap
+    Eigen::MatrixXd g{internal::rademacher(u.size(), remaining, rng)};
+    g -= q * (q.transpose() * g);
+    const Eigen::MatrixXd jg{jacobian_sketch<FunctionSize>(f, u, g)};
+    return q.cwiseProduct(jq).sum() +
+           g.cwiseProduct(jg).sum() / static_cast<double>(remaining);
+}
+
+/**
+ * \brief Estimates the diagonal of the jacobian of f at u from random sign
+ * probes
+ *
+ * Entry i is the mean of w_i (J w)_i over the probes, which converges to
+ * J_ii as the contributions of the off-diagonal entries cancel out. See
+ * Bekas, Kokiopoulou and Saad, "An estimator for the diagonal of a matrix",
+ * Applied Numerical Mathematics 57(11), 2007. For the diagonal of a hessian,
+ * pass the gradient of the function as f.
+ *
+ * \throws std::invalid_argument if f does not map R^n to R^n or probes is not
+ * positive
+ *
+ * \tparam FunctionSize The dimension of the output of f
+ * \tparam F Function Type that takes as input a Eigen::VectorX<DualNumber> and
+ * outputs a vector of DualNumbers of size FunctionSize
+ * \param f A function from R^n to R^n (in dual number representation)
+ * \param u A vector of inputs that f will be evaluated at
+ * \param probes The number of forward passes
+ * \param seed The seed of the random probes
+ * \return The estimated diagonal
+ */
+template <int FunctionSize, class F>
+auto stochastic_diagonal(F &&f, const Eigen::VectorXd &u, Eigen::Index probes,
+                         std::uint64_t seed = 0) -> Eigen::VectorXd
+{
+    internal::require_square(FunctionSize, u.size());
+    if (probes < 1) {
+        throw std::invalid_argument("Expected at least one probe");
+    }
+
+    std::mt19937_64 rng{seed};
+    const Eigen::MatrixXd w{internal::rademacher(u.size(), probes, rng)};
+    const Eigen::MatrixXd jw{
+        jacobian_sketch<FunctionSize>(std::forward<F>(f), u, w)};
+    return w.cwiseProduct(jw).rowwise().sum() / static_cast<double>(probes);
+}
+
+/**
+ * \brief Returns the diagonal of a banded jacobian of f at u from period
+ * forward passes
+ *
+ * Probe c is the indicator of the inputs i with i % period == c, so the
+ * diagonal is exact whenever J_ij = 0 for 0 < |i - j| < period, and an
+ * approximation polluted only by the entries within that distance otherwise.
+ * For the diagonal of a hessian, pass the gradient of the function as f.
+ *
+ * \throws std::invalid_argument if f does not map R^n to R^n or period is not
+ * positive
+ *
+ * \tparam FunctionSize The dimension of the output of f
+ * \tparam F Function Type that takes as input a Eigen::VectorX<DualNumber> and
+ * outputs a vector of DualNumbers of size FunctionSize
+ * \param f A function from R^n to R^n (in dual number representation)
+ * \param u A vector of inputs that f will be evaluated at
+ * \param period The number of forward passes, one more than the bandwidth
+ * \return The diagonal
+ */
+template <int FunctionSize, class F>
+auto probing_diagonal(F &&f, const Eigen::VectorXd &u, Eigen::Index period)
+    -> Eigen::VectorXd
+{
+    internal::require_square(FunctionSize, u.size());
+    if (period < 1) {
+        throw std::invalid_argument("Expected a positive period");
+    }
+
+    const auto probes{std::min(period, u.size())};
+    Eigen::MatrixXd w{Eigen::MatrixXd::Zero(u.size(), probes)};
+    for (Eigen::Index i = 0; i < u.size(); ++i) {
+        w(i, i % probes) = 1.0;
+    }
+    const Eigen::MatrixXd jw{
+        jacobian_sketch<FunctionSize>(std::forward<F>(f), u, w)};
+    return w.cwiseProduct(jw).rowwise().sum();
+}
+
+} // namespace algodiff::forward
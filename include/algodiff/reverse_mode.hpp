@@ -0,0 +1,144 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+/// \file reverse_mode.hpp
+/// \brief Implements reverse mode auto-differentiation on top of the tape
+#pragma once
+
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "tape.hpp"
+#include "tape_eigen.hpp"
+#include "tape_ops.hpp"
+
+namespace algodiff::reverse
+{
+/**
+ * \brief Records f evaluated at u on a tape
+ *
+ * One independent variable is created per entry of u and every output of f
+ * is registered, so the tape can afterwards be replayed at other points and
+ * swept for gradients, jacobians or vector-jacobian products.
+ *
+ * \throws std::invalid_argument if tape is not empty
+ *
+ * \tparam F Function Type that takes as input a Eigen::VectorX<Variable> and
+ * outputs either a Variable or a Eigen::VectorX<Variable>
+ * \param tape An empty tape to record on
+ * \param f The function to record
+ * \param u The point to record f at
+ */
+template <class F>
+auto record(Tape &tape, F &&f, const Eigen::VectorXd &u) -> void
+{
+    if (tape.size() != 0) {
+        throw std::invalid_argument("Expected an empty tape");
+    }
+
+    Eigen::VectorX<Variable> x(u.size());
+    for (Eigen::Index i = 0; i < u.size(); ++i) {
+        x[i] = tape.variable(u[i]);
+    }
+
+    const auto y{f(x)};
+    if constexpr (std::is_convertible_v<decltype(y), Variable>) {
+        tape.register_output(y);
+    } else {
+        for (Eigen::Index i = 0; i < y.size(); ++i) {
+            tape.register_output(y[i]);
+        }
+    }
+}
+
+/**
+ * \brief Returns the gradient of f evaluated at u with a single reverse
+ * sweep
+ *
+ * \tparam F Function Type that takes as input a Eigen::VectorX<Variable> and
+ * outputs a Variable
+ * \param f The function to take the gradient of
+ * \param u The point to evaluate the gradient at
+ * \return The gradient of f at u
+ */
+template <class F>
+auto gradient(F &&f, const Eigen::VectorXd &u) -> Eigen::VectorXd
+{
+    Tape tape{};
+    record(tape, std::forward<F>(f), u);
+    return tape.vjp(Eigen::VectorXd::Ones(1));
+}
+
+/**
+ * \brief Returns the jacobian of f evaluated at u with one reverse sweep per
+ * output
+ *
+ * \tparam F Function Type that takes as input a Eigen::VectorX<Variable> and
+ * outputs a Eigen::VectorX<Variable>
+ * \param f The function to take the jacobian of
+ * \param u The point to evaluate the jacobian at
+ * \return The jacobian of f at u
+ */
+template <class F>
+auto jacobian(F &&f, const Eigen::VectorXd &u) -> Eigen::MatrixXd
+{
+    Tape tape{};
+    record(tape, std::forward<F>(f), u);
+    return tape.jacobian();
+}
+
+/**
+ * \brief Calls an external function on Variables, recording the call as one
+ * node per output
+ *
+ * Passive inputs are evaluated directly without recording anything.
+ *
+ * \throws std::invalid_argument if the inputs are on different tapes
+ *
+ * \param function The external function
+ * \param inputs The inputs of the call
+ * \return The outputs of the call
+ */
+inline auto call(const std::shared_ptr<const ExternalFunction> &function,
+                 const Eigen::VectorX<Variable> &inputs)
+    -> Eigen::VectorX<Variable>
+{
+    Tape *tape{nullptr};
+    std::vector<Variable> arguments(static_cast<size_t>(inputs.size()));
+    for (Eigen::Index i = 0; i < inputs.size(); ++i) {
+        arguments[static_cast<size_t>(i)] = inputs[i];
+        if (inputs[i].is_active()) {
+            if (tape != nullptr && tape != inputs[i].tape()) {
+                throw std::invalid_argument(
+                    "Variables are recorded on different tapes");
+            }
+            tape = inputs[i].tape();
+        }
+    }
+
+    Eigen::VectorX<Variable> outputs{};
+    if (tape == nullptr) {
+        Eigen::VectorXd x(inputs.size());
+        for (Eigen::Index i = 0; i < inputs.size(); ++i) {
+            x[i] = inputs[i].value();
+        }
+        const Eigen::VectorXd y{function->primal(x)};
+        outputs.resize(y.size());
+        for (Eigen::Index i = 0; i < y.size(); ++i) {
+            outputs[i] = Variable{y[i]};
+        }
+        return outputs;
+    }
+
+    const std::vector<Variable> recorded{tape->call(function, arguments)};
+    outputs.resize(static_cast<Eigen::Index>(recorded.size()));
+    for (size_t i = 0; i < recorded.size(); ++i) {
+        outputs[static_cast<Eigen::Index>(i)] = recorded[i];
+    }
+    return outputs;
+}
+
+} // namespace algodiff::reverse
@@ -0,0 +1,55 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+/// \file server_plugin.hpp
+/// \brief The entry point of shared libraries that provide models to
+/// algodiff_server and the C API, and the loader of such libraries
+#pragma once
+
+#include <string>
+
+#include "model_registry.hpp"
+
+/// The symbol load_plugin looks up in every plugin, for algodiff_server and
+/// algodiff_model_load_plugin alike
+#define ALGODIFF_PLUGIN_ENTRY_POINT "algodiff_register_models"
+
+namespace algodiff
+{
+/// The signature of the plugin entry point
+using RegisterModels = void (*)(ModelRegistry &registry);
+
+/**
+ * \brief Loads a plugin and registers its models
+ *
+ * The plugin stays loaded for the lifetime of the process, since the
+ * registry holds functions that live in it.
+ *
+ * \throws std::runtime_error if the library cannot be loaded or has no entry
+ * point
+ *
+ * \note Requires a POSIX system
+ *
+ * \param path The path of the shared library
+ * \param registry The registry the plugin adds its models to
+ */
+auto load_plugin(const std::string &path, ModelRegistry &registry) -> void;
+
+} // namespace algodiff
+
+/**
+ * \brief Defines the entry point of a plugin
+ *
+ * A plugin is a shared library built against algodiff that registers its
+ * models (forward::make_model or reverse::make_tape_model) in the body:
+ *
+ * \code
+ * ALGODIFF_PLUGIN(registry)
+ * {
+ *     registry.add("rosenbrock", algodiff::forward::make_model<1>(f, 2));
+ * }
+ * \endcode
+ */
+#define ALGODIFF_PLUGIN(registry)                                              \
+    extern "C" void algodiff_register_models(algodiff::ModelRegistry &registry)
@@ -0,0 +1,574 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+/// \file sparse_dual_number.hpp
+/// \brief Contains a dual number whose tangent is a sparse vector
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include <Eigen/Core>
+
+namespace algodiff::forward
+{
+/**
+ * \brief A sparse vector of derivatives stored as (index, value) entries
+ * sorted by index
+ *
+ * Up to inline_capacity entries are stored inside the object. Longer tangents
+ * move to a buffer taken from a per-thread pool of recycled blocks, so the
+ * steady state of a long computation performs no heap allocation.
+ */
+class SparseTangent
+{
+public:
+    /// One stored derivative
+    struct Entry {
+        /// The index of the input the derivative is taken with respect to
+        Eigen::Index index;
+
+        /// The derivative
+        double value;
+    };
+
+    /// The number of entries stored without an external buffer
+    static constexpr std::uint32_t inline_capacity{4};
+
+    /// Creates an empty tangent
+    SparseTangent() = default;
+
+    /**
+     * \brief Creates a tangent with a single entry
+     *
+     * \param index The index of the entry
+     * \param value The value of the entry
+     */
+    SparseTangent(Eigen::Index index, double value);
+
+    /**
+     * \brief Creates a tangent from a range of entries
+     *
+     * \param first The first entry
+     * \param last One past the last entry; the entries must be sorted by
+     * strictly increasing index
+     */
+    SparseTangent(const Entry *first, const Entry *last);
+
+    /**
+     * \brief Copies the entries of other
+     *
+     * \param other The tangent to copy
+     */
+    SparseTangent(const SparseTangent &other);
+
+    /**
+     * \brief Takes over the entries of other, leaving it empty
+     *
+     * \param other The tangent to move from
+     */
+    SparseTangent(SparseTangent &&other) noexcept;
+
+    /**
+     * \brief Replaces the entries with a copy of those of other
+     *
+     * \param other The tangent to copy
+     * \return *this
+     */
+    auto operator=(const SparseTangent &other) -> SparseTangent &;
+
+    /**
+     * \brief Replaces the entries with those of other, leaving it empty
+     *
+     * \param other The tangent to move from
+     * \return *this
+     */
+    auto operator=(SparseTangent &&other) noexcept -> SparseTangent &;
+
+    /// Returns the external buffer, if any, to the pool
+    ~SparseTangent();
+
+    /**
+     * \brief Returns the number of stored entries
+     *
+     * \return The number of stored entries
+     */
+    auto size() const -> std::size_t
+    {
+        return m_size;
+    }
+
+    /**
+     * \brief Returns true if there are no stored entries
+     *
+     * \return true if there are no stored entries
+     */
+    auto empty() const -> bool
+    {
+        return m_size == 0;
+    }
+
+    /**
+     * \brief Returns the first entry
+     *
+     * \return A pointer to the first entry
+     */
+    auto begin() const -> const Entry *
+    {
+        return data();
+    }
+
+    /**
+     * \brief Returns one past the last entry
+     *
+     * \return A pointer one past the last entry
+     */
+    auto end() const -> const Entry *
+    {
+        return data() + m_size;
+    }
+
+    /**
+     * \brief Returns the derivative with respect to input index
+     *
+     * \param index The input index
+     * \return The stored value, or zero if index is not stored
+     */
+    auto coeff(Eigen::Index index) const -> double;
+
+    /**
+     * \brief Removes every entry
+     */
+    auto clear() -> void
+    {
+        m_size = 0;
+    }
+
+    /**
+     * \brief Multiplies every entry by scalar
+     *
+     * \param scalar The scalar
+     */
+    auto scale(double scalar) -> void;
+
+    /**
+     * \brief Returns a * x + b * y, merging the two index sets
+     *
+     * \param a The scale of x
+     * \param x The first tangent
+     * \param b The scale of y
+     * \param y The second tangent
+     * \return The linear combination of the tangents
+     */
+    static auto combine(double a, const SparseTangent &x, double b,
+                        const SparseTangent &y) -> SparseTangent;
+
+private:
+    auto data() -> Entry *
+    {
+        return m_heap != nullptr ? m_heap : m_inline.data();
+    }
+    auto data() const -> const Entry *
+    {
+        return m_heap != nullptr ? m_heap : m_inline.data();
+    }
+
+    /// Makes room for at least capacity entries, discarding the contents
+    auto reset_capacity(std::uint32_t capacity) -> void;
+
+    /// The inline entries, used while m_heap is null
+    std::array<Entry, inline_capacity> m_inline{};
+
+    /// The external buffer, or nullptr
+    Entry *m_heap{nullptr};
+
+    /// The number of stored entries
+    std::uint32_t m_size{0};
+
+    /// The number of entries the current storage can hold
+    std::uint32_t m_capacity{inline_capacity};
+};
+
+/**
+ * \brief A dual number whose dual component is a sparse gradient
+ *
+ * Each intermediate value carries the derivatives with respect to only the
+ * inputs it depends on, so a whole sparse gradient (or jacobian) is obtained
+ * in a single evaluation, at a cost proportional to the number of non-zero
+ * derivatives rather than to the number of inputs.
+ */
+class SparseDualNumber
+{
+public:
+    /// The default constructor
+    SparseDualNumber() = default;
+
+    /**
+     * \brief Creates a SparseDualNumber with the specified primal component
+     * and no derivatives
+     *
+     * \param primal The primal component
+     */
+    explicit SparseDualNumber(double primal) : m_primal{primal}
+    {
+    }
+
+    /**
+     * \brief Creates a SparseDualNumber with the specified primal component
+     * and tangent
+     *
+     * \param primal The primal component
+     * \param tangent The derivatives
+     */
+    SparseDualNumber(double primal, SparseTangent tangent)
+        : m_primal{primal}, m_tangent{std::move(tangent)}
+    {
+    }
+
+    /**
+     * \brief Creates the independent variable for input index
+     *
+     * \param primal The value of the input
+     * \param index The index of the input
+     * \return A SparseDualNumber whose tangent is the unit vector of index
+     */
+    static auto variable(double primal, Eigen::Index index) -> SparseDualNumber
+    {
+        return SparseDualNumber{primal, SparseTangent{index, 1.0}};
+    }
+
+    /**
+     * \brief Returns a mutable reference to the primal component
+     *
+     * \return The primal component
+     */
+    auto primal() -> double &
+    {
+        return m_primal;
+    }
+
+    /**
+     * \brief Returns a copy of the primal component
+     *
+     * \return The primal component
+     */
+    auto primal() const -> double
+    {
+        return m_primal;
+    }
+
+    /**
+     * \brief Returns a mutable reference to the derivatives
+     *
+     * \return The derivatives
+     */
+    auto tangent() -> SparseTangent &
+    {
+        return m_tangent;
+    }
+
+    /**
+     * \brief Returns the derivatives
+     *
+     * \return The derivatives
+     */
+    auto tangent() const -> const SparseTangent &
+    {
+        return m_tangent;
+    }
+
+    /**
+     * \brief Returns the negation of the SparseDualNumber
+     *
+     * \return The negation of the SparseDualNumber
+     */
+    auto operator-() const -> SparseDualNumber
+    {
+        SparseDualNumber result{*this};
+        result.m_primal = -m_primal;
+        result.m_tangent.scale(-1.0);
+        return result;
+    }
+
+    /**
+     * \brief Compares two SparseDualNumbers for equality of the primal
+     * component and of every derivative
+     *
+     * \param other The other SparseDualNumber
+     * \return true if the two are equal, false otherwise
+     */
+    auto operator==(const SparseDualNumber &other) const -> bool;
+
+    /**
+     * \brief Compares two SparseDualNumbers for inequality
+     *
+     * \param other The other SparseDualNumber
+     * \return true if the two are unequal, false otherwise
+     */
+    auto operator!=(const SparseDualNumber &other) const -> bool
+    {
+        return !(*this == other);
+    }
+
+    /**
+     * \brief Adds other to *this
+     *
+     * \param other A SparseDualNumber
+     * \return The sum of *this and other
+     */
+    auto operator+=(const SparseDualNumber &other) -> SparseDualNumber &
+    {
+        m_primal += other.m_primal;
+        m_tangent =
+            SparseTangent::combine(1.0, m_tangent, 1.0, other.m_tangent);
+        return *this;
+    }
+
+    /**
+     * \brief Adds a scalar to *this
+     *
+     * \param n A scalar value
+     * \return The sum of *this with the scalar
+     */
+    auto operator+=(const double n) -> SparseDualNumber &
+    {
+        m_primal += n;
+        return *this;
+    }
+
+    /**
+     * \brief Subtracts other from *this
+     *
+     * \param other The subtrahend SparseDualNumber
+     * \return The difference of *this and other
+     */
+    auto operator-=(const SparseDualNumber &other) -> SparseDualNumber &
+    {
+        m_primal -= other.m_primal;
+        m_tangent =
+            SparseTangent::combine(1.0, m_tangent, -1.0, other.m_tangent);
+        return *this;
+    }
+
+    /**
+     * \brief Subtracts a scalar from *this
+     *
+     * \param n The subtrahend scalar
+     * \return The difference of *this and the scalar
+     */
+    auto operator-=(const double n) -> SparseDualNumber &
+    {
+        m_primal -= n;
+        return *this;
+    }
+
+    /**
+     * \brief Multiplies *this by other
+     *
+     * \param other A SparseDualNumber
+     * \return The product of the two SparseDualNumbers
+     */
+    auto operator*=(const SparseDualNumber &other) -> SparseDualNumber &
+    {
+        m_tangent = SparseTangent::combine(other.m_primal, m_tangent, m_primal,
+                                           other.m_tangent);
+        m_primal *= other.m_primal;
+        return *this;
+    }
+
+    /**
+     * \brief Multiplies *this by a scalar
+     *
+     * \param scalar The scalar
+     * \return The product of *this and the scalar
+     */
+    auto operator*=(const double scalar) -> SparseDualNumber &
+    {
+        m_primal *= scalar;
+        m_tangent.scale(scalar);
+        return *this;
+    }
+
+    /**
+     * \brief Divides *this by other
+     *
+     * \param other The divisor SparseDualNumber
+     * \return The quotient of the two SparseDualNumbers
+     */
+    auto operator/=(const SparseDualNumber &other) -> SparseDualNumber &
+    {
+        const auto inverse{1.0 / other.m_primal};
+        m_primal *= inverse;
+        m_tangent = SparseTangent::combine(inverse, m_tangent,
+                                           -m_primal * inverse,
+                                           other.m_tangent);
+        return *this;
+    }
+
+    /**
+     * \brief Divides *this by a scalar
+     *
+     * \param scalar The scalar (divisor)
+     * \return The quotient of *this and the scalar
+     */
+    auto operator/=(const double scalar) -> SparseDualNumber &
+    {
+        return *this *= 1.0 / scalar;
+    }
+
+private:
+    /// The primal component
+    double m_primal{0.0};
+
+    /// The derivatives with respect to the inputs
+    SparseTangent m_tangent{};
+};
+
+/**
+ * \brief Adds left and right
+ *
+ * \param left A SparseDualNumber
+ * \param right The other SparseDualNumber
+ * \return The sum of the two SparseDualNumbers
+ */
+inline auto operator+(SparseDualNumber left, const SparseDualNumber &right)
+{
+    left += right;
+    return left;
+}
+
+/**
+ * \brief Adds num with n
+ *
+ * \param num The SparseDualNumber
+ * \param n The scalar
+ * \return The sum of the SparseDualNumber with the scalar
+ */
+inline auto operator+(SparseDualNumber num, const double n)
+{
+    num += n;
+    return num;
+}
+
+/**
+ * \brief Adds num with n
+ *
+ * \param n The scalar
+ * \param num The SparseDualNumber
+ * \return The sum of the SparseDualNumber with the scalar
+ */
+inline auto operator+(const double n, SparseDualNumber num)
+{
+    num += n;
+    return num;
+}
+
+/**
+ * \brief Subtracts right from left
+ *
+ * \param left The minuend SparseDualNumber
+ * \param right The subtrahend SparseDualNumber
+ * \return The difference between the two SparseDualNumbers
+ */
+inline auto operator-(SparseDualNumber left, const SparseDualNumber &right)
+{
+    left -= right;
+    return left;
+}
+
+/**
+ * \brief Subtracts n from num
+ *
+ * \param num The minuend SparseDualNumber
+ * \param n The scalar (subtrahend)
+ * \return The difference between the SparseDualNumber and the scalar
+ */
+inline auto operator-(SparseDualNumber num, const double n)
+{
+    num -= n;
+    return num;
+}
+
+/**
+ * \brief Subtracts num from n
+ *
+ * \param n The scalar (minuend)
+ * \param num The SparseDualNumber (subtrahend)
+ * \return The difference between the scalar and the SparseDualNumber
+ */
+inline auto operator-(const double n, SparseDualNumber num)
+{
+    num.primal() = n - num.primal();
+    num.tangent().scale(-1.0);
+    return num;
+}
+
+/**
+ * \brief Multiplies left and right
+ *
+ * \param left A SparseDualNumber
+ * \param right The other SparseDualNumber
+ * \return The product of the two SparseDualNumbers
+ */
+inline auto operator*(SparseDualNumber left, const SparseDualNumber &right)
+{
+    left *= right;
+    return left;
+}
+
+/**
+ * \brief Multiplies scalar with num
+ *
+ * \param scalar The scalar
+ * \param num The SparseDualNumber
+ * \return The product of the SparseDualNumber and the scalar
+ */
+inline auto operator*(const double scalar, SparseDualNumber num)
+{
+    num *= scalar;
+    return num;
+}
+
+/**
+ * \brief Multiplies num with scalar
+ *
+ * \param num The SparseDualNumber
+ * \param scalar The scalar
+ * \return The product of the SparseDualNumber and the scalar
+ */
+inline auto operator*(SparseDualNumber num, const double scalar)
+{
+    num *= scalar;
+    return num;
+}
+
+/**
+ * \brief Divides left by right
+ *
+ * \param left The dividend SparseDualNumber
+ * \param right The divisor SparseDualNumber
+ * \return The quotient of the two SparseDualNumbers
+ */
+inline auto operator/(SparseDualNumber left, const SparseDualNumber &right)
+{
+    left /= right;
+    return left;
+}
+
+/**
+ * \brief Divides num by scalar
+ *
+ * \param num The dividend SparseDualNumber
+ * \param scalar The scalar (divisor)
+ * \return The quotient of the SparseDualNumber and the scalar
+ */
+inline auto operator/(SparseDualNumber num, const double scalar)
+{
+    num /= scalar;
+    return num;
+}
+
+} // namespace algodiff::forward
@@ -0,0 +1,45 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+/// \file sparse_dual_number_eigen.hpp
+/// \brief Integrates sparse dual numbers with Eigen
+#pragma once
+
+#include <Eigen/Core>
+
+#include "sparse_dual_number.hpp"
+#include "sparse_dual_number_ops.hpp"
+
+namespace Eigen
+{
+template <>
+struct NumTraits<algodiff::forward::SparseDualNumber> : NumTraits<double> {
+    typedef algodiff::forward::SparseDualNumber Real;       // NOLINT
+    typedef algodiff::forward::SparseDualNumber NonInteger; // NOLINT
+    typedef algodiff::forward::SparseDualNumber Nested;     // NOLINT
+
+    enum {
+        IsComplex = 0,             // NOLINT
+        IsInteger = 0,             // NOLINT
+        IsSigned = 1,              // NOLINT
+        RequireInitialization = 1, // NOLINT
+        ReadCost = 1,              // NOLINT
+        AddCost = 8,               // NOLINT
+        MulCost = 8,               // NOLINT
+    };
+};
+
+template <typename BinaryOp>
+struct ScalarBinaryOpTraits<algodiff::forward::SparseDualNumber, double,
+                            BinaryOp> {
+    typedef algodiff::forward::SparseDualNumber ReturnType; // NOLINT
+};
+
+template <typename BinaryOp>
+struct ScalarBinaryOpTraits<double, algodiff::forward::SparseDualNumber,
+                            BinaryOp> {
+    typedef algodiff::forward::SparseDualNumber ReturnType; // NOLINT
+};
+
+} // namespace Eigen
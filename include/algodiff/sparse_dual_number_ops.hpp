@@ -0,0 +1,290 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+/// \file sparse_dual_number_ops.hpp
+/// \brief Implements operations that can be performed on sparse dual numbers
+#pragma once
+
+#include "sparse_dual_number.hpp"
+
+namespace algodiff::forward
+{
+// Non-member functions
+/**
+ * \brief Returns the primal component of a SparseDualNumber
+ *
+ * \param num The SparseDualNumber
+ * \return The primal component of num
+ */
+inline auto primal(const SparseDualNumber &num) -> double
+{
+    return num.primal();
+}
+
+/**
+ * \brief Returns the primal component of a SparseDualNumber. This function can
+ * be useful with Eigen
+ *
+ * \param num The SparseDualNumber
+ * \return The primal component of num
+ */
+inline auto real(const SparseDualNumber &num) -> double
+{
+    return num.primal();
+}
+
+/**
+ * \brief Returns the derivatives of a SparseDualNumber
+ *
+ * \param num The SparseDualNumber
+ * \return The sparse tangent of num
+ */
+inline auto tangent(const SparseDualNumber &num) -> const SparseTangent &
+{
+    return num.tangent();
+}
+
+/**
+ * \brief Returns the absolute value of a SparseDualNumber
+ *
+ * \param num The SparseDualNumber
+ * \return The absolute value of the SparseDualNumber
+ */
+auto abs(const SparseDualNumber &num) -> SparseDualNumber;
+
+/**
+ * \brief Computes the inverse of a SparseDualNumber
+ *
+ * \param num The SparseDualNumber
+ * \return The inverse of the SparseDualNumber
+ */
+auto inverse(const SparseDualNumber &num) -> SparseDualNumber;
+
+/**
+ * \brief Returns the conjugate of a SparseDualNumber
+ *
+ * \param num The SparseDualNumber
+ * \return The conjugate of the SparseDualNumber
+ */
+inline auto conj(const SparseDualNumber &num) -> SparseDualNumber
+{
+    SparseDualNumber result{num};
+    result.tangent().scale(-1.0);
+    return result;
+}
+
+/**
+ * \brief Computes the norm of a SparseDualNumber
+ *
+ * \note This is equivalent to multiplying the SparseDualNumber by itself
+ *
+ * \param num The SparseDualNumber
+ * \return The norm of the SparseDualNumber
+ */
+auto abs2(const SparseDualNumber &num) -> SparseDualNumber;
+
+/**
+ * \brief Computes the norm of a SparseDualNumber
+ *
+ * \note This is equivalent to multiplying the SparseDualNumber by itself
+ *
+ * \param num The SparseDualNumber
+ * \return The norm of the SparseDualNumber
+ */
+auto norm(const SparseDualNumber &num) -> SparseDualNumber;
+
+// Power functions
+/**
+ * \brief Computes a SparseDualNumber raised to the power of a scalar exponent
+ *
+ * \param num The SparseDualNumber
+ * \param exponent The scalar exponent
+ * \return The SparseDualNumber raised to the exponent
+ */
+auto pow(const SparseDualNumber &num, double exponent) -> SparseDualNumber;
+
+/**
+ * \brief Computes a SparseDualNumber raised to the power of another
+ * SparseDualNumber
+ *
+ * \param num The SparseDualNumber
+ * \param exponent The exponent SparseDualNumber
+ * \return The SparseDualNumber raised to the exponent SparseDualNumber
+ */
+auto pow(const SparseDualNumber &num, const SparseDualNumber &exponent)
+    -> SparseDualNumber;
+
+/**
+ * \brief Computes the square root of a SparseDualNumber
+ *
+ * \param num The SparseDualNumber
+ * \return The square root of the SparseDualNumber
+ */
+auto sqrt(const SparseDualNumber &num) -> SparseDualNumber;
+
+// Exponential functions
+/**
+ * \brief Compute e (euler's number) raised to the power of a
+ * SparseDualNumber
+ *
+ * \param num The SparseDualNumber
+ * \return The base-e exponential of num
+ */
+auto exp(const SparseDualNumber &num) -> SparseDualNumber;
+
+/**
+ * \brief Computes 2 raised to the power of a SparseDualNumber
+ *
+ * \param num The SparseDualNumber
+ * \return The base-2 exponential of num
+ */
+auto exp2(const SparseDualNumber &num) -> SparseDualNumber;
+
+// Logarithms
+/**
+ * \brief Computes the natural (base e) logarithm of a SparseDualNumber
+ *
+ * \param num The SparseDualNumber
+ * \return The natural logarithm of num
+ */
+auto log(const SparseDualNumber &num) -> SparseDualNumber;
+
+/**
+ * \brief Computes the base 2 logarithm of a SparseDualNumber
+ *
+ * \param num The SparseDualNumber
+ * \return The base 2 logarithm of num
+ */
+auto log2(const SparseDualNumber &num) -> SparseDualNumber;
+
+/**
+ * \brief Computes the base 10 logarithm of a SparseDualNumber
+ *
+ * \param num The SparseDualNumber
+ * \return The base 10 logarithm of num
+ */
+auto log10(const SparseDualNumber &num) -> SparseDualNumber;
+
+/**
+ * \brief Computes the input base logarithm of a SparseDualNumber
+ *
+ * \param num The SparseDualNumber
+ * \param base The base of the logarithm
+ * \return The base base logarithm of num
+ */
+auto log(const SparseDualNumber &num, double base) -> SparseDualNumber;
+
+// Trigonometric functions
+/**
+ * \brief Computes cosine of a SparseDualNumber
+ *
+ * \param num The SparseDualNumber
+ * \return Cosine of the SparseDualNumber
+ */
+auto cos(const SparseDualNumber &num) -> SparseDualNumber;
+
+/**
+ * \brief Computes sine of a SparseDualNumber
+ *
+ * \param num The SparseDualNumber
+ * \return Sine of the SparseDualNumber
+ */
+auto sin(const SparseDualNumber &num) -> SparseDualNumber;
+
+/**
+ * \brief Computes tangent of a SparseDualNumber
+ *
+ * \param num The SparseDualNumber
+ * \return Tangent of the SparseDualNumber
+ */
+auto tan(const SparseDualNumber &num) -> SparseDualNumber;
+
+// Inverse trigonometric functions
+/**
+ * \brief Computes inverse cosine of a SparseDualNumber
+ *
+ * \param num The SparseDualNumber
+ * \return Inverse cosine of the SparseDualNumber
+ */
+auto acos(const SparseDualNumber &num) -> SparseDualNumber;
+
+/**
+ * \brief Computes inverse sine of a SparseDualNumber
+ *
+ * \param num The SparseDualNumber
+ * \return Inverse sine of the SparseDualNumber
+ */
+auto asin(const SparseDualNumber &num) -> SparseDualNumber;
+
+/**
+ * \brief Computes inverse tangent of a SparseDualNumber
+ *
+ * \param num The SparseDualNumber
+ * \return Inverse tangent of the SparseDualNumber
+ */
+auto atan(const SparseDualNumber &num) -> SparseDualNumber;
+
+// Hyperbolic functions
+/**
+ * \brief Computes hyperbolic cosine of a SparseDualNumber
+ *
+ * \param num The SparseDualNumber
+ * \return Hyperbolic cosine of the SparseDualNumber
+ */
+auto cosh(const SparseDualNumber &num) -> SparseDualNumber;
+
+/**
+ * \brief Computes hyperbolic sine of a SparseDualNumber
+ *
+ * \param num The SparseDualNumber
+ * \return Hyperbolic sine of the SparseDualNumber
+ */
+auto sinh(const SparseDualNumber &num) -> SparseDualNumber;
+
+/**
+ * \brief Computes hyperbolic tangent of a SparseDualNumber
+ *
+ * \param num The SparseDualNumber
+ * \return Hyperbolic tangent of the SparseDualNumber
+ */
+auto tanh(const SparseDualNumber &num) -> SparseDualNumber;
+
+// Inverse hyperbolic functions
+/**
+ * \brief Computes inverse hyperbolic cosine of a SparseDualNumber
+ *
+ * \param num The SparseDualNumber
+ * \return Inverse hyperbolic cosine of the SparseDualNumber
+ */
+auto acosh(const SparseDualNumber &num) -> SparseDualNumber;
+
+/**
+ * \brief Computes inverse hyperbolic sine of a SparseDualNumber
+ *
+ * \param num The SparseDualNumber
+ * \return Inverse hyperbolic sine of the SparseDualNumber
+ */
+auto asinh(const SparseDualNumber &num) -> SparseDualNumber;
+
+/**
+ * \brief Computes inverse hyperbolic tangent of a SparseDualNumber
+ *
+ * \param num The SparseDualNumber
+ * \return Inverse hyperbolic tangent of the SparseDualNumber
+ */
+auto atanh(const SparseDualNumber &num) -> SparseDualNumber;
+
+/**
+ * \brief Computes the inverse of a SparseDualNumber multiplied by a scalar
+ *
+ * \param scalar The scalar
+ * \param num The SparseDualNumber
+ * \return The inverse of the SparseDualNumber multiplied by scalar
+ */
+inline auto operator/(const double scalar, const SparseDualNumber &num)
+{
+    return scalar * inverse(num);
+}
+
+} // namespace algodiff::forward
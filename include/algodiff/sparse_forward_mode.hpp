@@ -0,0 +1,102 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+/// \file sparse_forward_mode.hpp
+/// \brief Computes sparse gradients and jacobians in a single forward pass
+/// using sparse dual numbers
+#pragma once
+
+#include <stdexcept>
+#include <vector>
+
+#include <Eigen/SparseCore>
+
+#include "sparse_dual_number.hpp"
+#include "sparse_dual_number_eigen.hpp"
+
+namespace algodiff::forward
+{
+/**
+ * \brief Returns the inputs u as independent sparse variables
+ *
+ * \param u The point to seed
+ * \return A vector whose i-th entry has value u[i] and tangent e_i
+ */
+inline auto sparse_variables(const Eigen::VectorXd &u)
+    -> Eigen::VectorX<SparseDualNumber>
+{
+    Eigen::VectorX<SparseDualNumber> x(u.size());
+    for (Eigen::Index i = 0; i < u.size(); ++i) {
+        x[i] = SparseDualNumber::variable(u[i], i);
+    }
+    return x;
+}
+
+/**
+ * \brief Returns the gradient of f evaluated at u
+ *
+ * Unlike gradient, which runs one pass per input, this runs f once and only
+ * ever stores the derivatives each intermediate value actually depends on.
+ *
+ * \tparam F Function Type that takes as input a
+ * Eigen::VectorX<SparseDualNumber> and outputs a SparseDualNumber
+ * \param f The function to take the gradient of
+ * \param u The point to evaluate the gradient at
+ * \return The gradient of f at u, holding only its structural non-zeros
+ */
+template <class F>
+auto sparse_gradient(F &&f, const Eigen::VectorXd &u)
+    -> Eigen::SparseVector<double>
+{
+    const SparseDualNumber value{f(sparse_variables(u))};
+    Eigen::SparseVector<double> grad(u.size());
+    grad.reserve(static_cast<Eigen::Index>(value.tangent().size()));
+    for (const auto &entry : value.tangent()) {
+        grad.insertBack(entry.index) = entry.value;
+    }
+    return grad;
+}
+
+/**
+ * \brief Returns the jacobian of f evaluated at u
+ *
+ * f is run once; row i of the jacobian is the tangent of output i.
+ *
+ * \throws std::invalid_argument if the output of f does not have FunctionSize
+ * entries
+ *
+ * \tparam FunctionSize The dimension of the output of f, or Eigen::Dynamic
+ * \tparam F Function Type that takes as input a
+ * Eigen::VectorX<SparseDualNumber> and outputs a
+ * Eigen::VectorX<SparseDualNumber>
+ * \param f The function to take the jacobian of
+ * \param u The point to evaluate the jacobian at
+ * \return The jacobian of f at u, holding only its structural non-zeros
+ */
+template <int FunctionSize, class F>
+auto sparse_jacobian(F &&f, const Eigen::VectorXd &u)
+    -> Eigen::SparseMatrix<double, Eigen::RowMajor>
+{
+    const Eigen::VectorX<SparseDualNumber> values{f(sparse_variables(u))};
+    if (FunctionSize != Eigen::Dynamic && values.size() != FunctionSize) {
+        throw std::invalid_argument("Output does not have FunctionSize rows");
+    }
+
+    Eigen::Index non_zeros{0};
+    for (Eigen::Index row = 0; row < values.size(); ++row) {
+        non_zeros += static_cast<Eigen::Index>(values[row].tangent().size());
+    }
+    Eigen::SparseMatrix<double, Eigen::RowMajor> jac(values.size(), u.size());
+    jac.reserve(non_zeros);
+    for (Eigen::Index row = 0; row < values.size(); ++row) {
+        jac.startVec(row);
+        for (const auto &entry : values[row].tangent()) {
+            jac.insertBack(row, entry.index) = entry.value;
+        }
+    }
+    jac.finalize();
+    return jac;
+}
+
+} // namespace algodiff::forward
@@ -0,0 +1,175 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+/// \file sparse_hessian.hpp
+/// \brief Computes sparse hessians from a few hessian-vector products using a
+/// star coloring of the sparsity pattern
+#pragma once
+
+#include <stdexcept>
+#include <vector>
+
+#include <Eigen/SparseCore>
+
+#include "dual_number.hpp"
+#include "dual_number_eigen.hpp"
+#include "forward_mode.hpp"
+
+namespace algodiff::forward
+{
+/**
+ * \brief A star coloring of a symmetric sparsity pattern
+ *
+ * Columns of the same color are structurally orthogonal and, additionally,
+ * every path on four vertices of the adjacency graph uses at least three
+ * colors. This lets every entry of the symmetric matrix be read directly off
+ * the products of the matrix with one seed vector per color.
+ *
+ * Compute it once with color_hessian and reuse it for every hessian with the
+ * same pattern.
+ */
+struct HessianColoring {
+    /// The dimension of the hessian
+    Eigen::Index size{0};
+
+    /// The color of every column
+    std::vector<int> colors{};
+
+    /// The number of colors, i.e. the number of hessian-vector products
+    int color_count{0};
+
+    /// The lower triangle of the pattern (including the diagonal)
+    Eigen::SparseMatrix<double> lower{};
+
+    /// The full symmetric adjacency without the diagonal, one column per vertex
+    Eigen::SparseMatrix<double> adjacency{};
+};
+
+/**
+ * \brief Star colors a symmetric sparsity pattern with a greedy algorithm
+ *
+ * See: Gebremedhin, Manne and Pothen, "What color is your Jacobian? Graph
+ * coloring for computing derivatives", SIAM Review 47(4), 2005, algorithm 4.1
+ *
+ * \throws std::invalid_argument if pattern is not square
+ *
+ * \param pattern The non-zero structure of the hessian; either the full
+ * symmetric pattern or just one triangle. Stored values are ignored
+ * \return The coloring
+ */
+auto color_hessian(const Eigen::SparseMatrix<double> &pattern)
+    -> HessianColoring;
+
+/**
+ * \brief Recovers the lower triangle of a hessian from its compressed form
+ *
+ * \param coloring The coloring used to seed the products
+ * \param compressed The size x color_count matrix whose column c is the
+ * hessian times the indicator vector of color c
+ * \return The lower triangle of the hessian
+ */
+auto recover_hessian(const HessianColoring &coloring,
+                     const Eigen::MatrixXd &compressed)
+    -> Eigen::SparseMatrix<double>;
+
+/**
+ * \brief Returns the structural non-zeros of the hessian of a function at u
+ *
+ * This runs one forward pass of gradient per input, so detect the pattern
+ * once and reuse it (through color_hessian) for the following iterations.
+ * Entries that happen to vanish at u are missed; pick a generic point.
+ *
+ * \tparam G Function Type that takes as input a Eigen::VectorX<DualNumber>
+ * and outputs the gradient of the function as a Eigen::VectorX<DualNumber> of
+ * the same size
+ * \param gradient The gradient of the function to take the hessian of
+ * \param u The point to detect the pattern at
+ * \return The lower triangle of the pattern, with unit values
+ */
+template <class G>
+auto detect_hessian_sparsity(G &&gradient, const Eigen::VectorXd &u)
+    -> Eigen::SparseMatrix<double>
+{
+    std::vector<Eigen::Triplet<double>> triplets{};
+    Eigen::VectorX<DualNumber> x{u.template cast<DualNumber>()};
+    for (Eigen::Index col = 0; col < u.size(); ++col) {
+        x[col].dual() = 1.0;
+        const Eigen::VectorX<DualNumber> column{gradient(x)};
+        x[col].dual() = 0.0;
+        for (Eigen::Index row = col; row < column.size(); ++row) {
+            if (column[row].dual() != 0.0) {
+                triplets.emplace_back(row, col, 1.0);
+            }
+        }
+    }
+
+    Eigen::SparseMatrix<double> pattern(u.size(), u.size());
+    pattern.setFromTriplets(triplets.begin(), triplets.end());
+    return pattern;
+}
+
+/**
+ * \brief Returns the lower triangle of the hessian of a function at u
+ *
+ * The hessian is the jacobian of the gradient, so each hessian-vector
+ * product is a single forward pass of gradient seeded with the indicator
+ * vector of one color. Only coloring.color_count passes are needed, which
+ * for banded or otherwise sparse hessians is independent of the dimension.
+ *
+ * \throws std::invalid_argument if u does not match the coloring
+ *
+ * \tparam G Function Type that takes as input a Eigen::VectorX<DualNumber>
+ * and outputs the gradient of the function as a Eigen::VectorX<DualNumber> of
+ * the same size
+ * \param gradient The gradient of the function to take the hessian of
+ * \param u The point to evaluate the hessian at
+ * \param coloring A star coloring of the hessian sparsity pattern
+ * \return The lower triangle of the hessian at u
+ */
+template <class G>
+auto sparse_hessian(G &&gradient, const Eigen::VectorXd &u,
+                    const HessianColoring &coloring)
+    -> Eigen::SparseMatrix<double>
+{
+    if (u.size() != coloring.size) {
+        throw std::invalid_argument("Input does not match the coloring");
+    }
+
+    Eigen::MatrixXd compressed(u.size(), coloring.color_count);
+    Eigen::VectorX<DualNumber> x{u.template cast<DualNumber>()};
+    for (int color = 0; color < coloring.color_count; ++color) {
+        for (Eigen::Index i = 0; i < u.size(); ++i) {
+            x[i].dual() =
+                coloring.colors[static_cast<size_t>(i)] == color ? 1.0 : 0.0;
+        }
+        const Eigen::VectorX<DualNumber> product{gradient(x)};
+        for (Eigen::Index i = 0; i < u.size(); ++i) {
+            compressed(i, color) = product[i].dual();
+        }
+    }
+    return recover_hessian(coloring, compressed);
+}
+
+/**
+ * \brief Returns the lower triangle of the hessian of a function at u given
+ * its sparsity pattern
+ *
+ * \tparam G Function Type that takes as input a Eigen::VectorX<DualNumber>
+ * and outputs the gradient of the function as a Eigen::VectorX<DualNumber> of
+ * the same size
+ * \param gradient The gradient of the function to take the hessian of
+ * \param u The point to evaluate the hessian at
+ * \param pattern The non-zero structure of the hessian (full or one triangle)
+ * \return The lower triangle of the hessian at u
+ */
+template <class G>
+auto sparse_hessian(G &&gradient, const Eigen::VectorXd &u,
+                    const Eigen::SparseMatrix<double> &pattern)
+    -> Eigen::SparseMatrix<double>
+{
+    return sparse_hessian(std::forward<G>(gradient), u,
+                          color_hessian(pattern));
+}
+
+} // namespace algodiff::forward
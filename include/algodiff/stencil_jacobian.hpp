@@ -0,0 +1,364 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+/// \file stencil_jacobian.hpp
+/// \brief Computes the sparse jacobians of residuals defined by a stencil on
+/// a structured grid
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+
+#include "dual_number.hpp"
+#include "dual_number_eigen.hpp"
+#include "parallel.hpp"
+
+namespace algodiff::forward
+{
+/// How a stencil reads neighbours that lie outside the grid
+enum class StencilBoundary : std::uint8_t {
+    /// Neighbours wrap around to the opposite side of the grid
+    Periodic,
+
+    /// Neighbours outside the grid hold boundary_value and have no derivative
+    Constant,
+};
+
+/// The offsets of the neighbours a stencil reads, relative to its centre
+template <std::size_t Dimension, std::size_t Points>
+using StencilOffsets = std::array<std::array<Eigen::Index, Dimension>, Points>;
+
+/**
+ * \brief A structured grid whose points are numbered with the first
+ * coordinate varying fastest
+ *
+ * \tparam Dimension The number of spatial dimensions
+ */
+template <std::size_t Dimension> struct StructuredGrid {
+    /// The number of points along every dimension
+    std::array<Eigen::Index, Dimension> shape{};
+
+    /// How neighbours outside the grid are read
+    StencilBoundary boundary{StencilBoundary::Periodic};
+
+    /// The value of every component outside the grid, for Constant
+    /// boundaries
+    double boundary_value{0.0};
+
+    /**
+     * \brief Returns the number of grid points
+     *
+     * \return The product of the shape
+     */
+    auto points() const -> Eigen::Index
+    {
+        Eigen::Index result{1};
+        for (const auto extent : shape) {
+            result *= extent;
+        }
+        return result;
+    }
+
+    /**
+     * \brief Returns the neighbour of a point at an offset
+     *
+     * \param point The linear index of the point
+     * \param offset The offset along every dimension
+     * \return The linear index of the neighbour, or -1 if it lies outside a
+     * grid with Constant boundaries
+     */
+    auto neighbour(Eigen::Index point,
+                   const std::array<Eigen::Index, Dimension> &offset) const
+        -> Eigen::Index
+    {
+        Eigen::Index result{0};
+        Eigen::Index stride{1};
+        for (size_t d = 0; d < shape.size(); ++d) {
+            const auto extent{shape[d]};
+            auto coordinate{point % extent + offset[d]};
+            point /= extent;
+            if (coordinate < 0 || coordinate >= extent) {
+                if (boundary == StencilBoundary::Constant) {
+                    return -1;
+                }
+                coordinate = (coordinate % extent + extent) % extent;
+            }
+            result += coordinate * stride;
+            stride *= extent;
+        }
+        return result;
+    }
+};
+
+/// Options for stencil_jacobian and stencil_residual
+struct StencilOptions {
+    /// The number of grid points handed to a thread at a time
+    std::int64_t chunk_size{4096};
+
+    /// The number of worker threads, 0 for one per hardware thread
+    unsigned threads{0};
+};
+
+namespace internal
+{
+/**
+ * \brief Runs fn(point) for every grid point, spread over worker threads in
+ * chunks of consecutive points
+ *
+ * \throws std::invalid_argument if chunk_size is not positive
+ *
+ * \param points The number of grid points
+ * \param options The chunking and threading options
+ * \param fn The work for one point
+ */
+template <class Fn>
+auto for_each_grid_point(Eigen::Index points, const StencilOptions &options,
+                         Fn &&fn) -> void
+{
+    if (options.chunk_size < 1) {
+        throw std::invalid_argument("chunk_size must be positive");
+    }
+    const auto chunks{(points + options.chunk_size - 1) / options.chunk_size};
+    algodiff::internal::parallel_for(
+        chunks, options.threads, [&](std::int64_t chunk) {
+            const auto first{chunk * options.chunk_size};
+            const auto last{std::min(first + options.chunk_size, points)};
+            for (auto point = first; point < last; ++point) {
+                fn(point);
+            }
+        });
+}
+
+/**
+ * \brief Gathers the neighbourhood of a point
+ *
+ * \param grid The grid
+ * \param offsets The stencil
+ * \param u The components of every grid point
+ * \param point The centre of the stencil
+ * \param neighbours Receives the neighbour read by every stencil point, -1
+ * outside the grid
+ * \param values Receives the components read by every stencil point, one
+ * column per stencil point
+ */
+template <int Components, std::size_t Points, std::size_t Dimension,
+          class Scalar>
+auto gather(const StructuredGrid<Dimension> &grid,
+            const StencilOffsets<Dimension, Points> &offsets,
+            const Eigen::VectorXd &u, Eigen::Index point,
+            std::array<Eigen::Index, Points> &neighbours,
+            Eigen::Matrix<Scalar, Components, static_cast<int>(Points)>
+                &values) -> void
+{
+    for (size_t k = 0; k < Points; ++k) {
+        const auto n{grid.neighbour(point, offsets[k])};
+        neighbours[k] = n;
+        for (int c = 0; c < Components; ++c) {
+            values(c, static_cast<Eigen::Index>(k)) =
+                Scalar{n < 0 ? grid.boundary_value : u[n * Components + c]};
+        }
+    }
+}
+
+/**
+ * \brief Throws unless u holds every component of every grid point
+ *
+ * \throws std::invalid_argument if the sizes differ
+ *
+ * \param points The number of grid points
+ * \param components The number of components per point
+ * \param size The size of u
+ */
+auto require_grid_size(Eigen::Index points, Eigen::Index components,
+                       Eigen::Index size) -> void;
+
+} // namespace internal
+
+/**
+ * \brief Evaluates a stencil residual at every grid point
+ *
+ * \throws std::invalid_argument if u does not hold Components values per grid
+ * point
+ *
+ * \tparam Components The number of unknowns per grid point
+ * \tparam R Function Type that takes as input a Eigen::Matrix<Scalar,
+ * Components, Points> holding the components read by every stencil point and
+ * outputs the Components residuals of the centre point, for both double and
+ * DualNumber scalars (for example a generic lambda)
+ * \param residual The point-wise residual
+ * \param grid The grid
+ * \param offsets The stencil
+ * \param u The unknowns, point * Components + component
+ * \param options Chunking and threading options
+ * \return The residuals, laid out like u
+ */
+template <int Components, std::size_t Points, std::size_t Dimension, class R>
+auto stencil_residual(R &&residual, const StructuredGrid<Dimension> &grid,
+                      const StencilOffsets<Dimension, Points> &offsets,
+                      const Eigen::VectorXd &u,
+                      const StencilOptions &options = {}) -> Eigen::VectorXd
+{
+    const auto points{grid.points()};
+    internal::require_grid_size(points, Components, u.size());
+
+    Eigen::VectorXd result(u.size());
+    internal::for_each_grid_point(points, options, [&](Eigen::Index point) {
+        std::array<Eigen::Index, Points> neighbours{};
+        Eigen::Matrix<double, Components, static_cast<int>(Points)> values{};
+        internal::gather<Components>(grid, offsets, u, point, neighbours,
+                                     values);
+        result.template segment<Components>(point * Components) =
+            residual(std::as_const(values));
+    });
+    return result;
+}
+
+/**
+ * \brief Returns the jacobian of a stencil residual on a structured grid
+ *
+ * Rather than differentiating the whole residual vector, the residual of each
+ * grid point is differentiated on its own with Components * Points forward
+ * passes over fixed-size stack vectors, so the cost and memory grow with the
+ * number of grid points and not with their square. The local jacobians are
+ * written straight into the compressed storage of the global matrix, in
+ * parallel over chunks of grid points.
+ *
+ * \throws std::invalid_argument if u does not hold Components values per grid
+ * point
+ * \throws std::length_error if the jacobian has too many non-zeros for
+ * StorageIndex
+ *
+ * \tparam Components The number of unknowns per grid point
+ * \tparam StorageIndex The index type of the sparse matrix; the 64 bit
+ * default holds the billions of non-zeros of large 3D grids, int halves the
+ * index memory of smaller ones
+ * \tparam R Function Type that takes as input a Eigen::Matrix<Scalar,
+ * Components, Points> holding the components read by every stencil point and
+ * outputs the Components residuals of the centre point, for both double and
+ * DualNumber scalars (for example a generic lambda)
+ * \param residual The point-wise residual
+ * \param grid The grid
+ * \param offsets The stencil
+ * \param u The unknowns, point * Components + component
+ * \param options Chunking and threading options
+ * \return The jacobian of the residual at u; entries of neighbours that
+ * several stencil points read are summed
+ */
+template <int Components, class StorageIndex = std::int64_t,
+          std::size_t Points, std::size_t Dimension, class R>
+auto stencil_jacobian(R &&residual, const StructuredGrid<Dimension> &grid,
+                      const StencilOffsets<Dimension, Points> &offsets,
+                      const Eigen::VectorXd &u,
+                      const StencilOptions &options = {})
+    -> Eigen::SparseMatrix<double, Eigen::RowMajor, StorageIndex>
+{
+    using Matrix = Eigen::SparseMatrix<double, Eigen::RowMajor, StorageIndex>;
+    constexpr auto stencil_size{static_cast<int>(Points)};
+    const auto points{grid.points()};
+    internal::require_grid_size(points, Components, u.size());
+
+    // The distinct neighbours of every point decide the length of its rows
+    std::vector<StorageIndex> distinct(static_cast<size_t>(points));
+    internal::for_each_grid_point(points, options, [&](Eigen::Index point) {
+        std::array<Eigen::Index, Points> neighbours{};
+        for (size_t k = 0; k < Points; ++k) {
+            neighbours[k] = grid.neighbour(point, offsets[k]);
+        }
+        std::sort(neighbours.begin(), neighbours.end());
+        const auto end{std::unique(neighbours.begin(), neighbours.end())};
+        distinct[static_cast<size_t>(point)] = static_cast<StorageIndex>(
+            std::count_if(neighbours.begin(), end,
+                          [](Eigen::Index n) { return n >= 0; }));
+    });
+
+    const auto size{points * Components};
+    Matrix jac(size, size);
+    auto *outer{jac.outerIndexPtr()};
+    Eigen::Index non_zeros{0};
+    for (Eigen::Index point = 0; point < points; ++point) {
+        for (int c = 0; c < Components; ++c) {
+            outer[point * Components + c] =
+                static_cast<StorageIndex>(non_zeros);
+            non_zeros += distinct[static_cast<size_t>(point)] * Components;
+            if (non_zeros > static_cast<Eigen::Index>(
+                                std::numeric_limits<StorageIndex>::max())) {
+                throw std::length_error("Too many non-zeros in the jacobian");
+            }
+        }
+    }
+    outer[size] = static_cast<StorageIndex>(non_zeros);
+    jac.resizeNonZeros(non_zeros);
+    auto *inner{jac.innerIndexPtr()};
+    auto *values{jac.valuePtr()};
+
+    internal::for_each_grid_point(points, options, [&](Eigen::Index point) {
+        std::array<Eigen::Index, Points> neighbours{};
+        Eigen::Matrix<DualNumber, Components, stencil_size> x{};
+        internal::gather<Components>(grid, offsets, u, point, neighbours, x);
+
+        // One forward pass per component of every stencil point
+        Eigen::Matrix<double, Components, Components * stencil_size> local{};
+        for (int k = 0; k < stencil_size; ++k) {
+            for (int c = 0; c < Components; ++c) {
+                if (neighbours[static_cast<size_t>(k)] < 0) {
+                    local.col(k * Components + c).setZero();
+                    continue;
+                }
+                x(c, k).dual() = 1.0;
+                const Eigen::Matrix<DualNumber, Components, 1> r{
+                    residual(std::as_const(x))};
+                x(c, k).dual() = 0.0;
+                for (int row = 0; row < Components; ++row) {
+                    local(row, k * Components + c) = r[row].dual();
+                }
+            }
+        }
+
+        // Scatter in increasing column order, summing repeated neighbours
+        std::array<int, Points> order{};
+        for (int k = 0; k < stencil_size; ++k) {
+            order[static_cast<size_t>(k)] = k;
+        }
+        std::sort(order.begin(), order.end(), [&](int a, int b) {
+            return neighbours[static_cast<size_t>(a)] <
+                   neighbours[static_cast<size_t>(b)];
+        });
+        for (int row = 0; row < Components; ++row) {
+            auto next{outer[point * Components + row]};
+            Eigen::Index previous{-1};
+            for (const auto k : order) {
+                const auto n{neighbours[static_cast<size_t>(k)]};
+                if (n < 0) {
+                    continue;
+                }
+                if (n == previous) {
+                    next -= Components;
+                }
+                for (int c = 0; c < Components; ++c) {
+                    const double partial{local(row, k * Components + c)};
+                    if (n == previous) {
+                        values[next] += partial;
+                    } else {
+                        inner[next] =
+                            static_cast<StorageIndex>(n * Components + c);
+                        values[next] = partial;
+                    }
+                    ++next;
+                }
+                previous = n;
+            }
+        }
+    });
+    return jac;
+}
+
+} // namespace algodiff::forward
@@ -0,0 +1,698 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+/// \file tape.hpp
+/// \brief Contains the tape that records operations for reverse mode
+/// auto-differentiation and the variables recorded on it
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <Eigen/Core>
+
+namespace algodiff::reverse
+{
+/// The operation of a tape node
+enum class OpCode : std::uint8_t {
+    Input,            ///< An independent variable
+    Constant,         ///< A passive value used as an operand, in constant
+    Add,              ///< lhs + rhs
+    Subtract,         ///< lhs - rhs
+    Multiply,         ///< lhs * rhs
+    Divide,           ///< lhs / rhs
+    Pow,              ///< lhs ^ rhs
+    AddConstant,      ///< lhs + constant
+    ConstantSubtract, ///< constant - lhs
+    MultiplyConstant, ///< lhs * constant
+    DivideConstant,   ///< lhs / constant
+    ConstantDivide,   ///< constant / lhs
+    PowConstant,      ///< lhs ^ constant
+    Negate,           ///< -lhs
+    Abs,              ///< |lhs|
+    Sqrt,             ///< sqrt(lhs)
+    Exp,              ///< exp(lhs)
+    Log,              ///< log(lhs)
+    Sin,              ///< sin(lhs)
+    Cos,              ///< cos(lhs)
+    Tan,              ///< tan(lhs)
+    Asin,             ///< asin(lhs)
+    Acos,             ///< acos(lhs)
+    Atan,             ///< atan(lhs)
+    Sinh,             ///< sinh(lhs)
+    Cosh,             ///< cosh(lhs)
+    Tanh,             ///< tanh(lhs)
+    ExternalOutput,   ///< Output rhs of the external call lhs
+};
+
+/**
+ * \brief Returns true if the operation reads both lhs and rhs
+ *
+ * \param op The operation
+ * \return true for operations on two variables
+ */
+constexpr auto is_binary(OpCode op) -> bool
+{
+    return op == OpCode::Add || op == OpCode::Subtract ||
+           op == OpCode::Multiply || op == OpCode::Divide || op == OpCode::Pow;
+}
+
+/// One recorded operation
+struct Node {
+    /// The operation
+    OpCode op{OpCode::Input};
+
+    /// The first operand (or the external call for ExternalOutput)
+    std::uint32_t lhs{0};
+
+    /// The second operand (or the output position for ExternalOutput)
+    std::uint32_t rhs{0};
+
+    /// The passive operand of the operation, if any
+    double constant{0.0};
+};
+
+/// A branch taken while recording, see Tape::guard
+struct Guard {
+    /// The node whose sign decided the branch
+    std::uint32_t node{0};
+
+    /// Whether the node was positive when it was recorded
+    bool positive{false};
+};
+
+/**
+ * \brief A subroutine that is recorded as a single node per output instead of
+ * as its internal operations
+ *
+ * primal is always required. Exactly one of jacobian and vjp must be set:
+ * a jacobian is evaluated once whenever the primal is (at recording and at
+ * every replay) and reused by every reverse sweep, while a vjp is called in
+ * every reverse sweep.
+ */
+struct ExternalFunction {
+    /// Maps the inputs x to the outputs y
+    std::function<Eigen::VectorXd(const Eigen::VectorXd &x)> primal{};
+
+    /// Returns the jacobian of the outputs with respect to the inputs at x
+    std::function<Eigen::MatrixXd(const Eigen::VectorXd &x)> jacobian{};
+
+    /// Returns the transposed jacobian at x (with outputs y) times w
+    std::function<Eigen::VectorXd(const Eigen::VectorXd &x,
+                                  const Eigen::VectorXd &y,
+                                  const Eigen::VectorXd &w)>
+        vjp{};
+};
+
+class Tape;
+
+/**
+ * \brief A scalar that records the operations applied to it on a Tape
+ *
+ * A Variable without a tape is passive: it behaves like a double and
+ * operations on it record nothing.
+ */
+class Variable
+{
+public:
+    /// The default constructor
+    Variable() = default;
+
+    /**
+     * \brief Creates a passive Variable
+     *
+     * \param value The value
+     */
+    explicit Variable(double value) : m_value{value}
+    {
+    }
+
+    /**
+     * \brief Creates a Variable referring to a node of a tape
+     *
+     * \param tape The tape
+     * \param index The node on the tape
+     * \param value The value of the node
+     */
+    Variable(Tape *tape, std::uint32_t index, double value)
+        : m_tape{tape}, m_index{index}, m_value{value}
+    {
+    }
+
+    /**
+     * \brief Returns the value
+     *
+     * \return The value
+     */
+    auto value() const -> double
+    {
+        return m_value;
+    }
+
+    /**
+     * \brief Returns the tape the Variable is recorded on
+     *
+     * \return The tape, or nullptr for passive values
+     */
+    auto tape() const -> Tape *
+    {
+        return m_tape;
+    }
+
+    /**
+     * \brief Returns the node of the Variable on its tape
+     *
+     * \return The index of the node
+     */
+    auto index() const -> std::uint32_t
+    {
+        return m_index;
+    }
+
+    /**
+     * \brief Returns true if the Variable is recorded on a tape
+     *
+     * \return true if the Variable is recorded on a tape
+     */
+    auto is_active() const -> bool
+    {
+        return m_tape != nullptr;
+    }
+
+    /**
+     * \brief Returns the negation of the Variable
+     *
+     * \return The negation of the Variable
+     */
+    auto operator-() const -> Variable;
+
+    /**
+     * \brief Adds other to *this
+     *
+     * \param other A Variable
+     * \return The sum of *this and other
+     */
+    auto operator+=(const Variable &other) -> Variable &;
+
+    /**
+     * \brief Adds a scalar to *this
+     *
+     * \param n A scalar value
+     * \return The sum of *this and the scalar
+     */
+    auto operator+=(double n) -> Variable &;
+
+    /**
+     * \brief Subtracts other from *this
+     *
+     * \param other The subtrahend Variable
+     * \return The difference of *this and other
+     */
+    auto operator-=(const Variable &other) -> Variable &;
+
+    /**
+     * \brief Subtracts a scalar from *this
+     *
+     * \param n The subtrahend scalar
+     * \return The difference of *this and the scalar
+     */
+    auto operator-=(double n) -> Variable &;
+
+    /**
+     * \brief Multiplies *this by other
+     *
+     * \param other A Variable
+     * \return The product of *this and other
+     */
+    auto operator*=(const Variable &other) -> Variable &;
+
+    /**
+     * \brief Multiplies *this by a scalar
+     *
+     * \param scalar The scalar
+     * \return The product of *this and the scalar
+     */
+    auto operator*=(double scalar) -> Variable &;
+
+    /**
+     * \brief Divides *this by other
+     *
+     * \param other The divisor Variable
+     * \return The quotient of *this and other
+     */
+    auto operator/=(const Variable &other) -> Variable &;
+
+    /**
+     * \brief Divides *this by a scalar
+     *
+     * \param scalar The divisor scalar
+     * \return The quotient of *this and the scalar
+     */
+    auto operator/=(double scalar) -> Variable &;
+
+private:
+    /// The tape, or nullptr for passive values
+    Tape *m_tape{nullptr};
+
+    /// The node on the tape
+    std::uint32_t m_index{0};
+
+    /// The value
+    double m_value{0.0};
+};
+
+/**
+ * \brief Records operations on Variables so that their derivatives can be
+ * computed by sweeping backwards over them
+ *
+ * Variables refer to the tape by address, so a Tape can be neither copied nor
+ * moved. The recorded operations can be replayed at new inputs as long as the
+ * control flow of the recorded function does not depend on them.
+ */
+class Tape
+{
+public:
+    /// The default constructor
+    Tape() = default;
+    Tape(const Tape &) = delete;
+    Tape(Tape &&) = delete;
+    auto operator=(const Tape &) -> Tape & = delete;
+    auto operator=(Tape &&) -> Tape & = delete;
+    ~Tape() = default;
+
+    /**
+     * \brief Records a new independent variable
+     *
+     * \param value The value of the variable
+     * \return The variable
+     */
+    auto variable(double value) -> Variable;
+
+    /**
+     * \brief Marks a variable as an output of the recorded function
+     *
+     * \throws std::invalid_argument if output is recorded on another tape
+     *
+     * \param output The output; passive values are recorded as constants
+     */
+    auto register_output(const Variable &output) -> void;
+
+    /**
+     * \brief Records an operation
+     *
+     * \throws std::length_error if the tape is full
+     *
+     * \param op The operation
+     * \param lhs The first operand
+     * \param rhs The second operand, for binary operations
+     * \param constant The passive operand, if any
+     * \return The result of the operation
+     */
+    auto record(OpCode op, std::uint32_t lhs, std::uint32_t rhs = 0,
+                double constant = 0.0) -> Variable;
+
+    /**
+     * \brief Records a call to an external function as one node per output
+     *
+     * \throws std::invalid_argument if neither a jacobian nor a vjp is given,
+     * or if an input is recorded on another tape
+     * \throws std::runtime_error if the callbacks return the wrong sizes
+     *
+     * \param function The external function
+     * \param inputs The inputs of the call
+     * \return The outputs of the call
+     */
+    auto call(std::shared_ptr<const ExternalFunction> function,
+              const std::vector<Variable> &inputs) -> std::vector<Variable>;
+
+    /**
+     * \brief Records a branch of the recorded function on the sign of a
+     * variable
+     *
+     * The tape itself does not check guards when it is replayed; replays
+     * that take other branches, such as those of a TapeBatch, use them to
+     * detect where the recording no longer applies.
+     *
+     * \throws std::invalid_argument if condition is recorded on another tape
+     *
+     * \param condition The variable the branch depends on; passive values are
+     * not recorded
+     * \return true if condition is positive, to be used as the branch
+     */
+    auto guard(const Variable &condition) -> bool;
+
+    /**
+     * \brief Re-evaluates the recording at new inputs
+     *
+     * \throws std::invalid_argument if inputs does not have one value per
+     * independent variable
+     *
+     * \param inputs The new values of the independent variables
+     * \return The new values of the outputs
+     */
+    auto replay(const Eigen::VectorXd &inputs) -> Eigen::VectorXd;
+
+    /**
+     * \brief Re-evaluates the recording at new inputs, writing the outputs
+     * into caller storage
+     *
+     * \param inputs The new values of the independent variables, one per
+     * independent variable
+     * \param outputs Receives the new values of the outputs, one per output
+     */
+    auto replay(const double *inputs, double *outputs) -> void;
+
+    /**
+     * \brief Propagates adjoints from the last node back to the first
+     *
+     * \throws std::invalid_argument if adjoints does not have one entry per
+     * node
+     *
+     * \param adjoints The seed adjoint of every node, overwritten with the
+     * accumulated adjoints
+     */
+    auto reverse(std::vector<double> &adjoints) const -> void;
+
+    /**
+     * \brief Returns the transposed jacobian of the outputs times weights
+     *
+     * \throws std::invalid_argument if weights does not have one entry per
+     * output
+     *
+     * \param weights The weight of every output
+     * \return The weighted sum of the output gradients, one entry per input
+     */
+    auto vjp(const Eigen::VectorXd &weights) const -> Eigen::VectorXd;
+
+    /**
+     * \brief Returns the gradient of a variable with respect to the inputs
+     *
+     * \param output A variable recorded on the tape
+     * \return The gradient, one entry per input
+     */
+    auto gradient(const Variable &output) const -> Eigen::VectorXd;
+
+    /**
+     * \brief Returns the jacobian of the outputs with one sweep per output
+     *
+     * \return The output_count x input_count jacobian
+     */
+    auto jacobian() const -> Eigen::MatrixXd;
+
+    /**
+     * \brief Writes the jacobian of the outputs into caller storage with one
+     * sweep per output
+     *
+     * \param jacobian Receives the output_count x input_count jacobian in
+     * column-major order
+     * \param adjoints Scratch storage, resized to one entry per node; reusing
+     * it across calls avoids allocating
+     */
+    auto jacobian(double *jacobian, std::vector<double> &adjoints) const
+        -> void;
+
+    /**
+     * \brief Returns the partial derivatives of a node with respect to its
+     * operands at the recorded values
+     *
+     * \param index The node; must not be an ExternalOutput
+     * \return The partials with respect to lhs and rhs
+     */
+    auto partials(std::uint32_t index) const -> std::array<double, 2>;
+
+    /**
+     * \brief Returns the edges of the linearized computational graph that end
+     * at a node
+     *
+     * Every operand of the node is paired with the partial derivative of the
+     * node with respect to it. The outputs of an external call depend on every
+     * input of the call; a call with only a vjp is queried once per output.
+     *
+     * \param index The node
+     * \return The (operand, partial) pairs, each operand listed once
+     */
+    auto local_edges(std::uint32_t index) const
+        -> std::vector<std::pair<std::uint32_t, double>>;
+
+    /**
+     * \brief Removes every node, input and output
+     */
+    auto clear() -> void;
+
+    /**
+     * \brief Returns the number of nodes
+     *
+     * \return The number of nodes
+     */
+    auto size() const -> std::size_t
+    {
+        return m_nodes.size();
+    }
+
+    /**
+     * \brief Returns the recorded nodes
+     *
+     * \return The nodes
+     */
+    auto nodes() const -> const std::vector<Node> &
+    {
+        return m_nodes;
+    }
+
+    /**
+     * \brief Returns the value of every node
+     *
+     * \return The values
+     */
+    auto values() const -> const std::vector<double> &
+    {
+        return m_values;
+    }
+
+    /**
+     * \brief Returns the nodes of the independent variables
+     *
+     * \return The input nodes in creation order
+     */
+    auto inputs() const -> const std::vector<std::uint32_t> &
+    {
+        return m_inputs;
+    }
+
+    /**
+     * \brief Returns the nodes of the outputs
+     *
+     * \return The output nodes in registration order
+     */
+    auto outputs() const -> const std::vector<std::uint32_t> &
+    {
+        return m_outputs;
+    }
+
+    /**
+     * \brief Returns the branches taken while recording
+     *
+     * \return The guards in recording order
+     */
+    auto guards() const -> const std::vector<Guard> &
+    {
+        return m_guards;
+    }
+
+private:
+    /// A recorded call to an external function
+    struct ExternalCall {
+        std::shared_ptr<const ExternalFunction> function;
+        std::vector<std::uint32_t> inputs;
+        std::uint32_t first_output;
+        std::uint32_t output_count;
+        Eigen::MatrixXd jacobian;
+    };
+
+    auto push(const Node &node, double value) -> std::uint32_t;
+    auto operand(const Variable &var) -> std::uint32_t;
+    auto evaluate(ExternalCall &call, const Eigen::VectorXd &x)
+        -> Eigen::VectorXd;
+    auto reverse_call(const ExternalCall &call,
+                      std::vector<double> &adjoints) const -> void;
+
+    std::vector<Node> m_nodes{};
+    std::vector<double> m_values{};
+    std::vector<std::uint32_t> m_inputs{};
+    std::vector<std::uint32_t> m_outputs{};
+    std::vector<ExternalCall> m_calls{};
+    std::vector<Guard> m_guards{};
+};
+
+/**
+ * \brief Adds left and right
+ *
+ * \throws std::invalid_argument if left and right are on different tapes
+ *
+ * \param left A Variable
+ * \param right The other Variable
+ * \return The sum of the two Variables
+ */
+auto operator+(const Variable &left, const Variable &right) -> Variable;
+
+/**
+ * \brief Adds num and n
+ *
+ * \param num The Variable
+ * \param n The scalar
+ * \return The sum of the Variable and the scalar
+ */
+auto operator+(const Variable &num, double n) -> Variable;
+
+/**
+ * \brief Adds n and num
+ *
+ * \param n The scalar
+ * \param num The Variable
+ * \return The sum of the scalar and the Variable
+ */
+auto operator+(double n, const Variable &num) -> Variable;
+
+/**
+ * \brief Subtracts right from left
+ *
+ * \throws std::invalid_argument if left and right are on different tapes
+ *
+ * \param left The minuend Variable
+ * \param right The subtrahend Variable
+ * \return The difference of the two Variables
+ */
+auto operator-(const Variable &left, const Variable &right) -> Variable;
+
+/**
+ * \brief Subtracts n from num
+ *
+ * \param num The minuend Variable
+ * \param n The subtrahend scalar
+ * \return The difference of the Variable and the scalar
+ */
+auto operator-(const Variable &num, double n) -> Variable;
+
+/**
+ * \brief Subtracts num from n
+ *
+ * \param n The minuend scalar
+ * \param num The subtrahend Variable
+ * \return The difference of the scalar and the Variable
+ */
+auto operator-(double n, const Variable &num) -> Variable;
+
+/**
+ * \brief Multiplies left and right
+ *
+ * \throws std::invalid_argument if left and right are on different tapes
+ *
+ * \param left A Variable
+ * \param right The other Variable
+ * \return The product of the two Variables
+ */
+auto operator*(const Variable &left, const Variable &right) -> Variable;
+
+/**
+ * \brief Multiplies num by scalar
+ *
+ * \param num The Variable
+ * \param scalar The scalar
+ * \return The product of the Variable and the scalar
+ */
+auto operator*(const Variable &num, double scalar) -> Variable;
+
+/**
+ * \brief Multiplies scalar by num
+ *
+ * \param scalar The scalar
+ * \param num The Variable
+ * \return The product of the scalar and the Variable
+ */
+auto operator*(double scalar, const Variable &num) -> Variable;
+
+/**
+ * \brief Divides left by right
+ *
+ * \throws std::invalid_argument if left and right are on different tapes
+ *
+ * \param left The dividend Variable
+ * \param right The divisor Variable
+ * \return The quotient of the two Variables
+ */
+auto operator/(const Variable &left, const Variable &right) -> Variable;
+
+/**
+ * \brief Divides num by scalar
+ *
+ * \param num The dividend Variable
+ * \param scalar The divisor scalar
+ * \return The quotient of the Variable and the scalar
+ */
+auto operator/(const Variable &num, double scalar) -> Variable;
+
+/**
+ * \brief Divides scalar by num
+ *
+ * \param scalar The dividend scalar
+ * \param num The divisor Variable
+ * \return The quotient of the scalar and the Variable
+ */
+auto operator/(double scalar, const Variable &num) -> Variable;
+
+/**
+ * \brief Decides a branch of a recorded function on the sign of a Variable,
+ * recording it as a guard on the tape of the Variable
+ *
+ * Write if (branch(x - y)) instead of if (x.value() > y.value()) so replays
+ * over other inputs can detect when they take the other branch.
+ *
+ * \param condition The Variable the branch depends on
+ * \return true if condition is positive
+ */
+auto branch(const Variable &condition) -> bool;
+
+namespace internal
+{
+/**
+ * \brief Evaluates an operation on plain values
+ *
+ * \param op The operation; must not be Input or ExternalOutput
+ * \param lhs The value of the first operand
+ * \param rhs The value of the second operand
+ * \param constant The passive operand
+ * \return The result of the operation
+ */
+auto apply(OpCode op, double lhs, double rhs, double constant) -> double;
+
+/**
+ * \brief Returns the partial derivatives of an operation
+ *
+ * \param op The operation; must not be Input or ExternalOutput
+ * \param lhs The value of the first operand
+ * \param rhs The value of the second operand
+ * \param constant The passive operand
+ * \param value The result of the operation
+ * \return The partials with respect to lhs and rhs
+ */
+auto partials(OpCode op, double lhs, double rhs, double constant,
+              double value) -> std::array<double, 2>;
+
+/**
+ * \brief Applies a unary operation to a Variable, recording it if active
+ *
+ * \param op The operation
+ * \param num The operand
+ * \param constant The passive operand
+ * \return The result of the operation
+ */
+auto unary(OpCode op, const Variable &num, double constant = 0.0) -> Variable;
+
+} // namespace internal
+
+} // namespace algodiff::reverse
@@ -0,0 +1,157 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+/// \file tape_batch.hpp
+/// \brief Replays one recorded tape over many input points at once, with one
+/// point per lane
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <utility>
+
+#include <Eigen/Core>
+
+#include "reverse_mode.hpp"
+#include "tape.hpp"
+
+namespace algodiff::reverse
+{
+/**
+ * \brief A function recorded once and evaluated, with its vector-jacobian
+ * products, at a batch of points
+ *
+ * The values and adjoints are stored with one row per node and one column
+ * (lane) per point, so every node is decoded once per block of lanes and
+ * applied to a whole contiguous row with Eigen's vectorized kernels,
+ * transcendental functions included.
+ *
+ * The recording only holds for points that take the same branches. Branches
+ * decided with branch() are recorded as guards; lanes where the sign of a
+ * guard differs from the recording fall back to recording the function at
+ * their own point.
+ */
+class TapeBatch
+{
+public:
+    /// The recorded function
+    using Function = std::function<Eigen::VectorX<Variable>(
+        const Eigen::VectorX<Variable> &)>;
+
+    /**
+     * \brief Records the function
+     *
+     * \throws std::invalid_argument if the function calls external functions
+     * or lanes is not positive
+     *
+     * \tparam F Function Type that takes as input a Eigen::VectorX<Variable>
+     * and outputs a Eigen::VectorX<Variable>
+     * \param f The function to record
+     * \param u The point to record f at
+     * \param lanes The number of points evaluated together
+     */
+    template <class F>
+    TapeBatch(F &&f, const Eigen::VectorXd &u, Eigen::Index lanes = 64)
+        : m_function{std::forward<F>(f)}, m_tape{std::make_unique<Tape>()},
+          m_lanes{lanes}
+    {
+        record(*m_tape, m_function, u);
+        check();
+    }
+
+    /**
+     * \brief Returns the number of inputs of the function
+     *
+     * \return The number of inputs
+     */
+    auto input_count() const -> Eigen::Index
+    {
+        return static_cast<Eigen::Index>(m_tape->inputs().size());
+    }
+
+    /**
+     * \brief Returns the number of outputs of the function
+     *
+     * \return The number of outputs
+     */
+    auto output_count() const -> Eigen::Index
+    {
+        return static_cast<Eigen::Index>(m_tape->outputs().size());
+    }
+
+    /**
+     * \brief Returns the number of points evaluated together
+     *
+     * \return The number of lanes
+     */
+    auto lanes() const -> Eigen::Index
+    {
+        return m_lanes;
+    }
+
+    /**
+     * \brief Returns the recording
+     *
+     * \return The tape, with the values of the point it was recorded at
+     */
+    auto tape() const -> const Tape &
+    {
+        return *m_tape;
+    }
+
+    /**
+     * \brief Returns the number of points of the last evaluation that fell
+     * back to their own recording
+     *
+     * \return The number of points that failed a guard
+     */
+    auto fallbacks() const -> Eigen::Index
+    {
+        return m_fallbacks;
+    }
+
+    /**
+     * \brief Evaluates the function at every point
+     *
+     * \throws std::invalid_argument if points does not have one row per input
+     *
+     * \param points The points, one per column
+     * \return The outputs, one column per point
+     */
+    auto replay(const Eigen::MatrixXd &points) -> Eigen::MatrixXd;
+
+    /**
+     * \brief Computes the transposed jacobian times weights at every point
+     *
+     * \throws std::invalid_argument if points does not have one row per input
+     * or weights does not have one row per output and one column per point
+     *
+     * \param points The points, one per column
+     * \param weights The weight of every output, one column per point
+     * \return The weighted sums of the output gradients, one column per point
+     */
+    auto vjp(const Eigen::MatrixXd &points, const Eigen::MatrixXd &weights)
+        -> Eigen::MatrixXd;
+
+private:
+    /// One row per node, one column per lane
+    using Lanes =
+        Eigen::Array<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+    auto check() const -> void;
+    auto forward(const Eigen::MatrixXd &points, Eigen::Index start,
+                 Eigen::Index width) -> void;
+    auto reverse() -> void;
+    auto failures() const -> Eigen::Array<bool, 1, Eigen::Dynamic>;
+    auto fallback(const Eigen::VectorXd &point, Tape &tape) const -> void;
+
+    Function m_function;
+    std::unique_ptr<Tape> m_tape;
+    Eigen::Index m_lanes;
+    Eigen::Index m_fallbacks{0};
+    Lanes m_values{};
+    Lanes m_adjoints{};
+};
+
+} // namespace algodiff::reverse
@@ -0,0 +1,43 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+/// \file tape_eigen.hpp
+/// \brief Integrates tape variables with Eigen
+#pragma once
+
+#include <Eigen/Core>
+
+#include "tape.hpp"
+#include "tape_ops.hpp"
+
+namespace Eigen
+{
+template <>
+struct NumTraits<algodiff::reverse::Variable> : NumTraits<double> {
+    typedef algodiff::reverse::Variable Real;       // NOLINT
+    typedef algodiff::reverse::Variable NonInteger; // NOLINT
+    typedef algodiff::reverse::Variable Nested;     // NOLINT
+
+    enum {
+        IsComplex = 0,             // NOLINT
+        IsInteger = 0,             // NOLINT
+        IsSigned = 1,              // NOLINT
+        RequireInitialization = 1, // NOLINT
+        ReadCost = 1,              // NOLINT
+        AddCost = 8,               // NOLINT
+        MulCost = 8,               // NOLINT
+    };
+};
+
+template <typename BinaryOp>
+struct ScalarBinaryOpTraits<algodiff::reverse::Variable, double, BinaryOp> {
+    typedef algodiff::reverse::Variable ReturnType; // NOLINT
+};
+
+template <typename BinaryOp>
+struct ScalarBinaryOpTraits<double, algodiff::reverse::Variable, BinaryOp> {
+    typedef algodiff::reverse::Variable ReturnType; // NOLINT
+};
+
+} // namespace Eigen
@@ -0,0 +1,156 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+/// \file tape_interpreter.hpp
+/// \brief Contains a threaded-code interpreter that replays recorded tapes
+/// faster than Tape::replay
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <Eigen/Core>
+
+#include "tape.hpp"
+
+namespace algodiff::reverse
+{
+/// The operations of a TapeProgram
+enum class ProgramOp : std::uint8_t {
+    Add,              ///< a + b
+    Subtract,         ///< a - b
+    Multiply,         ///< a * b
+    Divide,           ///< a / b
+    Pow,              ///< a ^ b
+    Square,           ///< a * a
+    AddConstant,      ///< a + constant
+    ConstantSubtract, ///< constant - a
+    SubtractConstant, ///< a - constant
+    MultiplyConstant, ///< a * constant
+    DivideConstant,   ///< a / constant
+    ConstantDivide,   ///< constant / a
+    PowConstant,      ///< a ^ constant
+    ConstantPow,      ///< constant ^ a
+    Negate,           ///< -a
+    Abs,              ///< |a|
+    Sqrt,             ///< sqrt(a)
+    Exp,              ///< exp(a)
+    Log,              ///< log(a)
+    Sin,              ///< sin(a)
+    Cos,              ///< cos(a)
+    Tan,              ///< tan(a)
+    Asin,             ///< asin(a)
+    Acos,             ///< acos(a)
+    Atan,             ///< atan(a)
+    Sinh,             ///< sinh(a)
+    Cosh,             ///< cosh(a)
+    Tanh,             ///< tanh(a)
+    MultiplyAdd,      ///< a * b, then that plus c in the next node
+    SinCos,           ///< sin(a), then cos(a) in the next node
+    CosSin,           ///< cos(a), then sin(a) in the next node
+    Halt,             ///< The end of the program
+};
+
+/// One instruction of a TapeProgram
+struct Instruction {
+    /// The address of the code that executes the instruction, when threaded
+    const void *handler{nullptr};
+
+    /// The operation
+    ProgramOp op{ProgramOp::Halt};
+
+    /// The node that receives the result; fused operations also write the
+    /// node after it
+    std::uint32_t result{0};
+
+    /// The first operand
+    std::uint32_t a{0};
+
+    /// The second operand
+    std::uint32_t b{0};
+
+    /// The third operand, for MultiplyAdd
+    std::uint32_t c{0};
+
+    /// The passive operand, if any
+    double constant{0.0};
+};
+
+/**
+ * \brief A recorded tape translated into a compact program for fast replays
+ *
+ * Replaying a tape with a switch over its nodes spends much of its time on
+ * mispredicted branches. A TapeProgram instead ends the code of every
+ * instruction with its own jump to the code of the next one (direct threaded
+ * code, with GCC and Clang computed gotos; other compilers fall back to a
+ * switch). The translation also
+ *   - drops input and constant nodes, whose values never change,
+ *   - turns operations on constant nodes into operations on constants,
+ *   - and fuses common pairs of nodes into superinstructions: x * x,
+ *     a multiplication followed by an addition of its result, and sin and
+ *     cos of the same operand.
+ *
+ * Every node still receives its value, so values() matches Tape::values()
+ * after replaying both at the same inputs.
+ */
+class TapeProgram
+{
+public:
+    /**
+     * \brief Translates a tape
+     *
+     * \throws std::invalid_argument if the tape calls external functions
+     *
+     * \param tape The tape, which is only read during the translation
+     */
+    explicit TapeProgram(const Tape &tape);
+
+    /**
+     * \brief Re-evaluates the program at new inputs
+     *
+     * \throws std::invalid_argument if inputs does not have one value per
+     * independent variable
+     *
+     * \param inputs The new values of the independent variables
+     * \return The new values of the outputs
+     */
+    auto replay(const Eigen::VectorXd &inputs) -> Eigen::VectorXd;
+
+    /**
+     * \brief Returns the value of every node of the tape
+     *
+     * \return The values from the last replay, or the recorded values
+     */
+    auto values() const -> const std::vector<double> &
+    {
+        return m_values;
+    }
+
+    /**
+     * \brief Returns the instructions
+     *
+     * \return The instructions, ending with Halt
+     */
+    auto instructions() const -> const std::vector<Instruction> &
+    {
+        return m_program;
+    }
+
+    /**
+     * \brief Returns whether instructions jump straight to each other
+     *
+     * \return true if the program runs as direct threaded code, false if it
+     * uses the switch fallback
+     */
+    static auto is_threaded() -> bool;
+
+private:
+    std::vector<Instruction> m_program{};
+    std::vector<double> m_values{};
+    std::vector<std::uint32_t> m_inputs{};
+    std::vector<std::uint32_t> m_outputs{};
+};
+
+} // namespace algodiff::reverse
@@ -0,0 +1,203 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+/// \file tape_ops.hpp
+/// \brief Implements operations that can be recorded on a tape
+#pragma once
+
+#include "tape.hpp"
+
+namespace algodiff::reverse
+{
+/**
+ * \brief Returns the value of a Variable
+ *
+ * \param num The Variable
+ * \return The value of num
+ */
+inline auto value(const Variable &num) -> double
+{
+    return num.value();
+}
+
+/**
+ * \brief Returns the value of a Variable. This function can be useful with
+ * Eigen
+ *
+ * \param num The Variable
+ * \return The value of num
+ */
+inline auto real(const Variable &num) -> double
+{
+    return num.value();
+}
+
+/**
+ * \brief Returns the conjugate of a Variable, which is the Variable itself
+ *
+ * \param num The Variable
+ * \return num
+ */
+inline auto conj(const Variable &num) -> Variable
+{
+    return num;
+}
+
+/**
+ * \brief Computes the square of a Variable
+ *
+ * \param num The Variable
+ * \return The square of num
+ */
+auto abs2(const Variable &num) -> Variable;
+
+/**
+ * \brief Computes a Variable raised to the power of a scalar exponent
+ *
+ * \param num The Variable
+ * \param exponent The scalar exponent
+ * \return The Variable raised to the exponent
+ */
+auto pow(const Variable &num, double exponent) -> Variable;
+
+/**
+ * \brief Computes a Variable raised to the power of another Variable
+ *
+ * \throws std::invalid_argument if num and exponent are on different tapes
+ *
+ * \param num The Variable
+ * \param exponent The exponent Variable
+ * \return The Variable raised to the exponent Variable
+ */
+auto pow(const Variable &num, const Variable &exponent) -> Variable;
+
+/**
+ * \brief Computes 2 raised to the power of a Variable
+ *
+ * \param num The Variable
+ * \return The base-2 exponential of num
+ */
+auto exp2(const Variable &num) -> Variable;
+
+/**
+ * \brief Computes the base 2 logarithm of a Variable
+ *
+ * \param num The Variable
+ * \return The base 2 logarithm of num
+ */
+auto log2(const Variable &num) -> Variable;
+
+/**
+ * \brief Computes the base 10 logarithm of a Variable
+ *
+ * \param num The Variable
+ * \return The base 10 logarithm of num
+ */
+auto log10(const Variable &num) -> Variable;
+
+/**
+ * \brief Computes the absolute value of a Variable
+ *
+ * \param num The Variable
+ * \return The absolute value of num
+ */
+auto abs(const Variable &num) -> Variable;
+
+/**
+ * \brief Computes the square root of a Variable
+ *
+ * \param num The Variable
+ * \return The square root of num
+ */
+auto sqrt(const Variable &num) -> Variable;
+
+/**
+ * \brief Computes e (euler's number) raised to the power of a Variable
+ *
+ * \param num The Variable
+ * \return The base-e exponential of num
+ */
+auto exp(const Variable &num) -> Variable;
+
+/**
+ * \brief Computes the natural (base e) logarithm of a Variable
+ *
+ * \param num The Variable
+ * \return The natural logarithm of num
+ */
+auto log(const Variable &num) -> Variable;
+
+/**
+ * \brief Computes sine of a Variable
+ *
+ * \param num The Variable
+ * \return Sine of the Variable
+ */
+auto sin(const Variable &num) -> Variable;
+
+/**
+ * \brief Computes cosine of a Variable
+ *
+ * \param num The Variable
+ * \return Cosine of the Variable
+ */
+auto cos(const Variable &num) -> Variable;
+
+/**
+ * \brief Computes tangent of a Variable
+ *
+ * \param num The Variable
+ * \return Tangent of the Variable
+ */
+auto tan(const Variable &num) -> Variable;
+
+/**
+ * \brief Computes inverse sine of a Variable
+ *
+ * \param num The Variable
+ * \return Inverse sine of the Variable
+ */
+auto asin(const Variable &num) -> Variable;
+
+/**
+ * \brief Computes inverse cosine of a Variable
+ *
+ * \param num The Variable
+ * \return Inverse cosine of the Variable
+ */
+auto acos(const Variable &num) -> Variable;
+
+/**
+ * \brief Computes inverse tangent of a Variable
+ *
+ * \param num The Variable
+ * \return Inverse tangent of the Variable
+ */
+auto atan(const Variable &num) -> Variable;
+
+/**
+ * \brief Computes hyperbolic sine of a Variable
+ *
+ * \param num The Variable
+ * \return Hyperbolic sine of the Variable
+ */
+auto sinh(const Variable &num) -> Variable;
+
+/**
+ * \brief Computes hyperbolic cosine of a Variable
+ *
+ * \param num The Variable
+ * \return Hyperbolic cosine of the Variable
+ */
+auto cosh(const Variable &num) -> Variable;
+
+/**
+ * \brief Computes hyperbolic tangent of a Variable
+ *
+ * \param num The Variable
+ * \return Hyperbolic tangent of the Variable
+ */
+auto tanh(const Variable &num) -> Variable;
+
+} // namespace algodiff::reverse
@@ -0,0 +1,166 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+/// \file tape_template.hpp
+/// \brief Records loop bodies and repeated subroutines once and calls the
+/// recording instead of recording every iteration
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+
+#include <Eigen/Core>
+
+#include "reverse_mode.hpp"
+#include "tape.hpp"
+
+namespace algodiff::reverse
+{
+/**
+ * \brief A function recorded once on a tape of its own, which is then called
+ * on other tapes as an external function
+ *
+ * Every call records only one node per output and the nodes of its inputs,
+ * so the memory of a tape that calls a template many times grows with the
+ * size of the template rather than with the number of calls. Replaying the
+ * calling tape replays the template once per call, and every reverse sweep
+ * replays it again at the inputs of each call before sweeping it backwards,
+ * trading the stored intermediate values for recomputation.
+ *
+ * \warning Like Tape::replay, this only holds for functions whose control
+ * flow does not depend on the values of their inputs. Values that change
+ * between calls must be passed as inputs; anything else is frozen into the
+ * template when it is recorded
+ */
+class TapeTemplate
+{
+public:
+    /**
+     * \brief Records the template
+     *
+     * \tparam F Function Type that takes as input a Eigen::VectorX<Variable>
+     * and outputs a Eigen::VectorX<Variable>
+     * \param f The function to record
+     * \param u The point to record f at
+     */
+    template <class F>
+    TapeTemplate(F &&f, const Eigen::VectorXd &u)
+        : m_state{std::make_shared<State>()}
+    {
+        record(m_state->tape, std::forward<F>(f), u);
+        m_function = make_function(m_state);
+    }
+
+    /**
+     * \brief Returns the number of inputs of the template
+     *
+     * \return The number of inputs
+     */
+    auto input_count() const -> Eigen::Index
+    {
+        return static_cast<Eigen::Index>(m_state->tape.inputs().size());
+    }
+
+    /**
+     * \brief Returns the number of outputs of the template
+     *
+     * \return The number of outputs
+     */
+    auto output_count() const -> Eigen::Index
+    {
+        return static_cast<Eigen::Index>(m_state->tape.outputs().size());
+    }
+
+    /**
+     * \brief Returns the number of nodes of the template
+     *
+     * \return The number of nodes, stored once however often it is called
+     */
+    auto size() const -> std::size_t
+    {
+        return m_state->tape.size();
+    }
+
+    /**
+     * \brief Returns the external function that evaluates the template
+     *
+     * \return The external function, with a vjp that sweeps the template
+     */
+    auto function() const -> const std::shared_ptr<const ExternalFunction> &
+    {
+        return m_function;
+    }
+
+    /**
+     * \brief Calls the template
+     *
+     * Active inputs record the call on their tape; if every input is passive
+     * the template is only evaluated.
+     *
+     * \throws std::invalid_argument if the number of inputs differs from the
+     * template or the inputs are on different tapes
+     *
+     * \param inputs The inputs of the call
+     * \return The outputs of the call
+     */
+    auto operator()(const Eigen::VectorX<Variable> &inputs) const
+        -> Eigen::VectorX<Variable>;
+
+private:
+    /// The recording, shared by every tape that calls it
+    struct State {
+        Tape tape;
+        std::mutex mutex;
+    };
+
+    static auto make_function(const std::shared_ptr<State> &state)
+        -> std::shared_ptr<const ExternalFunction>;
+
+    std::shared_ptr<State> m_state;
+    std::shared_ptr<const ExternalFunction> m_function;
+};
+
+/**
+ * \brief Records a loop that applies step to a state a number of times,
+ * recording step only once
+ *
+ * The first iteration records step as a TapeTemplate at the values of the
+ * initial state and every iteration, the first included, calls it.
+ *
+ * \throws std::invalid_argument if step does not return a state of the same
+ * size
+ *
+ * \tparam F Function Type that takes as input a Eigen::VectorX<Variable> and
+ * outputs a Eigen::VectorX<Variable> of the same size
+ * \param step The loop body
+ * \param state The initial state
+ * \param trips The number of iterations
+ * \return The final state
+ */
+template <class F>
+auto record_loop(F &&step, Eigen::VectorX<Variable> state, std::size_t trips)
+    -> Eigen::VectorX<Variable>
+{
+    if (trips == 0) {
+        return state;
+    }
+    Eigen::VectorXd u(state.size());
+    for (Eigen::Index i = 0; i < state.size(); ++i) {
+        u[i] = state[i].value();
+    }
+    const TapeTemplate body{std::forward<F>(step), u};
+    if (body.output_count() != state.size()) {
+        throw std::invalid_argument(
+            "The loop body must return a state of the same size");
+    }
+    for (std::size_t trip = 0; trip < trips; ++trip) {
+        state = body(state);
+    }
+    return state;
+}
+
+} // namespace algodiff::reverse
@@ -0,0 +1,81 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+/// \file thread_pool.hpp
+/// \brief Contains a fixed-size pool of worker threads that runs submitted
+/// tasks
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace algodiff
+{
+/**
+ * \brief Runs submitted tasks on a fixed set of worker threads
+ *
+ * Tasks start in submission order. Destroying the pool waits for every
+ * submitted task to finish. This is the default executor of the asynchronous
+ * drivers, but any type with a compatible submit member can be used instead.
+ */
+class ThreadPool
+{
+public:
+    /**
+     * \brief Starts the worker threads
+     *
+     * \param threads The number of workers, 0 for one per hardware thread
+     */
+    explicit ThreadPool(unsigned threads = 0);
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool(ThreadPool &&) = delete;
+    auto operator=(const ThreadPool &) -> ThreadPool & = delete;
+    auto operator=(ThreadPool &&) -> ThreadPool & = delete;
+
+    /// Runs the remaining tasks and joins the workers
+    ~ThreadPool();
+
+    /**
+     * \brief Queues a task
+     *
+     * \throws std::runtime_error if the pool is shutting down
+     *
+     * \param task The task; it must not throw
+     */
+    auto submit(std::function<void()> task) -> void;
+
+    /**
+     * \brief Returns the number of worker threads
+     *
+     * \return The number of worker threads
+     */
+    auto size() const -> std::size_t
+    {
+        return m_workers.size();
+    }
+
+private:
+    auto run() -> void;
+
+    std::mutex m_mutex{};
+    std::condition_variable m_ready{};
+    std::deque<std::function<void()>> m_tasks{};
+    bool m_stopping{false};
+    std::vector<std::thread> m_workers{};
+};
+
+/**
+ * \brief Returns a process wide pool with one worker per hardware thread
+ *
+ * \return The default executor
+ */
+auto default_executor() -> ThreadPool &;
+
+} // namespace algodiff
@@ -0,0 +1,158 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+/// \file trajectory_jacobian.hpp
+/// \brief Block-structured jacobians of multiple shooting dynamics constraints
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include <Eigen/SparseCore>
+
+#include "dual_number.hpp"
+#include "dual_number_eigen.hpp"
+#include "forward_mode.hpp"
+#include "parallel.hpp"
+
+namespace algodiff::forward
+{
+/**
+ * \brief The linearization of one stage of the dynamics constraint
+ * x_{k+1} = f(x_k, u_k)
+ *
+ * \tparam StateSize The dimension of the state
+ * \tparam ControlSize The dimension of the control
+ */
+template <int StateSize, int ControlSize> struct StageJacobian {
+    /// The derivative of f with respect to the state x_k
+    Eigen::Matrix<double, StateSize, StateSize> A{};
+
+    /// The derivative of f with respect to the control u_k
+    Eigen::Matrix<double, StateSize, ControlSize> B{};
+
+    /// The constraint residual f(x_k, u_k) - x_{k+1}
+    Eigen::Vector<double, StateSize> defect{};
+};
+
+/**
+ * \brief The block-banded jacobian of the stacked dynamics constraints of a
+ * trajectory
+ *
+ * Stage k contributes the rows of the constraint f(x_k, u_k) - x_{k+1} = 0,
+ * whose only non-zero blocks are A_k (columns of x_k), B_k (columns of u_k)
+ * and -I (columns of x_{k+1}). Riccati and banded solvers can consume the
+ * blocks directly; to_sparse() assembles the full matrix when needed.
+ *
+ * \tparam StateSize The dimension of the state
+ * \tparam ControlSize The dimension of the control
+ */
+template <int StateSize, int ControlSize> struct TrajectoryJacobian {
+    /// One entry per stage of the horizon
+    std::vector<StageJacobian<StateSize, ControlSize>> stages{};
+
+    /**
+     * \brief Returns the number of stages
+     *
+     * \return The horizon length
+     */
+    auto horizon() const -> Eigen::Index
+    {
+        return static_cast<Eigen::Index>(stages.size());
+    }
+
+    /**
+     * \brief Assembles the sparse constraint jacobian
+     *
+     * The columns follow the interleaved ordering
+     * [x_0, u_0, x_1, u_1, ..., x_{N-1}, u_{N-1}, x_N].
+     *
+     * \return The (N * StateSize) x (N * (StateSize + ControlSize) +
+     * StateSize) sparse jacobian
+     */
+    auto to_sparse() const -> Eigen::SparseMatrix<double>
+    {
+        constexpr Eigen::Index stride{StateSize + ControlSize};
+        std::vector<Eigen::Triplet<double>> triplets{};
+        triplets.reserve(stages.size() * StateSize * (stride + 1));
+        for (Eigen::Index k = 0; k < horizon(); ++k) {
+            const auto &stage{stages[static_cast<size_t>(k)]};
+            const auto row{k * StateSize};
+            const auto col{k * stride};
+            for (Eigen::Index i = 0; i < StateSize; ++i) {
+                for (Eigen::Index j = 0; j < StateSize; ++j) {
+                    triplets.emplace_back(row + i, col + j, stage.A(i, j));
+                }
+                for (Eigen::Index j = 0; j < ControlSize; ++j) {
+                    triplets.emplace_back(row + i, col + StateSize + j,
+                                          stage.B(i, j));
+                }
+                triplets.emplace_back(row + i, col + stride + i, -1.0);
+            }
+        }
+
+        Eigen::SparseMatrix<double> jac(horizon() * StateSize,
+                                        horizon() * stride + StateSize);
+        jac.setFromTriplets(triplets.begin(), triplets.end());
+        return jac;
+    }
+};
+
+/**
+ * \brief Computes the stage jacobian blocks of the dynamics constraints
+ * x_{k+1} = f(x_k, u_k) along a trajectory
+ *
+ * Each stage is differentiated independently with a fixed size forward pass
+ * over its StateSize + ControlSize inputs, and stages are spread over worker
+ * threads. The cost is linear in the horizon, unlike differentiating the
+ * stacked trajectory densely.
+ *
+ * \throws std::invalid_argument if states does not hold one more entry than
+ * controls
+ *
+ * \tparam StateSize The dimension of the state
+ * \tparam ControlSize The dimension of the control
+ * \tparam F Function Type that takes as input the stacked stage vector
+ * [x_k; u_k] as a Eigen::Vector<DualNumber, StateSize + ControlSize> and
+ * outputs the next state as a vector of DualNumbers of size StateSize. It is
+ * called concurrently from several threads
+ * \param f The stage dynamics
+ * \param states The states x_0, ..., x_N
+ * \param controls The controls u_0, ..., u_{N-1}
+ * \param threads The number of worker threads, 0 for one per hardware thread
+ * \return The block structured jacobian of the dynamics constraints
+ */
+template <int StateSize, int ControlSize, class F>
+auto trajectory_jacobian(
+    F &&f, const std::vector<Eigen::Vector<double, StateSize>> &states,
+    const std::vector<Eigen::Vector<double, ControlSize>> &controls,
+    unsigned threads = 0) -> TrajectoryJacobian<StateSize, ControlSize>
+{
+    constexpr int stage_size{StateSize + ControlSize};
+    if (states.size() != controls.size() + 1) {
+        throw std::invalid_argument(
+            "states must hold one more entry than controls");
+    }
+
+    TrajectoryJacobian<StateSize, ControlSize> result{};
+    result.stages.resize(controls.size());
+    algodiff::internal::parallel_for(
+        result.horizon(), threads, [&](std::int64_t k) {
+            const auto stage_index{static_cast<size_t>(k)};
+            Eigen::Vector<double, stage_size> z{};
+            z << states[stage_index], controls[stage_index];
+
+            // The next state is the primal of the seeded passes, so the
+            // dynamics are evaluated stage_size times and not once more
+            const auto next{value_and_jacobian<StateSize>(f, z)};
+            auto &stage{result.stages[stage_index]};
+            stage.A = next.jacobian.template leftCols<StateSize>();
+            stage.B = next.jacobian.template rightCols<ControlSize>();
+            stage.defect = next.value - states[stage_index + 1];
+        });
+    return result;
+}
+
+} // namespace algodiff::forward
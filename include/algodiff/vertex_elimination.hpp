@@ -0,0 +1,61 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+/// \file vertex_elimination.hpp
+/// \brief Accumulates jacobians by eliminating the intermediate vertices of a
+/// recorded computational graph
+#pragma once
+
+#include <cstddef>
+
+#include <Eigen/Core>
+
+#include "tape.hpp"
+
+namespace algodiff::reverse
+{
+/// The order in which intermediate vertices are eliminated
+enum class EliminationOrder {
+    /// In recording order, which performs the work of forward mode
+    Forward,
+
+    /// In reverse recording order, which performs the work of reverse mode
+    Reverse,
+
+    /// Always the vertex with the fewest predecessors times successors
+    Markowitz,
+};
+
+/// A jacobian obtained by vertex elimination
+struct JacobianAccumulation {
+    /// The output_count x input_count jacobian
+    Eigen::MatrixXd jacobian{};
+
+    /// The number of multiplications performed by the elimination
+    std::size_t multiplications{0};
+};
+
+/**
+ * \brief Computes the jacobian of the outputs of a tape with respect to its
+ * inputs by vertex elimination
+ *
+ * The tape is linearized at its current values into a graph whose edges carry
+ * local partial derivatives. Eliminating an intermediate vertex connects each
+ * of its predecessors to each of its successors with the product of the two
+ * edges, so once only inputs and outputs remain the edges are the jacobian.
+ * Unlike pure forward or reverse mode, cross-country orders such as Markowitz
+ * exploit narrow bottlenecks in the middle of the graph.
+ *
+ * See: Griewank and Walther, "Evaluating Derivatives", 2nd ed., SIAM 2008,
+ * chapter 9
+ *
+ * \param tape A tape with registered outputs
+ * \param order The elimination order
+ * \return The jacobian and the number of multiplications spent on it
+ */
+auto accumulate_jacobian(const Tape &tape,
+                         EliminationOrder order = EliminationOrder::Markowitz)
+    -> JacobianAccumulation;
+
+} // namespace algodiff::reverse
@@ -58,22 +58,38 @@ PYBIND11_MODULE(algodiff_py, m)
         .def(double() / py::self);
 
     // DualNumber operations
-    m.def("primal", &algodiff::forward::primal,
+    m.def("primal",
+          py::overload_cast<const algodiff::forward::DualNumber &>(
+              &algodiff::forward::primal),
           "Returns the primal component of a DualNumber");
-    m.def("real", &algodiff::forward::real,
+    m.def("real",
+          py::overload_cast<const algodiff::forward::DualNumber &>(
+              &algodiff::forward::real),
           "Returns the primal component of a DualNumber");
     m.def("dual", &algodiff::forward::dual,
           "Returns the dual component of a DualNumber");
     m.def("imag", &algodiff::forward::imag,
           "Returns the dual component of a DualNumber");
-    m.def("abs", &algodiff::forward::abs,
+    m.def("abs",
+          py::overload_cast<const algodiff::forward::DualNumber &>(
+              &algodiff::forward::abs),
           "Returns the absolute value of the primal component");
-    m.def("inverse", &algodiff::forward::inverse,
+    m.def("inverse",
+          py::overload_cast<const algodiff::forward::DualNumber &>(
+              &algodiff::forward::inverse),
           "Returns the inverse of a DualNumber");
-    m.def("conj", &algodiff::forward::conj,
+    m.def("conj",
+          py::overload_cast<const algodiff::forward::DualNumber &>(
+              &algodiff::forward::conj),
           "Returns the conjugate of a DualNumber");
-    m.def("abs2", &algodiff::forward::abs2, "Returns the norm of a DualNumber");
-    m.def("norm", &algodiff::forward::norm, "Returns the norm of a DualNumber");
+    m.def("abs2",
+          py::overload_cast<const algodiff::forward::DualNumber &>(
+              &algodiff::forward::abs2),
+          "Returns the norm of a DualNumber");
+    m.def("norm",
+          py::overload_cast<const algodiff::forward::DualNumber &>(
+              &algodiff::forward::norm),
+          "Returns the norm of a DualNumber");
     m.def("pow",
           py::overload_cast<const algodiff::forward::DualNumber &, double>(
               &algodiff::forward::pow),
@@ -83,43 +99,136 @@ PYBIND11_MODULE(algodiff_py, m)
                             const algodiff::forward::DualNumber &>(
               &algodiff::forward::pow),
           "Returns a DualNumber raised to the power of a another DualNumber");
-    m.def("sqrt", &algodiff::forward::sqrt,
+    m.def("pow", &algodiff::forward::pow<int>,
+          "Returns a DualNumber raised to the power of an integer exponent");
+    m.def("cbrt",
+          py::overload_cast<const algodiff::forward::DualNumber &>(
+              &algodiff::forward::cbrt),
+          "Returns the cube root of a DualNumber");
+    m.def("hypot",
+          py::overload_cast<const algodiff::forward::DualNumber &,
+                            const algodiff::forward::DualNumber &>(
+              &algodiff::forward::hypot),
+          "Computes sqrt(x * x + y * y) without overflowing");
+    m.def("sqrt",
+          py::overload_cast<const algodiff::forward::DualNumber &>(
+              &algodiff::forward::sqrt),
           "Returns the square root of a DualNumber");
-    m.def("exp", &algodiff::forward::exp,
+    m.def("exp",
+          py::overload_cast<const algodiff::forward::DualNumber &>(
+              &algodiff::forward::exp),
           "Computes e (euler's number) raised to the power of a DualNumber");
-    m.def("exp2", &algodiff::forward::exp2,
+    m.def("exp2",
+          py::overload_cast<const algodiff::forward::DualNumber &>(
+              &algodiff::forward::exp2),
           "Computes 2 raised to the power of a DualNumber");
+    m.def("expm1",
+          py::overload_cast<const algodiff::forward::DualNumber &>(
+              &algodiff::forward::expm1),
+          "Computes exp(num) - 1 accurately for small DualNumbers");
     m.def("log",
           py::overload_cast<const algodiff::forward::DualNumber &>(
               &algodiff::forward::log),
           "Returns the natural (base e) logarithm of a DualNumber");
-    m.def("log2", &algodiff::forward::log2,
+    m.def("log2",
+          py::overload_cast<const algodiff::forward::DualNumber &>(
+              &algodiff::forward::log2),
           "Computes the base 2 logarithm of a DualNumber");
-    m.def("log10", &algodiff::forward::log10,
+    m.def("log10",
+          py::overload_cast<const algodiff::forward::DualNumber &>(
+              &algodiff::forward::log10),
           "Computes the base 10 logarithm of a DualNumber");
+    m.def("log1p",
+          py::overload_cast<const algodiff::forward::DualNumber &>(
+              &algodiff::forward::log1p),
+          "Computes log(1 + num) accurately for small DualNumbers");
     m.def("log",
           py::overload_cast<const algodiff::forward::DualNumber &, double>(
               &algodiff::forward::log),
           "Compute the input base logarithm of a DualNumber");
-    m.def("cos", &algodiff::forward::cos, "Computes cosine of a DualNumber");
-    m.def("sin", &algodiff::forward::sin, "Computes sine of a DualNumber");
-    m.def("tan", &algodiff::forward::tan, "Computes tangent of a DualNumber");
-    m.def("acos", &algodiff::forward::acos,
+    m.def("cos",
+          py::overload_cast<const algodiff::forward::DualNumber &>(
+              &algodiff::forward::cos),
+          "Computes cosine of a DualNumber");
+    m.def("sin",
+          py::overload_cast<const algodiff::forward::DualNumber &>(
+              &algodiff::forward::sin),
+          "Computes sine of a DualNumber");
+    m.def("tan",
+          py::overload_cast<const algodiff::forward::DualNumber &>(
+              &algodiff::forward::tan),
+          "Computes tangent of a DualNumber");
+    m.def("acos",
+          py::overload_cast<const algodiff::forward::DualNumber &>(
+              &algodiff::forward::acos),
           "Computes inverse cosine of a DualNumber");
-    m.def("asin", &algodiff::forward::asin,
+    m.def("asin",
+          py::overload_cast<const algodiff::forward::DualNumber &>(
+              &algodiff::forward::asin),
           "Computes inverse sine of a DualNumber");
-    m.def("atan", &algodiff::forward::atan,
+    m.def("atan",
+          py::overload_cast<const algodiff::forward::DualNumber &>(
+              &algodiff::forward::atan),
           "Computes inverse tangent of a DualNumber");
-    m.def("cosh", &algodiff::forward::cosh,
+    m.def("atan2",
+          py::overload_cast<const algodiff::forward::DualNumber &,
+                            const algodiff::forward::DualNumber &>(
+              &algodiff::forward::atan2),
+          "Computes the angle of the point (x, y) from the positive x axis");
+    m.def("cosh",
+          py::overload_cast<const algodiff::forward::DualNumber &>(
+              &algodiff::forward::cosh),
           "Computes hyperbolic cosine of a DualNumber");
-    m.def("sinh", &algodiff::forward::sinh,
+    m.def("sinh",
+          py::overload_cast<const algodiff::forward::DualNumber &>(
+              &algodiff::forward::sinh),
           "Computes hyperbolic sine of a DualNumber");
-    m.def("tanh", &algodiff::forward::tanh,
+    m.def("tanh",
+          py::overload_cast<const algodiff::forward::DualNumber &>(
+              &algodiff::forward::tanh),
           "Computes hyperbolic tangent of a DualNumber");
-    m.def("acosh", &algodiff::forward::acosh,
+    m.def("acosh",
+          py::overload_cast<const algodiff::forward::DualNumber &>(
+              &algodiff::forward::acosh),
           "Computes inverse hyperbolic cosine of a DualNumber");
-    m.def("asinh", &algodiff::forward::asinh,
+    m.def("asinh",
+          py::overload_cast<const algodiff::forward::DualNumber &>(
+              &algodiff::forward::asinh),
           "Computes inverse hyperbolic sine of a DualNumber");
-    m.def("atanh", &algodiff::forward::atanh,
+    m.def("atanh",
+          py::overload_cast<const algodiff::forward::DualNumber &>(
+              &algodiff::forward::atanh),
           "Computes inverse hyperbolic tangent of a DualNumber");
+    m.def("erf",
+          py::overload_cast<const algodiff::forward::DualNumber &>(
+              &algodiff::forward::erf),
+          "Computes the error function of a DualNumber");
+    m.def("erfc",
+          py::overload_cast<const algodiff::forward::DualNumber &>(
+              &algodiff::forward::erfc),
+          "Computes the complementary error function of a DualNumber");
+    m.def("lgamma",
+          py::overload_cast<const algodiff::forward::DualNumber &>(
+              &algodiff::forward::lgamma),
+          "Computes the log of the absolute gamma function of a DualNumber");
+    m.def("tgamma",
+          py::overload_cast<const algodiff::forward::DualNumber &>(
+              &algodiff::forward::tgamma),
+          "Computes the gamma function of a DualNumber");
+    m.def("fma",
+          py::overload_cast<const algodiff::forward::DualNumber &,
+                            const algodiff::forward::DualNumber &,
+                            const algodiff::forward::DualNumber &>(
+              &algodiff::forward::fma),
+          "Computes x * y + z with a single rounding of the primal component");
+    m.def("fmin",
+          py::overload_cast<const algodiff::forward::DualNumber &,
+                            const algodiff::forward::DualNumber &>(
+              &algodiff::forward::fmin),
+          "Returns the DualNumber with the smaller primal component");
+    m.def("fmax",
+          py::overload_cast<const algodiff::forward::DualNumber &,
+                            const algodiff::forward::DualNumber &>(
+              &algodiff::forward::fmax),
+          "Returns the DualNumber with the larger primal component");
 }
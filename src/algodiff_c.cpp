@@ -0,0 +1,470 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "algodiff/algodiff_c.h"
+#include "algodiff/model_registry.hpp"
+#include "algodiff/server_plugin.hpp"
+#include "algodiff/tape.hpp"
+#include "algodiff/tape_ops.hpp"
+
+struct algodiff_tape {
+    std::unique_ptr<algodiff::reverse::Tape> tape{
+        std::make_unique<algodiff::reverse::Tape>()};
+    std::vector<algodiff::reverse::Variable> variables{};
+};
+
+struct algodiff_model {
+    std::shared_ptr<const algodiff::Model> model{};
+};
+
+struct algodiff_workspace {
+    const algodiff_model *owner{nullptr};
+
+    /// The model, or its copy that keeps scratch storage between calls
+    algodiff::Model model{};
+
+    // Staging for buffers that are not contiguous
+    Eigen::VectorXd x{};
+    Eigen::VectorXd v{};
+    Eigen::VectorXd value{};
+    Eigen::VectorXd jv{};
+    Eigen::MatrixXd jacobian{};
+};
+
+namespace
+{
+using algodiff::reverse::Variable;
+
+thread_local std::string last_error{}; // NOLINT
+
+auto fail(algodiff_status status, const char *message) -> algodiff_status
+{
+    last_error = message;
+    return status;
+}
+
+// Runs fn, turning the exceptions of the C++ API into status codes
+template <class Fn> auto guard(Fn &&fn) -> algodiff_status
+{
+    try {
+        return fn();
+    } catch (const std::invalid_argument &error) {
+        return fail(ALGODIFF_ERROR_INVALID_ARGUMENT, error.what());
+    } catch (const std::bad_alloc &) {
+        return fail(ALGODIFF_ERROR_OUT_OF_MEMORY, "Out of memory");
+    } catch (const std::exception &error) {
+        return fail(ALGODIFF_ERROR_EVALUATION, error.what());
+    } catch (...) {
+        return fail(ALGODIFF_ERROR_EVALUATION, "Unknown exception");
+    }
+}
+
+auto variable(const algodiff_tape *tape, algodiff_var index) -> const Variable &
+{
+    if (index >= tape->variables.size()) {
+        throw std::invalid_argument("Unknown variable");
+    }
+    return tape->variables[index];
+}
+
+auto push(algodiff_tape *tape, Variable variable, algodiff_var *out)
+    -> algodiff_status
+{
+    tape->variables.push_back(variable);
+    *out = static_cast<algodiff_var>(tape->variables.size() - 1);
+    return ALGODIFF_OK;
+}
+
+auto unary(algodiff_unary_op op, const Variable &x) -> Variable
+{
+    namespace r = algodiff::reverse;
+    switch (op) {
+    case ALGODIFF_NEGATE:
+        return -x;
+    case ALGODIFF_ABS:
+        return r::abs(x);
+    case ALGODIFF_SQRT:
+        return r::sqrt(x);
+    case ALGODIFF_EXP:
+        return r::exp(x);
+    case ALGODIFF_LOG:
+        return r::log(x);
+    case ALGODIFF_SIN:
+        return r::sin(x);
+    case ALGODIFF_COS:
+        return r::cos(x);
+    case ALGODIFF_TAN:
+        return r::tan(x);
+    case ALGODIFF_ASIN:
+        return r::asin(x);
+    case ALGODIFF_ACOS:
+        return r::acos(x);
+    case ALGODIFF_ATAN:
+        return r::atan(x);
+    case ALGODIFF_SINH:
+        return r::sinh(x);
+    case ALGODIFF_COSH:
+        return r::cosh(x);
+    case ALGODIFF_TANH:
+        return r::tanh(x);
+    }
+    throw std::invalid_argument("Unknown unary operation");
+}
+
+auto binary(algodiff_binary_op op, const Variable &lhs, const Variable &rhs)
+    -> Variable
+{
+    switch (op) {
+    case ALGODIFF_ADD:
+        return lhs + rhs;
+    case ALGODIFF_SUBTRACT:
+        return lhs - rhs;
+    case ALGODIFF_MULTIPLY:
+        return lhs * rhs;
+    case ALGODIFF_DIVIDE:
+        return lhs / rhs;
+    case ALGODIFF_POW:
+        return algodiff::reverse::pow(lhs, rhs);
+    }
+    throw std::invalid_argument("Unknown binary operation");
+}
+
+auto check(const algodiff_model *model, const algodiff_workspace *workspace)
+    -> const algodiff::Model &
+{
+    if (model == nullptr || workspace == nullptr) {
+        throw std::invalid_argument("The model and workspace must not be null");
+    }
+    if (workspace->owner != model) {
+        throw std::invalid_argument(
+            "The workspace was created for a different model");
+    }
+    return workspace->model;
+}
+
+// Returns x itself when it is contiguous, else a copy gathered into staging
+auto gather(const double *x, std::ptrdiff_t incx, Eigen::VectorXd &staging)
+    -> const double *
+{
+    if (staging.size() > 0 && x == nullptr) {
+        throw std::invalid_argument("Input vectors must not be null");
+    }
+    if (incx == 1) {
+        return x;
+    }
+    for (Eigen::Index i = 0; i < staging.size(); ++i) {
+        staging[i] = x[i * incx];
+    }
+    return staging.data();
+}
+
+// Returns y itself when results can be written there directly, else staging
+auto target(double *y, std::ptrdiff_t incy, Eigen::VectorXd &staging)
+    -> double *
+{
+    return y != nullptr && incy == 1 ? y : staging.data();
+}
+
+auto scatter(const Eigen::VectorXd &in, double *y, std::ptrdiff_t incy) -> void
+{
+    if (y == nullptr) {
+        return;
+    }
+    for (Eigen::Index i = 0; i < in.size(); ++i) {
+        y[i * incy] = in[i];
+    }
+}
+
+} // namespace
+
+extern "C" {
+
+const char *algodiff_status_string(algodiff_status status)
+{
+    switch (status) {
+    case ALGODIFF_OK:
+        return "Success";
+    case ALGODIFF_ERROR_INVALID_ARGUMENT:
+        return "Invalid argument";
+    case ALGODIFF_ERROR_DIMENSION_MISMATCH:
+        return "Dimension mismatch";
+    case ALGODIFF_ERROR_NOT_FOUND:
+        return "Not found";
+    case ALGODIFF_ERROR_EVALUATION:
+        return "Evaluation failed";
+    case ALGODIFF_ERROR_OUT_OF_MEMORY:
+        return "Out of memory";
+    }
+    return "Unknown status";
+}
+
+const char *algodiff_last_error(void)
+{
+    return last_error.c_str();
+}
+
+algodiff_status algodiff_tape_create(algodiff_tape **tape)
+{
+    return guard([&] {
+        if (tape == nullptr) {
+            throw std::invalid_argument("tape must not be null");
+        }
+        *tape = new algodiff_tape{};
+        return ALGODIFF_OK;
+    });
+}
+
+void algodiff_tape_destroy(algodiff_tape *tape)
+{
+    delete tape;
+}
+
+algodiff_status algodiff_tape_input(algodiff_tape *tape, double value,
+                                    algodiff_var *out)
+{
+    return guard([&] {
+        if (tape == nullptr || out == nullptr || !tape->tape) {
+            throw std::invalid_argument("Invalid tape or output");
+        }
+        return push(tape, tape->tape->variable(value), out);
+    });
+}
+
+algodiff_status algodiff_tape_constant(algodiff_tape *tape, double value,
+                                       algodiff_var *out)
+{
+    return guard([&] {
+        if (tape == nullptr || out == nullptr || !tape->tape) {
+            throw std::invalid_argument("Invalid tape or output");
+        }
+        return push(tape, Variable{value}, out);
+    });
+}
+
+algodiff_status algodiff_tape_unary(algodiff_tape *tape, algodiff_unary_op op,
+                                    algodiff_var operand, algodiff_var *out)
+{
+    return guard([&] {
+        if (tape == nullptr || out == nullptr || !tape->tape) {
+            throw std::invalid_argument("Invalid tape or output");
+        }
+        return push(tape, unary(op, variable(tape, operand)), out);
+    });
+}
+
+algodiff_status algodiff_tape_binary(algodiff_tape *tape,
+                                     algodiff_binary_op op, algodiff_var lhs,
+                                     algodiff_var rhs, algodiff_var *out)
+{
+    return guard([&] {
+        if (tape == nullptr || out == nullptr || !tape->tape) {
+            throw std::invalid_argument("Invalid tape or output");
+        }
+        return push(tape,
+                    binary(op, variable(tape, lhs), variable(tape, rhs)), out);
+    });
+}
+
+algodiff_status algodiff_tape_output(algodiff_tape *tape, algodiff_var output)
+{
+    return guard([&] {
+        if (tape == nullptr || !tape->tape) {
+            throw std::invalid_argument("Invalid tape");
+        }
+        tape->tape->register_output(variable(tape, output));
+        return ALGODIFF_OK;
+    });
+}
+
+algodiff_status algodiff_model_from_tape(algodiff_tape *tape,
+                                         algodiff_model **model)
+{
+    return guard([&] {
+        if (tape == nullptr || model == nullptr || !tape->tape) {
+            throw std::invalid_argument("Invalid tape or output");
+        }
+        auto result{std::make_unique<algodiff_model>()};
+        result->model = std::make_shared<const algodiff::Model>(
+            algodiff::reverse::make_tape_model(std::move(tape->tape)));
+        tape->variables.clear();
+        *model = result.release();
+        return ALGODIFF_OK;
+    });
+}
+
+algodiff_status algodiff_model_load_plugin(const char *path, const char *name,
+                                           algodiff_model **model)
+{
+    return guard([&] {
+        if (path == nullptr || name == nullptr || model == nullptr) {
+            throw std::invalid_argument("Invalid path, name or output");
+        }
+        algodiff::ModelRegistry registry{};
+        try {
+            algodiff::load_plugin(path, registry);
+        } catch (const std::runtime_error &error) {
+            return fail(ALGODIFF_ERROR_NOT_FOUND, error.what());
+        }
+        auto found{registry.find(name)};
+        if (!found) {
+            return fail(ALGODIFF_ERROR_NOT_FOUND,
+                        "The plugin has no model with that name");
+        }
+        auto result{std::make_unique<algodiff_model>()};
+        result->model = std::move(found);
+        *model = result.release();
+        return ALGODIFF_OK;
+    });
+}
+
+void algodiff_model_destroy(algodiff_model *model)
+{
+    delete model;
+}
+
+algodiff_status algodiff_model_size(const algodiff_model *model,
+                                    size_t *input_size, size_t *output_size)
+{
+    return guard([&] {
+        if (model == nullptr || input_size == nullptr ||
+            output_size == nullptr) {
+            throw std::invalid_argument("Invalid model or output");
+        }
+        *input_size = static_cast<size_t>(model->model->input_size);
+        *output_size = static_cast<size_t>(model->model->output_size);
+        return ALGODIFF_OK;
+    });
+}
+
+algodiff_status algodiff_workspace_create(const algodiff_model *model,
+                                          algodiff_workspace **workspace)
+{
+    return guard([&] {
+        if (model == nullptr || workspace == nullptr) {
+            throw std::invalid_argument("Invalid model or output");
+        }
+        const auto n{model->model->input_size};
+        const auto m{model->model->output_size};
+        auto result{std::make_unique<algodiff_workspace>()};
+        result->owner = model;
+        const auto &shared{*model->model};
+        result->model =
+            shared.with_workspace ? shared.with_workspace() : shared;
+        result->x.resize(n);
+        result->v.resize(n);
+        result->value.resize(m);
+        result->jv.resize(m);
+        result->jacobian.resize(m, n);
+        *workspace = result.release();
+        return ALGODIFF_OK;
+    });
+}
+
+void algodiff_workspace_destroy(algodiff_workspace *workspace)
+{
+    delete workspace;
+}
+
+algodiff_status algodiff_gradient(const algodiff_model *model,
+                                  algodiff_workspace *workspace,
+                                  const double *x, ptrdiff_t incx,
+                                  double *value, double *gradient,
+                                  ptrdiff_t incg)
+{
+    return guard([&] {
+        const auto &m{check(model, workspace)};
+        if (m.output_size != 1) {
+            return fail(ALGODIFF_ERROR_DIMENSION_MISMATCH,
+                        "Gradients need a model with one output");
+        }
+        if (gradient == nullptr && m.input_size > 0) {
+            throw std::invalid_argument("gradient must not be null");
+        }
+
+        // A 1 x n jacobian is a row, so a contiguous gradient takes it as is
+        auto &staging{workspace->jacobian};
+        double *jacobian{incg == 1 ? gradient : staging.data()};
+        m.evaluate(gather(x, incx, workspace->x),
+                   target(value, 1, workspace->value), jacobian);
+        if (jacobian == staging.data()) {
+            for (Eigen::Index i = 0; i < m.input_size; ++i) {
+                gradient[i * incg] = staging(0, i);
+            }
+        }
+        return ALGODIFF_OK;
+    });
+}
+
+algodiff_status algodiff_jacobian(const algodiff_model *model,
+                                  algodiff_workspace *workspace,
+                                  const double *x, ptrdiff_t incx, double *y,
+                                  ptrdiff_t incy, double *jacobian,
+                                  ptrdiff_t row_stride,
+                                  ptrdiff_t column_stride)
+{
+    return guard([&] {
+        const auto &m{check(model, workspace)};
+        auto &staging{workspace->jacobian};
+        if (jacobian == nullptr && staging.size() > 0) {
+            throw std::invalid_argument("jacobian must not be null");
+        }
+
+        // Contiguous column-major storage is what models write
+        const bool direct{row_stride == 1 && (column_stride == m.output_size ||
+                                              m.input_size <= 1)};
+        double *value{target(y, incy, workspace->value)};
+        m.evaluate(gather(x, incx, workspace->x), value,
+                   direct ? jacobian : staging.data());
+        scatter(workspace->value, value == y ? nullptr : y, incy);
+        if (!direct) {
+            for (Eigen::Index j = 0; j < m.input_size; ++j) {
+                for (Eigen::Index i = 0; i < m.output_size; ++i) {
+                    jacobian[i * row_stride + j * column_stride] =
+                        staging(i, j);
+                }
+            }
+        }
+        return ALGODIFF_OK;
+    });
+}
+
+algodiff_status algodiff_jvp(const algodiff_model *model,
+                             algodiff_workspace *workspace, const double *x,
+                             ptrdiff_t incx, const double *v, ptrdiff_t incv,
+                             double *y, ptrdiff_t incy, double *jv,
+                             ptrdiff_t incjv)
+{
+    return guard([&] {
+        const auto &m{check(model, workspace)};
+        if (jv == nullptr && m.output_size > 0) {
+            throw std::invalid_argument("jv must not be null");
+        }
+        const double *input{gather(x, incx, workspace->x)};
+        const double *direction{gather(v, incv, workspace->v)};
+        double *value{target(y, incy, workspace->value)};
+        double *product{target(jv, incjv, workspace->jv)};
+        if (m.jvp) {
+            m.jvp(input, direction, value, product);
+        } else {
+            // Models without a tangent pass fall back to the full jacobian
+            m.evaluate(input, value, workspace->jacobian.data());
+            Eigen::Map<Eigen::VectorXd>(product, m.output_size).noalias() =
+                workspace->jacobian *
+                Eigen::Map<const Eigen::VectorXd>(direction, m.input_size);
+        }
+        scatter(workspace->value, value == y ? nullptr : y, incy);
+        scatter(workspace->jv, product == jv ? nullptr : jv, incjv);
+        return ALGODIFF_OK;
+    });
+}
+
+} // extern "C"
@@ -0,0 +1,97 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+#include <array>
+#include <cstring>
+#include <filesystem>
+
+#include "algodiff/batch_jacobian.hpp"
+
+namespace algodiff::forward::internal
+{
+namespace
+{
+constexpr std::array<char, 8> checkpoint_magic{'A', 'D', 'B', 'A',
+                                               'T', 'C', 'H', '1'};
+
+/// Describes the run a checkpoint belongs to
+struct CheckpointHeader {
+    std::array<char, 8> magic{checkpoint_magic};
+    std::int64_t points{0};
+    std::int64_t chunk_size{0};
+    std::int64_t point_bytes{0};
+    std::int64_t result_bytes{0};
+};
+
+auto header_matches(const MappedFile &file, const CheckpointHeader &expected)
+    -> bool
+{
+    CheckpointHeader found{};
+    std::memcpy(&found, file.data(), sizeof(found));
+    return found.magic == expected.magic && found.points == expected.points &&
+           found.chunk_size == expected.chunk_size &&
+           found.point_bytes == expected.point_bytes &&
+           found.result_bytes == expected.result_bytes;
+}
+
+} // namespace
+
+BatchCheckpoint::BatchCheckpoint(const std::string &path, std::int64_t points,
+                                 std::int64_t chunk_size,
+                                 std::int64_t point_bytes,
+                                 std::int64_t result_bytes)
+{
+    if (path.empty()) {
+        return;
+    }
+
+    CheckpointHeader header{};
+    header.points = points;
+    header.chunk_size = chunk_size;
+    header.point_bytes = point_bytes;
+    header.result_bytes = result_bytes;
+    const auto chunks{(points + chunk_size - 1) / chunk_size};
+    const auto size{sizeof(CheckpointHeader) + static_cast<size_t>(chunks)};
+
+    std::error_code ec{};
+    const bool existing{std::filesystem::file_size(path, ec) == size};
+    m_file = MappedFile{path, MappedFile::Mode::ReadWrite, size};
+    m_resumed = existing && header_matches(m_file, header);
+    if (!m_resumed) {
+        std::memcpy(m_file.data(), &header, sizeof(header));
+        reset();
+    }
+}
+
+auto BatchCheckpoint::done(std::int64_t chunk) const -> bool
+{
+    if (m_file.data() == nullptr) {
+        return false;
+    }
+    return m_file.data()[sizeof(CheckpointHeader) +
+                         static_cast<size_t>(chunk)] != std::byte{0};
+}
+
+auto BatchCheckpoint::mark_done(std::int64_t chunk) -> void
+{
+    if (m_file.data() == nullptr) {
+        return;
+    }
+    const auto offset{sizeof(CheckpointHeader) + static_cast<size_t>(chunk)};
+    m_file.data()[offset] = std::byte{1};
+    m_file.sync(offset, 1);
+}
+
+auto BatchCheckpoint::reset() -> void
+{
+    m_resumed = false;
+    if (m_file.data() == nullptr) {
+        return;
+    }
+    std::memset(m_file.data() + sizeof(CheckpointHeader), 0,
+                m_file.size() - sizeof(CheckpointHeader));
+    m_file.sync();
+}
+
+} // namespace algodiff::forward::internal
@@ -0,0 +1 @@
+#include "algodiff/cached_jacobian.hpp"
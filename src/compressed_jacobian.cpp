@@ -0,0 +1,260 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#include "algodiff/compressed_jacobian.hpp"
+
+namespace algodiff::forward
+{
+namespace
+{
+constexpr std::array<char, 4> binary_magic{'A', 'D', 'J', 'C'};
+constexpr std::int64_t binary_version{1};
+
+// Offset of the entry count within the binary header
+constexpr std::streamoff binary_nnz_offset{static_cast<std::streamoff>(
+    binary_magic.size() + 3 * sizeof(std::int64_t))};
+
+// Width reserved for each number on the Matrix Market size line
+constexpr int size_field_width{20};
+
+// Numbers are stored as little endian 64 bit values whatever the host order
+template <typename T> auto write_raw(std::ostream &out, const T &value) -> void
+{
+    static_assert(sizeof(T) == sizeof(std::uint64_t));
+    std::uint64_t bits{};
+    std::memcpy(&bits, &value, sizeof(T));
+    std::array<char, sizeof(T)> bytes{};
+    for (auto &byte : bytes) {
+        byte = static_cast<char>(bits & 0xFFU); // NOLINT
+        bits >>= 8U;                            // NOLINT
+    }
+    out.write(bytes.data(), bytes.size());
+}
+
+template <typename T> auto read_raw(std::istream &in) -> T
+{
+    static_assert(sizeof(T) == sizeof(std::uint64_t));
+    std::array<char, sizeof(T)> bytes{};
+    in.read(bytes.data(), bytes.size());
+    if (!in) {
+        throw std::runtime_error("Unexpected end of jacobian file");
+    }
+    std::uint64_t bits{0};
+    for (auto it = bytes.rbegin(); it != bytes.rend(); ++it) {
+        bits = (bits << 8U) | static_cast<unsigned char>(*it); // NOLINT
+    }
+    T value{};
+    std::memcpy(&value, &bits, sizeof(T));
+    return value;
+}
+
+} // namespace
+
+auto transpose_storage(const CompressedJacobian &jac) -> CompressedJacobian
+{
+    CompressedJacobian result{};
+    result.order = jac.order == StorageOrder::CSC ? StorageOrder::CSR
+                                                  : StorageOrder::CSC;
+    result.rows = jac.rows;
+    result.cols = jac.cols;
+
+    const auto new_outer{static_cast<size_t>(
+        jac.order == StorageOrder::CSC ? jac.rows : jac.cols)};
+    const auto old_outer{jac.outer_index.size() - 1};
+
+    // Counting sort on the inner index keeps the new inner indices sorted
+    result.outer_index.assign(new_outer + 1, 0);
+    for (const auto inner : jac.inner_index) {
+        ++result.outer_index[static_cast<size_t>(inner) + 1];
+    }
+    for (size_t i = 0; i < new_outer; ++i) {
+        result.outer_index[i + 1] += result.outer_index[i];
+    }
+
+    result.inner_index.resize(jac.inner_index.size());
+    result.values.resize(jac.values.size());
+    std::vector<std::int64_t> next(result.outer_index.begin(),
+                                   result.outer_index.end() - 1);
+    for (size_t outer = 0; outer < old_outer; ++outer) {
+        for (auto k = jac.outer_index[outer]; k < jac.outer_index[outer + 1];
+             ++k) {
+            const auto slot{static_cast<size_t>(
+                next[static_cast<size_t>(jac.inner_index[static_cast<size_t>(
+                    k)])]++)};
+            result.inner_index[slot] = static_cast<std::int64_t>(outer);
+            result.values[slot] = jac.values[static_cast<size_t>(k)];
+        }
+    }
+    return result;
+}
+
+auto to_sparse_matrix(const CompressedJacobian &jac)
+    -> Eigen::SparseMatrix<double>
+{
+    const auto &csc{jac.order == StorageOrder::CSC ? jac
+                                                   : transpose_storage(jac)};
+    Eigen::SparseMatrix<double> result(csc.rows, csc.cols);
+    result.reserve(static_cast<Eigen::Index>(csc.values.size()));
+    for (Eigen::Index col = 0; col < csc.cols; ++col) {
+        result.startVec(col);
+        const auto begin{csc.outer_index[static_cast<size_t>(col)]};
+        const auto end{csc.outer_index[static_cast<size_t>(col) + 1]};
+        for (auto k = begin; k < end; ++k) {
+            result.insertBack(csc.inner_index[static_cast<size_t>(k)], col) =
+                csc.values[static_cast<size_t>(k)];
+        }
+    }
+    result.finalize();
+    return result;
+}
+
+BinaryJacobianWriter::BinaryJacobianWriter(const std::string &path,
+                                           std::int64_t rows,
+                                           std::int64_t cols, double tolerance)
+    : m_out{path, std::ios::binary | std::ios::trunc}, m_tolerance{tolerance}
+{
+    if (!m_out) {
+        throw std::runtime_error("Unable to open " + path + " for writing");
+    }
+    m_out.write(binary_magic.data(), binary_magic.size());
+    write_raw(m_out, binary_version);
+    write_raw(m_out, rows);
+    write_raw(m_out, cols);
+    write_raw(m_out, m_nnz);
+}
+
+BinaryJacobianWriter::~BinaryJacobianWriter()
+{
+    try {
+        finish();
+    } catch (...) { // NOLINT(bugprone-empty-catch)
+    }
+}
+
+auto BinaryJacobianWriter::write_column(
+    Eigen::Index col, const Eigen::Ref<const Eigen::VectorXd> &column) -> void
+{
+    m_rows.clear();
+    m_values.clear();
+    for (Eigen::Index row = 0; row < column.size(); ++row) {
+        if (std::abs(column[row]) > m_tolerance) {
+            m_rows.push_back(row);
+            m_values.push_back(column[row]);
+        }
+    }
+
+    write_raw(m_out, static_cast<std::int64_t>(col));
+    write_raw(m_out, static_cast<std::int64_t>(m_rows.size()));
+    for (size_t i = 0; i < m_rows.size(); ++i) {
+        write_raw(m_out, m_rows[i]);
+        write_raw(m_out, m_values[i]);
+    }
+    m_nnz += static_cast<std::int64_t>(m_rows.size());
+}
+
+auto BinaryJacobianWriter::finish() -> void
+{
+    if (!m_out.is_open()) {
+        return;
+    }
+    m_out.seekp(binary_nnz_offset);
+    write_raw(m_out, m_nnz);
+    m_out.close();
+    if (!m_out) {
+        throw std::runtime_error("Failed to write binary jacobian");
+    }
+}
+
+auto read_binary_jacobian(const std::string &path)
+    -> Eigen::SparseMatrix<double>
+{
+    std::ifstream in{path, std::ios::binary};
+    if (!in) {
+        throw std::runtime_error("Unable to open " + path + " for reading");
+    }
+
+    std::array<char, 4> magic{};
+    in.read(magic.data(), magic.size());
+    if (!in || magic != binary_magic ||
+        read_raw<std::int64_t>(in) != binary_version) {
+        throw std::runtime_error(path + " is not a binary jacobian file");
+    }
+    const auto rows{read_raw<std::int64_t>(in)};
+    const auto cols{read_raw<std::int64_t>(in)};
+    const auto nnz{read_raw<std::int64_t>(in)};
+
+    std::vector<Eigen::Triplet<double>> triplets{};
+    triplets.reserve(static_cast<size_t>(nnz));
+    while (in.peek() != std::ifstream::traits_type::eof()) {
+        const auto col{read_raw<std::int64_t>(in)};
+        const auto count{read_raw<std::int64_t>(in)};
+        for (std::int64_t k = 0; k < count; ++k) {
+            const auto row{read_raw<std::int64_t>(in)};
+            triplets.emplace_back(row, col, read_raw<double>(in));
+        }
+    }
+    if (static_cast<std::int64_t>(triplets.size()) != nnz) {
+        throw std::runtime_error(path + " has an inconsistent entry count");
+    }
+
+    Eigen::SparseMatrix<double> result(rows, cols);
+    result.setFromTriplets(triplets.begin(), triplets.end());
+    return result;
+}
+
+MatrixMarketWriter::MatrixMarketWriter(const std::string &path,
+                                       std::int64_t rows, std::int64_t cols,
+                                       double tolerance)
+    : m_out{path, std::ios::trunc}, m_rows{rows}, m_cols{cols},
+      m_tolerance{tolerance}
+{
+    if (!m_out) {
+        throw std::runtime_error("Unable to open " + path + " for writing");
+    }
+    m_out << "%%MatrixMarket matrix coordinate real general\n";
+    m_size_line = m_out.tellp();
+    m_out << std::string(3 * size_field_width + 2, ' ') << '\n';
+    m_out.precision(std::numeric_limits<double>::max_digits10);
+}
+
+MatrixMarketWriter::~MatrixMarketWriter()
+{
+    try {
+        finish();
+    } catch (...) { // NOLINT(bugprone-empty-catch)
+    }
+}
+
+auto MatrixMarketWriter::write_column(
+    Eigen::Index col, const Eigen::Ref<const Eigen::VectorXd> &column) -> void
+{
+    for (Eigen::Index row = 0; row < column.size(); ++row) {
+        if (std::abs(column[row]) > m_tolerance) {
+            m_out << row + 1 << ' ' << col + 1 << ' ' << column[row] << '\n';
+            ++m_nnz;
+        }
+    }
+}
+
+auto MatrixMarketWriter::finish() -> void
+{
+    if (!m_out.is_open()) {
+        return;
+    }
+    m_out.seekp(m_size_line);
+    m_out << m_rows << ' ' << m_cols << ' ' << m_nnz;
+    m_out.close();
+    if (!m_out) {
+        throw std::runtime_error("Failed to write Matrix Market jacobian");
+    }
+}
+
+} // namespace algodiff::forward
@@ -0,0 +1,5 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+#include "algodiff/custom_function.hpp"
@@ -0,0 +1,285 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+#include <stdexcept>
+#include <utility>
+
+#include "algodiff/dual_array.hpp"
+
+namespace algodiff::forward
+{
+namespace
+{
+auto require_same_size(Eigen::Index left, Eigen::Index right) -> void
+{
+    if (left != right) {
+        throw std::invalid_argument("Expected batches of the same size");
+    }
+}
+
+} // namespace
+
+DualArray::DualArray(Eigen::ArrayXd primal, Eigen::ArrayXd dual)
+    : m_primal{std::move(primal)}, m_dual{std::move(dual)}
+{
+    require_same_size(m_primal.size(), m_dual.size());
+}
+
+DualArray::DualArray(const Eigen::VectorX<DualNumber> &x)
+    : m_primal(x.size()), m_dual(x.size())
+{
+    for (Eigen::Index i = 0; i < x.size(); ++i) {
+        m_primal[i] = x[i].primal();
+        m_dual[i] = x[i].dual();
+    }
+}
+
+auto DualArray::to_vector() const -> Eigen::VectorX<DualNumber>
+{
+    Eigen::VectorX<DualNumber> result(size());
+    for (Eigen::Index i = 0; i < size(); ++i) {
+        result[i] = (*this)[i];
+    }
+    return result;
+}
+
+auto operator-(const DualArray &x) -> DualArray
+{
+    return DualArray{-x.primal(), -x.dual()};
+}
+
+auto operator+(const DualArray &left, const DualArray &right) -> DualArray
+{
+    require_same_size(left.size(), right.size());
+    return DualArray{left.primal() + right.primal(),
+                     left.dual() + right.dual()};
+}
+
+auto operator+(const DualArray &x, double n) -> DualArray
+{
+    return DualArray{x.primal() + n, x.dual()};
+}
+
+auto operator+(double n, const DualArray &x) -> DualArray
+{
+    return x + n;
+}
+
+auto operator-(const DualArray &left, const DualArray &right) -> DualArray
+{
+    require_same_size(left.size(), right.size());
+    return DualArray{left.primal() - right.primal(),
+                     left.dual() - right.dual()};
+}
+
+auto operator-(const DualArray &x, double n) -> DualArray
+{
+    return DualArray{x.primal() - n, x.dual()};
+}
+
+auto operator-(double n, const DualArray &x) -> DualArray
+{
+    return DualArray{n - x.primal(), -x.dual()};
+}
+
+auto operator*(const DualArray &left, const DualArray &right) -> DualArray
+{
+    require_same_size(left.size(), right.size());
+    return DualArray{left.primal() * right.primal(),
+                     left.dual() * right.primal() +
+                         left.primal() * right.dual()};
+}
+
+auto operator*(const DualArray &x, double scalar) -> DualArray
+{
+    return DualArray{x.primal() * scalar, x.dual() * scalar};
+}
+
+auto operator*(double scalar, const DualArray &x) -> DualArray
+{
+    return x * scalar;
+}
+
+auto operator/(const DualArray &left, const DualArray &right) -> DualArray
+{
+    require_same_size(left.size(), right.size());
+    Eigen::ArrayXd quotient{left.primal() / right.primal()};
+    Eigen::ArrayXd dual{(left.dual() - quotient * right.dual()) /
+                        right.primal()};
+    return DualArray{std::move(quotient), std::move(dual)};
+}
+
+auto operator/(const DualArray &x, double scalar) -> DualArray
+{
+    return DualArray{x.primal() / scalar, x.dual() / scalar};
+}
+
+auto operator/(double scalar, const DualArray &x) -> DualArray
+{
+    Eigen::ArrayXd quotient{scalar / x.primal()};
+    Eigen::ArrayXd dual{-quotient * x.dual() / x.primal()};
+    return DualArray{std::move(quotient), std::move(dual)};
+}
+
+auto operator<(const DualArray &left, const DualArray &right) -> DualMask
+{
+    require_same_size(left.size(), right.size());
+    return left.primal() < right.primal();
+}
+
+auto operator<(const DualArray &x, double n) -> DualMask
+{
+    return x.primal() < n;
+}
+
+auto operator<(double n, const DualArray &x) -> DualMask
+{
+    return n < x.primal();
+}
+
+auto operator<=(const DualArray &left, const DualArray &right) -> DualMask
+{
+    require_same_size(left.size(), right.size());
+    return left.primal() <= right.primal();
+}
+
+auto operator<=(const DualArray &x, double n) -> DualMask
+{
+    return x.primal() <= n;
+}
+
+auto operator<=(double n, const DualArray &x) -> DualMask
+{
+    return n <= x.primal();
+}
+
+auto operator>(const DualArray &left, const DualArray &right) -> DualMask
+{
+    require_same_size(left.size(), right.size());
+    return left.primal() > right.primal();
+}
+
+auto operator>(const DualArray &x, double n) -> DualMask
+{
+    return x.primal() > n;
+}
+
+auto operator>(double n, const DualArray &x) -> DualMask
+{
+    return n > x.primal();
+}
+
+auto operator>=(const DualArray &left, const DualArray &right) -> DualMask
+{
+    require_same_size(left.size(), right.size());
+    return left.primal() >= right.primal();
+}
+
+auto operator>=(const DualArray &x, double n) -> DualMask
+{
+    return x.primal() >= n;
+}
+
+auto operator>=(double n, const DualArray &x) -> DualMask
+{
+    return n >= x.primal();
+}
+
+auto sqrt(const DualArray &x) -> DualArray
+{
+    Eigen::ArrayXd root{x.primal().sqrt()};
+    Eigen::ArrayXd dual{0.5 * x.dual() / root};
+    return DualArray{std::move(root), std::move(dual)};
+}
+
+auto exp(const DualArray &x) -> DualArray
+{
+    Eigen::ArrayXd value{x.primal().exp()};
+    Eigen::ArrayXd dual{value * x.dual()};
+    return DualArray{std::move(value), std::move(dual)};
+}
+
+auto log(const DualArray &x) -> DualArray
+{
+    return DualArray{x.primal().log(), x.dual() / x.primal()};
+}
+
+auto sin(const DualArray &x) -> DualArray
+{
+    return DualArray{x.primal().sin(), x.primal().cos() * x.dual()};
+}
+
+auto cos(const DualArray &x) -> DualArray
+{
+    return DualArray{x.primal().cos(), -x.primal().sin() * x.dual()};
+}
+
+auto tanh(const DualArray &x) -> DualArray
+{
+    Eigen::ArrayXd value{x.primal().tanh()};
+    Eigen::ArrayXd dual{(1.0 - value.square()) * x.dual()};
+    return DualArray{std::move(value), std::move(dual)};
+}
+
+auto pow(const DualArray &x, double exponent) -> DualArray
+{
+    return DualArray{x.primal().pow(exponent),
+                     exponent * x.primal().pow(exponent - 1.0) * x.dual()};
+}
+
+auto abs(const DualArray &x) -> DualArray
+{
+    return DualArray{x.primal().abs(), x.primal().sign() * x.dual()};
+}
+
+auto select(const DualMask &mask, const DualArray &a, const DualArray &b)
+    -> DualArray
+{
+    require_same_size(mask.size(), a.size());
+    require_same_size(mask.size(), b.size());
+    return DualArray{mask.select(a.primal(), b.primal()),
+                     mask.select(a.dual(), b.dual())};
+}
+
+auto select(const DualMask &mask, const DualArray &a, double b) -> DualArray
+{
+    require_same_size(mask.size(), a.size());
+    return DualArray{mask.select(a.primal(), b), mask.select(a.dual(), 0.0)};
+}
+
+auto select(const DualMask &mask, double a, const DualArray &b) -> DualArray
+{
+    require_same_size(mask.size(), b.size());
+    return DualArray{mask.select(a, b.primal()), mask.select(0.0, b.dual())};
+}
+
+auto where(const DualMask &mask, const DualArray &x) -> DualArray
+{
+    return select(mask, x, 0.0);
+}
+
+auto clamp(const DualArray &x, double low, double high) -> DualArray
+{
+    const DualMask inside{x.primal() >= low && x.primal() <= high};
+    return DualArray{x.primal().max(low).min(high),
+                     inside.select(x.dual(), 0.0)};
+}
+
+auto clamp(const DualArray &x, const DualArray &low, const DualArray &high)
+    -> DualArray
+{
+    return select(x < low, low, select(high < x, high, x));
+}
+
+auto smooth_abs(const DualArray &x, double epsilon) -> DualArray
+{
+    // hypot scaled by the larger magnitude, so large lanes do not overflow
+    const Eigen::ArrayXd scale{x.primal().abs().max(epsilon)};
+    const Eigen::ArrayXd radius{
+        scale * ((x.primal() / scale).square() + (epsilon / scale).square())
+                    .sqrt()};
+    return DualArray{radius - epsilon, x.primal() / radius * x.dual()};
+}
+
+} // namespace algodiff::forward
@@ -0,0 +1,148 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include "algodiff/dual_number_kernels.hpp"
+
+namespace algodiff::forward
+{
+namespace
+{
+// The primal and dual components of a vector as contiguous arrays, so the
+// kernels below run on Eigen's vectorized array expressions
+struct Components {
+    explicit Components(const DualVectorRef &x)
+        : primal(x.size()), dual(x.size())
+    {
+        for (Eigen::Index i = 0; i < x.size(); ++i) {
+            primal[i] = x[i].primal();
+            dual[i] = x[i].dual();
+        }
+    }
+
+    Eigen::ArrayXd primal;
+    Eigen::ArrayXd dual;
+};
+
+auto combine(const Eigen::ArrayXd &primal, const Eigen::ArrayXd &dual)
+    -> Eigen::VectorX<DualNumber>
+{
+    Eigen::VectorX<DualNumber> result(primal.size());
+    for (Eigen::Index i = 0; i < primal.size(); ++i) {
+        result[i] = DualNumber{primal[i], dual[i]};
+    }
+    return result;
+}
+
+// The shifted exponentials exp(x - max(x)) and their sum
+struct ShiftedExp {
+    explicit ShiftedExp(const Eigen::ArrayXd &primal)
+        : shift{primal.size() == 0 ? -std::numeric_limits<double>::infinity()
+                                   : primal.maxCoeff()},
+          exp{(primal - shift).exp()}, sum{exp.sum()}
+    {
+    }
+
+    double shift;
+    Eigen::ArrayXd exp;
+    double sum;
+};
+
+} // namespace
+
+auto sum(const DualVectorRef &x) -> DualNumber
+{
+    const Components c{x};
+    return DualNumber{c.primal.sum(), c.dual.sum()};
+}
+
+auto prod(const DualVectorRef &x) -> DualNumber
+{
+    double value{1.0};
+    double tangent{0.0};
+    for (Eigen::Index i = 0; i < x.size(); ++i) {
+        tangent = tangent * x[i].primal() + value * x[i].dual();
+        value *= x[i].primal();
+    }
+    return DualNumber{value, tangent};
+}
+
+auto dot(const DualVectorRef &x, const DualVectorRef &y) -> DualNumber
+{
+    if (x.size() != y.size()) {
+        throw std::invalid_argument("Expected vectors of the same size");
+    }
+    const Components a{x};
+    const Components b{y};
+    return DualNumber{(a.primal * b.primal).sum(),
+                      (a.primal * b.dual + a.dual * b.primal).sum()};
+}
+
+auto squared_norm(const DualVectorRef &x) -> DualNumber
+{
+    const Components c{x};
+    return DualNumber{c.primal.square().sum(),
+                      2.0 * (c.primal * c.dual).sum()};
+}
+
+auto norm(const DualVectorRef &x) -> DualNumber
+{
+    const Components c{x};
+    const double scale{x.size() == 0 ? 0.0 : c.primal.abs().maxCoeff()};
+    if (scale == 0.0 || !std::isfinite(scale)) {
+        return DualNumber{scale, 0.0};
+    }
+    const Eigen::ArrayXd scaled{c.primal / scale};
+    const double value{scale * std::sqrt(scaled.square().sum())};
+    return DualNumber{value, (scaled * c.dual).sum() * scale / value};
+}
+
+auto logsumexp(const DualVectorRef &x) -> DualNumber
+{
+    const Components c{x};
+    const ShiftedExp e{c.primal};
+    if (!std::isfinite(e.shift)) {
+        return DualNumber{e.shift, 0.0};
+    }
+    return DualNumber{e.shift + std::log(e.sum),
+                      (e.exp * c.dual).sum() / e.sum};
+}
+
+auto softmax(const DualVectorRef &x) -> Eigen::VectorX<DualNumber>
+{
+    const Components c{x};
+    const ShiftedExp e{c.primal};
+    const Eigen::ArrayXd probabilities{e.exp / e.sum};
+    const double mean{(probabilities * c.dual).sum()};
+    return combine(probabilities, probabilities * (c.dual - mean));
+}
+
+auto log_softmax(const DualVectorRef &x) -> Eigen::VectorX<DualNumber>
+{
+    const Components c{x};
+    const ShiftedExp e{c.primal};
+    const double mean{(e.exp * c.dual).sum() / e.sum};
+    return combine(c.primal - e.shift - std::log(e.sum), c.dual - mean);
+}
+
+auto sigmoid(const DualNumber &num) -> DualNumber
+{
+    const double e{std::exp(-std::abs(num.primal()))};
+    const double value{num.primal() >= 0.0 ? 1.0 / (1.0 + e) : e / (1.0 + e)};
+    return DualNumber{value, value * (1.0 - value) * num.dual()};
+}
+
+auto sigmoid(const DualVectorRef &x) -> Eigen::VectorX<DualNumber>
+{
+    const Components c{x};
+    const Eigen::ArrayXd e{(-c.primal.abs()).exp()};
+    const Eigen::ArrayXd value{
+        (c.primal >= 0.0).select(1.0 / (1.0 + e), e / (1.0 + e))};
+    return combine(value, value * (1.0 - value) * c.dual);
+}
+
+} // namespace algodiff::forward
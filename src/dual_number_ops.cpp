@@ -3,6 +3,7 @@
  * SPDX-License-Identifier: MIT
  */
 #include <cmath>
+#include <limits>
 
 #include "algodiff/dual_number_ops.hpp"
 
@@ -10,6 +11,55 @@
 
 namespace algodiff::forward
 {
+namespace
+{
+constexpr double pi{3.14159265358979323846};
+
+// x^n by repeated squaring; negative powers invert the positive one, so
+// x^-n stays finite whenever x^n is normal
+auto integer_power(double x, long long n) -> double
+{
+    auto remaining{n < 0 ? 0ULL - static_cast<unsigned long long>(n)
+                         : static_cast<unsigned long long>(n)};
+    double base{x};
+    double power{1.0};
+    while (remaining != 0) {
+        if ((remaining & 1U) != 0) {
+            power *= base;
+        }
+        remaining >>= 1U;
+        if (remaining != 0) {
+            base *= base;
+        }
+    }
+    return n < 0 ? 1.0 / power : power;
+}
+
+// The derivative of lgamma, from the recurrence psi(x) = psi(x + 1) - 1 / x
+// and the asymptotic series for large x
+auto digamma(double x) -> double
+{
+    if (x <= 0.0 && x == std::floor(x)) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    if (x < 0.0) {
+        return digamma(1.0 - x) - pi / std::tan(pi * x);
+    }
+
+    double result{0.0};
+    while (x < 10.0) {
+        result -= 1.0 / x;
+        x += 1.0;
+    }
+    const double f{1.0 / (x * x)};
+    return result + std::log(x) - 0.5 / x -
+           f * (1.0 / 12.0 -
+                f * (1.0 / 120.0 -
+                     f * (1.0 / 252.0 - f * (1.0 / 240.0 - f / 132.0))));
+}
+
+} // namespace
+
 auto abs(const DualNumber &num) -> DualNumber
 {
     return DualNumber{std::abs(num.primal()),
@@ -36,6 +86,47 @@ auto pow(const DualNumber &num, const DualNumber &exponent) -> DualNumber
                            num.dual() * exponent.primal() / num.primal())};
 }
 
+namespace internal
+{
+auto integer_pow(const DualNumber &num, long long exponent) -> DualNumber
+{
+    if (exponent == 0) {
+        return DualNumber{1.0, 0.0};
+    }
+
+    const double x{num.primal()};
+    const double power{integer_power(x, exponent)};
+    // n x^n / x reuses the power, unless it lost x to overflow, underflow
+    // or a zero base
+    const double slope{
+        power != 0.0 && std::isfinite(power)
+            ? static_cast<double>(exponent) * (power / x)
+            : static_cast<double>(exponent) *
+                  (exponent == std::numeric_limits<long long>::min()
+                       ? std::pow(x, static_cast<double>(exponent) - 1.0)
+                       : integer_power(x, exponent - 1))};
+    return DualNumber{power, slope * num.dual()};
+}
+
+} // namespace internal
+
+auto cbrt(const DualNumber &num) -> DualNumber
+{
+    const double root{std::cbrt(num.primal())};
+    return DualNumber{root, num.dual() / (3.0 * root * root)};
+}
+
+auto hypot(const DualNumber &x, const DualNumber &y) -> DualNumber
+{
+    const double value{std::hypot(x.primal(), y.primal())};
+    if (value == 0.0) {
+        return DualNumber{0.0, 0.0};
+    }
+    return DualNumber{value,
+                      (x.primal() / value) * x.dual() +
+                          (y.primal() / value) * y.dual()};
+}
+
 auto sqrt(const DualNumber &num) -> DualNumber
 {
     constexpr double exponent{0.5};
@@ -53,6 +144,12 @@ auto exp2(const DualNumber &num) -> DualNumber
     return exp(std::log(2.0) * num); // NOLINT
 }
 
+auto expm1(const DualNumber &num) -> DualNumber
+{
+    const double value{std::expm1(num.primal())};
+    return DualNumber{value, num.dual() * (value + 1.0)};
+}
+
 auto log(const DualNumber &num) -> DualNumber
 {
     return DualNumber{std::log(num.primal()), num.dual() / num.primal()};
@@ -68,6 +165,12 @@ auto log10(const DualNumber &num) -> DualNumber
     return log(num) / std::log(10.0); // NOLINT
 }
 
+auto log1p(const DualNumber &num) -> DualNumber
+{
+    return DualNumber{std::log1p(num.primal()),
+                      num.dual() / (1.0 + num.primal())};
+}
+
 auto log(const DualNumber &num, const double base) -> DualNumber
 {
     return log(num) / std::log(base);
@@ -112,6 +215,15 @@ auto atan(const DualNumber &num) -> DualNumber
                       num.dual() / (1.0 + num.primal() * num.primal())};
 }
 
+auto atan2(const DualNumber &y, const DualNumber &x) -> DualNumber
+{
+    const double radius{std::hypot(x.primal(), y.primal())};
+    return DualNumber{std::atan2(y.primal(), x.primal()),
+                      ((x.primal() / radius) * y.dual() -
+                       (y.primal() / radius) * x.dual()) /
+                          radius};
+}
+
 auto sinh(const DualNumber &num) -> DualNumber
 {
     return DualNumber{std::sinh(num.primal()),
@@ -151,4 +263,87 @@ auto atanh(const DualNumber &num) -> DualNumber
                       num.dual() / (1.0 - num.primal() * num.primal())};
 }
 
+auto erf(const DualNumber &num) -> DualNumber
+{
+    const double slope{2.0 / std::sqrt(pi) *
+                       std::exp(-num.primal() * num.primal())};
+    return DualNumber{std::erf(num.primal()), slope * num.dual()};
+}
+
+auto erfc(const DualNumber &num) -> DualNumber
+{
+    const double slope{2.0 / std::sqrt(pi) *
+                       std::exp(-num.primal() * num.primal())};
+    return DualNumber{std::erfc(num.primal()), -slope * num.dual()};
+}
+
+auto lgamma(const DualNumber &num) -> DualNumber
+{
+    return DualNumber{std::lgamma(num.primal()),
+                      digamma(num.primal()) * num.dual()};
+}
+
+auto tgamma(const DualNumber &num) -> DualNumber
+{
+    const double value{std::tgamma(num.primal())};
+    return DualNumber{value, value * digamma(num.primal()) * num.dual()};
+}
+
+auto fma(const DualNumber &x, const DualNumber &y, const DualNumber &z)
+    -> DualNumber
+{
+    return DualNumber{std::fma(x.primal(), y.primal(), z.primal()),
+                      x.dual() * y.primal() + x.primal() * y.dual() +
+                          z.dual()};
+}
+
+auto fmin(const DualNumber &x, const DualNumber &y) -> DualNumber
+{
+    if (std::isnan(x.primal())) {
+        return y;
+    }
+    if (std::isnan(y.primal())) {
+        return x;
+    }
+    return y.primal() < x.primal() ? y : x;
+}
+
+auto fmax(const DualNumber &x, const DualNumber &y) -> DualNumber
+{
+    if (std::isnan(x.primal())) {
+        return y;
+    }
+    if (std::isnan(y.primal())) {
+        return x;
+    }
+    return y.primal() > x.primal() ? y : x;
+}
+
+auto select(bool cond, const DualNumber &a, const DualNumber &b) -> DualNumber
+{
+    return cond ? a : b;
+}
+
+auto where(bool cond, const DualNumber &num) -> DualNumber
+{
+    return cond ? num : DualNumber{};
+}
+
+auto clamp(const DualNumber &num, const DualNumber &low,
+           const DualNumber &high) -> DualNumber
+{
+    return num < low ? low : (high < num ? high : num);
+}
+
+auto clamp(const DualNumber &num, double low, double high) -> DualNumber
+{
+    return clamp(num, DualNumber{low}, DualNumber{high});
+}
+
+auto smooth_abs(const DualNumber &num, double epsilon) -> DualNumber
+{
+    const double radius{std::hypot(num.primal(), epsilon)};
+    return DualNumber{radius - epsilon, num.primal() / radius * num.dual()};
+}
+
 } // namespace algodiff::forward
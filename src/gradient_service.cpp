@@ -0,0 +1,862 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "algodiff/gradient_service.hpp"
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+#ifndef MSG_CMSG_CLOEXEC
+#define MSG_CMSG_CLOEXEC 0
+#endif
+
+namespace algodiff
+{
+namespace
+{
+// The wire format is native-endian, since both ends live on the same machine.
+// Every request starts with a RequestHeader followed by name_length bytes of
+// model name and, for evaluations, input_size doubles; an evaluation carries
+// the result file descriptor as SCM_RIGHTS ancillary data on its first byte.
+// Every request is answered with a ResponseHeader.
+constexpr std::uint32_t protocol_magic{0x53474441}; // "ADGS"
+constexpr std::uint32_t max_name_length{4096};
+constexpr std::uint32_t max_input_size{1U << 24U};
+
+// The server reads at most this many bytes from a connection per wake up
+constexpr std::size_t receive_chunk{1U << 14U};
+
+// The most descriptors a connection may send ahead of their requests
+constexpr std::size_t max_descriptors{4};
+
+enum class RequestKind : std::uint32_t {
+    Describe,
+    Evaluate,
+};
+
+enum class Status : std::uint32_t {
+    Ok,
+    UnknownModel,
+    BadRequest,
+    EvaluationFailed,
+};
+
+struct RequestHeader {
+    std::uint32_t magic;
+    RequestKind kind;
+    std::uint32_t name_length;
+    std::uint32_t input_size;
+};
+
+struct ResponseHeader {
+    Status status;
+    std::uint32_t input_size;
+    std::uint32_t output_size;
+    std::uint32_t reserved;
+};
+
+[[noreturn]] auto throw_errno(const std::string &what) -> void
+{
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+auto socket_address(const std::string &path) -> sockaddr_un
+{
+    sockaddr_un address{};
+    if (path.size() >= sizeof(address.sun_path)) {
+        throw std::invalid_argument("Socket path is too long: " + path);
+    }
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    return address;
+}
+
+auto close_fd(int fd) -> void
+{
+    if (fd >= 0) {
+        ::close(fd);
+    }
+}
+
+auto read_all(int fd, void *data, std::size_t size) -> bool
+{
+    auto *bytes{static_cast<char *>(data)};
+    while (size > 0) {
+        const auto count{::read(fd, bytes, size)};
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            return false;
+        }
+        bytes += count;
+        size -= static_cast<std::size_t>(count);
+    }
+    return true;
+}
+
+// Sends the buffers in order, with fd (if not negative) attached to the first
+// byte
+auto send_all(int socket, std::vector<iovec> buffers, int fd = -1) -> bool
+{
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))]{};
+    std::size_t first{0};
+    while (first < buffers.size()) {
+        msghdr message{};
+        message.msg_iov = &buffers[first];
+        message.msg_iovlen = buffers.size() - first;
+        if (fd >= 0) {
+            message.msg_control = control;
+            message.msg_controllen = sizeof(control);
+            auto *header{CMSG_FIRSTHDR(&message)};
+            header->cmsg_level = SOL_SOCKET;
+            header->cmsg_type = SCM_RIGHTS;
+            header->cmsg_len = CMSG_LEN(sizeof(int));
+            std::memcpy(CMSG_DATA(header), &fd, sizeof(int));
+        }
+
+        auto count{::sendmsg(socket, &message, MSG_NOSIGNAL)};
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count < 0) {
+            return false;
+        }
+        fd = -1;
+        for (; first < buffers.size(); ++first) {
+            auto &buffer{buffers[first]};
+            if (static_cast<std::size_t>(count) < buffer.iov_len) {
+                buffer.iov_base = static_cast<char *>(buffer.iov_base) + count;
+                buffer.iov_len -= static_cast<std::size_t>(count);
+                break;
+            }
+            count -= static_cast<ssize_t>(buffer.iov_len);
+        }
+    }
+    return true;
+}
+
+auto result_size(std::size_t input_size, std::size_t output_size)
+    -> std::size_t
+{
+    return sizeof(double) * output_size * (1 + input_size);
+}
+
+/// An owning, move-only shared mapping of a file descriptor
+class SharedMapping
+{
+public:
+    SharedMapping() = default;
+
+    SharedMapping(int fd, std::size_t size) : m_size{size}
+    {
+        if (size == 0) {
+            return;
+        }
+        void *data{
+            ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)};
+        if (data == MAP_FAILED) {
+            throw_errno("Unable to map shared memory");
+        }
+        m_data = static_cast<double *>(data);
+    }
+
+    SharedMapping(const SharedMapping &) = delete;
+    auto operator=(const SharedMapping &) -> SharedMapping & = delete;
+
+    SharedMapping(SharedMapping &&other) noexcept
+        : m_data{std::exchange(other.m_data, nullptr)},
+          m_size{std::exchange(other.m_size, 0)}
+    {
+    }
+
+    auto operator=(SharedMapping &&other) noexcept -> SharedMapping &
+    {
+        if (this != &other) {
+            release();
+            m_data = std::exchange(other.m_data, nullptr);
+            m_size = std::exchange(other.m_size, 0);
+        }
+        return *this;
+    }
+
+    ~SharedMapping()
+    {
+        release();
+    }
+
+    auto data() const -> double *
+    {
+        return m_data;
+    }
+
+private:
+    auto release() -> void
+    {
+        if (m_data != nullptr) {
+            ::munmap(m_data, m_size);
+            m_data = nullptr;
+        }
+    }
+
+    double *m_data{nullptr};
+    std::size_t m_size{0};
+};
+
+// Creates an anonymous shared memory file of the given size
+auto create_shared_memory(std::size_t size) -> int
+{
+#ifdef __linux__
+    const int fd{::memfd_create("algodiff", MFD_CLOEXEC)};
+#else
+    static std::atomic<unsigned> counter{0};
+    const auto name{"/algodiff-" + std::to_string(::getpid()) + "-" +
+                    std::to_string(counter++)};
+    const int fd{
+        ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600)};
+    if (fd >= 0) {
+        ::shm_unlink(name.c_str());
+    }
+#endif
+    if (fd < 0) {
+        throw_errno("Unable to create shared memory");
+    }
+    if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        const auto error{errno};
+        ::close(fd);
+        throw std::system_error(error, std::generic_category(),
+                                "Unable to resize shared memory");
+    }
+    return fd;
+}
+
+/// An evaluation waiting for its batch
+struct Request {
+    int client;
+    Eigen::VectorXd x;
+    SharedMapping result;
+    Status status{Status::Ok};
+};
+
+/**
+ * \brief A client connection of the server, which is only ever read and
+ * written without blocking
+ *
+ * Bytes are buffered until a whole request has arrived, and responses until
+ * the client reads them. While an evaluation of the connection waits in a
+ * batch nothing more is read from it, so neither buffer grows beyond one
+ * request and its response.
+ */
+struct Connection {
+    int fd{-1};
+
+    /// Received bytes that do not form a whole request yet
+    std::vector<char> input{};
+
+    /// Received descriptors not yet claimed by an evaluation
+    std::deque<int> descriptors{};
+
+    /// The number of bytes of a rejected request left to discard
+    std::size_t skip{0};
+
+    /// Responses the client has not read yet
+    std::vector<char> output{};
+
+    /// Whether an evaluation of this connection waits in a batch
+    bool waiting{false};
+};
+
+// Removes the first count bytes of a buffer
+auto consume(std::vector<char> &buffer, std::size_t count) -> void
+{
+    buffer.erase(buffer.begin(),
+                 buffer.begin() + static_cast<std::ptrdiff_t>(count));
+}
+
+auto queue_response(Connection &connection, Status status,
+                    const Model *model) -> void
+{
+    ResponseHeader response{status, 0, 0, 0};
+    if (model != nullptr) {
+        response.input_size = static_cast<std::uint32_t>(model->input_size);
+        response.output_size = static_cast<std::uint32_t>(model->output_size);
+    }
+    const auto *bytes{reinterpret_cast<const char *>(&response)};
+    connection.output.insert(connection.output.end(), bytes,
+                             bytes + sizeof(response));
+}
+
+// Reads what the client has sent so far, queueing the attached descriptors;
+// returns false if the connection was closed or misbehaved
+auto receive(Connection &connection) -> bool
+{
+    char data[receive_chunk];
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * max_descriptors)]{};
+    iovec buffer{data, sizeof(data)};
+    msghdr message{};
+    message.msg_iov = &buffer;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+
+    ssize_t count{};
+    do {
+        count = ::recvmsg(connection.fd, &message,
+                          MSG_DONTWAIT | MSG_CMSG_CLOEXEC);
+    } while (count < 0 && errno == EINTR);
+    if (count < 0) {
+        return errno == EAGAIN || errno == EWOULDBLOCK;
+    }
+    if (count == 0) {
+        return false;
+    }
+
+    for (auto *header = CMSG_FIRSTHDR(&message); header != nullptr;
+         header = CMSG_NXTHDR(&message, header)) {
+        if (header->cmsg_level != SOL_SOCKET ||
+            header->cmsg_type != SCM_RIGHTS) {
+            continue;
+        }
+        const auto descriptors{(header->cmsg_len - CMSG_LEN(0)) / sizeof(int)};
+        for (std::size_t i = 0; i < descriptors; ++i) {
+            int fd{-1};
+            std::memcpy(&fd, CMSG_DATA(header) + i * sizeof(int), sizeof(int));
+            connection.descriptors.push_back(fd);
+        }
+    }
+    connection.input.insert(connection.input.end(), data,
+                            data + static_cast<std::size_t>(count));
+    return (message.msg_flags & MSG_CTRUNC) == 0 &&
+           connection.descriptors.size() <= max_descriptors;
+}
+
+// Sends as much of the queued responses as the client accepts; returns false
+// if the connection is broken
+auto flush(Connection &connection) -> bool
+{
+    auto &output{connection.output};
+    std::size_t sent{0};
+    while (sent < output.size()) {
+        const auto count{::send(connection.fd, output.data() + sent,
+                                output.size() - sent,
+                                MSG_DONTWAIT | MSG_NOSIGNAL)};
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        }
+        if (count < 0) {
+            return false;
+        }
+        sent += static_cast<std::size_t>(count);
+    }
+    consume(output, sent);
+    return true;
+}
+
+auto close_connection(Connection &connection) -> void
+{
+    close_fd(connection.fd);
+    for (const auto fd : connection.descriptors) {
+        close_fd(fd);
+    }
+    connection.descriptors.clear();
+}
+
+} // namespace
+
+/// The pending requests for one model
+struct GradientServer::Batch {
+    std::shared_ptr<const Model> model{};
+    std::chrono::steady_clock::time_point opened{};
+    std::vector<Request> requests{};
+};
+
+GradientServer::GradientServer(std::string socket_path,
+                               const ModelRegistry &registry,
+                               ServiceOptions options)
+    : m_socket_path{std::move(socket_path)}, m_registry{&registry},
+      m_options{options},
+      m_pool{std::make_unique<ThreadPool>(options.threads)}
+{
+    const auto address{socket_address(m_socket_path)};
+    if (::pipe(m_wake_fds) != 0) {
+        throw_errno("Unable to create the wake pipe");
+    }
+    for (const auto fd : m_wake_fds) {
+        ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+        ::fcntl(fd, F_SETFL, O_NONBLOCK);
+    }
+
+    m_listen_fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (m_listen_fd < 0) {
+        const auto error{errno};
+        close_fd(m_wake_fds[0]);
+        close_fd(m_wake_fds[1]);
+        throw std::system_error(error, std::generic_category(),
+                                "Unable to create a socket");
+    }
+    ::fcntl(m_listen_fd, F_SETFD, FD_CLOEXEC);
+    ::fcntl(m_listen_fd, F_SETFL, O_NONBLOCK);
+    ::unlink(m_socket_path.c_str());
+    if (::bind(m_listen_fd, reinterpret_cast<const sockaddr *>(&address),
+               sizeof(address)) != 0 ||
+        ::listen(m_listen_fd, SOMAXCONN) != 0) {
+        const auto error{errno};
+        close_fd(m_listen_fd);
+        close_fd(m_wake_fds[0]);
+        close_fd(m_wake_fds[1]);
+        throw std::system_error(error, std::generic_category(),
+                                "Unable to listen on " + m_socket_path);
+    }
+}
+
+GradientServer::~GradientServer()
+{
+    close_fd(m_listen_fd);
+    close_fd(m_wake_fds[0]);
+    close_fd(m_wake_fds[1]);
+    ::unlink(m_socket_path.c_str());
+}
+
+auto GradientServer::stop() noexcept -> void
+{
+    const char byte{0};
+    [[maybe_unused]] const auto count{::write(m_wake_fds[1], &byte, 1)};
+}
+
+auto GradientServer::statistics() const -> ServiceStatistics
+{
+    ServiceStatistics statistics{};
+    statistics.requests = m_requests;
+    statistics.batches = m_batches;
+    return statistics;
+}
+
+auto GradientServer::dispatch(Batch &batch) -> void
+{
+    const auto &model{*batch.model};
+    const auto outputs{static_cast<std::size_t>(model.output_size)};
+    auto evaluate = [&](Request &request) {
+        double *value{request.result.data()};
+        try {
+            model.evaluate(request.x.data(), value,
+                           value == nullptr ? nullptr : value + outputs);
+        } catch (...) {
+            request.status = Status::EvaluationFailed;
+        }
+    };
+
+    const auto count{batch.requests.size()};
+    const auto workers{model.thread_safe
+                           ? std::min(count, m_pool->size() + 1)
+                           : std::size_t{1}};
+    std::atomic<std::size_t> next{0};
+    auto work = [&] {
+        for (auto i = next++; i < count; i = next++) {
+            evaluate(batch.requests[i]);
+        }
+    };
+
+    // The server thread takes part in the batch, so the pool only receives
+    // the extra workers
+    std::mutex mutex{};
+    std::condition_variable finished{};
+    std::size_t running{workers - 1};
+    for (std::size_t w = 1; w < workers; ++w) {
+        m_pool->submit([&] {
+            work();
+            const std::lock_guard<std::mutex> lock{mutex};
+            if (--running == 0) {
+                finished.notify_one();
+            }
+        });
+    }
+    work();
+    {
+        std::unique_lock<std::mutex> lock{mutex};
+        finished.wait(lock, [&] { return running == 0; });
+    }
+
+    // Counted before answering, so a client that has its result also sees it
+    // in the statistics
+    m_requests += count;
+    ++m_batches;
+}
+
+auto GradientServer::run() -> void
+{
+    std::map<int, Connection> connections{};
+    std::map<std::string, Batch> batches{};
+
+    // Takes the next whole request out of the input of a connection; returns
+    // false if the connection should be closed
+    auto parse = [&](Connection &connection) {
+        auto &input{connection.input};
+        const auto discarded{std::min(connection.skip, input.size())};
+        consume(input, discarded);
+        connection.skip -= discarded;
+
+        RequestHeader header{};
+        if (connection.skip > 0 || input.size() < sizeof(header)) {
+            return true;
+        }
+        std::memcpy(&header, input.data(), sizeof(header));
+        if (header.magic != protocol_magic ||
+            (header.kind != RequestKind::Describe &&
+             header.kind != RequestKind::Evaluate) ||
+            header.name_length > max_name_length ||
+            header.input_size > max_input_size) {
+            queue_response(connection, Status::BadRequest, nullptr);
+            return false;
+        }
+        const auto name_end{sizeof(header) + header.name_length};
+        if (input.size() < name_end) {
+            return true;
+        }
+
+        // The size of an evaluation is checked against its model before
+        // waiting for its input, so a client cannot make the server buffer
+        // more than the model takes
+        const std::string name(input.data() + sizeof(header),
+                               header.name_length);
+        const auto model{m_registry->find(name)};
+        const bool evaluate{header.kind == RequestKind::Evaluate};
+        const auto input_bytes{
+            evaluate ? sizeof(double) * std::size_t{header.input_size} : 0};
+        if (!model || (evaluate && header.input_size != model->input_size)) {
+            if (evaluate && !connection.descriptors.empty()) {
+                close_fd(connection.descriptors.front());
+                connection.descriptors.pop_front();
+            }
+            consume(input, name_end);
+            connection.skip = input_bytes;
+            queue_response(connection,
+                           model ? Status::BadRequest : Status::UnknownModel,
+                           model.get());
+            return true;
+        }
+        if (!evaluate) {
+            consume(input, name_end);
+            queue_response(connection, Status::Ok, model.get());
+            return true;
+        }
+        if (input.size() < name_end + input_bytes) {
+            return true;
+        }
+
+        Eigen::VectorXd x(model->input_size);
+        std::memcpy(x.data(), input.data() + name_end, input_bytes);
+        consume(input, name_end + input_bytes);
+        int fd{-1};
+        if (!connection.descriptors.empty()) {
+            fd = connection.descriptors.front();
+            connection.descriptors.pop_front();
+        }
+
+        const auto size{
+            result_size(static_cast<std::size_t>(model->input_size),
+                        static_cast<std::size_t>(model->output_size))};
+        struct stat status {};
+        SharedMapping result{};
+        try {
+            if (fd < 0 || ::fstat(fd, &status) != 0 ||
+                static_cast<std::size_t>(status.st_size) < size) {
+                close_fd(fd);
+                queue_response(connection, Status::BadRequest, model.get());
+                return true;
+            }
+            result = SharedMapping{fd, size};
+            close_fd(fd);
+        } catch (const std::system_error &) {
+            close_fd(fd);
+            queue_response(connection, Status::BadRequest, model.get());
+            return true;
+        }
+
+        auto &batch{batches[name]};
+        if (batch.requests.empty()) {
+            batch.model = model;
+            batch.opened = std::chrono::steady_clock::now();
+        }
+        batch.requests.push_back(
+            Request{connection.fd, std::move(x), std::move(result)});
+        connection.waiting = true;
+        return true;
+    };
+
+    // Answers every whole request of a connection that does not wait on a
+    // batch
+    auto serve = [&](Connection &connection) {
+        while (!connection.waiting) {
+            const auto buffered{connection.input.size()};
+            const auto answers{connection.output.size()};
+            if (!parse(connection)) {
+                return false;
+            }
+            if (connection.input.size() == buffered &&
+                connection.output.size() == answers && !connection.waiting) {
+                break;
+            }
+        }
+        return flush(connection);
+    };
+
+    auto drop = [&](int client) {
+        for (auto &entry : batches) {
+            auto &requests{entry.second.requests};
+            requests.erase(std::remove_if(requests.begin(), requests.end(),
+                                          [client](const Request &request) {
+                                              return request.client == client;
+                                          }),
+                           requests.end());
+        }
+        auto connection{connections.find(client)};
+        // A rejected client gets its answer if its socket has room for it
+        flush(connection->second);
+        close_connection(connection->second);
+        connections.erase(connection);
+    };
+
+    auto dispatch_due = [&](bool all) {
+        const auto now{std::chrono::steady_clock::now()};
+        for (auto &entry : batches) {
+            auto &batch{entry.second};
+            if (batch.requests.empty() ||
+                !(all || batch.requests.size() >= m_options.max_batch ||
+                  now - batch.opened >= m_options.batch_window)) {
+                continue;
+            }
+            dispatch(batch);
+            for (const auto &request : batch.requests) {
+                auto &connection{connections.at(request.client)};
+                queue_response(connection, request.status, batch.model.get());
+                connection.waiting = false;
+            }
+            batch.requests.clear();
+        }
+    };
+
+    bool stopping{false};
+    while (!stopping) {
+        // Sleep until the oldest open batch is due
+        int timeout{-1};
+        const auto now{std::chrono::steady_clock::now()};
+        for (const auto &entry : batches) {
+            const auto &batch{entry.second};
+            if (batch.requests.empty()) {
+                continue;
+            }
+            const auto remaining{
+                std::chrono::ceil<std::chrono::milliseconds>(
+                    batch.opened + m_options.batch_window - now)
+                    .count()};
+            const auto wait{static_cast<int>(std::max<long long>(
+                0, static_cast<long long>(remaining)))};
+            timeout = timeout < 0 ? wait : std::min(timeout, wait);
+        }
+
+        // A connection is only read when it has nothing in flight, and only
+        // written when it has answers left
+        std::vector<pollfd> fds{{m_wake_fds[0], POLLIN, 0},
+                                {m_listen_fd, POLLIN, 0}};
+        for (const auto &entry : connections) {
+            const auto &connection{entry.second};
+            short events{0};
+            if (!connection.waiting && connection.output.empty()) {
+                events |= POLLIN;
+            }
+            if (!connection.output.empty()) {
+                events |= POLLOUT;
+            }
+            fds.push_back({connection.fd, events, 0});
+        }
+        if (::poll(fds.data(), fds.size(), timeout) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw_errno("Unable to wait on the sockets");
+        }
+
+        if ((fds[0].revents & POLLIN) != 0) {
+            char byte{};
+            while (::read(m_wake_fds[0], &byte, 1) > 0) {
+            }
+            stopping = true;
+        }
+        if ((fds[1].revents & POLLIN) != 0) {
+            const int client{::accept(m_listen_fd, nullptr, nullptr)};
+            if (client >= 0) {
+                ::fcntl(client, F_SETFD, FD_CLOEXEC);
+                ::fcntl(client, F_SETFL, O_NONBLOCK);
+                connections[client].fd = client;
+            }
+        }
+        for (size_t i = 2; i < fds.size(); ++i) {
+            const auto revents{fds[i].revents};
+            auto &connection{connections.at(fds[i].fd)};
+            const bool broken{(revents & (POLLERR | POLLHUP | POLLNVAL)) != 0};
+            if (broken || ((revents & POLLIN) != 0 && !receive(connection)) ||
+                ((revents & (POLLIN | POLLOUT)) != 0 && !serve(connection))) {
+                drop(fds[i].fd);
+            }
+        }
+
+        // Answered connections may already hold their next request
+        dispatch_due(stopping);
+        for (auto entry = connections.begin(); entry != connections.end();) {
+            const auto client{entry->first};
+            ++entry;
+            if (!serve(connections.at(client))) {
+                drop(client);
+            }
+        }
+    }
+
+    for (auto &entry : connections) {
+        close_connection(entry.second);
+    }
+}
+
+struct GradientClient::Buffer {
+    std::size_t input_size{0};
+    std::size_t output_size{0};
+    int fd{-1};
+    SharedMapping mapping{};
+
+    Buffer() = default;
+    Buffer(const Buffer &) = delete;
+    Buffer(Buffer &&) = delete;
+    auto operator=(const Buffer &) -> Buffer & = delete;
+    auto operator=(Buffer &&) -> Buffer & = delete;
+    ~Buffer()
+    {
+        close_fd(fd);
+    }
+};
+
+GradientClient::GradientClient(const std::string &socket_path)
+{
+    const auto address{socket_address(socket_path)};
+    m_fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (m_fd < 0) {
+        throw_errno("Unable to create a socket");
+    }
+    ::fcntl(m_fd, F_SETFD, FD_CLOEXEC);
+    if (::connect(m_fd, reinterpret_cast<const sockaddr *>(&address),
+                  sizeof(address)) != 0) {
+        const auto error{errno};
+        ::close(m_fd);
+        throw std::system_error(error, std::generic_category(),
+                                "Unable to connect to " + socket_path);
+    }
+}
+
+GradientClient::~GradientClient()
+{
+    close_fd(m_fd);
+}
+
+namespace
+{
+auto round_trip(int socket, const std::string &model, RequestKind kind,
+              const Eigen::VectorXd &x, int fd) -> ResponseHeader
+{
+    RequestHeader header{protocol_magic, kind,
+                         static_cast<std::uint32_t>(model.size()),
+                         static_cast<std::uint32_t>(x.size())};
+    std::vector<iovec> buffers{
+        {&header, sizeof(header)},
+        {const_cast<char *>(model.data()), model.size()}};
+    if (kind == RequestKind::Evaluate) {
+        buffers.push_back({const_cast<double *>(x.data()),
+                           sizeof(double) * static_cast<size_t>(x.size())});
+    }
+
+    ResponseHeader response{};
+    if (!send_all(socket, std::move(buffers), fd) ||
+        !read_all(socket, &response, sizeof(response))) {
+        throw std::runtime_error("Lost the connection to the gradient server");
+    }
+    switch (response.status) {
+    case Status::Ok:
+        return response;
+    case Status::UnknownModel:
+        throw std::runtime_error("The gradient server has no model named " +
+                                 model);
+    case Status::BadRequest:
+        throw std::runtime_error("The gradient server rejected a request for " +
+                                 model);
+    case Status::EvaluationFailed:
+        throw std::runtime_error("Model " + model + " failed to evaluate");
+    }
+    throw std::runtime_error("Unexpected response from the gradient server");
+}
+
+} // namespace
+
+auto GradientClient::buffer(const std::string &model) -> Buffer &
+{
+    auto &slot{m_buffers[model]};
+    if (slot) {
+        return *slot;
+    }
+
+    const auto response{
+        round_trip(m_fd, model, RequestKind::Describe, Eigen::VectorXd{}, -1)};
+    auto buffer{std::make_shared<Buffer>()};
+    buffer->input_size = response.input_size;
+    buffer->output_size = response.output_size;
+    const auto size{result_size(buffer->input_size, buffer->output_size)};
+    buffer->fd = create_shared_memory(size);
+    buffer->mapping = SharedMapping{buffer->fd, size};
+    slot = std::move(buffer);
+    return *slot;
+}
+
+auto GradientClient::evaluate(const std::string &model,
+                              const Eigen::VectorXd &x) -> GradientView
+{
+    auto &buffer{this->buffer(model)};
+    if (static_cast<std::size_t>(x.size()) != buffer.input_size) {
+        throw std::invalid_argument("Model " + model + " takes " +
+                                    std::to_string(buffer.input_size) +
+                                    " inputs");
+    }
+    round_trip(m_fd, model, RequestKind::Evaluate, x, buffer.fd);
+
+    const auto rows{static_cast<Eigen::Index>(buffer.output_size)};
+    const auto cols{static_cast<Eigen::Index>(buffer.input_size)};
+    const double *value{buffer.mapping.data()};
+    return GradientView{
+        Eigen::Map<const Eigen::VectorXd>(value, rows),
+        Eigen::Map<const Eigen::MatrixXd>(
+            value == nullptr ? nullptr : value + rows, rows, cols)};
+}
+
+} // namespace algodiff
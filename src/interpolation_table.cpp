@@ -0,0 +1,224 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+#include "algodiff/interpolation_table.hpp"
+
+namespace algodiff::forward
+{
+InterpolationAxis::InterpolationAxis(std::vector<double> knots)
+    : m_knots{std::move(knots)}
+{
+    if (m_knots.size() < 2) {
+        throw std::invalid_argument("Expected at least two knots");
+    }
+    const double step{(m_knots.back() - m_knots.front()) /
+                      static_cast<double>(m_knots.size() - 1)};
+    m_uniform = true;
+    m_inverse_widths.reserve(m_knots.size() - 1);
+    for (size_t i = 0; i + 1 < m_knots.size(); ++i) {
+        const double width{m_knots[i + 1] - m_knots[i]};
+        if (!(width > 0.0)) {
+            throw std::invalid_argument("Knots must be strictly increasing");
+        }
+        m_uniform = m_uniform && std::abs(width - step) <= 1e-10 * step;
+        m_inverse_widths.push_back(1.0 / width);
+    }
+    if (m_uniform) {
+        std::fill(m_inverse_widths.begin(), m_inverse_widths.end(),
+                  1.0 / step);
+    }
+}
+
+auto InterpolationAxis::locate(double x, Eigen::Index &hint) const
+    -> Eigen::Index
+{
+    const auto last{cells() - 1};
+    if (m_uniform) {
+        const double t{(x - m_knots.front()) * m_inverse_widths.front()};
+        hint = t >= 0.0 ? static_cast<Eigen::Index>(std::min(
+                              std::floor(t), static_cast<double>(last)))
+                        : 0;
+        return hint;
+    }
+
+    // The first and last cells also hold the queries outside the knots
+    const auto contains = [&](Eigen::Index cell) {
+        return (cell == 0 || x >= m_knots[static_cast<size_t>(cell)]) &&
+               (cell == last || x < m_knots[static_cast<size_t>(cell) + 1]);
+    };
+    const auto start{std::clamp<Eigen::Index>(hint, 0, last)};
+    for (const auto cell : {start, start + 1, start - 1}) {
+        if (cell >= 0 && cell <= last && contains(cell)) {
+            hint = cell;
+            return hint;
+        }
+    }
+    const auto first{m_knots.begin() + 1};
+    hint = std::upper_bound(first, m_knots.end() - 1, x) - first;
+    return hint;
+}
+
+auto InterpolationAxis::locate(const Eigen::ArrayXd &x,
+                               Eigen::ArrayX<Eigen::Index> &cells,
+                               Eigen::ArrayXd &fractions,
+                               Eigen::ArrayXd &inverse_widths) const -> void
+{
+    if (m_uniform) {
+        const double inverse{m_inverse_widths.front()};
+        const Eigen::ArrayXd t{(x - m_knots.front()) * inverse};
+        const Eigen::ArrayXd lower{(t >= 0.0).select(
+            t.floor().min(static_cast<double>(this->cells() - 1)), 0.0)};
+        cells = lower.cast<Eigen::Index>();
+        fractions = t - lower;
+        inverse_widths = Eigen::ArrayXd::Constant(x.size(), inverse);
+        return;
+    }
+
+    cells.resize(x.size());
+    fractions.resize(x.size());
+    inverse_widths.resize(x.size());
+    Eigen::Index hint{0};
+    for (Eigen::Index i = 0; i < x.size(); ++i) {
+        const auto cell{locate(x[i], hint)};
+        cells[i] = cell;
+        fractions[i] = fraction(x[i], cell);
+        inverse_widths[i] = inverse_width(cell);
+    }
+}
+
+namespace internal
+{
+auto split(const Eigen::Ref<const Eigen::ArrayX<DualNumber>> &x,
+           Eigen::ArrayXd &primal, Eigen::ArrayXd &dual) -> void
+{
+    primal.resize(x.size());
+    dual.resize(x.size());
+    for (Eigen::Index i = 0; i < x.size(); ++i) {
+        primal[i] = x[i].primal();
+        dual[i] = x[i].dual();
+    }
+}
+
+auto join(const Eigen::ArrayXd &primal, const Eigen::ArrayXd &dual)
+    -> Eigen::VectorX<DualNumber>
+{
+    Eigen::VectorX<DualNumber> result(primal.size());
+    for (Eigen::Index i = 0; i < primal.size(); ++i) {
+        result[i] = DualNumber{primal[i], dual[i]};
+    }
+    return result;
+}
+
+auto require_table_size(Eigen::Index knots, Eigen::Index values) -> void
+{
+    if (knots != values) {
+        throw std::invalid_argument("Expected one value per knot");
+    }
+}
+
+} // namespace internal
+
+CubicSpline::CubicSpline(std::vector<double> knots,
+                         const Eigen::VectorXd &values)
+    : m_axis{std::move(knots)}
+{
+    const auto &x{m_axis.knots()};
+    const auto n{static_cast<Eigen::Index>(x.size())};
+    internal::require_table_size(n, values.size());
+
+    // Solve the tridiagonal system for the second derivatives at the interior
+    // knots with the Thomas algorithm
+    Eigen::VectorXd second{Eigen::VectorXd::Zero(n)};
+    Eigen::VectorXd upper{Eigen::VectorXd::Zero(n)};
+    const auto width = [&](Eigen::Index i) {
+        return x[static_cast<size_t>(i) + 1] - x[static_cast<size_t>(i)];
+    };
+    for (Eigen::Index i = 1; i + 1 < n; ++i) {
+        const double left{width(i - 1)};
+        const double right{width(i)};
+        const double rhs{6.0 * ((values[i + 1] - values[i]) / right -
+                                (values[i] - values[i - 1]) / left)};
+        const double pivot{2.0 * (left + right) - left * upper[i - 1]};
+        upper[i] = right / pivot;
+        second[i] = (rhs - left * second[i - 1]) / pivot;
+    }
+    for (Eigen::Index i = n - 2; i > 0; --i) {
+        second[i] -= upper[i] * second[i + 1];
+    }
+
+    m_coefficients.resize(4, n - 1);
+    for (Eigen::Index i = 0; i + 1 < n; ++i) {
+        const double h2{width(i) * width(i)};
+        m_coefficients(0, i) = values[i];
+        m_coefficients(1, i) = values[i + 1] - values[i] -
+                               h2 * (2.0 * second[i] + second[i + 1]) / 6.0;
+        m_coefficients(2, i) = h2 * second[i] / 2.0;
+        m_coefficients(3, i) = h2 * (second[i + 1] - second[i]) / 6.0;
+    }
+}
+
+auto CubicSpline::value(double x, Eigen::Index &hint, double *derivative) const
+    -> double
+{
+    const auto cell{m_axis.locate(x, hint)};
+    const double t{m_axis.fraction(x, cell)};
+    const auto c{m_coefficients.col(cell)};
+    if (derivative != nullptr) {
+        *derivative = ((3.0 * c[3] * t + 2.0 * c[2]) * t + c[1]) *
+                      m_axis.inverse_width(cell);
+    }
+    return ((c[3] * t + c[2]) * t + c[1]) * t + c[0];
+}
+
+auto CubicSpline::operator()(const DualNumber &x, Eigen::Index &hint) const
+    -> DualNumber
+{
+    double derivative{0.0};
+    const double result{value(x.primal(), hint, &derivative)};
+    return DualNumber{result, derivative * x.dual()};
+}
+
+auto CubicSpline::batch(const Eigen::VectorXd &x) const -> Eigen::VectorXd
+{
+    return evaluate(x.array(), nullptr).matrix();
+}
+
+auto CubicSpline::batch(const Eigen::VectorX<DualNumber> &x) const
+    -> Eigen::VectorX<DualNumber>
+{
+    Eigen::ArrayXd primal{};
+    Eigen::ArrayXd dual{};
+    internal::split(x.array(), primal, dual);
+    Eigen::ArrayXd derivative{};
+    const Eigen::ArrayXd result{evaluate(primal, &derivative)};
+    return internal::join(result, derivative * dual);
+}
+
+auto CubicSpline::evaluate(const Eigen::ArrayXd &x,
+                           Eigen::ArrayXd *derivative) const -> Eigen::ArrayXd
+{
+    Eigen::ArrayX<Eigen::Index> cells{};
+    Eigen::ArrayXd t{};
+    Eigen::ArrayXd inverse_widths{};
+    m_axis.locate(x, cells, t, inverse_widths);
+
+    // Gather the coefficients of every query so the polynomials are
+    // evaluated with array expressions
+    Eigen::Array<double, Eigen::Dynamic, 4> c(x.size(), 4);
+    for (Eigen::Index i = 0; i < x.size(); ++i) {
+        c.row(i) = m_coefficients.col(cells[i]).transpose().array();
+    }
+    if (derivative != nullptr) {
+        *derivative = ((3.0 * c.col(3) * t + 2.0 * c.col(2)) * t + c.col(1)) *
+                      inverse_widths;
+    }
+    return ((c.col(3) * t + c.col(2)) * t + c.col(1)) * t + c.col(0);
+}
+
+} // namespace algodiff::forward
@@ -0,0 +1,88 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+#include <stdexcept>
+
+#include "algodiff/jacobian_operator.hpp"
+
+namespace algodiff::reverse
+{
+auto JacobianOperator::linearize(const Tape &tape) -> void
+{
+    m_inputs = tape.inputs();
+    m_outputs = tape.outputs();
+    m_value.resize(static_cast<Eigen::Index>(m_outputs.size()));
+    for (size_t i = 0; i < m_outputs.size(); ++i) {
+        m_value[static_cast<Eigen::Index>(i)] = tape.values()[m_outputs[i]];
+    }
+
+    m_offsets.reserve(tape.size() + 1);
+    m_offsets.push_back(0);
+    for (std::uint32_t i = 0; i < tape.size(); ++i) {
+        for (const auto &[operand, partial] : tape.local_edges(i)) {
+            m_operands.push_back(operand);
+            m_partials.push_back(partial);
+        }
+        m_offsets.push_back(m_operands.size());
+    }
+}
+
+auto JacobianOperator::jvp(const Eigen::Ref<const Eigen::VectorXd> &v) const
+    -> Eigen::VectorXd
+{
+    if (v.size() != cols()) {
+        throw std::invalid_argument("Expected one entry per input");
+    }
+
+    std::vector<double> tangents(m_offsets.size() - 1, 0.0);
+    for (size_t k = 0; k < m_inputs.size(); ++k) {
+        tangents[m_inputs[k]] = v[static_cast<Eigen::Index>(k)];
+    }
+    for (size_t i = 0; i < tangents.size(); ++i) {
+        if (m_offsets[i] == m_offsets[i + 1]) {
+            continue;
+        }
+        double tangent{0.0};
+        for (auto e = m_offsets[i]; e < m_offsets[i + 1]; ++e) {
+            tangent += m_partials[e] * tangents[m_operands[e]];
+        }
+        tangents[i] = tangent;
+    }
+
+    Eigen::VectorXd result(rows());
+    for (size_t j = 0; j < m_outputs.size(); ++j) {
+        result[static_cast<Eigen::Index>(j)] = tangents[m_outputs[j]];
+    }
+    return result;
+}
+
+auto JacobianOperator::vjp(const Eigen::Ref<const Eigen::VectorXd> &w) const
+    -> Eigen::VectorXd
+{
+    if (w.size() != rows()) {
+        throw std::invalid_argument("Expected one entry per output");
+    }
+
+    std::vector<double> adjoints(m_offsets.size() - 1, 0.0);
+    for (size_t j = 0; j < m_outputs.size(); ++j) {
+        adjoints[m_outputs[j]] += w[static_cast<Eigen::Index>(j)];
+    }
+    for (auto i = adjoints.size(); i-- > 0;) {
+        const double adjoint{adjoints[i]};
+        if (adjoint == 0.0) {
+            continue;
+        }
+        for (auto e = m_offsets[i]; e < m_offsets[i + 1]; ++e) {
+            adjoints[m_operands[e]] += m_partials[e] * adjoint;
+        }
+    }
+
+    Eigen::VectorXd result(cols());
+    for (size_t k = 0; k < m_inputs.size(); ++k) {
+        result[static_cast<Eigen::Index>(k)] = adjoints[m_inputs[k]];
+    }
+    return result;
+}
+
+} // namespace algodiff::reverse
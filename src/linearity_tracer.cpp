@@ -0,0 +1,252 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+#include "algodiff/linearity_tracer.hpp"
+
+namespace algodiff::forward
+{
+namespace
+{
+// Returns the sorted union of two sorted index lists
+auto merge(const std::vector<Eigen::Index> &left,
+           const std::vector<Eigen::Index> &right) -> std::vector<Eigen::Index>
+{
+    std::vector<Eigen::Index> result{};
+    result.reserve(left.size() + right.size());
+    std::set_union(left.begin(), left.end(), right.begin(), right.end(),
+                   std::back_inserter(result));
+    return result;
+}
+
+// Returns every input a tracer depends on
+auto dependencies(const LinearityTracer &num) -> std::vector<Eigen::Index>
+{
+    std::vector<Eigen::Index> linear{};
+    linear.reserve(num.linear().size());
+    for (const auto &term : num.linear()) {
+        linear.push_back(term.first);
+    }
+    return merge(linear, num.nonlinear());
+}
+
+} // namespace
+
+auto LinearityTracer::input(Eigen::Index index, double value)
+    -> LinearityTracer
+{
+    LinearityTracer result{value};
+    result.m_linear.emplace_back(index, 1.0);
+    return result;
+}
+
+auto LinearityTracer::nonlinear_function(double value) const
+    -> LinearityTracer
+{
+    LinearityTracer result{value};
+    result.m_nonlinear = dependencies(*this);
+    return result;
+}
+
+auto LinearityTracer::operator-() const -> LinearityTracer
+{
+    LinearityTracer result{*this};
+    result *= -1.0;
+    return result;
+}
+
+auto LinearityTracer::operator+=(const LinearityTracer &other)
+    -> LinearityTracer &
+{
+    m_value += other.m_value;
+    m_nonlinear = merge(m_nonlinear, other.m_nonlinear);
+
+    // Sum the coefficients of inputs that stay affine in both operands
+    std::vector<Term> linear{};
+    linear.reserve(m_linear.size() + other.m_linear.size());
+    auto left{m_linear.begin()};
+    auto right{other.m_linear.begin()};
+    while (left != m_linear.end() || right != other.m_linear.end()) {
+        Term term{};
+        if (right == other.m_linear.end() ||
+            (left != m_linear.end() && left->first < right->first)) {
+            term = *left++;
+        } else if (left == m_linear.end() || right->first < left->first) {
+            term = *right++;
+        } else {
+            term = Term{left->first, left->second + right->second};
+            ++left;
+            ++right;
+        }
+        if (!std::binary_search(m_nonlinear.begin(), m_nonlinear.end(),
+                                term.first)) {
+            linear.push_back(term);
+        }
+    }
+    m_linear = std::move(linear);
+    return *this;
+}
+
+auto LinearityTracer::operator*=(const LinearityTracer &other)
+    -> LinearityTracer &
+{
+    if (other.is_constant()) {
+        return *this *= other.m_value;
+    }
+    if (is_constant()) {
+        const double scalar{m_value};
+        *this = other;
+        return *this *= scalar;
+    }
+    const double value{m_value * other.m_value};
+    *this = (*this + other).nonlinear_function(value);
+    return *this;
+}
+
+auto LinearityTracer::operator*=(double scalar) -> LinearityTracer &
+{
+    m_value *= scalar;
+    for (auto &term : m_linear) {
+        term.second *= scalar;
+    }
+    return *this;
+}
+
+auto LinearityTracer::operator/=(const LinearityTracer &other)
+    -> LinearityTracer &
+{
+    if (other.is_constant()) {
+        return *this /= other.m_value;
+    }
+    const double value{m_value / other.m_value};
+    *this = (*this + other).nonlinear_function(value);
+    return *this;
+}
+
+auto pow(const LinearityTracer &num, double exponent) -> LinearityTracer
+{
+    if (exponent == 1.0) {
+        return num;
+    }
+    if (exponent == 0.0) {
+        return LinearityTracer{1.0};
+    }
+    return num.nonlinear_function(std::pow(num.value(), exponent));
+}
+
+auto pow(const LinearityTracer &num, const LinearityTracer &exponent)
+    -> LinearityTracer
+{
+    if (exponent.is_constant()) {
+        return pow(num, exponent.value());
+    }
+    // The sum depends on the inputs of both operands
+    return (num + exponent)
+        .nonlinear_function(std::pow(num.value(), exponent.value()));
+}
+
+auto abs(const LinearityTracer &num) -> LinearityTracer
+{
+    return num.nonlinear_function(std::abs(num.value()));
+}
+
+auto abs2(const LinearityTracer &num) -> LinearityTracer
+{
+    return num.nonlinear_function(num.value() * num.value());
+}
+
+auto sqrt(const LinearityTracer &num) -> LinearityTracer
+{
+    return num.nonlinear_function(std::sqrt(num.value()));
+}
+
+auto exp(const LinearityTracer &num) -> LinearityTracer
+{
+    return num.nonlinear_function(std::exp(num.value()));
+}
+
+auto exp2(const LinearityTracer &num) -> LinearityTracer
+{
+    return num.nonlinear_function(std::exp2(num.value()));
+}
+
+auto log(const LinearityTracer &num) -> LinearityTracer
+{
+    return num.nonlinear_function(std::log(num.value()));
+}
+
+auto log2(const LinearityTracer &num) -> LinearityTracer
+{
+    return num.nonlinear_function(std::log2(num.value()));
+}
+
+auto log10(const LinearityTracer &num) -> LinearityTracer
+{
+    return num.nonlinear_function(std::log10(num.value()));
+}
+
+auto sin(const LinearityTracer &num) -> LinearityTracer
+{
+    return num.nonlinear_function(std::sin(num.value()));
+}
+
+auto cos(const LinearityTracer &num) -> LinearityTracer
+{
+    return num.nonlinear_function(std::cos(num.value()));
+}
+
+auto tan(const LinearityTracer &num) -> LinearityTracer
+{
+    return num.nonlinear_function(std::tan(num.value()));
+}
+
+auto asin(const LinearityTracer &num) -> LinearityTracer
+{
+    return num.nonlinear_function(std::asin(num.value()));
+}
+
+auto acos(const LinearityTracer &num) -> LinearityTracer
+{
+    return num.nonlinear_function(std::acos(num.value()));
+}
+
+auto atan(const LinearityTracer &num) -> LinearityTracer
+{
+    return num.nonlinear_function(std::atan(num.value()));
+}
+
+auto sinh(const LinearityTracer &num) -> LinearityTracer
+{
+    return num.nonlinear_function(std::sinh(num.value()));
+}
+
+auto cosh(const LinearityTracer &num) -> LinearityTracer
+{
+    return num.nonlinear_function(std::cosh(num.value()));
+}
+
+auto tanh(const LinearityTracer &num) -> LinearityTracer
+{
+    return num.nonlinear_function(std::tanh(num.value()));
+}
+
+auto asinh(const LinearityTracer &num) -> LinearityTracer
+{
+    return num.nonlinear_function(std::asinh(num.value()));
+}
+
+auto acosh(const LinearityTracer &num) -> LinearityTracer
+{
+    return num.nonlinear_function(std::acosh(num.value()));
+}
+
+auto atanh(const LinearityTracer &num) -> LinearityTracer
+{
+    return num.nonlinear_function(std::atanh(num.value()));
+}
+
+} // namespace algodiff::forward
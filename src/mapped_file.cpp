@@ -0,0 +1,145 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+#include <cerrno>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "algodiff/mapped_file.hpp"
+
+namespace algodiff
+{
+namespace
+{
+[[noreturn]] auto throw_errno(const std::string &what) -> void
+{
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+/// Closes a file descriptor when leaving scope
+class FileDescriptor
+{
+public:
+    explicit FileDescriptor(int fd) : m_fd{fd}
+    {
+    }
+    FileDescriptor(const FileDescriptor &) = delete;
+    FileDescriptor(FileDescriptor &&) = delete;
+    auto operator=(const FileDescriptor &) -> FileDescriptor & = delete;
+    auto operator=(FileDescriptor &&) -> FileDescriptor & = delete;
+    ~FileDescriptor()
+    {
+        if (m_fd >= 0) {
+            ::close(m_fd);
+        }
+    }
+    auto get() const -> int
+    {
+        return m_fd;
+    }
+
+private:
+    int m_fd;
+};
+
+} // namespace
+
+MappedFile::MappedFile(const std::string &path, Mode mode, std::size_t size)
+{
+    const bool writable{mode == Mode::ReadWrite};
+    const FileDescriptor fd{
+        ::open(path.c_str(), writable ? O_RDWR | O_CREAT : O_RDONLY, 0644)};
+    if (fd.get() < 0) {
+        throw_errno("Unable to open " + path);
+    }
+
+    if (writable) {
+        if (::ftruncate(fd.get(), static_cast<off_t>(size)) != 0) {
+            throw_errno("Unable to resize " + path);
+        }
+    } else {
+        struct stat info {};
+        if (::fstat(fd.get(), &info) != 0) {
+            throw_errno("Unable to stat " + path);
+        }
+        size = static_cast<std::size_t>(info.st_size);
+    }
+
+    if (size == 0) {
+        return;
+    }
+    void *data{::mmap(nullptr, size,
+                      writable ? PROT_READ | PROT_WRITE : PROT_READ,
+                      MAP_SHARED, fd.get(), 0)};
+    if (data == MAP_FAILED) { // NOLINT
+        throw_errno("Unable to map " + path);
+    }
+    m_data = static_cast<std::byte *>(data);
+    m_size = size;
+}
+
+auto MappedFile::shared_memory(std::size_t size) -> MappedFile
+{
+    if (size == 0) {
+        return MappedFile{};
+    }
+    void *data{::mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_ANONYMOUS, -1, 0)};
+    if (data == MAP_FAILED) { // NOLINT
+        throw_errno("Unable to map shared memory");
+    }
+    return MappedFile{static_cast<std::byte *>(data), size};
+}
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+    : m_data{std::exchange(other.m_data, nullptr)},
+      m_size{std::exchange(other.m_size, 0)}
+{
+}
+
+auto MappedFile::operator=(MappedFile &&other) noexcept -> MappedFile &
+{
+    if (this != &other) {
+        if (m_data != nullptr) {
+            ::munmap(m_data, m_size);
+        }
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+    }
+    return *this;
+}
+
+MappedFile::~MappedFile()
+{
+    if (m_data != nullptr) {
+        ::munmap(m_data, m_size);
+    }
+}
+
+auto MappedFile::advise_sequential() const -> void
+{
+    if (m_data != nullptr) {
+        ::madvise(m_data, m_size, MADV_SEQUENTIAL);
+    }
+}
+
+auto MappedFile::sync(std::size_t offset, std::size_t length) const -> void
+{
+    if (m_data == nullptr || length == 0) {
+        return;
+    }
+    // msync needs a page aligned start address
+    const auto page{static_cast<std::size_t>(::sysconf(_SC_PAGESIZE))};
+    const auto begin{offset - offset % page};
+    if (::msync(m_data + begin, offset + length - begin, MS_SYNC) != 0) {
+        throw_errno("Unable to write back mapped file");
+    }
+}
+
+} // namespace algodiff
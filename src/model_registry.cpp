@@ -0,0 +1,95 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+#include <stdexcept>
+#include <utility>
+
+#include <dlfcn.h>
+
+#include "algodiff/model_registry.hpp"
+#include "algodiff/server_plugin.hpp"
+
+namespace algodiff
+{
+auto ModelRegistry::add(const std::string &name, Model model) -> void
+{
+    if (name.empty()) {
+        throw std::invalid_argument("Model names must not be empty");
+    }
+    if (!model.evaluate) {
+        throw std::invalid_argument("Model " + name +
+                                    " has no evaluate function");
+    }
+
+    const std::lock_guard<std::mutex> lock{m_mutex};
+    const auto inserted{m_models
+                            .emplace(name, std::make_shared<const Model>(
+                                               std::move(model)))
+                            .second};
+    if (!inserted) {
+        throw std::invalid_argument("A model named " + name +
+                                    " is already registered");
+    }
+}
+
+auto ModelRegistry::find(const std::string &name) const
+    -> std::shared_ptr<const Model>
+{
+    const std::lock_guard<std::mutex> lock{m_mutex};
+    const auto it{m_models.find(name)};
+    return it == m_models.end() ? nullptr : it->second;
+}
+
+auto ModelRegistry::names() const -> std::vector<std::string>
+{
+    const std::lock_guard<std::mutex> lock{m_mutex};
+    std::vector<std::string> result{};
+    result.reserve(m_models.size());
+    for (const auto &entry : m_models) {
+        result.push_back(entry.first);
+    }
+    return result;
+}
+
+auto load_plugin(const std::string &path, ModelRegistry &registry) -> void
+{
+    void *handle{::dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL)};
+    if (handle == nullptr) {
+        throw std::runtime_error(::dlerror());
+    }
+    auto *entry{reinterpret_cast<RegisterModels>(
+        ::dlsym(handle, ALGODIFF_PLUGIN_ENTRY_POINT))};
+    if (entry == nullptr) {
+        throw std::runtime_error(path + " has no " +
+                                 ALGODIFF_PLUGIN_ENTRY_POINT + " function");
+    }
+    entry(registry);
+}
+
+namespace reverse
+{
+auto make_tape_model(std::shared_ptr<Tape> tape) -> Model
+{
+    if (!tape) {
+        throw std::invalid_argument("The tape of a model must not be null");
+    }
+
+    Model model{};
+    model.input_size = static_cast<Eigen::Index>(tape->inputs().size());
+    model.output_size = static_cast<Eigen::Index>(tape->outputs().size());
+    model.thread_safe = false;
+    // Calls are serialized anyway, so they share one set of adjoints
+    model.evaluate = [tape, mutex = std::make_shared<std::mutex>(),
+                      adjoints = std::make_shared<std::vector<double>>()](
+                         const double *x, double *value, double *jacobian) {
+        const std::lock_guard<std::mutex> lock{*mutex};
+        tape->replay(x, value);
+        tape->jacobian(jacobian, *adjoints);
+    };
+    return model;
+}
+
+} // namespace reverse
+
+} // namespace algodiff
@@ -0,0 +1,120 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "algodiff/process_jacobian.hpp"
+
+namespace algodiff::forward::internal
+{
+namespace
+{
+/// How long the parent sleeps when no child has finished
+constexpr std::chrono::milliseconds poll_interval{1};
+
+// Waits for every child in running, ignoring how they end
+auto reap(const std::unordered_map<pid_t, std::int64_t> &running) -> void
+{
+    for (const auto &child : running) {
+        int status{0};
+        while (::waitpid(child.first, &status, 0) < 0 && errno == EINTR) {
+        }
+    }
+}
+
+} // namespace
+
+auto run_process_shards(std::int64_t shards, unsigned processes,
+                        int max_attempts,
+                        const std::function<void(std::int64_t)> &work)
+    -> void
+{
+    // A child sets its byte once work returns, which guards against children
+    // that exit with status 0 from inside f
+    const MappedFile done{
+        MappedFile::shared_memory(static_cast<std::size_t>(shards))};
+
+    std::deque<std::int64_t> pending{};
+    for (std::int64_t shard = 0; shard < shards; ++shard) {
+        pending.push_back(shard);
+    }
+    std::vector<int> attempts(static_cast<size_t>(shards), 0);
+    std::unordered_map<pid_t, std::int64_t> running{};
+    std::int64_t failed{-1};
+
+    while (!running.empty() || (!pending.empty() && failed < 0)) {
+        while (failed < 0 && !pending.empty() && running.size() < processes) {
+            const auto shard{pending.front()};
+            const pid_t pid{::fork()};
+            if (pid < 0) {
+                const int error{errno};
+                reap(running);
+                throw std::system_error(error, std::generic_category(),
+                                        "Unable to start a worker process");
+            }
+            if (pid == 0) {
+                int code{EXIT_FAILURE};
+                try {
+                    work(shard);
+                    done.data()[shard] = std::byte{1};
+                    code = EXIT_SUCCESS;
+                } catch (...) {
+                }
+                std::_Exit(code);
+            }
+            pending.pop_front();
+            ++attempts[static_cast<size_t>(shard)];
+            running.emplace(pid, shard);
+        }
+
+        bool finished{false};
+        for (auto it = running.begin(); it != running.end();) {
+            int status{0};
+            const pid_t pid{::waitpid(it->first, &status, WNOHANG)};
+            if (pid == 0 || (pid < 0 && errno == EINTR)) {
+                ++it;
+                continue;
+            }
+
+            const auto shard{it->second};
+            it = running.erase(it);
+            finished = true;
+            const bool succeeded{pid > 0 && WIFEXITED(status) &&
+                                 WEXITSTATUS(status) == EXIT_SUCCESS &&
+                                 done.data()[shard] == std::byte{1}};
+            if (succeeded) {
+                continue;
+            }
+            if (attempts[static_cast<size_t>(shard)] < max_attempts) {
+                pending.push_back(shard);
+            } else if (failed < 0) {
+                failed = shard;
+            }
+        }
+        if (!finished && !running.empty()) {
+            std::this_thread::sleep_for(poll_interval);
+        }
+    }
+
+    if (failed >= 0) {
+        throw std::runtime_error("Shard " + std::to_string(failed) +
+                                 " failed after " +
+                                 std::to_string(max_attempts) + " attempts");
+    }
+}
+
+} // namespace algodiff::forward::internal
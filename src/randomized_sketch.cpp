@@ -0,0 +1,52 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+#include <Eigen/QR>
+
+#include "algodiff/randomized_sketch.hpp"
+
+namespace algodiff::forward::internal
+{
+auto rademacher(Eigen::Index rows, Eigen::Index cols, std::mt19937_64 &rng)
+    -> Eigen::MatrixXd
+{
+    std::bernoulli_distribution coin{0.5};
+    Eigen::MatrixXd result(rows, cols);
+    for (Eigen::Index j = 0; j < cols; ++j) {
+        for (Eigen::Index i = 0; i < rows; ++i) {
+            result(i, j) = coin(rng) ? 1.0 : -1.0;
+        }
+    }
+    return result;
+}
+
+auto gaussian(Eigen::Index rows, Eigen::Index cols, std::mt19937_64 &rng)
+    -> Eigen::MatrixXd
+{
+    std::normal_distribution<double> normal{};
+    Eigen::MatrixXd result(rows, cols);
+    for (Eigen::Index j = 0; j < cols; ++j) {
+        for (Eigen::Index i = 0; i < rows; ++i) {
+            result(i, j) = normal(rng);
+        }
+    }
+    return result;
+}
+
+auto orthonormalize(const Eigen::MatrixXd &y) -> Eigen::MatrixXd
+{
+    const Eigen::HouseholderQR<Eigen::MatrixXd> qr{y};
+    return qr.householderQ() * Eigen::MatrixXd::Identity(y.rows(), y.cols());
+}
+
+auto require_square(Eigen::Index function_size, Eigen::Index input_size)
+    -> void
+{
+    if (function_size != input_size) {
+        throw std::invalid_argument(
+            "Expected a function with as many outputs as inputs");
+    }
+}
+
+} // namespace algodiff::forward::internal
@@ -0,0 +1,263 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <new>
+#include <vector>
+
+#include "algodiff/sparse_dual_number.hpp"
+
+namespace algodiff::forward
+{
+namespace
+{
+using Entry = SparseTangent::Entry;
+
+/// The smallest external buffer, in entries
+constexpr std::uint32_t min_block{8};
+
+/// The number of free blocks kept per size class
+constexpr size_t max_pooled_blocks{256};
+
+/// Set once the pool of the current thread is destroyed
+thread_local bool pool_destroyed{false};
+
+/**
+ * Recycles external tangent buffers within a thread. Blocks come in power of
+ * two capacities and are kept on one free list per capacity.
+ */
+class BlockPool
+{
+public:
+    BlockPool() = default;
+    BlockPool(const BlockPool &) = delete;
+    BlockPool(BlockPool &&) = delete;
+    auto operator=(const BlockPool &) -> BlockPool & = delete;
+    auto operator=(BlockPool &&) -> BlockPool & = delete;
+
+    ~BlockPool()
+    {
+        for (auto &blocks : m_free) {
+            for (auto *block : blocks) {
+                ::operator delete(block);
+            }
+        }
+        pool_destroyed = true;
+    }
+
+    auto acquire(std::uint32_t capacity) -> Entry *
+    {
+        auto &blocks{m_free[size_class(capacity)]};
+        if (!blocks.empty()) {
+            auto *block{blocks.back()};
+            blocks.pop_back();
+            return block;
+        }
+        return static_cast<Entry *>(::operator new(capacity * sizeof(Entry)));
+    }
+
+    auto release(Entry *block, std::uint32_t capacity) -> void
+    {
+        auto &blocks{m_free[size_class(capacity)]};
+        if (blocks.size() < max_pooled_blocks) {
+            blocks.push_back(block);
+        } else {
+            ::operator delete(block);
+        }
+    }
+
+private:
+    static auto size_class(std::uint32_t capacity) -> size_t
+    {
+        size_t result{0};
+        while ((min_block << result) < capacity) {
+            ++result;
+        }
+        return result;
+    }
+
+    std::array<std::vector<Entry *>, 32> m_free{};
+};
+
+auto pool() -> BlockPool &
+{
+    thread_local BlockPool instance{};
+    return instance;
+}
+
+auto round_capacity(std::uint32_t size) -> std::uint32_t
+{
+    std::uint32_t capacity{min_block};
+    while (capacity < size) {
+        capacity *= 2;
+    }
+    return capacity;
+}
+
+auto release_block(Entry *block, std::uint32_t capacity) -> void
+{
+    if (pool_destroyed) {
+        ::operator delete(block);
+    } else {
+        pool().release(block, capacity);
+    }
+}
+
+} // namespace
+
+SparseTangent::SparseTangent(Eigen::Index index, double value) : m_size{1}
+{
+    m_inline[0] = Entry{index, value};
+}
+
+SparseTangent::SparseTangent(const Entry *first, const Entry *last)
+{
+    const auto size{static_cast<std::uint32_t>(last - first)};
+    reset_capacity(size);
+    std::copy(first, last, data());
+    m_size = size;
+}
+
+SparseTangent::SparseTangent(const SparseTangent &other)
+{
+    reset_capacity(other.m_size);
+    std::copy(other.begin(), other.end(), data());
+    m_size = other.m_size;
+}
+
+SparseTangent::SparseTangent(SparseTangent &&other) noexcept
+    : m_heap{std::exchange(other.m_heap, nullptr)},
+      m_size{std::exchange(other.m_size, 0)},
+      m_capacity{std::exchange(other.m_capacity, inline_capacity)}
+{
+    if (m_heap == nullptr) {
+        std::copy(other.m_inline.begin(), other.m_inline.begin() + m_size,
+                  m_inline.begin());
+    }
+}
+
+auto SparseTangent::operator=(const SparseTangent &other) -> SparseTangent &
+{
+    if (this != &other) {
+        reset_capacity(other.m_size);
+        std::copy(other.begin(), other.end(), data());
+        m_size = other.m_size;
+    }
+    return *this;
+}
+
+auto SparseTangent::operator=(SparseTangent &&other) noexcept
+    -> SparseTangent &
+{
+    if (this != &other) {
+        if (m_heap != nullptr) {
+            release_block(m_heap, m_capacity);
+        }
+        m_heap = std::exchange(other.m_heap, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+        m_capacity = std::exchange(other.m_capacity, inline_capacity);
+        if (m_heap == nullptr) {
+            std::copy(other.m_inline.begin(), other.m_inline.begin() + m_size,
+                      m_inline.begin());
+        }
+    }
+    return *this;
+}
+
+SparseTangent::~SparseTangent()
+{
+    if (m_heap != nullptr) {
+        release_block(m_heap, m_capacity);
+    }
+}
+
+auto SparseTangent::coeff(Eigen::Index index) const -> double
+{
+    const auto *it{std::lower_bound(
+        begin(), end(), index,
+        [](const Entry &entry, Eigen::Index i) { return entry.index < i; })};
+    return it != end() && it->index == index ? it->value : 0.0;
+}
+
+auto SparseTangent::scale(double scalar) -> void
+{
+    auto *entries{data()};
+    for (std::uint32_t i = 0; i < m_size; ++i) {
+        entries[i].value *= scalar;
+    }
+}
+
+auto SparseTangent::combine(double a, const SparseTangent &x, double b,
+                            const SparseTangent &y) -> SparseTangent
+{
+    SparseTangent result{};
+    if (y.empty()) {
+        result = x;
+        result.scale(a);
+        return result;
+    }
+    if (x.empty()) {
+        result = y;
+        result.scale(b);
+        return result;
+    }
+
+    result.reset_capacity(x.m_size + y.m_size);
+    auto *out{result.data()};
+    const auto *xi{x.begin()};
+    const auto *yi{y.begin()};
+    while (xi != x.end() && yi != y.end()) {
+        if (xi->index < yi->index) {
+            *out++ = Entry{xi->index, a * xi->value};
+            ++xi;
+        } else if (yi->index < xi->index) {
+            *out++ = Entry{yi->index, b * yi->value};
+            ++yi;
+        } else {
+            *out++ = Entry{xi->index, a * xi->value + b * yi->value};
+            ++xi;
+            ++yi;
+        }
+    }
+    for (; xi != x.end(); ++xi) {
+        *out++ = Entry{xi->index, a * xi->value};
+    }
+    for (; yi != y.end(); ++yi) {
+        *out++ = Entry{yi->index, b * yi->value};
+    }
+    result.m_size = static_cast<std::uint32_t>(out - result.data());
+    return result;
+}
+
+auto SparseTangent::reset_capacity(std::uint32_t capacity) -> void
+{
+    m_size = 0;
+    if (capacity <= m_capacity) {
+        return;
+    }
+    if (m_heap != nullptr) {
+        release_block(m_heap, m_capacity);
+    }
+    m_capacity = round_capacity(capacity);
+    m_heap = pool().acquire(m_capacity);
+}
+
+auto SparseDualNumber::operator==(const SparseDualNumber &other) const -> bool
+{
+    constexpr double epsilon{std::numeric_limits<double>::epsilon()};
+    if (std::abs(primal() - other.primal()) >= epsilon ||
+        tangent().size() != other.tangent().size()) {
+        return false;
+    }
+    return std::equal(tangent().begin(), tangent().end(),
+                      other.tangent().begin(),
+                      [&](const Entry &left, const Entry &right) {
+                          return left.index == right.index &&
+                                 std::abs(left.value - right.value) < epsilon;
+                      });
+}
+
+} // namespace algodiff::forward
@@ -0,0 +1,173 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+#include <cmath>
+
+#include "algodiff/sparse_dual_number_ops.hpp"
+
+#include "algodiff/sparse_dual_number.hpp"
+
+namespace algodiff::forward
+{
+namespace
+{
+// Applies a scalar function with value f(x) and derivative f'(x) to num
+auto chain(const SparseDualNumber &num, const double value,
+           const double derivative) -> SparseDualNumber
+{
+    SparseDualNumber result{value, num.tangent()};
+    result.tangent().scale(derivative);
+    return result;
+}
+
+} // namespace
+
+auto abs(const SparseDualNumber &num) -> SparseDualNumber
+{
+    return chain(num, std::abs(num.primal()),
+                 num.primal() / std::abs(num.primal()));
+}
+
+auto inverse(const SparseDualNumber &num) -> SparseDualNumber
+{
+    return pow(num, -1.0);
+}
+
+auto abs2(const SparseDualNumber &num) -> SparseDualNumber
+{
+    return chain(num, num.primal() * num.primal(), 2.0 * num.primal());
+}
+
+auto norm(const SparseDualNumber &num) -> SparseDualNumber
+{
+    return abs2(num);
+}
+
+auto pow(const SparseDualNumber &num, const double exponent)
+    -> SparseDualNumber
+{
+    return chain(num, std::pow(num.primal(), exponent),
+                 exponent * std::pow(num.primal(), exponent - 1.0));
+}
+
+auto pow(const SparseDualNumber &num, const SparseDualNumber &exponent)
+    -> SparseDualNumber
+{
+    const double value{std::pow(num.primal(), exponent.primal())};
+    return SparseDualNumber{
+        value, SparseTangent::combine(
+                   value * exponent.primal() / num.primal(), num.tangent(),
+                   value * std::log(num.primal()), exponent.tangent())};
+}
+
+auto sqrt(const SparseDualNumber &num) -> SparseDualNumber
+{
+    const double value{std::sqrt(num.primal())};
+    return chain(num, value, 0.5 / value); // NOLINT
+}
+
+auto exp(const SparseDualNumber &num) -> SparseDualNumber
+{
+    const double value{std::exp(num.primal())};
+    return chain(num, value, value);
+}
+
+auto exp2(const SparseDualNumber &num) -> SparseDualNumber
+{
+    const double value{std::exp2(num.primal())};
+    return chain(num, value, std::log(2.0) * value); // NOLINT
+}
+
+auto log(const SparseDualNumber &num) -> SparseDualNumber
+{
+    return chain(num, std::log(num.primal()), 1.0 / num.primal());
+}
+
+auto log2(const SparseDualNumber &num) -> SparseDualNumber
+{
+    return log(num, 2.0); // NOLINT
+}
+
+auto log10(const SparseDualNumber &num) -> SparseDualNumber
+{
+    return log(num, 10.0); // NOLINT
+}
+
+auto log(const SparseDualNumber &num, const double base) -> SparseDualNumber
+{
+    const double log_base{std::log(base)};
+    return chain(num, std::log(num.primal()) / log_base,
+                 1.0 / (num.primal() * log_base));
+}
+
+auto sin(const SparseDualNumber &num) -> SparseDualNumber
+{
+    return chain(num, std::sin(num.primal()), std::cos(num.primal()));
+}
+
+auto cos(const SparseDualNumber &num) -> SparseDualNumber
+{
+    return chain(num, std::cos(num.primal()), -std::sin(num.primal()));
+}
+
+auto tan(const SparseDualNumber &num) -> SparseDualNumber
+{
+    const double cos_primal = std::cos(num.primal());
+    return chain(num, std::tan(num.primal()), 1.0 / (cos_primal * cos_primal));
+}
+
+auto asin(const SparseDualNumber &num) -> SparseDualNumber
+{
+    return chain(num, std::asin(num.primal()),
+                 1.0 / std::sqrt(1.0 - num.primal() * num.primal()));
+}
+
+auto acos(const SparseDualNumber &num) -> SparseDualNumber
+{
+    return chain(num, std::acos(num.primal()),
+                 -1.0 / std::sqrt(1.0 - num.primal() * num.primal()));
+}
+
+auto atan(const SparseDualNumber &num) -> SparseDualNumber
+{
+    return chain(num, std::atan(num.primal()),
+                 1.0 / (1.0 + num.primal() * num.primal()));
+}
+
+auto sinh(const SparseDualNumber &num) -> SparseDualNumber
+{
+    return chain(num, std::sinh(num.primal()), std::cosh(num.primal()));
+}
+
+auto cosh(const SparseDualNumber &num) -> SparseDualNumber
+{
+    return chain(num, std::cosh(num.primal()), std::sinh(num.primal()));
+}
+
+auto tanh(const SparseDualNumber &num) -> SparseDualNumber
+{
+    const double cosh_primal = std::cosh(num.primal());
+    return chain(num, std::tanh(num.primal()),
+                 1.0 / (cosh_primal * cosh_primal));
+}
+
+auto asinh(const SparseDualNumber &num) -> SparseDualNumber
+{
+    return chain(num, std::asinh(num.primal()),
+                 1.0 / std::sqrt(num.primal() * num.primal() + 1.0));
+}
+
+auto acosh(const SparseDualNumber &num) -> SparseDualNumber
+{
+    return chain(num, std::acosh(num.primal()),
+                 1.0 / std::sqrt(num.primal() * num.primal() - 1.0));
+}
+
+auto atanh(const SparseDualNumber &num) -> SparseDualNumber
+{
+    return chain(num, std::atanh(num.primal()),
+                 1.0 / (1.0 - num.primal() * num.primal()));
+}
+
+} // namespace algodiff::forward
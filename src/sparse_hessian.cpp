@@ -0,0 +1,134 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+#include <algorithm>
+
+#include "algodiff/sparse_hessian.hpp"
+
+namespace algodiff::forward
+{
+namespace
+{
+using Adjacency = Eigen::SparseMatrix<double>;
+
+// Counts the neighbors of vertex that have the given color
+auto neighbors_with_color(const Adjacency &adjacency,
+                          const std::vector<int> &colors, Eigen::Index vertex,
+                          int color) -> int
+{
+    int count{0};
+    for (Adjacency::InnerIterator it(adjacency, vertex); it; ++it) {
+        if (colors[static_cast<size_t>(it.row())] == color) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+} // namespace
+
+auto color_hessian(const Eigen::SparseMatrix<double> &pattern)
+    -> HessianColoring
+{
+    if (pattern.rows() != pattern.cols()) {
+        throw std::invalid_argument("A hessian pattern must be square");
+    }
+
+    HessianColoring coloring{};
+    coloring.size = pattern.rows();
+    const auto n{coloring.size};
+
+    std::vector<Eigen::Triplet<double>> lower{};
+    std::vector<Eigen::Triplet<double>> adjacency{};
+    for (Eigen::Index col = 0; col < pattern.outerSize(); ++col) {
+        for (Eigen::SparseMatrix<double>::InnerIterator it(pattern, col); it;
+             ++it) {
+            const auto i{std::max(it.row(), it.col())};
+            const auto j{std::min(it.row(), it.col())};
+            lower.emplace_back(i, j, 1.0);
+            if (i != j) {
+                adjacency.emplace_back(i, j, 1.0);
+                adjacency.emplace_back(j, i, 1.0);
+            }
+        }
+    }
+    // Duplicates from a full pattern collapse; the values are never read
+    auto keep_one = [](double, double) { return 1.0; };
+    coloring.lower.resize(n, n);
+    coloring.lower.setFromTriplets(lower.begin(), lower.end(), keep_one);
+    coloring.adjacency.resize(n, n);
+    coloring.adjacency.setFromTriplets(adjacency.begin(), adjacency.end(),
+                                       keep_one);
+
+    const auto &graph{coloring.adjacency};
+    auto &colors{coloring.colors};
+    colors.assign(static_cast<size_t>(n), -1);
+    auto color_of = [&](Eigen::Index vertex) {
+        return colors[static_cast<size_t>(vertex)];
+    };
+
+    // forbidden[c] == v marks color c as unavailable for vertex v
+    std::vector<Eigen::Index> forbidden(static_cast<size_t>(n) + 1, -1);
+    for (Eigen::Index v = 0; v < n; ++v) {
+        for (Adjacency::InnerIterator w(graph, v); w; ++w) {
+            const auto w_color{color_of(w.row())};
+            if (w_color >= 0) {
+                forbidden[static_cast<size_t>(w_color)] = v;
+            }
+            for (Adjacency::InnerIterator x(graph, w.row()); x; ++x) {
+                const auto x_color{color_of(x.row())};
+                if (x.row() == v || x_color < 0) {
+                    continue;
+                }
+                if (w_color < 0) {
+                    forbidden[static_cast<size_t>(x_color)] = v;
+                    continue;
+                }
+                // Avoid a two colored path v - w - x - y
+                for (Adjacency::InnerIterator y(graph, x.row()); y; ++y) {
+                    if (y.row() != w.row() && color_of(y.row()) == w_color) {
+                        forbidden[static_cast<size_t>(x_color)] = v;
+                        break;
+                    }
+                }
+            }
+        }
+
+        int color{0};
+        while (forbidden[static_cast<size_t>(color)] == v) {
+            ++color;
+        }
+        colors[static_cast<size_t>(v)] = color;
+        coloring.color_count = std::max(coloring.color_count, color + 1);
+    }
+    return coloring;
+}
+
+auto recover_hessian(const HessianColoring &coloring,
+                     const Eigen::MatrixXd &compressed)
+    -> Eigen::SparseMatrix<double>
+{
+    Eigen::SparseMatrix<double> hessian{coloring.lower};
+    const auto &colors{coloring.colors};
+    for (Eigen::Index col = 0; col < hessian.outerSize(); ++col) {
+        const auto col_color{colors[static_cast<size_t>(col)]};
+        for (Eigen::SparseMatrix<double>::InnerIterator it(hessian, col); it;
+             ++it) {
+            const auto row{it.row()};
+            const auto row_color{colors[static_cast<size_t>(row)]};
+            if (row == col) {
+                it.valueRef() = compressed(row, col_color);
+            } else if (neighbors_with_color(coloring.adjacency, colors, row,
+                                            col_color) == 1) {
+                // col is the only neighbor of row with its color
+                it.valueRef() = compressed(row, col_color);
+            } else {
+                it.valueRef() = compressed(col, row_color);
+            }
+        }
+    }
+    return hessian;
+}
+
+} // namespace algodiff::forward
@@ -0,0 +1,18 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+#include "algodiff/stencil_jacobian.hpp"
+
+namespace algodiff::forward::internal
+{
+auto require_grid_size(Eigen::Index points, Eigen::Index components,
+                       Eigen::Index size) -> void
+{
+    if (points * components != size) {
+        throw std::invalid_argument(
+            "Expected one value per component of every grid point");
+    }
+}
+
+} // namespace algodiff::forward::internal
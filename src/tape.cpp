@@ -0,0 +1,649 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include "algodiff/tape.hpp"
+
+namespace algodiff::reverse
+{
+namespace
+{
+auto same_tape(const Variable &left, const Variable &right) -> Tape *
+{
+    if (left.tape() != right.tape()) {
+        throw std::invalid_argument(
+            "Variables are recorded on different tapes");
+    }
+    return left.tape();
+}
+
+} // namespace
+
+namespace internal
+{
+auto apply(OpCode op, double lhs, double rhs, double constant) -> double
+{
+    switch (op) {
+    case OpCode::Constant:
+        return constant;
+    case OpCode::Add:
+        return lhs + rhs;
+    case OpCode::Subtract:
+        return lhs - rhs;
+    case OpCode::Multiply:
+        return lhs * rhs;
+    case OpCode::Divide:
+        return lhs / rhs;
+    case OpCode::Pow:
+        return std::pow(lhs, rhs);
+    case OpCode::AddConstant:
+        return lhs + constant;
+    case OpCode::ConstantSubtract:
+        return constant - lhs;
+    case OpCode::MultiplyConstant:
+        return lhs * constant;
+    case OpCode::DivideConstant:
+        return lhs / constant;
+    case OpCode::ConstantDivide:
+        return constant / lhs;
+    case OpCode::PowConstant:
+        return std::pow(lhs, constant);
+    case OpCode::Negate:
+        return -lhs;
+    case OpCode::Abs:
+        return std::abs(lhs);
+    case OpCode::Sqrt:
+        return std::sqrt(lhs);
+    case OpCode::Exp:
+        return std::exp(lhs);
+    case OpCode::Log:
+        return std::log(lhs);
+    case OpCode::Sin:
+        return std::sin(lhs);
+    case OpCode::Cos:
+        return std::cos(lhs);
+    case OpCode::Tan:
+        return std::tan(lhs);
+    case OpCode::Asin:
+        return std::asin(lhs);
+    case OpCode::Acos:
+        return std::acos(lhs);
+    case OpCode::Atan:
+        return std::atan(lhs);
+    case OpCode::Sinh:
+        return std::sinh(lhs);
+    case OpCode::Cosh:
+        return std::cosh(lhs);
+    case OpCode::Tanh:
+        return std::tanh(lhs);
+    case OpCode::Input:
+    case OpCode::ExternalOutput:
+        break;
+    }
+    throw std::invalid_argument("The operation has no local evaluation");
+}
+
+auto partials(OpCode op, double lhs, double rhs, double constant,
+              double value) -> std::array<double, 2>
+{
+    switch (op) {
+    case OpCode::Add:
+        return {1.0, 1.0};
+    case OpCode::Subtract:
+        return {1.0, -1.0};
+    case OpCode::Multiply:
+        return {rhs, lhs};
+    case OpCode::Divide:
+        return {1.0 / rhs, -value / rhs};
+    case OpCode::Pow:
+        return {rhs * std::pow(lhs, rhs - 1.0), value * std::log(lhs)};
+    case OpCode::AddConstant:
+        return {1.0, 0.0};
+    case OpCode::ConstantSubtract:
+    case OpCode::Negate:
+        return {-1.0, 0.0};
+    case OpCode::MultiplyConstant:
+        return {constant, 0.0};
+    case OpCode::DivideConstant:
+        return {1.0 / constant, 0.0};
+    case OpCode::ConstantDivide:
+        return {-value / lhs, 0.0};
+    case OpCode::PowConstant:
+        return {constant * std::pow(lhs, constant - 1.0), 0.0};
+    case OpCode::Abs:
+        return {lhs / std::abs(lhs), 0.0};
+    case OpCode::Sqrt:
+        return {0.5 / value, 0.0}; // NOLINT
+    case OpCode::Exp:
+        return {value, 0.0};
+    case OpCode::Log:
+        return {1.0 / lhs, 0.0};
+    case OpCode::Sin:
+        return {std::cos(lhs), 0.0};
+    case OpCode::Cos:
+        return {-std::sin(lhs), 0.0};
+    case OpCode::Tan: {
+        const double cos_lhs{std::cos(lhs)};
+        return {1.0 / (cos_lhs * cos_lhs), 0.0};
+    }
+    case OpCode::Asin:
+        return {1.0 / std::sqrt(1.0 - lhs * lhs), 0.0};
+    case OpCode::Acos:
+        return {-1.0 / std::sqrt(1.0 - lhs * lhs), 0.0};
+    case OpCode::Atan:
+        return {1.0 / (1.0 + lhs * lhs), 0.0};
+    case OpCode::Sinh:
+        return {std::cosh(lhs), 0.0};
+    case OpCode::Cosh:
+        return {std::sinh(lhs), 0.0};
+    case OpCode::Tanh:
+        return {1.0 - value * value, 0.0};
+    case OpCode::Input:
+    case OpCode::Constant:
+    case OpCode::ExternalOutput:
+        break;
+    }
+    return {0.0, 0.0};
+}
+
+auto unary(OpCode op, const Variable &num, double constant) -> Variable
+{
+    if (!num.is_active()) {
+        return Variable{apply(op, num.value(), 0.0, constant)};
+    }
+    return num.tape()->record(op, num.index(), 0, constant);
+}
+
+} // namespace internal
+
+auto Variable::operator-() const -> Variable
+{
+    return internal::unary(OpCode::Negate, *this);
+}
+
+auto Variable::operator+=(const Variable &other) -> Variable &
+{
+    return *this = *this + other;
+}
+
+auto Variable::operator+=(double n) -> Variable &
+{
+    return *this = *this + n;
+}
+
+auto Variable::operator-=(const Variable &other) -> Variable &
+{
+    return *this = *this - other;
+}
+
+auto Variable::operator-=(double n) -> Variable &
+{
+    return *this = *this - n;
+}
+
+auto Variable::operator*=(const Variable &other) -> Variable &
+{
+    return *this = *this * other;
+}
+
+auto Variable::operator*=(double scalar) -> Variable &
+{
+    return *this = *this * scalar;
+}
+
+auto Variable::operator/=(const Variable &other) -> Variable &
+{
+    return *this = *this / other;
+}
+
+auto Variable::operator/=(double scalar) -> Variable &
+{
+    return *this = *this / scalar;
+}
+
+auto operator+(const Variable &left, const Variable &right) -> Variable
+{
+    if (!right.is_active()) {
+        return left + right.value();
+    }
+    if (!left.is_active()) {
+        return left.value() + right;
+    }
+    return same_tape(left, right)
+        ->record(OpCode::Add, left.index(), right.index());
+}
+
+auto operator+(const Variable &num, double n) -> Variable
+{
+    return internal::unary(OpCode::AddConstant, num, n);
+}
+
+auto operator+(double n, const Variable &num) -> Variable
+{
+    return internal::unary(OpCode::AddConstant, num, n);
+}
+
+auto operator-(const Variable &left, const Variable &right) -> Variable
+{
+    if (!right.is_active()) {
+        return left - right.value();
+    }
+    if (!left.is_active()) {
+        return left.value() - right;
+    }
+    return same_tape(left, right)
+        ->record(OpCode::Subtract, left.index(), right.index());
+}
+
+auto operator-(const Variable &num, double n) -> Variable
+{
+    return internal::unary(OpCode::AddConstant, num, -n);
+}
+
+auto operator-(double n, const Variable &num) -> Variable
+{
+    return internal::unary(OpCode::ConstantSubtract, num, n);
+}
+
+auto operator*(const Variable &left, const Variable &right) -> Variable
+{
+    if (!right.is_active()) {
+        return left * right.value();
+    }
+    if (!left.is_active()) {
+        return left.value() * right;
+    }
+    return same_tape(left, right)
+        ->record(OpCode::Multiply, left.index(), right.index());
+}
+
+auto operator*(const Variable &num, double scalar) -> Variable
+{
+    return internal::unary(OpCode::MultiplyConstant, num, scalar);
+}
+
+auto operator*(double scalar, const Variable &num) -> Variable
+{
+    return internal::unary(OpCode::MultiplyConstant, num, scalar);
+}
+
+auto operator/(const Variable &left, const Variable &right) -> Variable
+{
+    if (!right.is_active()) {
+        return left / right.value();
+    }
+    if (!left.is_active()) {
+        return left.value() / right;
+    }
+    return same_tape(left, right)
+        ->record(OpCode::Divide, left.index(), right.index());
+}
+
+auto operator/(const Variable &num, double scalar) -> Variable
+{
+    return internal::unary(OpCode::DivideConstant, num, scalar);
+}
+
+auto operator/(double scalar, const Variable &num) -> Variable
+{
+    return internal::unary(OpCode::ConstantDivide, num, scalar);
+}
+
+auto branch(const Variable &condition) -> bool
+{
+    if (!condition.is_active()) {
+        return condition.value() > 0.0;
+    }
+    return condition.tape()->guard(condition);
+}
+
+auto Tape::variable(double value) -> Variable
+{
+    const auto index{push(Node{OpCode::Input, 0, 0, 0.0}, value)};
+    m_inputs.push_back(index);
+    return Variable{this, index, value};
+}
+
+auto Tape::register_output(const Variable &output) -> void
+{
+    m_outputs.push_back(operand(output));
+}
+
+auto Tape::record(OpCode op, std::uint32_t lhs, std::uint32_t rhs,
+                  double constant) -> Variable
+{
+    const double value{internal::apply(
+        op, m_values[lhs], is_binary(op) ? m_values[rhs] : 0.0, constant)};
+    return Variable{this, push(Node{op, lhs, rhs, constant}, value), value};
+}
+
+auto Tape::call(std::shared_ptr<const ExternalFunction> function,
+                const std::vector<Variable> &inputs) -> std::vector<Variable>
+{
+    if (!function || !function->primal ||
+        (!function->jacobian && !function->vjp)) {
+        throw std::invalid_argument(
+            "An external function needs a primal and a jacobian or vjp");
+    }
+
+    ExternalCall call{std::move(function), {}, 0, 0, {}};
+    Eigen::VectorXd x(static_cast<Eigen::Index>(inputs.size()));
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        call.inputs.push_back(operand(inputs[i]));
+        x[static_cast<Eigen::Index>(i)] = inputs[i].value();
+    }
+
+    const auto id{static_cast<std::uint32_t>(m_calls.size())};
+    const Eigen::VectorXd y{evaluate(call, x)};
+    call.first_output = static_cast<std::uint32_t>(m_nodes.size());
+    call.output_count = static_cast<std::uint32_t>(y.size());
+
+    std::vector<Variable> outputs{};
+    outputs.reserve(static_cast<size_t>(y.size()));
+    for (std::uint32_t i = 0; i < call.output_count; ++i) {
+        const auto index{push(Node{OpCode::ExternalOutput, id, i, 0.0}, y[i])};
+        outputs.emplace_back(this, index, y[i]);
+    }
+    m_calls.push_back(std::move(call));
+    return outputs;
+}
+
+auto Tape::guard(const Variable &condition) -> bool
+{
+    const bool positive{condition.value() > 0.0};
+    if (condition.is_active()) {
+        m_guards.push_back(Guard{operand(condition), positive});
+    }
+    return positive;
+}
+
+auto Tape::replay(const Eigen::VectorXd &inputs) -> Eigen::VectorXd
+{
+    if (static_cast<size_t>(inputs.size()) != m_inputs.size()) {
+        throw std::invalid_argument("Expected one value per input");
+    }
+    Eigen::VectorXd result(static_cast<Eigen::Index>(m_outputs.size()));
+    replay(inputs.data(), result.data());
+    return result;
+}
+
+auto Tape::replay(const double *inputs, double *outputs) -> void
+{
+    for (size_t i = 0; i < m_inputs.size(); ++i) {
+        m_values[m_inputs[i]] = inputs[i];
+    }
+
+    for (size_t i = 0; i < m_nodes.size(); ++i) {
+        const auto &node{m_nodes[i]};
+        switch (node.op) {
+        case OpCode::Input:
+            break;
+        case OpCode::ExternalOutput:
+            if (node.rhs == 0) {
+                auto &call{m_calls[node.lhs]};
+                Eigen::VectorXd x(
+                    static_cast<Eigen::Index>(call.inputs.size()));
+                for (size_t k = 0; k < call.inputs.size(); ++k) {
+                    x[static_cast<Eigen::Index>(k)] = m_values[call.inputs[k]];
+                }
+                const Eigen::VectorXd y{evaluate(call, x)};
+                std::copy(y.data(), y.data() + y.size(),
+                          m_values.begin() + call.first_output);
+            }
+            break;
+        default:
+            m_values[i] = internal::apply(
+                node.op, m_values[node.lhs],
+                is_binary(node.op) ? m_values[node.rhs] : 0.0, node.constant);
+            break;
+        }
+    }
+
+    for (size_t i = 0; i < m_outputs.size(); ++i) {
+        outputs[i] = m_values[m_outputs[i]];
+    }
+}
+
+auto Tape::reverse(std::vector<double> &adjoints) const -> void
+{
+    if (adjoints.size() != m_nodes.size()) {
+        throw std::invalid_argument("Expected one adjoint per node");
+    }
+
+    for (size_t i = m_nodes.size(); i-- > 0;) {
+        const auto &node{m_nodes[i]};
+        if (node.op == OpCode::Input || node.op == OpCode::Constant) {
+            continue;
+        }
+        if (node.op == OpCode::ExternalOutput) {
+            // The first output is reached once every output adjoint is final
+            if (node.rhs == 0) {
+                reverse_call(m_calls[node.lhs], adjoints);
+            }
+            continue;
+        }
+
+        const double adjoint{adjoints[i]};
+        if (adjoint == 0.0) {
+            continue;
+        }
+        const auto partial{partials(static_cast<std::uint32_t>(i))};
+        adjoints[node.lhs] += adjoint * partial[0];
+        if (is_binary(node.op)) {
+            adjoints[node.rhs] += adjoint * partial[1];
+        }
+    }
+}
+
+auto Tape::vjp(const Eigen::VectorXd &weights) const -> Eigen::VectorXd
+{
+    if (static_cast<size_t>(weights.size()) != m_outputs.size()) {
+        throw std::invalid_argument("Expected one weight per output");
+    }
+
+    std::vector<double> adjoints(m_nodes.size(), 0.0);
+    for (size_t i = 0; i < m_outputs.size(); ++i) {
+        adjoints[m_outputs[i]] += weights[static_cast<Eigen::Index>(i)];
+    }
+    reverse(adjoints);
+
+    Eigen::VectorXd result(static_cast<Eigen::Index>(m_inputs.size()));
+    for (size_t i = 0; i < m_inputs.size(); ++i) {
+        result[static_cast<Eigen::Index>(i)] = adjoints[m_inputs[i]];
+    }
+    return result;
+}
+
+auto Tape::gradient(const Variable &output) const -> Eigen::VectorXd
+{
+    Eigen::VectorXd result{
+        Eigen::VectorXd::Zero(static_cast<Eigen::Index>(m_inputs.size()))};
+    if (!output.is_active()) {
+        return result;
+    }
+    if (output.tape() != this) {
+        throw std::invalid_argument("The output is recorded on another tape");
+    }
+
+    std::vector<double> adjoints(m_nodes.size(), 0.0);
+    adjoints[output.index()] = 1.0;
+    reverse(adjoints);
+    for (size_t i = 0; i < m_inputs.size(); ++i) {
+        result[static_cast<Eigen::Index>(i)] = adjoints[m_inputs[i]];
+    }
+    return result;
+}
+
+auto Tape::jacobian() const -> Eigen::MatrixXd
+{
+    Eigen::MatrixXd result(static_cast<Eigen::Index>(m_outputs.size()),
+                           static_cast<Eigen::Index>(m_inputs.size()));
+    std::vector<double> adjoints{};
+    jacobian(result.data(), adjoints);
+    return result;
+}
+
+auto Tape::jacobian(double *jacobian, std::vector<double> &adjoints) const
+    -> void
+{
+    const auto rows{m_outputs.size()};
+    adjoints.resize(m_nodes.size());
+    for (size_t row = 0; row < rows; ++row) {
+        std::fill(adjoints.begin(), adjoints.end(), 0.0);
+        adjoints[m_outputs[row]] = 1.0;
+        reverse(adjoints);
+        for (size_t col = 0; col < m_inputs.size(); ++col) {
+            jacobian[row + col * rows] = adjoints[m_inputs[col]];
+        }
+    }
+}
+
+auto Tape::partials(std::uint32_t index) const -> std::array<double, 2>
+{
+    const auto &node{m_nodes[index]};
+    return internal::partials(node.op, m_values[node.lhs],
+                              is_binary(node.op) ? m_values[node.rhs] : 0.0,
+                              node.constant, m_values[index]);
+}
+
+auto Tape::local_edges(std::uint32_t index) const
+    -> std::vector<std::pair<std::uint32_t, double>>
+{
+    const auto &node{m_nodes[index]};
+    switch (node.op) {
+    case OpCode::Input:
+    case OpCode::Constant:
+        return {};
+    case OpCode::ExternalOutput: {
+        const auto &call{m_calls[node.lhs]};
+        Eigen::VectorXd row{};
+        if (call.function->jacobian) {
+            row = call.jacobian.row(node.rhs).transpose();
+        } else {
+            Eigen::VectorXd x(static_cast<Eigen::Index>(call.inputs.size()));
+            for (size_t k = 0; k < call.inputs.size(); ++k) {
+                x[static_cast<Eigen::Index>(k)] = m_values[call.inputs[k]];
+            }
+            const Eigen::Map<const Eigen::VectorXd> y{
+                m_values.data() + call.first_output,
+                static_cast<Eigen::Index>(call.output_count)};
+            row = call.function->vjp(
+                x, y, Eigen::VectorXd::Unit(y.size(), node.rhs));
+        }
+
+        std::vector<std::pair<std::uint32_t, double>> edges{};
+        for (size_t k = 0; k < call.inputs.size(); ++k) {
+            const auto operand{call.inputs[k]};
+            const double partial{row[static_cast<Eigen::Index>(k)]};
+            const auto it{std::find_if(
+                edges.begin(), edges.end(),
+                [&](const auto &edge) { return edge.first == operand; })};
+            if (it != edges.end()) {
+                it->second += partial;
+            } else {
+                edges.emplace_back(operand, partial);
+            }
+        }
+        return edges;
+    }
+    default:
+        break;
+    }
+
+    const auto partial{partials(index)};
+    if (!is_binary(node.op)) {
+        return {{node.lhs, partial[0]}};
+    }
+    if (node.lhs == node.rhs) {
+        return {{node.lhs, partial[0] + partial[1]}};
+    }
+    return {{node.lhs, partial[0]}, {node.rhs, partial[1]}};
+}
+
+auto Tape::clear() -> void
+{
+    m_nodes.clear();
+    m_values.clear();
+    m_inputs.clear();
+    m_outputs.clear();
+    m_calls.clear();
+    m_guards.clear();
+}
+
+auto Tape::push(const Node &node, double value) -> std::uint32_t
+{
+    if (m_nodes.size() >= std::numeric_limits<std::uint32_t>::max()) {
+        throw std::length_error("The tape is full");
+    }
+    m_nodes.push_back(node);
+    m_values.push_back(value);
+    return static_cast<std::uint32_t>(m_nodes.size() - 1);
+}
+
+auto Tape::operand(const Variable &var) -> std::uint32_t
+{
+    if (!var.is_active()) {
+        return push(Node{OpCode::Constant, 0, 0, var.value()}, var.value());
+    }
+    if (var.tape() != this) {
+        throw std::invalid_argument("The variable is recorded on another tape");
+    }
+    return var.index();
+}
+
+auto Tape::evaluate(ExternalCall &call, const Eigen::VectorXd &x)
+    -> Eigen::VectorXd
+{
+    Eigen::VectorXd y{call.function->primal(x)};
+    if (call.output_count != 0 &&
+        static_cast<std::uint32_t>(y.size()) != call.output_count) {
+        throw std::runtime_error("The external function changed output size");
+    }
+    if (call.function->jacobian) {
+        call.jacobian = call.function->jacobian(x);
+        if (call.jacobian.rows() != y.size() ||
+            call.jacobian.cols() != x.size()) {
+            throw std::runtime_error(
+                "The external jacobian has the wrong size");
+        }
+    }
+    return y;
+}
+
+auto Tape::reverse_call(const ExternalCall &call,
+                        std::vector<double> &adjoints) const -> void
+{
+    const Eigen::Map<const Eigen::VectorXd> w{
+        adjoints.data() + call.first_output,
+        static_cast<Eigen::Index>(call.output_count)};
+    if (w.isZero(0.0)) {
+        return;
+    }
+
+    Eigen::VectorXd result{};
+    if (call.function->jacobian) {
+        result = call.jacobian.transpose() * w;
+    } else {
+        Eigen::VectorXd x(static_cast<Eigen::Index>(call.inputs.size()));
+        for (size_t k = 0; k < call.inputs.size(); ++k) {
+            x[static_cast<Eigen::Index>(k)] = m_values[call.inputs[k]];
+        }
+        const Eigen::Map<const Eigen::VectorXd> y{
+            m_values.data() + call.first_output,
+            static_cast<Eigen::Index>(call.output_count)};
+        result = call.function->vjp(x, y, w);
+    }
+    if (static_cast<size_t>(result.size()) != call.inputs.size()) {
+        throw std::runtime_error("The external vjp has the wrong size");
+    }
+    for (size_t k = 0; k < call.inputs.size(); ++k) {
+        adjoints[call.inputs[k]] += result[static_cast<Eigen::Index>(k)];
+    }
+}
+
+} // namespace algodiff::reverse
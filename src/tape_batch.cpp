@@ -0,0 +1,332 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+#include <algorithm>
+#include <stdexcept>
+
+#include "algodiff/tape_batch.hpp"
+
+namespace algodiff::reverse
+{
+auto TapeBatch::replay(const Eigen::MatrixXd &points) -> Eigen::MatrixXd
+{
+    if (points.rows() != input_count()) {
+        throw std::invalid_argument("Expected one row per input");
+    }
+
+    const auto &outputs{m_tape->outputs()};
+    Eigen::MatrixXd result(output_count(), points.cols());
+    m_fallbacks = 0;
+    for (Eigen::Index start = 0; start < points.cols(); start += m_lanes) {
+        const Eigen::Index width{std::min(m_lanes, points.cols() - start)};
+        forward(points, start, width);
+        for (Eigen::Index k = 0; k < output_count(); ++k) {
+            result.row(k).segment(start, width) =
+                m_values.row(outputs[static_cast<std::size_t>(k)]).matrix();
+        }
+
+        const auto failed{failures()};
+        for (Eigen::Index lane = 0; lane < width; ++lane) {
+            if (!failed[lane]) {
+                continue;
+            }
+            Tape tape{};
+            fallback(points.col(start + lane), tape);
+            for (Eigen::Index k = 0; k < output_count(); ++k) {
+                result(k, start + lane) =
+                    tape.values()[tape.outputs()[static_cast<std::size_t>(k)]];
+            }
+            ++m_fallbacks;
+        }
+    }
+    return result;
+}
+
+auto TapeBatch::vjp(const Eigen::MatrixXd &points,
+                    const Eigen::MatrixXd &weights) -> Eigen::MatrixXd
+{
+    if (points.rows() != input_count()) {
+        throw std::invalid_argument("Expected one row per input");
+    }
+    if (weights.rows() != output_count() || weights.cols() != points.cols()) {
+        throw std::invalid_argument(
+            "Expected one row per output and one column per point");
+    }
+
+    const auto &inputs{m_tape->inputs()};
+    const auto &outputs{m_tape->outputs()};
+    Eigen::MatrixXd result(input_count(), points.cols());
+    m_fallbacks = 0;
+    for (Eigen::Index start = 0; start < points.cols(); start += m_lanes) {
+        const Eigen::Index width{std::min(m_lanes, points.cols() - start)};
+        forward(points, start, width);
+        m_adjoints.setZero(m_values.rows(), width);
+        for (Eigen::Index k = 0; k < output_count(); ++k) {
+            m_adjoints.row(outputs[static_cast<std::size_t>(k)]) +=
+                weights.row(k).segment(start, width).array();
+        }
+        reverse();
+        for (Eigen::Index j = 0; j < input_count(); ++j) {
+            result.row(j).segment(start, width) =
+                m_adjoints.row(inputs[static_cast<std::size_t>(j)]).matrix();
+        }
+
+        const auto failed{failures()};
+        for (Eigen::Index lane = 0; lane < width; ++lane) {
+            if (!failed[lane]) {
+                continue;
+            }
+            Tape tape{};
+            fallback(points.col(start + lane), tape);
+            result.col(start + lane) = tape.vjp(weights.col(start + lane));
+            ++m_fallbacks;
+        }
+    }
+    return result;
+}
+
+auto TapeBatch::check() const -> void
+{
+    if (m_lanes <= 0) {
+        throw std::invalid_argument("Expected a positive number of lanes");
+    }
+    const auto &nodes{m_tape->nodes()};
+    if (std::any_of(nodes.begin(), nodes.end(), [](const Node &node) {
+            return node.op == OpCode::ExternalOutput;
+        })) {
+        throw std::invalid_argument(
+            "Batched replays do not support external functions");
+    }
+}
+
+auto TapeBatch::forward(const Eigen::MatrixXd &points, Eigen::Index start,
+                        Eigen::Index width) -> void
+{
+    const auto &nodes{m_tape->nodes()};
+    const auto &inputs{m_tape->inputs()};
+    m_values.resize(static_cast<Eigen::Index>(nodes.size()), width);
+    for (std::size_t j = 0; j < inputs.size(); ++j) {
+        m_values.row(inputs[j]) =
+            points.row(static_cast<Eigen::Index>(j)).segment(start, width);
+    }
+
+    for (std::size_t n = 0; n < nodes.size(); ++n) {
+        const auto &node{nodes[n]};
+        const auto i{static_cast<Eigen::Index>(n)};
+        const auto a{m_values.row(node.lhs)};
+        const auto b{m_values.row(node.rhs)};
+        const double c{node.constant};
+        auto value{m_values.row(i)};
+        switch (node.op) {
+        case OpCode::Input:
+        case OpCode::ExternalOutput:
+            break;
+        case OpCode::Constant:
+            value.setConstant(c);
+            break;
+        case OpCode::Add:
+            value = a + b;
+            break;
+        case OpCode::Subtract:
+            value = a - b;
+            break;
+        case OpCode::Multiply:
+            value = a * b;
+            break;
+        case OpCode::Divide:
+            value = a / b;
+            break;
+        case OpCode::Pow:
+            value = a.pow(b);
+            break;
+        case OpCode::AddConstant:
+            value = a + c;
+            break;
+        case OpCode::ConstantSubtract:
+            value = c - a;
+            break;
+        case OpCode::MultiplyConstant:
+            value = a * c;
+            break;
+        case OpCode::DivideConstant:
+            value = a / c;
+            break;
+        case OpCode::ConstantDivide:
+            value = c / a;
+            break;
+        case OpCode::PowConstant:
+            value = a.pow(c);
+            break;
+        case OpCode::Negate:
+            value = -a;
+            break;
+        case OpCode::Abs:
+            value = a.abs();
+            break;
+        case OpCode::Sqrt:
+            value = a.sqrt();
+            break;
+        case OpCode::Exp:
+            value = a.exp();
+            break;
+        case OpCode::Log:
+            value = a.log();
+            break;
+        case OpCode::Sin:
+            value = a.sin();
+            break;
+        case OpCode::Cos:
+            value = a.cos();
+            break;
+        case OpCode::Tan:
+            value = a.tan();
+            break;
+        case OpCode::Asin:
+            value = a.asin();
+            break;
+        case OpCode::Acos:
+            value = a.acos();
+            break;
+        case OpCode::Atan:
+            value = a.atan();
+            break;
+        case OpCode::Sinh:
+            value = a.sinh();
+            break;
+        case OpCode::Cosh:
+            value = a.cosh();
+            break;
+        case OpCode::Tanh:
+            value = a.tanh();
+            break;
+        }
+    }
+}
+
+auto TapeBatch::reverse() -> void
+{
+    const auto &nodes{m_tape->nodes()};
+    for (std::size_t n = nodes.size(); n-- > 0;) {
+        const auto &node{nodes[n]};
+        const auto i{static_cast<Eigen::Index>(n)};
+        if (node.op == OpCode::Input || node.op == OpCode::Constant ||
+            (m_adjoints.row(i) == 0.0).all()) {
+            continue;
+        }
+
+        const auto a{m_values.row(node.lhs)};
+        const auto b{m_values.row(node.rhs)};
+        const auto value{m_values.row(i)};
+        const double c{node.constant};
+        const auto w{m_adjoints.row(i)};
+        auto lhs{m_adjoints.row(node.lhs)};
+        auto rhs{m_adjoints.row(node.rhs)};
+        switch (node.op) {
+        case OpCode::Input:
+        case OpCode::Constant:
+        case OpCode::ExternalOutput:
+            break;
+        case OpCode::Add:
+            lhs += w;
+            rhs += w;
+            break;
+        case OpCode::Subtract:
+            lhs += w;
+            rhs -= w;
+            break;
+        case OpCode::Multiply:
+            lhs += w * b;
+            rhs += w * a;
+            break;
+        case OpCode::Divide:
+            lhs += w / b;
+            rhs -= w * value / b;
+            break;
+        case OpCode::Pow:
+            lhs += w * b * a.pow(b - 1.0);
+            rhs += w * value * a.log();
+            break;
+        case OpCode::AddConstant:
+            lhs += w;
+            break;
+        case OpCode::ConstantSubtract:
+        case OpCode::Negate:
+            lhs -= w;
+            break;
+        case OpCode::MultiplyConstant:
+            lhs += w * c;
+            break;
+        case OpCode::DivideConstant:
+            lhs += w / c;
+            break;
+        case OpCode::ConstantDivide:
+            lhs -= w * value / a;
+            break;
+        case OpCode::PowConstant:
+            lhs += w * c * a.pow(c - 1.0);
+            break;
+        case OpCode::Abs:
+            lhs += w * a / a.abs();
+            break;
+        case OpCode::Sqrt:
+            lhs += 0.5 * w / value; // NOLINT
+            break;
+        case OpCode::Exp:
+            lhs += w * value;
+            break;
+        case OpCode::Log:
+            lhs += w / a;
+            break;
+        case OpCode::Sin:
+            lhs += w * a.cos();
+            break;
+        case OpCode::Cos:
+            lhs -= w * a.sin();
+            break;
+        case OpCode::Tan:
+            lhs += w / a.cos().square();
+            break;
+        case OpCode::Asin:
+            lhs += w / (1.0 - a.square()).sqrt();
+            break;
+        case OpCode::Acos:
+            lhs -= w / (1.0 - a.square()).sqrt();
+            break;
+        case OpCode::Atan:
+            lhs += w / (1.0 + a.square());
+            break;
+        case OpCode::Sinh:
+            lhs += w * a.cosh();
+            break;
+        case OpCode::Cosh:
+            lhs += w * a.sinh();
+            break;
+        case OpCode::Tanh:
+            lhs += w * (1.0 - value.square());
+            break;
+        }
+    }
+}
+
+auto TapeBatch::failures() const -> Eigen::Array<bool, 1, Eigen::Dynamic>
+{
+    Eigen::Array<bool, 1, Eigen::Dynamic> failed{
+        Eigen::Array<bool, 1, Eigen::Dynamic>::Constant(m_values.cols(),
+                                                        false)};
+    for (const auto &guard : m_tape->guards()) {
+        failed = failed || ((m_values.row(guard.node) > 0.0) != guard.positive);
+    }
+    return failed;
+}
+
+auto TapeBatch::fallback(const Eigen::VectorXd &point, Tape &tape) const
+    -> void
+{
+    record(tape, m_function, point);
+    if (tape.outputs().size() != m_tape->outputs().size()) {
+        throw std::runtime_error("The function changed output size");
+    }
+}
+
+} // namespace algodiff::reverse
@@ -0,0 +1,396 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+
+#include "algodiff/tape_interpreter.hpp"
+
+// Labels as values are a GCC extension that Clang supports as well
+#if defined(__GNUC__) && !defined(ALGODIFF_NO_COMPUTED_GOTO)
+#define ALGODIFF_HAS_COMPUTED_GOTO 1
+#endif
+
+namespace algodiff::reverse
+{
+namespace
+{
+// Runs a program on the values of its nodes. Called with a null program, it
+// returns the address of the code of every operation instead, in the order of
+// ProgramOp, or null if the program is not threaded.
+// NOLINTNEXTLINE(readability-function-size)
+auto run(const Instruction *ip, double *v) -> const void *const *
+{
+#ifdef ALGODIFF_HAS_COMPUTED_GOTO
+    static const void *const handlers[] = {
+        &&add, &&subtract, &&multiply, &&divide, &&pow, &&square,
+        &&add_constant, &&constant_subtract, &&subtract_constant,
+        &&multiply_constant, &&divide_constant, &&constant_divide,
+        &&pow_constant, &&constant_pow, &&negate, &&abs, &&sqrt, &&exp, &&log,
+        &&sin, &&cos, &&tan, &&asin, &&acos, &&atan, &&sinh, &&cosh, &&tanh,
+        &&multiply_add, &&sin_cos, &&cos_sin, &&halt,
+    };
+    static_assert(sizeof(handlers) / sizeof(handlers[0]) ==
+                  static_cast<std::size_t>(ProgramOp::Halt) + 1);
+    if (ip == nullptr) {
+        return handlers;
+    }
+// Every instruction jumps straight to the next one
+#define ALGODIFF_OP(label, op) label:
+#define ALGODIFF_NEXT()                                                        \
+    ++ip;                                                                      \
+    goto *ip->handler
+    goto *ip->handler;
+#else
+    if (ip == nullptr) {
+        return nullptr;
+    }
+#define ALGODIFF_OP(label, op) case ProgramOp::op:
+#define ALGODIFF_NEXT()                                                        \
+    ++ip;                                                                      \
+    continue
+    for (;;) {
+        switch (ip->op) {
+#endif
+    ALGODIFF_OP(add, Add)
+    v[ip->result] = v[ip->a] + v[ip->b];
+    ALGODIFF_NEXT();
+    ALGODIFF_OP(subtract, Subtract)
+    v[ip->result] = v[ip->a] - v[ip->b];
+    ALGODIFF_NEXT();
+    ALGODIFF_OP(multiply, Multiply)
+    v[ip->result] = v[ip->a] * v[ip->b];
+    ALGODIFF_NEXT();
+    ALGODIFF_OP(divide, Divide)
+    v[ip->result] = v[ip->a] / v[ip->b];
+    ALGODIFF_NEXT();
+    ALGODIFF_OP(pow, Pow)
+    v[ip->result] = std::pow(v[ip->a], v[ip->b]);
+    ALGODIFF_NEXT();
+    ALGODIFF_OP(square, Square)
+    v[ip->result] = v[ip->a] * v[ip->a];
+    ALGODIFF_NEXT();
+    ALGODIFF_OP(add_constant, AddConstant)
+    v[ip->result] = v[ip->a] + ip->constant;
+    ALGODIFF_NEXT();
+    ALGODIFF_OP(constant_subtract, ConstantSubtract)
+    v[ip->result] = ip->constant - v[ip->a];
+    ALGODIFF_NEXT();
+    ALGODIFF_OP(subtract_constant, SubtractConstant)
+    v[ip->result] = v[ip->a] - ip->constant;
+    ALGODIFF_NEXT();
+    ALGODIFF_OP(multiply_constant, MultiplyConstant)
+    v[ip->result] = v[ip->a] * ip->constant;
+    ALGODIFF_NEXT();
+    ALGODIFF_OP(divide_constant, DivideConstant)
+    v[ip->result] = v[ip->a] / ip->constant;
+    ALGODIFF_NEXT();
+    ALGODIFF_OP(constant_divide, ConstantDivide)
+    v[ip->result] = ip->constant / v[ip->a];
+    ALGODIFF_NEXT();
+    ALGODIFF_OP(pow_constant, PowConstant)
+    v[ip->result] = std::pow(v[ip->a], ip->constant);
+    ALGODIFF_NEXT();
+    ALGODIFF_OP(constant_pow, ConstantPow)
+    v[ip->result] = std::pow(ip->constant, v[ip->a]);
+    ALGODIFF_NEXT();
+    ALGODIFF_OP(negate, Negate)
+    v[ip->result] = -v[ip->a];
+    ALGODIFF_NEXT();
+    ALGODIFF_OP(abs, Abs)
+    v[ip->result] = std::abs(v[ip->a]);
+    ALGODIFF_NEXT();
+    ALGODIFF_OP(sqrt, Sqrt)
+    v[ip->result] = std::sqrt(v[ip->a]);
+    ALGODIFF_NEXT();
+    ALGODIFF_OP(exp, Exp)
+    v[ip->result] = std::exp(v[ip->a]);
+    ALGODIFF_NEXT();
+    ALGODIFF_OP(log, Log)
+    v[ip->result] = std::log(v[ip->a]);
+    ALGODIFF_NEXT();
+    ALGODIFF_OP(sin, Sin)
+    v[ip->result] = std::sin(v[ip->a]);
+    ALGODIFF_NEXT();
+    ALGODIFF_OP(cos, Cos)
+    v[ip->result] = std::cos(v[ip->a]);
+    ALGODIFF_NEXT();
+    ALGODIFF_OP(tan, Tan)
+    v[ip->result] = std::tan(v[ip->a]);
+    ALGODIFF_NEXT();
+    ALGODIFF_OP(asin, Asin)
+    v[ip->result] = std::asin(v[ip->a]);
+    ALGODIFF_NEXT();
+    ALGODIFF_OP(acos, Acos)
+    v[ip->result] = std::acos(v[ip->a]);
+    ALGODIFF_NEXT();
+    ALGODIFF_OP(atan, Atan)
+    v[ip->result] = std::atan(v[ip->a]);
+    ALGODIFF_NEXT();
+    ALGODIFF_OP(sinh, Sinh)
+    v[ip->result] = std::sinh(v[ip->a]);
+    ALGODIFF_NEXT();
+    ALGODIFF_OP(cosh, Cosh)
+    v[ip->result] = std::cosh(v[ip->a]);
+    ALGODIFF_NEXT();
+    ALGODIFF_OP(tanh, Tanh)
+    v[ip->result] = std::tanh(v[ip->a]);
+    ALGODIFF_NEXT();
+    ALGODIFF_OP(multiply_add, MultiplyAdd)
+    v[ip->result] = v[ip->a] * v[ip->b];
+    v[ip->result + 1] = v[ip->result] + v[ip->c];
+    ALGODIFF_NEXT();
+    ALGODIFF_OP(sin_cos, SinCos)
+    v[ip->result] = std::sin(v[ip->a]);
+    v[ip->result + 1] = std::cos(v[ip->a]);
+    ALGODIFF_NEXT();
+    ALGODIFF_OP(cos_sin, CosSin)
+    v[ip->result] = std::cos(v[ip->a]);
+    v[ip->result + 1] = std::sin(v[ip->a]);
+    ALGODIFF_NEXT();
+    ALGODIFF_OP(halt, Halt)
+    return nullptr;
+#ifndef ALGODIFF_HAS_COMPUTED_GOTO
+        }
+    }
+#endif
+#undef ALGODIFF_OP
+#undef ALGODIFF_NEXT
+}
+
+// Translates an operation whose operands are both variables, specializing it
+// when one of them is a constant node
+auto binary(const std::vector<Node> &nodes, const std::vector<double> &values,
+            const Node &node) -> Instruction
+{
+    Instruction ins{};
+    ins.a = node.lhs;
+    ins.b = node.rhs;
+    const bool constant_lhs{nodes[node.lhs].op == OpCode::Constant};
+    const bool constant_rhs{nodes[node.rhs].op == OpCode::Constant};
+    if (!constant_lhs && !constant_rhs) {
+        switch (node.op) {
+        case OpCode::Add:
+            ins.op = ProgramOp::Add;
+            break;
+        case OpCode::Subtract:
+            ins.op = ProgramOp::Subtract;
+            break;
+        case OpCode::Multiply:
+            ins.op = node.lhs == node.rhs ? ProgramOp::Square
+                                          : ProgramOp::Multiply;
+            break;
+        case OpCode::Divide:
+            ins.op = ProgramOp::Divide;
+            break;
+        default:
+            ins.op = ProgramOp::Pow;
+            break;
+        }
+        return ins;
+    }
+
+    if (constant_rhs) {
+        ins.constant = values[node.rhs];
+        switch (node.op) {
+        case OpCode::Add:
+            ins.op = ProgramOp::AddConstant;
+            break;
+        case OpCode::Subtract:
+            ins.op = ProgramOp::SubtractConstant;
+            break;
+        case OpCode::Multiply:
+            ins.op = ProgramOp::MultiplyConstant;
+            break;
+        case OpCode::Divide:
+            ins.op = ProgramOp::DivideConstant;
+            break;
+        default:
+            ins.op = ProgramOp::PowConstant;
+            break;
+        }
+        return ins;
+    }
+
+    ins.a = node.rhs;
+    ins.constant = values[node.lhs];
+    switch (node.op) {
+    case OpCode::Add:
+        ins.op = ProgramOp::AddConstant;
+        break;
+    case OpCode::Subtract:
+        ins.op = ProgramOp::ConstantSubtract;
+        break;
+    case OpCode::Multiply:
+        ins.op = ProgramOp::MultiplyConstant;
+        break;
+    case OpCode::Divide:
+        ins.op = ProgramOp::ConstantDivide;
+        break;
+    default:
+        ins.op = ProgramOp::ConstantPow;
+        break;
+    }
+    return ins;
+}
+
+// Translates an operation on a variable and possibly a constant
+auto unary(const Node &node) -> Instruction
+{
+    Instruction ins{};
+    ins.a = node.lhs;
+    ins.constant = node.constant;
+    switch (node.op) {
+    case OpCode::AddConstant:
+        ins.op = ProgramOp::AddConstant;
+        break;
+    case OpCode::ConstantSubtract:
+        ins.op = ProgramOp::ConstantSubtract;
+        break;
+    case OpCode::MultiplyConstant:
+        ins.op = ProgramOp::MultiplyConstant;
+        break;
+    case OpCode::DivideConstant:
+        ins.op = ProgramOp::DivideConstant;
+        break;
+    case OpCode::ConstantDivide:
+        ins.op = ProgramOp::ConstantDivide;
+        break;
+    case OpCode::PowConstant:
+        ins.op = ProgramOp::PowConstant;
+        break;
+    case OpCode::Negate:
+        ins.op = ProgramOp::Negate;
+        break;
+    case OpCode::Abs:
+        ins.op = ProgramOp::Abs;
+        break;
+    case OpCode::Sqrt:
+        ins.op = ProgramOp::Sqrt;
+        break;
+    case OpCode::Exp:
+        ins.op = ProgramOp::Exp;
+        break;
+    case OpCode::Log:
+        ins.op = ProgramOp::Log;
+        break;
+    case OpCode::Sin:
+        ins.op = ProgramOp::Sin;
+        break;
+    case OpCode::Cos:
+        ins.op = ProgramOp::Cos;
+        break;
+    case OpCode::Tan:
+        ins.op = ProgramOp::Tan;
+        break;
+    case OpCode::Asin:
+        ins.op = ProgramOp::Asin;
+        break;
+    case OpCode::Acos:
+        ins.op = ProgramOp::Acos;
+        break;
+    case OpCode::Atan:
+        ins.op = ProgramOp::Atan;
+        break;
+    case OpCode::Sinh:
+        ins.op = ProgramOp::Sinh;
+        break;
+    case OpCode::Cosh:
+        ins.op = ProgramOp::Cosh;
+        break;
+    default:
+        ins.op = ProgramOp::Tanh;
+        break;
+    }
+    return ins;
+}
+
+// Fuses an instruction with the translation of the node after it, if they
+// form a superinstruction
+auto fuse(Instruction &ins, const Node &next) -> bool
+{
+    const auto result{ins.result};
+    if (ins.op == ProgramOp::Multiply && next.op == OpCode::Add &&
+        (next.lhs == result) != (next.rhs == result)) {
+        ins.op = ProgramOp::MultiplyAdd;
+        ins.c = next.lhs == result ? next.rhs : next.lhs;
+        return true;
+    }
+    if (ins.op == ProgramOp::Sin && next.op == OpCode::Cos &&
+        next.lhs == ins.a) {
+        ins.op = ProgramOp::SinCos;
+        return true;
+    }
+    if (ins.op == ProgramOp::Cos && next.op == OpCode::Sin &&
+        next.lhs == ins.a) {
+        ins.op = ProgramOp::CosSin;
+        return true;
+    }
+    return false;
+}
+
+} // namespace
+
+TapeProgram::TapeProgram(const Tape &tape)
+    : m_values{tape.values()}, m_inputs{tape.inputs()},
+      m_outputs{tape.outputs()}
+{
+    const auto &nodes{tape.nodes()};
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+        const auto &node{nodes[i]};
+        if (node.op == OpCode::Input || node.op == OpCode::Constant) {
+            continue;
+        }
+        if (node.op == OpCode::ExternalOutput) {
+            throw std::invalid_argument(
+                "Tapes with external calls cannot be translated");
+        }
+
+        Instruction ins{is_binary(node.op) ? binary(nodes, m_values, node)
+                                           : unary(node)};
+        ins.result = static_cast<std::uint32_t>(i);
+        if (i + 1 < nodes.size() && fuse(ins, nodes[i + 1])) {
+            ++i;
+        }
+        m_program.push_back(ins);
+    }
+    m_program.emplace_back();
+
+    const auto *const handlers{run(nullptr, nullptr)};
+    if (handlers != nullptr) {
+        for (auto &ins : m_program) {
+            ins.handler = handlers[static_cast<std::size_t>(ins.op)];
+        }
+    }
+}
+
+auto TapeProgram::replay(const Eigen::VectorXd &inputs) -> Eigen::VectorXd
+{
+    if (static_cast<std::size_t>(inputs.size()) != m_inputs.size()) {
+        throw std::invalid_argument("Expected one value per input");
+    }
+    for (std::size_t i = 0; i < m_inputs.size(); ++i) {
+        m_values[m_inputs[i]] = inputs[static_cast<Eigen::Index>(i)];
+    }
+
+    run(m_program.data(), m_values.data());
+
+    Eigen::VectorXd result(static_cast<Eigen::Index>(m_outputs.size()));
+    for (std::size_t i = 0; i < m_outputs.size(); ++i) {
+        result[static_cast<Eigen::Index>(i)] = m_values[m_outputs[i]];
+    }
+    return result;
+}
+
+auto TapeProgram::is_threaded() -> bool
+{
+#ifdef ALGODIFF_HAS_COMPUTED_GOTO
+    return true;
+#else
+    return false;
+#endif
+}
+
+} // namespace algodiff::reverse
@@ -0,0 +1,119 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+#include <cmath>
+#include <stdexcept>
+
+#include "algodiff/tape_ops.hpp"
+
+#include "algodiff/tape.hpp"
+
+namespace algodiff::reverse
+{
+auto abs2(const Variable &num) -> Variable
+{
+    return num * num;
+}
+
+auto pow(const Variable &num, double exponent) -> Variable
+{
+    return internal::unary(OpCode::PowConstant, num, exponent);
+}
+
+auto pow(const Variable &num, const Variable &exponent) -> Variable
+{
+    if (!exponent.is_active()) {
+        return pow(num, exponent.value());
+    }
+    if (!num.is_active()) {
+        return exp(std::log(num.value()) * exponent);
+    }
+    if (num.tape() != exponent.tape()) {
+        throw std::invalid_argument(
+            "Variables are recorded on different tapes");
+    }
+    return num.tape()->record(OpCode::Pow, num.index(), exponent.index());
+}
+
+auto exp2(const Variable &num) -> Variable
+{
+    return exp(std::log(2.0) * num); // NOLINT
+}
+
+auto log2(const Variable &num) -> Variable
+{
+    return log(num) / std::log(2.0); // NOLINT
+}
+
+auto log10(const Variable &num) -> Variable
+{
+    return log(num) / std::log(10.0); // NOLINT
+}
+
+auto abs(const Variable &num) -> Variable
+{
+    return internal::unary(OpCode::Abs, num);
+}
+
+auto sqrt(const Variable &num) -> Variable
+{
+    return internal::unary(OpCode::Sqrt, num);
+}
+
+auto exp(const Variable &num) -> Variable
+{
+    return internal::unary(OpCode::Exp, num);
+}
+
+auto log(const Variable &num) -> Variable
+{
+    return internal::unary(OpCode::Log, num);
+}
+
+auto sin(const Variable &num) -> Variable
+{
+    return internal::unary(OpCode::Sin, num);
+}
+
+auto cos(const Variable &num) -> Variable
+{
+    return internal::unary(OpCode::Cos, num);
+}
+
+auto tan(const Variable &num) -> Variable
+{
+    return internal::unary(OpCode::Tan, num);
+}
+
+auto asin(const Variable &num) -> Variable
+{
+    return internal::unary(OpCode::Asin, num);
+}
+
+auto acos(const Variable &num) -> Variable
+{
+    return internal::unary(OpCode::Acos, num);
+}
+
+auto atan(const Variable &num) -> Variable
+{
+    return internal::unary(OpCode::Atan, num);
+}
+
+auto sinh(const Variable &num) -> Variable
+{
+    return internal::unary(OpCode::Sinh, num);
+}
+
+auto cosh(const Variable &num) -> Variable
+{
+    return internal::unary(OpCode::Cosh, num);
+}
+
+auto tanh(const Variable &num) -> Variable
+{
+    return internal::unary(OpCode::Tanh, num);
+}
+
+} // namespace algodiff::reverse
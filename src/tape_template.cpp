@@ -0,0 +1,40 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+#include <stdexcept>
+
+#include "algodiff/tape_template.hpp"
+
+namespace algodiff::reverse
+{
+auto TapeTemplate::operator()(const Eigen::VectorX<Variable> &inputs) const
+    -> Eigen::VectorX<Variable>
+{
+    if (inputs.size() != input_count()) {
+        throw std::invalid_argument("Expected one value per template input");
+    }
+    return call(m_function, inputs);
+}
+
+auto TapeTemplate::make_function(const std::shared_ptr<State> &state)
+    -> std::shared_ptr<const ExternalFunction>
+{
+    // Replaying and sweeping the template reuse its values, so calls from
+    // several threads take turns
+    auto function{std::make_shared<ExternalFunction>()};
+    function->primal = [state](const Eigen::VectorXd &x) {
+        const std::lock_guard<std::mutex> lock{state->mutex};
+        return state->tape.replay(x);
+    };
+    function->vjp = [state](const Eigen::VectorXd &x,
+                            const Eigen::VectorXd & /*y*/,
+                            const Eigen::VectorXd &w) {
+        const std::lock_guard<std::mutex> lock{state->mutex};
+        state->tape.replay(x);
+        return state->tape.vjp(w);
+    };
+    return function;
+}
+
+} // namespace algodiff::reverse
@@ -0,0 +1,70 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+#include <stdexcept>
+#include <utility>
+
+#include "algodiff/thread_pool.hpp"
+
+#include "algodiff/parallel.hpp"
+
+namespace algodiff
+{
+ThreadPool::ThreadPool(unsigned threads)
+{
+    const auto count{internal::thread_count(threads)};
+    m_workers.reserve(count);
+    for (unsigned i = 0; i < count; ++i) {
+        m_workers.emplace_back([this] { run(); });
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        const std::lock_guard<std::mutex> lock{m_mutex};
+        m_stopping = true;
+    }
+    m_ready.notify_all();
+    for (auto &worker : m_workers) {
+        worker.join();
+    }
+}
+
+auto ThreadPool::submit(std::function<void()> task) -> void
+{
+    {
+        const std::lock_guard<std::mutex> lock{m_mutex};
+        if (m_stopping) {
+            throw std::runtime_error("The thread pool is shutting down");
+        }
+        m_tasks.push_back(std::move(task));
+    }
+    m_ready.notify_one();
+}
+
+auto ThreadPool::run() -> void
+{
+    for (;;) {
+        std::function<void()> task{};
+        {
+            std::unique_lock<std::mutex> lock{m_mutex};
+            m_ready.wait(lock, [&] { return m_stopping || !m_tasks.empty(); });
+            if (m_tasks.empty()) {
+                return;
+            }
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+        }
+        task();
+    }
+}
+
+auto default_executor() -> ThreadPool &
+{
+    static ThreadPool pool{};
+    return pool;
+}
+
+} // namespace algodiff
@@ -0,0 +1,162 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "algodiff/vertex_elimination.hpp"
+
+namespace algodiff::reverse
+{
+namespace
+{
+/// The linearized computational graph; the weights live on the predecessors
+struct Graph {
+    std::vector<std::unordered_map<std::uint32_t, double>> predecessors{};
+    std::vector<std::unordered_set<std::uint32_t>> successors{};
+
+    auto add_edge(std::uint32_t from, std::uint32_t to, double weight) -> void
+    {
+        predecessors[to][from] += weight;
+        successors[from].insert(to);
+    }
+
+    auto markowitz(std::uint32_t vertex) const -> std::size_t
+    {
+        return predecessors[vertex].size() * successors[vertex].size();
+    }
+
+    // Returns the number of multiplications performed
+    auto eliminate(std::uint32_t vertex) -> std::size_t
+    {
+        auto preds{std::move(predecessors[vertex])};
+        auto succs{std::move(successors[vertex])};
+        predecessors[vertex].clear();
+        successors[vertex].clear();
+
+        for (const auto succ : succs) {
+            auto &incoming{predecessors[succ]};
+            const double outgoing{incoming.at(vertex)};
+            incoming.erase(vertex);
+            for (const auto &[pred, weight] : preds) {
+                incoming[pred] += outgoing * weight;
+                successors[pred].insert(succ);
+            }
+        }
+        for (const auto &pred : preds) {
+            successors[pred.first].erase(vertex);
+        }
+        return preds.size() * succs.size();
+    }
+};
+
+} // namespace
+
+auto accumulate_jacobian(const Tape &tape, EliminationOrder order)
+    -> JacobianAccumulation
+{
+    const auto &nodes{tape.nodes()};
+    const auto &inputs{tape.inputs()};
+    const auto &outputs{tape.outputs()};
+    const auto node_count{static_cast<std::uint32_t>(nodes.size())};
+
+    // Every output gets its own sink vertex, so outputs that feed other nodes
+    // (or that are registered twice) can be eliminated like the rest
+    Graph graph{};
+    const auto vertex_count{node_count + outputs.size()};
+    graph.predecessors.resize(vertex_count);
+    graph.successors.resize(vertex_count);
+    for (std::uint32_t i = 0; i < node_count; ++i) {
+        for (const auto &[operand, partial] : tape.local_edges(i)) {
+            if (nodes[operand].op != OpCode::Constant) {
+                graph.add_edge(operand, i, partial);
+            }
+        }
+    }
+    for (size_t k = 0; k < outputs.size(); ++k) {
+        graph.add_edge(outputs[k], static_cast<std::uint32_t>(node_count + k),
+                       1.0);
+    }
+
+    std::vector<std::uint32_t> intermediates{};
+    for (std::uint32_t i = 0; i < node_count; ++i) {
+        if (nodes[i].op != OpCode::Input && nodes[i].op != OpCode::Constant) {
+            intermediates.push_back(i);
+        }
+    }
+
+    JacobianAccumulation result{};
+    switch (order) {
+    case EliminationOrder::Forward:
+        for (const auto vertex : intermediates) {
+            result.multiplications += graph.eliminate(vertex);
+        }
+        break;
+    case EliminationOrder::Reverse:
+        for (auto it = intermediates.rbegin(); it != intermediates.rend();
+             ++it) {
+            result.multiplications += graph.eliminate(*it);
+        }
+        break;
+    case EliminationOrder::Markowitz: {
+        std::vector<std::size_t> degree(vertex_count, 0);
+        std::vector<bool> pending(vertex_count, false);
+        std::set<std::pair<std::size_t, std::uint32_t>> queue{};
+        for (const auto vertex : intermediates) {
+            degree[vertex] = graph.markowitz(vertex);
+            pending[vertex] = true;
+            queue.emplace(degree[vertex], vertex);
+        }
+
+        auto update = [&](std::uint32_t vertex) {
+            if (!pending[vertex]) {
+                return;
+            }
+            queue.erase({degree[vertex], vertex});
+            degree[vertex] = graph.markowitz(vertex);
+            queue.emplace(degree[vertex], vertex);
+        };
+
+        while (!queue.empty()) {
+            const auto vertex{queue.begin()->second};
+            queue.erase(queue.begin());
+            pending[vertex] = false;
+
+            std::vector<std::uint32_t> neighbors{};
+            for (const auto &pred : graph.predecessors[vertex]) {
+                neighbors.push_back(pred.first);
+            }
+            neighbors.insert(neighbors.end(),
+                             graph.successors[vertex].begin(),
+                             graph.successors[vertex].end());
+
+            result.multiplications += graph.eliminate(vertex);
+            for (const auto neighbor : neighbors) {
+                update(neighbor);
+            }
+        }
+        break;
+    }
+    }
+
+    result.jacobian = Eigen::MatrixXd::Zero(
+        static_cast<Eigen::Index>(outputs.size()),
+        static_cast<Eigen::Index>(inputs.size()));
+    for (size_t col = 0; col < inputs.size(); ++col) {
+        for (size_t row = 0; row < outputs.size(); ++row) {
+            const auto &incoming{graph.predecessors[node_count + row]};
+            const auto it{incoming.find(inputs[col])};
+            if (it != incoming.end()) {
+                result.jacobian(static_cast<Eigen::Index>(row),
+                                static_cast<Eigen::Index>(col)) = it->second;
+            }
+        }
+    }
+    return result;
+}
+
+} // namespace algodiff::reverse
@@ -0,0 +1,162 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "algodiff/algodiff_c.h"
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+using Catch::Approx;
+
+namespace
+{
+// Records y0 = x0 * sin(x1) + 2, y1 = exp(x0 / x1)
+auto record() -> algodiff_model *
+{
+    algodiff_tape *tape{nullptr};
+    REQUIRE(algodiff_tape_create(&tape) == ALGODIFF_OK);
+    algodiff_var x0{};
+    algodiff_var x1{};
+    algodiff_var two{};
+    algodiff_var s{};
+    algodiff_var p{};
+    algodiff_var y0{};
+    algodiff_var q{};
+    algodiff_var y1{};
+    REQUIRE(algodiff_tape_input(tape, 1.0, &x0) == ALGODIFF_OK);
+    REQUIRE(algodiff_tape_input(tape, 2.0, &x1) == ALGODIFF_OK);
+    REQUIRE(algodiff_tape_constant(tape, 2.0, &two) == ALGODIFF_OK);
+    REQUIRE(algodiff_tape_unary(tape, ALGODIFF_SIN, x1, &s) == ALGODIFF_OK);
+    REQUIRE(algodiff_tape_binary(tape, ALGODIFF_MULTIPLY, x0, s, &p) ==
+            ALGODIFF_OK);
+    REQUIRE(algodiff_tape_binary(tape, ALGODIFF_ADD, p, two, &y0) ==
+            ALGODIFF_OK);
+    REQUIRE(algodiff_tape_binary(tape, ALGODIFF_DIVIDE, x0, x1, &q) ==
+            ALGODIFF_OK);
+    REQUIRE(algodiff_tape_unary(tape, ALGODIFF_EXP, q, &y1) == ALGODIFF_OK);
+    REQUIRE(algodiff_tape_output(tape, y0) == ALGODIFF_OK);
+    REQUIRE(algodiff_tape_output(tape, y1) == ALGODIFF_OK);
+
+    algodiff_model *model{nullptr};
+    REQUIRE(algodiff_model_from_tape(tape, &model) == ALGODIFF_OK);
+    // The recording moved into the model
+    REQUIRE(algodiff_tape_input(tape, 0.0, &x0) ==
+            ALGODIFF_ERROR_INVALID_ARGUMENT);
+    algodiff_tape_destroy(tape);
+    return model;
+}
+
+} // namespace
+
+TEST_CASE("Test C jacobian with strided buffers")
+{
+    auto *model{record()};
+    size_t n{};
+    size_t m{};
+    REQUIRE(algodiff_model_size(model, &n, &m) == ALGODIFF_OK);
+    REQUIRE(n == 2);
+    REQUIRE(m == 2);
+
+    algodiff_workspace *workspace{nullptr};
+    REQUIRE(algodiff_workspace_create(model, &workspace) == ALGODIFF_OK);
+
+    // x is every other element of a buffer, the jacobian is row-major with a
+    // padded leading dimension
+    const double x0{0.5};
+    const double x1{1.5};
+    const std::vector<double> x{x0, -1.0, x1, -1.0};
+    std::vector<double> y(4, 0.0);
+    std::vector<double> jac(2 * 3, 0.0);
+    REQUIRE(algodiff_jacobian(model, workspace, x.data(), 2, y.data(), 2,
+                              jac.data(), 3, 1) == ALGODIFF_OK);
+
+    const double e{std::exp(x0 / x1)};
+    REQUIRE(y[0] == Approx(x0 * std::sin(x1) + 2.0));
+    REQUIRE(y[2] == Approx(e));
+    REQUIRE(jac[0] == Approx(std::sin(x1)));
+    REQUIRE(jac[1] == Approx(x0 * std::cos(x1)));
+    REQUIRE(jac[2] == 0.0);
+    REQUIRE(jac[3] == Approx(e / x1));
+    REQUIRE(jac[4] == Approx(-e * x0 / (x1 * x1)));
+
+    // Contiguous column-major buffers are written by the model directly
+    const std::vector<double> packed{x0, x1};
+    std::vector<double> packed_y(2, 0.0);
+    std::vector<double> packed_jac(2 * 2, 0.0);
+    REQUIRE(algodiff_jacobian(model, workspace, packed.data(), 1,
+                              packed_y.data(), 1, packed_jac.data(), 1,
+                              2) == ALGODIFF_OK);
+    REQUIRE(packed_y[0] == Approx(y[0]));
+    REQUIRE(packed_y[1] == Approx(y[2]));
+    REQUIRE(packed_jac ==
+            std::vector<double>{jac[0], jac[3], jac[1], jac[4]});
+
+    // A jacobian-vector product along (1, 1)
+    const std::vector<double> v{1.0, 1.0};
+    std::vector<double> jv(2, 0.0);
+    REQUIRE(algodiff_jvp(model, workspace, x.data(), 2, v.data(), 1, nullptr,
+                         1, jv.data(), 1) == ALGODIFF_OK);
+    REQUIRE(jv[0] == Approx(jac[0] + jac[1]));
+    REQUIRE(jv[1] == Approx(jac[3] + jac[4]));
+
+    // Gradients need a single output
+    std::vector<double> gradient(2, 0.0);
+    REQUIRE(algodiff_gradient(model, workspace, x.data(), 2, nullptr,
+                              gradient.data(),
+                              1) == ALGODIFF_ERROR_DIMENSION_MISMATCH);
+    REQUIRE(std::string{algodiff_last_error()}.size() > 0);
+
+    algodiff_workspace_destroy(workspace);
+    algodiff_model_destroy(model);
+}
+
+TEST_CASE("Test C gradient and errors")
+{
+    algodiff_tape *tape{nullptr};
+    REQUIRE(algodiff_tape_create(&tape) == ALGODIFF_OK);
+    algodiff_var x0{};
+    algodiff_var x1{};
+    algodiff_var y{};
+    REQUIRE(algodiff_tape_input(tape, 3.0, &x0) == ALGODIFF_OK);
+    REQUIRE(algodiff_tape_input(tape, 2.0, &x1) == ALGODIFF_OK);
+    REQUIRE(algodiff_tape_binary(tape, ALGODIFF_POW, x0, x1, &y) ==
+            ALGODIFF_OK);
+    REQUIRE(algodiff_tape_unary(tape, ALGODIFF_SQRT, 42, &y) ==
+            ALGODIFF_ERROR_INVALID_ARGUMENT);
+    REQUIRE(algodiff_tape_output(tape, y) == ALGODIFF_OK);
+
+    algodiff_model *model{nullptr};
+    REQUIRE(algodiff_model_from_tape(tape, &model) == ALGODIFF_OK);
+    algodiff_tape_destroy(tape);
+
+    algodiff_workspace *workspace{nullptr};
+    REQUIRE(algodiff_workspace_create(model, &workspace) == ALGODIFF_OK);
+
+    // A Fortran-style column of a 3 x 2 array: stride 3
+    const std::vector<double> x{2.0, 0.0, 0.0, 3.0, 0.0, 0.0};
+    double value{};
+    std::vector<double> gradient(2, 0.0);
+    REQUIRE(algodiff_gradient(model, workspace, x.data(), 3, &value,
+                              gradient.data(), 1) == ALGODIFF_OK);
+    REQUIRE(value == Approx(8.0));
+    REQUIRE(gradient[0] == Approx(12.0));
+    REQUIRE(gradient[1] == Approx(8.0 * std::log(2.0)));
+
+    // Workspaces belong to one model
+    auto *other{record()};
+    REQUIRE(algodiff_gradient(other, workspace, x.data(), 3, &value,
+                              gradient.data(),
+                              1) == ALGODIFF_ERROR_INVALID_ARGUMENT);
+    REQUIRE(algodiff_model_load_plugin("/nonexistent/plugin.so", "model",
+                                       &other) == ALGODIFF_ERROR_NOT_FOUND);
+    REQUIRE(std::string{algodiff_status_string(ALGODIFF_OK)} == "Success");
+
+    algodiff_model_destroy(other);
+    algodiff_workspace_destroy(workspace);
+    algodiff_model_destroy(model);
+}
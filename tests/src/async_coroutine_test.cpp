@@ -0,0 +1,136 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+#include <exception>
+#include <functional>
+#include <future>
+#include <stdexcept>
+#include <utility>
+
+#include "algodiff/async.hpp"
+
+#ifndef ALGODIFF_HAS_COROUTINES
+#error "The coroutine tests must be built as C++20 with coroutine support"
+#endif
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "algodiff/dual_number.hpp"
+#include "algodiff/dual_number_ops.hpp"
+#include "algodiff/forward_mode.hpp"
+#include "algodiff/thread_pool.hpp"
+
+using algodiff::forward::DualNumber;
+
+namespace
+{
+auto residual(const Eigen::VectorX<DualNumber> &x) -> Eigen::VectorX<DualNumber>
+{
+    Eigen::VectorX<DualNumber> y(2);
+    y[0] = algodiff::forward::sin(x[0]) * x[1];
+    y[1] = algodiff::forward::exp(x[1]) + x[2] * x[0];
+    return y;
+}
+
+auto energy(const Eigen::Vector3<DualNumber> &x) -> DualNumber
+{
+    return x[0] * x[1] * x[2] + algodiff::forward::cos(x[2]);
+}
+
+// Runs every task immediately on the submitting thread
+struct InlineExecutor {
+    auto submit(const std::function<void()> &task) -> void
+    {
+        task();
+    }
+};
+
+// A coroutine that starts immediately and frees itself when it finishes
+struct Detached {
+    struct promise_type {
+        auto get_return_object() -> Detached
+        {
+            return {};
+        }
+
+        auto initial_suspend() noexcept -> std::suspend_never
+        {
+            return {};
+        }
+
+        auto final_suspend() noexcept -> std::suspend_never
+        {
+            return {};
+        }
+
+        auto return_void() -> void
+        {
+        }
+
+        auto unhandled_exception() -> void
+        {
+            std::terminate();
+        }
+    };
+};
+
+template <class Executor>
+auto differentiate(Executor &executor, Eigen::VectorXd u,
+                   std::promise<std::pair<Eigen::Vector3d, Eigen::MatrixXd>>
+                       *result) -> Detached
+{
+    const Eigen::Vector3d grad{co_await algodiff::forward::await_gradient(
+        executor, energy, Eigen::Vector3d{u})};
+    const Eigen::MatrixXd jac{
+        co_await algodiff::forward::await_jacobian<2>(executor, residual, u)};
+    result->set_value({grad, jac});
+}
+
+auto fail(algodiff::ThreadPool &pool, std::promise<bool> *rethrown)
+    -> Detached
+{
+    auto throwing = [](const Eigen::VectorX<DualNumber> &)
+        -> Eigen::VectorX<DualNumber> {
+        throw std::domain_error("outside the model's range");
+    };
+    try {
+        co_await algodiff::forward::await_jacobian<2>(
+            pool, throwing, Eigen::VectorXd::Zero(3));
+        rethrown->set_value(false);
+    } catch (const std::domain_error &) {
+        rethrown->set_value(true);
+    }
+}
+
+} // namespace
+
+TEST_CASE("Awaited results match the blocking calls", "[Async]")
+{
+    const Eigen::VectorXd u{Eigen::Vector3d{0.3, -0.2, 1.4}};
+    const Eigen::Vector3d expected_grad{
+        algodiff::forward::gradient(energy, Eigen::Vector3d{u})};
+    const Eigen::MatrixXd expected_jac{
+        algodiff::forward::jacobian<2>(residual, u)};
+
+    algodiff::ThreadPool pool{2};
+    std::promise<std::pair<Eigen::Vector3d, Eigen::MatrixXd>> pooled{};
+    differentiate(pool, u, &pooled);
+    const auto results{pooled.get_future().get()};
+    REQUIRE(results.first.isApprox(expected_grad));
+    REQUIRE(results.second.isApprox(expected_jac));
+
+    // Resuming inside submit must not touch the finished awaitable
+    InlineExecutor executor{};
+    std::promise<std::pair<Eigen::Vector3d, Eigen::MatrixXd>> inlined{};
+    differentiate(executor, u, &inlined);
+    REQUIRE(inlined.get_future().get().second.isApprox(expected_jac));
+}
+
+TEST_CASE("Awaiting rethrows the exception of the work", "[Async]")
+{
+    algodiff::ThreadPool pool{1};
+    std::promise<bool> rethrown{};
+    fail(pool, &rethrown);
+    REQUIRE(rethrown.get_future().get());
+}
@@ -0,0 +1,144 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+#include <functional>
+#include <future>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+#include "algodiff/async.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "algodiff/dual_number.hpp"
+#include "algodiff/dual_number_ops.hpp"
+#include "algodiff/forward_mode.hpp"
+#include "algodiff/thread_pool.hpp"
+
+using algodiff::forward::DualNumber;
+
+namespace
+{
+auto residual(const Eigen::VectorX<DualNumber> &x) -> Eigen::VectorX<DualNumber>
+{
+    Eigen::VectorX<DualNumber> y(2);
+    y[0] = algodiff::forward::sin(x[0]) * x[1];
+    y[1] = algodiff::forward::exp(x[1]) + x[2] * x[0];
+    return y;
+}
+
+auto energy(const Eigen::Vector3<DualNumber> &x) -> DualNumber
+{
+    return x[0] * x[1] * x[2] + algodiff::forward::cos(x[2]);
+}
+
+// Runs every task immediately on the submitting thread
+struct InlineExecutor {
+    int submitted{0};
+
+    auto submit(const std::function<void()> &task) -> void
+    {
+        ++submitted;
+        task();
+    }
+};
+
+} // namespace
+
+TEST_CASE("Futures hold the same results as the blocking calls", "[Async]")
+{
+    algodiff::ThreadPool pool{2};
+    REQUIRE(pool.size() == 2);
+
+    const Eigen::VectorXd u{Eigen::Vector3d{0.3, -0.2, 1.4}};
+    std::vector<std::future<Eigen::MatrixXd>> jacobians{};
+    for (int i = 0; i < 8; ++i) {
+        jacobians.push_back(algodiff::forward::async_jacobian<2>(
+            pool, residual, Eigen::VectorXd{u * i}));
+    }
+    auto grad{algodiff::forward::async_gradient(pool, energy,
+                                                Eigen::Vector3d{u})};
+
+    for (int i = 0; i < 8; ++i) {
+        const Eigen::MatrixXd expected{
+            algodiff::forward::jacobian<2>(residual, Eigen::VectorXd{u * i})};
+        REQUIRE(jacobians[static_cast<size_t>(i)].get().isApprox(expected));
+    }
+    REQUIRE(grad.get().isApprox(
+        algodiff::forward::gradient(energy, Eigen::Vector3d{u})));
+}
+
+TEST_CASE("The default executor and custom executors can be used", "[Async]")
+{
+    const Eigen::VectorXd u{Eigen::Vector3d{0.1, 0.2, 0.3}};
+    const Eigen::MatrixXd expected{algodiff::forward::jacobian<2>(residual, u)};
+    REQUIRE(algodiff::forward::async_jacobian<2>(residual, u)
+                .get()
+                .isApprox(expected));
+
+    InlineExecutor executor{};
+    Eigen::MatrixXd result{};
+    bool failed{true};
+    algodiff::forward::async_jacobian<2>(
+        executor, residual, u,
+        [&](std::exception_ptr error, std::optional<Eigen::MatrixXd> jac) {
+            failed = static_cast<bool>(error) || !jac;
+            result = std::move(*jac);
+        });
+    REQUIRE(executor.submitted == 1);
+    REQUIRE_FALSE(failed);
+    REQUIRE(result.isApprox(expected));
+}
+
+TEST_CASE("Exceptions reach the future or the callback", "[Async]")
+{
+    auto throwing = [](const Eigen::VectorX<DualNumber> &)
+        -> Eigen::VectorX<DualNumber> {
+        throw std::domain_error("outside the model's range");
+    };
+    const Eigen::VectorXd u{Eigen::VectorXd::Zero(3)};
+
+    algodiff::ThreadPool pool{1};
+    auto future{algodiff::forward::async_jacobian<2>(pool, throwing, u)};
+    REQUIRE_THROWS_AS(future.get(), std::domain_error);
+
+    std::promise<bool> called{};
+    algodiff::forward::async_jacobian<2>(
+        pool, throwing, u,
+        [&](std::exception_ptr error,
+            const std::optional<Eigen::MatrixXd> &jac) {
+            called.set_value(static_cast<bool>(error) && !jac);
+        });
+    REQUIRE(called.get_future().get());
+
+    // A fixed-size result is absent rather than left uninitialized
+    auto throwing_energy = [](const Eigen::Vector3<DualNumber> &)
+        -> DualNumber { throw std::domain_error("outside the model's range"); };
+    std::promise<bool> absent{};
+    algodiff::forward::async_gradient(
+        pool, throwing_energy, Eigen::Vector3d{u},
+        [&](std::exception_ptr error,
+            const std::optional<Eigen::Vector3d> &grad) {
+            absent.set_value(static_cast<bool>(error) && !grad);
+        });
+    REQUIRE(absent.get_future().get());
+}
+
+TEST_CASE("Exceptions thrown by callbacks do not stop the executor",
+          "[Async]")
+{
+    algodiff::ThreadPool pool{1};
+    const Eigen::VectorXd u{Eigen::Vector3d{0.1, 0.2, 0.3}};
+    algodiff::forward::async_jacobian<2>(
+        pool, residual, u,
+        [](std::exception_ptr, const std::optional<Eigen::MatrixXd> &) {
+            throw std::runtime_error("callback failure");
+        });
+
+    // The only worker survives to run the next task
+    REQUIRE(algodiff::forward::async_jacobian<2>(pool, residual, u)
+                .get()
+                .isApprox(algodiff::forward::jacobian<2>(residual, u)));
+}
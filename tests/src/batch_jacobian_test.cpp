@@ -0,0 +1,171 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "algodiff/batch_jacobian.hpp"
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "algodiff/dual_number.hpp"
+#include "algodiff/dual_number_ops.hpp"
+#include "algodiff/mapped_file.hpp"
+
+namespace
+{
+constexpr int input_size{3};
+constexpr int function_size{2};
+constexpr std::int64_t point_count{50};
+
+auto f(const Eigen::Vector<algodiff::forward::DualNumber, input_size> &x)
+{
+    Eigen::Vector<algodiff::forward::DualNumber, function_size> out{};
+    out[0] = x[0] * x[1] + algodiff::forward::sin(x[2]);
+    out[1] = algodiff::forward::exp(x[0]) - 3.0 * x[2];
+    return out;
+}
+
+auto point(std::int64_t p) -> Eigen::Vector<double, input_size>
+{
+    const auto t{static_cast<double>(p)};
+    return {0.01 * t, 1.0 - 0.02 * t, 0.5 + 0.03 * t};
+}
+
+auto write_points(const std::string &path) -> void
+{
+    std::ofstream out{path, std::ios::binary};
+    for (std::int64_t p = 0; p < point_count; ++p) {
+        const auto u{point(p)};
+        out.write(reinterpret_cast<const char *>(u.data()), // NOLINT
+                  sizeof(double) * input_size);
+    }
+}
+
+auto check_output(const std::string &path) -> void
+{
+    const algodiff::MappedFile output{path,
+                                      algodiff::MappedFile::Mode::ReadOnly};
+    REQUIRE(output.size() ==
+            point_count * function_size * input_size * sizeof(double));
+    const auto *data{reinterpret_cast<const double *>( // NOLINT
+        output.data())};
+    for (std::int64_t p = 0; p < point_count; ++p) {
+        const auto expected{algodiff::forward::jacobian<function_size>(
+            f, point(p))};
+        const Eigen::Map<const Eigen::Matrix<double, function_size, input_size>>
+            actual{data + p * function_size * input_size};
+        REQUIRE(actual.isApprox(expected));
+    }
+}
+
+} // namespace
+
+TEST_CASE("Batch jacobian over mapped files", "[Batch Jacobian]")
+{
+    const std::string input_path{"batch_jacobian_test.in"};
+    const std::string output_path{"batch_jacobian_test.out"};
+    const std::string checkpoint_path{"batch_jacobian_test.ckpt"};
+    write_points(input_path);
+    std::remove(output_path.c_str());
+    std::remove(checkpoint_path.c_str());
+
+    SECTION("all points are computed in parallel chunks")
+    {
+        algodiff::forward::BatchJacobianOptions options{};
+        options.chunk_size = 7;
+        options.threads = 3;
+        const auto result{
+            algodiff::forward::batch_jacobian<function_size, input_size>(
+                f, input_path, output_path, options)};
+
+        REQUIRE(result.points == point_count);
+        REQUIRE(result.chunks_computed == 8);
+        REQUIRE(result.chunks_skipped == 0);
+        check_output(output_path);
+    }
+
+    SECTION("every pass receives a fixed-size point")
+    {
+        // No conversion to a fixed-size vector may hide a dynamic argument
+        auto fixed = [](const auto &x) {
+            static_assert(
+                std::is_same_v<
+                    std::decay_t<decltype(x)>,
+                    Eigen::Vector<algodiff::forward::DualNumber, input_size>>,
+                "batch_jacobian must pass fixed-size points");
+            return f(x);
+        };
+        algodiff::forward::batch_jacobian<function_size, input_size>(
+            fixed, input_path, output_path);
+        check_output(output_path);
+    }
+
+    SECTION("an interrupted run resumes from its checkpoint")
+    {
+        algodiff::forward::BatchJacobianOptions options{};
+        options.chunk_size = 10;
+        options.threads = 1;
+        options.checkpoint_path = checkpoint_path;
+
+        auto failing =
+            [](const Eigen::Vector<algodiff::forward::DualNumber, input_size>
+                   &x) {
+                // Point 30 is the first point of chunk 3
+                if (x[0].primal() > 0.295 && x[0].primal() < 0.305) {
+                    throw std::runtime_error("interrupted");
+                }
+                return f(x);
+            };
+        REQUIRE_THROWS_AS(
+            (algodiff::forward::batch_jacobian<function_size, input_size>(
+                failing, input_path, output_path, options)),
+            std::runtime_error);
+
+        std::atomic<int> evaluations{0};
+        auto counting =
+            [&](const Eigen::Vector<algodiff::forward::DualNumber, input_size>
+                    &x) {
+                ++evaluations;
+                return f(x);
+            };
+        const auto result{
+            algodiff::forward::batch_jacobian<function_size, input_size>(
+                counting, input_path, output_path, options)};
+
+        REQUIRE(result.chunks_skipped == 3);
+        REQUIRE(result.chunks_computed == 2);
+        // One forward pass per input dimension for each of the 20 points
+        REQUIRE(evaluations == 20 * input_size);
+        check_output(output_path);
+
+        const auto rerun{
+            algodiff::forward::batch_jacobian<function_size, input_size>(
+                counting, input_path, output_path, options)};
+        REQUIRE(rerun.chunks_computed == 0);
+        REQUIRE(rerun.chunks_skipped == 5);
+    }
+
+    SECTION("malformed input is rejected")
+    {
+        {
+            std::ofstream out{input_path, std::ios::binary | std::ios::app};
+            out.put('x');
+        }
+        REQUIRE_THROWS_AS(
+            (algodiff::forward::batch_jacobian<function_size, input_size>(
+                f, input_path, output_path)),
+            std::invalid_argument);
+    }
+
+    std::remove(input_path.c_str());
+    std::remove(output_path.c_str());
+    std::remove(checkpoint_path.c_str());
+}
@@ -0,0 +1,99 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+#include <stdexcept>
+#include <type_traits>
+
+#include "algodiff/cached_jacobian.hpp"
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "algodiff/dual_number_ops.hpp"
+#include "algodiff/forward_mode.hpp"
+#include "algodiff/linearity_tracer.hpp"
+
+using algodiff::forward::JacobianEntry;
+using Catch::Approx;
+
+namespace
+{
+// y0 = 2 x0 - x2 + 1, y1 = x1 * sin(x2), y2 = 3 x0 + x3 / 4
+// Only the columns of x1 and x2 contain varying entries
+struct Model {
+    int *calls;
+
+    template <class Vector> auto operator()(const Vector &x) const
+    {
+        using T = typename std::decay_t<Vector>::Scalar;
+        ++*calls;
+        Eigen::VectorX<T> y(3);
+        y[0] = 2.0 * x[0] - x[2] + 1.0;
+        y[1] = x[1] * sin(x[2]);
+        y[2] = 3.0 * x[0] + x[3] / 4.0;
+        return y;
+    }
+};
+
+} // namespace
+
+TEST_CASE("Test linearity tracer")
+{
+    using algodiff::forward::LinearityTracer;
+    const auto x{LinearityTracer::input(0, 2.0)};
+    const auto y{LinearityTracer::input(1, 3.0)};
+
+    const auto affine{3.0 * x - y / 2.0 + 1.0};
+    REQUIRE(affine.value() == Approx(5.5));
+    REQUIRE(affine.nonlinear().empty());
+    REQUIRE(affine.linear().size() == 2);
+    REQUIRE(affine.linear()[0].second == Approx(3.0));
+    REQUIRE(affine.linear()[1].second == Approx(-0.5));
+
+    // The product makes both inputs nonlinear, the sum keeps y affine
+    const auto mixed{x * x + y};
+    REQUIRE(mixed.value() == Approx(7.0));
+    REQUIRE(mixed.nonlinear() == std::vector<Eigen::Index>{0});
+    REQUIRE(mixed.linear().size() == 1);
+    REQUIRE(mixed.linear()[0].first == 1);
+
+    REQUIRE(exp(LinearityTracer{1.0}).is_constant());
+    REQUIRE((x * LinearityTracer{2.0}).nonlinear().empty());
+}
+
+TEST_CASE("Test cached jacobian")
+{
+    int calls{0};
+    Eigen::VectorXd u(4);
+    u << 0.5, 1.5, -0.3, 2.0;
+    auto jac{algodiff::forward::make_cached_jacobian<3>(Model{&calls}, u)};
+    REQUIRE(calls == 1);
+
+    REQUIRE(jac.entry(0, 0) == JacobianEntry::Constant);
+    REQUIRE(jac.entry(0, 1) == JacobianEntry::Zero);
+    REQUIRE(jac.entry(1, 1) == JacobianEntry::Varying);
+    REQUIRE(jac.entry(1, 2) == JacobianEntry::Varying);
+    REQUIRE(jac.entry(2, 3) == JacobianEntry::Constant);
+    REQUIRE(jac.varying_columns() == std::vector<Eigen::Index>{1, 2});
+    REQUIRE(jac.constant_entries()(0, 2) == Approx(-1.0));
+
+    // Only the two varying columns are seeded
+    calls = 0;
+    Eigen::VectorXd v(4);
+    v << -1.0, 0.25, 1.2, 3.0;
+    const Eigen::MatrixXd cached{jac(v)};
+    REQUIRE(calls == 2);
+
+    int reference_calls{0};
+    const Eigen::MatrixXd expected{
+        algodiff::forward::jacobian<3>(Model{&reference_calls}, v)};
+    REQUIRE(reference_calls == 4);
+    for (Eigen::Index row = 0; row < 3; ++row) {
+        for (Eigen::Index col = 0; col < 4; ++col) {
+            REQUIRE(cached(row, col) == Approx(expected(row, col)));
+        }
+    }
+
+    REQUIRE_THROWS_AS(jac(Eigen::VectorXd::Zero(3)), std::invalid_argument);
+}
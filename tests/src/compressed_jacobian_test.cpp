@@ -0,0 +1,181 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "algodiff/compressed_jacobian.hpp"
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "algodiff/dual_number.hpp"
+#include "algodiff/dual_number_ops.hpp"
+#include "algodiff/forward_mode.hpp"
+
+namespace
+{
+constexpr int function_size{4};
+
+// A banded function whose jacobian has exactly 7 non-zero entries at any
+// input with non-zero components
+auto banded(const Eigen::VectorX<algodiff::forward::DualNumber> &x)
+{
+    Eigen::VectorX<algodiff::forward::DualNumber> out(function_size);
+    out[0] = x[0] * x[1];
+    out[1] = algodiff::forward::sin(x[1]) + 2.0 * x[2];
+    out[2] = x[2] * x[2] - x[3];
+    out[3] = algodiff::forward::exp(x[3]) * 3.0;
+    return out;
+}
+
+auto input() -> Eigen::VectorXd
+{
+    Eigen::VectorXd u(4);
+    u << 1.5, 0.25, -2.0, 0.5;
+    return u;
+}
+
+} // namespace
+
+TEST_CASE("Compressed jacobian", "[Compressed Jacobian]")
+{
+    const Eigen::VectorXd u{input()};
+    const Eigen::MatrixXd dense{
+        algodiff::forward::jacobian<function_size>(banded, u)};
+
+    SECTION("Eigen CSC and CSR")
+    {
+        const auto csc{
+            algodiff::forward::jacobian_csc<function_size>(banded, u)};
+        const auto csr{
+            algodiff::forward::jacobian_csr<function_size>(banded, u)};
+
+        REQUIRE(csc.nonZeros() == 7);
+        REQUIRE(csr.nonZeros() == 7);
+        REQUIRE(csc.isCompressed());
+        for (int i = 0; i < dense.rows(); ++i) {
+            for (int j = 0; j < dense.cols(); ++j) {
+                REQUIRE(Catch::Approx(csc.coeff(i, j)) == dense(i, j));
+                REQUIRE(Catch::Approx(csr.coeff(i, j)) == dense(i, j));
+            }
+        }
+    }
+
+    SECTION("raw CSC and CSR arrays")
+    {
+        const auto csc{algodiff::forward::compressed_jacobian<function_size>(
+            banded, u, algodiff::forward::StorageOrder::CSC)};
+        const auto csr{algodiff::forward::compressed_jacobian<function_size>(
+            banded, u, algodiff::forward::StorageOrder::CSR)};
+
+        REQUIRE(csc.outer_index == std::vector<std::int64_t>{0, 1, 3, 5, 7});
+        REQUIRE(csc.inner_index ==
+                std::vector<std::int64_t>{0, 0, 1, 1, 2, 2, 3});
+        REQUIRE(csr.outer_index == std::vector<std::int64_t>{0, 2, 4, 6, 7});
+        REQUIRE(csr.inner_index ==
+                std::vector<std::int64_t>{0, 1, 1, 2, 2, 3, 3});
+
+        const auto from_csr{algodiff::forward::to_sparse_matrix(csr)};
+        for (int i = 0; i < dense.rows(); ++i) {
+            for (int j = 0; j < dense.cols(); ++j) {
+                REQUIRE(Catch::Approx(from_csr.coeff(i, j)) == dense(i, j));
+            }
+        }
+    }
+
+    SECTION("drop tolerance")
+    {
+        const auto csc{
+            algodiff::forward::jacobian_csc<function_size>(banded, u, 1.0)};
+        for (int i = 0; i < dense.rows(); ++i) {
+            for (int j = 0; j < dense.cols(); ++j) {
+                const double expected{std::abs(dense(i, j)) > 1.0 ? dense(i, j)
+                                                                  : 0.0};
+                REQUIRE(Catch::Approx(csc.coeff(i, j)) == expected);
+            }
+        }
+    }
+}
+
+TEST_CASE("Jacobian writers", "[Compressed Jacobian]")
+{
+    const Eigen::VectorXd u{input()};
+    const Eigen::MatrixXd dense{
+        algodiff::forward::jacobian<function_size>(banded, u)};
+
+    SECTION("binary round trip")
+    {
+        const std::string path{"compressed_jacobian_test.adjc"};
+        {
+            algodiff::forward::BinaryJacobianWriter writer{
+                path, function_size, u.size()};
+            algodiff::forward::write_jacobian<function_size>(banded, u,
+                                                             writer);
+            writer.finish();
+            REQUIRE(writer.nonZeros() == 7);
+        }
+
+        // The header stores rows, cols and the entry count little endian
+        std::ifstream file{path, std::ios::binary};
+        std::array<unsigned char, 36> header{};
+        file.read(reinterpret_cast<char *>(header.data()), // NOLINT
+                  header.size());
+        REQUIRE(header[12] == function_size);
+        REQUIRE(header[20] == u.size());
+        REQUIRE(header[28] == 7);
+        for (const std::size_t field : {12, 20, 28}) {
+            for (std::size_t k = 1; k < 8; ++k) {
+                REQUIRE(header[field + k] == 0);
+            }
+        }
+
+        const auto jac{algodiff::forward::read_binary_jacobian(path)};
+        REQUIRE(jac.rows() == function_size);
+        REQUIRE(jac.cols() == u.size());
+        REQUIRE(jac.nonZeros() == 7);
+        for (int i = 0; i < dense.rows(); ++i) {
+            for (int j = 0; j < dense.cols(); ++j) {
+                REQUIRE(Catch::Approx(jac.coeff(i, j)) == dense(i, j));
+            }
+        }
+        std::remove(path.c_str());
+    }
+
+    SECTION("Matrix Market")
+    {
+        const std::string path{"compressed_jacobian_test.mtx"};
+        {
+            algodiff::forward::MatrixMarketWriter writer{path, function_size,
+                                                         u.size()};
+            algodiff::forward::write_jacobian<function_size>(banded, u,
+                                                             writer);
+        }
+
+        std::ifstream in{path};
+        std::string banner{};
+        std::getline(in, banner);
+        REQUIRE(banner == "%%MatrixMarket matrix coordinate real general");
+
+        long rows{};
+        long cols{};
+        long nnz{};
+        in >> rows >> cols >> nnz;
+        REQUIRE(rows == function_size);
+        REQUIRE(cols == u.size());
+        REQUIRE(nnz == 7);
+
+        for (long k = 0; k < nnz; ++k) {
+            long i{};
+            long j{};
+            double value{};
+            in >> i >> j >> value;
+            REQUIRE(Catch::Approx(value) == dense(i - 1, j - 1));
+        }
+        std::remove(path.c_str());
+    }
+}
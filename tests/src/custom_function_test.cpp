@@ -0,0 +1,197 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+#include <cmath>
+
+#include "algodiff/custom_function.hpp"
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "algodiff/dual_number.hpp"
+#include "algodiff/dual_number_ops.hpp"
+#include "algodiff/forward_mode.hpp"
+#include "algodiff/reverse_mode.hpp"
+#include "algodiff/sparse_forward_mode.hpp"
+#include "algodiff/tape.hpp"
+
+using algodiff::forward::DualNumber;
+
+namespace
+{
+// Stands in for a routine that only works on doubles, e.g. a table lookup
+auto property(double x) -> double
+{
+    return std::exp(x) / (1.0 + x * x);
+}
+
+auto property_derivative(double x) -> double
+{
+    const double denominator{1.0 + x * x};
+    return std::exp(x) * (denominator - 2.0 * x) / (denominator * denominator);
+}
+
+// y = (x0 x1, x1 + x2^2) with its jacobian-vector product
+auto pair(const Eigen::VectorXd &x) -> Eigen::VectorXd
+{
+    return Eigen::Vector2d{x[0] * x[1], x[1] + x[2] * x[2]};
+}
+
+auto pair_jvp(const Eigen::VectorXd &x, const Eigen::VectorXd &v)
+    -> Eigen::VectorXd
+{
+    return Eigen::Vector2d{x[1] * v[0] + x[0] * v[1], v[1] + 2.0 * x[2] * v[2]};
+}
+
+auto pair_vjp(const Eigen::VectorXd &x, const Eigen::VectorXd &w)
+    -> Eigen::VectorXd
+{
+    return Eigen::Vector3d{x[1] * w[0], x[0] * w[0] + w[1], 2.0 * x[2] * w[1]};
+}
+
+} // namespace
+
+TEST_CASE("CustomFunction uses the supplied derivative", "[CustomFunction]")
+{
+    int derivative_calls{0};
+    const auto f{algodiff::forward::make_custom_function(
+        property, [&](double x) {
+            ++derivative_calls;
+            return property_derivative(x);
+        })};
+
+    constexpr double u{0.7};
+    REQUIRE(f(u) == Catch::Approx(property(u)));
+    REQUIRE(derivative_calls == 0);
+
+    const double d{algodiff::forward::derivative(
+        [&](const DualNumber &x) { return algodiff::forward::sin(f(x)); }, u)};
+    REQUIRE(d == Catch::Approx(std::cos(property(u)) * property_derivative(u)));
+    REQUIRE(derivative_calls == 1);
+}
+
+TEST_CASE("CustomFunction composes inside gradients", "[CustomFunction]")
+{
+    const auto f{
+        algodiff::forward::make_custom_function(property, property_derivative)};
+    const Eigen::Vector3d u{0.2, -0.4, 1.1};
+
+    const Eigen::VectorXd grad{algodiff::forward::gradient(
+        [&](const Eigen::Vector3<DualNumber> &x) {
+            return f(x[0] * x[1]) + x[2];
+        },
+        u)};
+    const double inner{u[0] * u[1]};
+    REQUIRE(grad[0] == Catch::Approx(property_derivative(inner) * u[1]));
+    REQUIRE(grad[1] == Catch::Approx(property_derivative(inner) * u[0]));
+    REQUIRE(grad[2] == Catch::Approx(1.0));
+
+    const Eigen::SparseVector<double> sparse{algodiff::forward::sparse_gradient(
+        [&](const Eigen::VectorX<algodiff::forward::SparseDualNumber> &x) {
+            return f(x[0] * x[1]);
+        },
+        Eigen::VectorXd{u})};
+    REQUIRE(sparse.nonZeros() == 2);
+    REQUIRE(sparse.coeff(0) == Catch::Approx(grad[0]));
+    REQUIRE(sparse.coeff(1) == Catch::Approx(grad[1]));
+}
+
+TEST_CASE("CustomVectorFunction propagates tangents through the jvp",
+          "[CustomFunction]")
+{
+    const auto f{
+        algodiff::forward::make_custom_vector_function(pair, pair_jvp)};
+    const Eigen::VectorXd u{Eigen::Vector3d{1.5, -2.0, 0.5}};
+    Eigen::MatrixXd expected(2, 3);
+    expected << u[1], u[0], 0.0, 0.0, 1.0, 2.0 * u[2];
+
+    const Eigen::MatrixXd dense{algodiff::forward::jacobian<2>(
+        [&](const Eigen::VectorX<DualNumber> &x) { return f(x); }, u)};
+    REQUIRE(dense.isApprox(expected));
+
+    const auto sparse{algodiff::forward::sparse_jacobian<2>(
+        [&](const Eigen::VectorX<algodiff::forward::SparseDualNumber> &x) {
+            return f(x);
+        },
+        u)};
+    REQUIRE(Eigen::MatrixXd(sparse).isApprox(expected));
+    REQUIRE(f(u).isApprox(pair(u)));
+}
+
+TEST_CASE("Custom functions record their rules on tapes", "[CustomFunction]")
+{
+    using algodiff::reverse::Variable;
+    int derivative_calls{0};
+    const auto f{algodiff::forward::make_custom_function(
+        property, [&](double x) {
+            ++derivative_calls;
+            return property_derivative(x);
+        })};
+    const Eigen::VectorXd u{Eigen::Vector3d{1.5, -2.0, 0.5}};
+
+    // The scalar derivative becomes the vjp of a single node
+    const Eigen::VectorXd grad{algodiff::reverse::gradient(
+        [&](const Eigen::VectorX<Variable> &x) {
+            Eigen::VectorX<Variable> y(1);
+            y[0] = f(x[0] * x[2]) + x[1];
+            return y;
+        },
+        u)};
+    const double inner{u[0] * u[2]};
+    REQUIRE(grad[0] == Catch::Approx(property_derivative(inner) * u[2]));
+    REQUIRE(grad[1] == Catch::Approx(1.0));
+    REQUIRE(grad[2] == Catch::Approx(property_derivative(inner) * u[0]));
+    REQUIRE(derivative_calls == 1);
+    REQUIRE(f(Variable{0.3}).value() == Catch::Approx(property(0.3)));
+
+    // Vector functions use the vjp when given, the jvp otherwise
+    Eigen::MatrixXd expected(2, 3);
+    expected << u[1], u[0], 0.0, 0.0, 1.0, 2.0 * u[2];
+    const auto with_vjp{algodiff::forward::make_custom_vector_function(
+        pair, pair_jvp, pair_vjp)};
+    const auto without_vjp{
+        algodiff::forward::make_custom_vector_function(pair, pair_jvp)};
+    REQUIRE(with_vjp.external()->vjp);
+    REQUIRE(without_vjp.external()->jacobian);
+    REQUIRE(algodiff::reverse::jacobian(
+                [&](const Eigen::VectorX<Variable> &x) { return with_vjp(x); },
+                u)
+                .isApprox(expected));
+    REQUIRE(algodiff::reverse::jacobian(
+                [&](const Eigen::VectorX<Variable> &x) {
+                    return without_vjp(x);
+                },
+                u)
+                .isApprox(expected));
+}
+
+TEST_CASE("CustomVectorFunction builds each sparse tangent once",
+          "[CustomFunction]")
+{
+    // Every output depends on every input through a dense jvp
+    constexpr Eigen::Index size{64};
+    const auto f{algodiff::forward::make_custom_vector_function(
+        [](const Eigen::VectorXd &x) {
+            return Eigen::VectorXd::Constant(2, x.sum());
+        },
+        [](const Eigen::VectorXd &, const Eigen::VectorXd &v) {
+            return Eigen::VectorXd::Constant(2, v.sum());
+        })};
+    Eigen::VectorX<algodiff::forward::SparseDualNumber> x(size);
+    for (Eigen::Index i = 0; i < size; ++i) {
+        x[i] = algodiff::forward::SparseDualNumber{
+            1.0, algodiff::forward::SparseTangent{size - 1 - i, 2.0}};
+    }
+    const auto y{f(x)};
+    for (Eigen::Index i = 0; i < y.size(); ++i) {
+        REQUIRE(y[i].primal() == Catch::Approx(64.0));
+        REQUIRE(y[i].tangent().size() == static_cast<std::size_t>(size));
+        Eigen::Index previous{-1};
+        for (const auto &entry : y[i].tangent()) {
+            REQUIRE(entry.index > previous);
+            REQUIRE(entry.value == 2.0);
+            previous = entry.index;
+        }
+    }
+}
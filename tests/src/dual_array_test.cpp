@@ -0,0 +1,154 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+#include <cmath>
+#include <stdexcept>
+
+#include "algodiff/dual_array.hpp"
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "algodiff/dual_number.hpp"
+#include "algodiff/dual_number_ops.hpp"
+
+using algodiff::forward::DualArray;
+using algodiff::forward::DualNumber;
+using Catch::Approx;
+
+namespace
+{
+auto same(const DualNumber &actual, const DualNumber &expected) -> bool
+{
+    return actual.primal() == Approx(expected.primal()) &&
+           actual.dual() == Approx(expected.dual());
+}
+
+// A piecewise model written once for scalars with branches
+auto branchy(const DualNumber &x) -> DualNumber
+{
+    if (x < -1.0) {
+        return -2.0 * x - 1.0;
+    }
+    if (x < 1.0) {
+        return x * x;
+    }
+    return algodiff::forward::log(x) + 1.0;
+}
+
+// The same model written with lane masks
+auto masked(const DualArray &x) -> DualArray
+{
+    using algodiff::forward::select;
+    const DualArray quadratic{x * x};
+    return select(x < -1.0, -2.0 * x - 1.0,
+                  select(x < 1.0, quadratic,
+                         algodiff::forward::log(abs(x)) + 1.0));
+}
+
+} // namespace
+
+TEST_CASE("Test dual array arithmetic")
+{
+    const Eigen::ArrayXd primal{Eigen::ArrayXd::LinSpaced(6, 0.5, 3.0)};
+    const Eigen::ArrayXd dual{Eigen::ArrayXd::LinSpaced(6, 1.0, -1.0)};
+    const DualArray x{primal, dual};
+    const DualArray y{x.size(), DualNumber{1.5, 0.25}};
+    const DualArray result{algodiff::forward::sin(x) * y / (2.0 - x) +
+                           algodiff::forward::exp(x) / y -
+                           algodiff::forward::pow(x, 1.5) +
+                           algodiff::forward::sqrt(x) * 3.0 +
+                           algodiff::forward::tanh(-x) -
+                           1.0 / algodiff::forward::cos(x) +
+                           algodiff::forward::log(x)};
+    for (Eigen::Index i = 0; i < x.size(); ++i) {
+        const DualNumber a{x[i]};
+        const DualNumber b{y[i]};
+        const DualNumber expected{
+            algodiff::forward::sin(a) * b / (2.0 - a) +
+            algodiff::forward::exp(a) / b - algodiff::forward::pow(a, 1.5) +
+            algodiff::forward::sqrt(a) * 3.0 + algodiff::forward::tanh(-a) -
+            algodiff::forward::inverse(algodiff::forward::cos(a)) +
+            algodiff::forward::log(a)};
+        REQUIRE(same(result[i], expected));
+    }
+
+    const auto lanes{x.to_vector()};
+    const DualArray round_trip{lanes};
+    REQUIRE((round_trip.primal() == x.primal()).all());
+    REQUIRE((round_trip.dual() == x.dual()).all());
+    REQUIRE_THROWS_AS((x + DualArray{2, DualNumber{}}), std::invalid_argument);
+    REQUIRE_THROWS_AS((DualArray{primal, dual.head(2)}),
+                      std::invalid_argument);
+}
+
+TEST_CASE("Test branch-free selection")
+{
+    const Eigen::ArrayXd primal{Eigen::ArrayXd::LinSpaced(9, -2.0, 2.0)};
+    const DualArray x{primal, Eigen::ArrayXd::Ones(9)};
+    const DualArray y{masked(x)};
+    for (Eigen::Index i = 0; i < x.size(); ++i) {
+        REQUIRE(same(y[i], branchy(x[i])));
+    }
+
+    // Masks compare primal components only
+    const DualArray z{x.size(), DualNumber{0.0, 5.0}};
+    REQUIRE((x < z).count() == 4);
+    REQUIRE((x <= z).count() == 5);
+    REQUIRE((x > 0.0).count() == 4);
+    REQUIRE((x >= 0.0).count() == 5);
+    REQUIRE(((0.0 < x) == (x > 0.0)).all());
+    REQUIRE(((0.0 <= x) == (x >= 0.0)).all());
+    REQUIRE(((0.0 > x) == (x < 0.0)).all());
+    REQUIRE(((0.0 >= x) == (x <= 0.0)).all());
+    REQUIRE_THROWS_AS(x < DualArray{}, std::invalid_argument);
+
+    // Disjoint where() terms build the same piecewise function
+    const DualArray sum{algodiff::forward::where(x < 0.0, -x) +
+                        algodiff::forward::where(x >= 0.0, x * x)};
+    const DualArray clamped{algodiff::forward::clamp(x, -0.5, 1.0)};
+    const DualArray low{x.size(), DualNumber{-0.5, 2.0}};
+    const DualArray high{x.size(), DualNumber{1.0, 3.0}};
+    const DualArray bounded{algodiff::forward::clamp(x, low, high)};
+    const DualArray smooth{algodiff::forward::smooth_abs(x, 0.1)};
+    for (Eigen::Index i = 0; i < x.size(); ++i) {
+        const DualNumber a{x[i]};
+        REQUIRE(same(sum[i], algodiff::forward::select(a < 0.0, -a, a * a)));
+        REQUIRE(same(clamped[i],
+                     algodiff::forward::clamp(a, -0.5, 1.0)));
+        REQUIRE(same(bounded[i],
+                     algodiff::forward::clamp(a, low[i], high[i])));
+        REQUIRE(same(smooth[i], algodiff::forward::smooth_abs(a, 0.1)));
+    }
+
+    // Scalar primitives
+    const DualNumber a{-0.5, 1.0};
+    REQUIRE(same(algodiff::forward::where(a < 0.0, a), a));
+    REQUIRE(same(algodiff::forward::where(a > 0.0, a), DualNumber{}));
+    REQUIRE(0.0 > a);
+    REQUIRE(-0.5 <= a);
+    REQUIRE(-0.5 >= a);
+    REQUIRE_FALSE(-1.0 > a);
+    REQUIRE(same(algodiff::forward::clamp(a, 0.0, 1.0), DualNumber{}));
+    REQUIRE(same(algodiff::forward::clamp(a, -1.0, 1.0), a));
+    REQUIRE(same(algodiff::forward::clamp(a, DualNumber{0.0, 4.0},
+                                          DualNumber{1.0}),
+                 DualNumber{0.0, 4.0}));
+    const DualNumber zero{algodiff::forward::smooth_abs(DualNumber{0.0, 1.0},
+                                                        0.1)};
+    REQUIRE(zero.primal() == 0.0);
+    REQUIRE(zero.dual() == 0.0);
+    const DualNumber far{algodiff::forward::smooth_abs(a * 100.0, 1e-3)};
+    REQUIRE(far.primal() == Approx(50.0).epsilon(1e-4));
+    REQUIRE(far.dual() == Approx(-100.0));
+
+    // Lanes beyond the square root of the largest double do not overflow
+    const DualArray huge{Eigen::ArrayXd::Constant(2, 1e200) * primal.head(2),
+                         Eigen::ArrayXd::Ones(2)};
+    const DualArray smooth_huge{algodiff::forward::smooth_abs(huge, 0.1)};
+    for (Eigen::Index i = 0; i < huge.size(); ++i) {
+        REQUIRE(smooth_huge[i].primal() == Approx(std::abs(huge[i].primal())));
+        REQUIRE(smooth_huge[i].dual() == Approx(-1.0));
+    }
+}
@@ -0,0 +1,104 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+#include <cmath>
+#include <initializer_list>
+#include <stdexcept>
+
+#include "algodiff/dual_number_kernels.hpp"
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "algodiff/dual_number.hpp"
+#include "algodiff/dual_number_ops.hpp"
+
+using algodiff::forward::DualNumber;
+using Catch::Approx;
+
+namespace
+{
+auto vector(std::initializer_list<DualNumber> values)
+    -> Eigen::VectorX<DualNumber>
+{
+    Eigen::VectorX<DualNumber> x(static_cast<Eigen::Index>(values.size()));
+    Eigen::Index i{0};
+    for (const auto &value : values) {
+        x[i++] = value;
+    }
+    return x;
+}
+
+auto same(const DualNumber &actual, const DualNumber &expected) -> bool
+{
+    return actual.primal() == Approx(expected.primal()) &&
+           actual.dual() == Approx(expected.dual());
+}
+
+} // namespace
+
+TEST_CASE("Test reductions of dual vectors")
+{
+    const auto x{vector({DualNumber{0.5, 1.0}, DualNumber{-1.5, 0.25},
+                         DualNumber{2.0, -0.5}})};
+    const auto y{vector({DualNumber{1.0, 0.0}, DualNumber{3.0, 2.0},
+                         DualNumber{-0.5, 1.0}})};
+
+    REQUIRE(same(algodiff::forward::sum(x), x[0] + x[1] + x[2]));
+    REQUIRE(same(algodiff::forward::prod(x), x[0] * x[1] * x[2]));
+    REQUIRE(same(algodiff::forward::dot(x, y),
+                 x[0] * y[0] + x[1] * y[1] + x[2] * y[2]));
+    const DualNumber squares{x[0] * x[0] + x[1] * x[1] + x[2] * x[2]};
+    REQUIRE(same(algodiff::forward::squared_norm(x), squares));
+    REQUIRE(same(algodiff::forward::norm(x), algodiff::forward::sqrt(squares)));
+    REQUIRE_THROWS_AS(algodiff::forward::dot(x, x.head(2)),
+                      std::invalid_argument);
+
+    // The tangent of a product with a zero factor is still exact
+    const auto zero{vector({DualNumber{0.0, 1.0}, DualNumber{3.0, 0.0},
+                            DualNumber{2.0, 0.0}})};
+    REQUIRE(same(algodiff::forward::prod(zero), DualNumber{0.0, 6.0}));
+    REQUIRE(same(algodiff::forward::norm(zero.head(0)), DualNumber{0.0}));
+
+    // Huge entries do not overflow the norm
+    const auto huge{vector({DualNumber{3e200, 1.0}, DualNumber{4e200, 0.0}})};
+    const auto n{algodiff::forward::norm(huge)};
+    REQUIRE(n.primal() == Approx(5e200));
+    REQUIRE(n.dual() == Approx(0.6));
+}
+
+TEST_CASE("Test activations of dual vectors")
+{
+    const auto x{vector({DualNumber{0.5, 1.0}, DualNumber{-1.5, 0.25},
+                         DualNumber{2.0, -0.5}})};
+    const DualNumber total{algodiff::forward::exp(x[0]) +
+                           algodiff::forward::exp(x[1]) +
+                           algodiff::forward::exp(x[2])};
+    const auto lse{algodiff::forward::logsumexp(x)};
+    REQUIRE(same(lse, algodiff::forward::log(total)));
+
+    const auto probabilities{algodiff::forward::softmax(x)};
+    const auto log_probabilities{algodiff::forward::log_softmax(x)};
+    const auto sigmoids{algodiff::forward::sigmoid(x)};
+    for (Eigen::Index i = 0; i < x.size(); ++i) {
+        REQUIRE(same(probabilities[i], algodiff::forward::exp(x[i]) / total));
+        REQUIRE(same(log_probabilities[i], x[i] - lse));
+        const DualNumber expected{
+            1.0 / (1.0 + algodiff::forward::exp(-x[i]))};
+        REQUIRE(same(sigmoids[i], expected));
+        REQUIRE(same(algodiff::forward::sigmoid(x[i]), expected));
+    }
+
+    // Large inputs stay finite
+    const auto large{
+        vector({DualNumber{1000.0, 1.0}, DualNumber{1000.0, 0.0}})};
+    REQUIRE(same(algodiff::forward::logsumexp(large),
+                 DualNumber{1000.0 + std::log(2.0), 0.5}));
+    const auto split{algodiff::forward::softmax(large)};
+    REQUIRE(same(split[0], DualNumber{0.5, 0.25}));
+    REQUIRE(same(split[1], DualNumber{0.5, -0.25}));
+    const auto saturated{algodiff::forward::sigmoid(DualNumber{-800.0, 1.0})};
+    REQUIRE(saturated.primal() == 0.0);
+    REQUIRE(std::isfinite(saturated.dual()));
+}
@@ -3,7 +3,10 @@
  * SPDX-License-Identifier: MIT
  */
 #include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <cstddef>
+#include <iostream>
 #include <limits>
 #include <random>
 
@@ -220,3 +223,169 @@ TEST_CASE("Non member functions", "[DualNumber]")
     REQUIRE(aa.dual() == Catch::Approx(norm_a.dual()));
     REQUIRE(aa.dual() == Catch::Approx(abs2_a.dual()));
 }
+
+TEST_CASE("Special functions", "[DualNumber]")
+{
+    using algodiff::forward::DualNumber;
+    constexpr double step{1e-6};
+    const auto check = [&](auto &&fused, auto &&reference, double x) {
+        const DualNumber result{fused(DualNumber{x, 1.0})};
+        REQUIRE(result.primal() == Catch::Approx(reference(x)));
+        const double slope{(reference(x + step) - reference(x - step)) /
+                           (2.0 * step)};
+        REQUIRE(result.dual() ==
+                Catch::Approx(slope).epsilon(1e-6).margin(1e-8));
+    };
+
+    for (const double x : {-2.5, -0.3, 0.7, 1.9, 4.2}) {
+        check([](const auto &d) { return algodiff::forward::expm1(d); },
+              [](double v) { return std::expm1(v); }, x);
+        check([](const auto &d) { return algodiff::forward::cbrt(d); },
+              [](double v) { return std::cbrt(v); }, x);
+        check([](const auto &d) { return algodiff::forward::erf(d); },
+              [](double v) { return std::erf(v); }, x);
+        check([](const auto &d) { return algodiff::forward::erfc(d); },
+              [](double v) { return std::erfc(v); }, x);
+        check([](const auto &d) { return algodiff::forward::lgamma(d); },
+              [](double v) { return std::lgamma(v); }, x);
+        check([](const auto &d) { return algodiff::forward::tgamma(d); },
+              [](double v) { return std::tgamma(v); }, x);
+        check([](const auto &d) { return algodiff::forward::pow(d, 3); },
+              [](double v) { return v * v * v; }, x);
+        check([](const auto &d) { return algodiff::forward::pow(d, -2); },
+              [](double v) { return 1.0 / (v * v); }, x);
+        check(
+            [](const auto &d) {
+                return algodiff::forward::atan2(DualNumber{-1.5}, d);
+            },
+            [](double v) { return std::atan2(-1.5, v); }, x);
+        check(
+            [](const auto &d) {
+                return algodiff::forward::hypot(d, DualNumber{2.0});
+            },
+            [](double v) { return std::hypot(v, 2.0); }, x);
+        check(
+            [](const auto &d) {
+                return algodiff::forward::fma(d, d, DualNumber{0.5});
+            },
+            [](double v) { return v * v + 0.5; }, x);
+    }
+    for (const double x : {-0.5, 0.3, 2.0}) {
+        check([](const auto &d) { return algodiff::forward::log1p(d); },
+              [](double v) { return std::log1p(v); }, x);
+    }
+
+    // Precision where the composed forms cancel
+    const DualNumber tiny{1e-12, 1.0};
+    REQUIRE(algodiff::forward::expm1(tiny).primal() ==
+            Catch::Approx(1e-12).epsilon(1e-12));
+    REQUIRE(algodiff::forward::log1p(tiny).primal() ==
+            Catch::Approx(1e-12).epsilon(1e-12));
+    REQUIRE(algodiff::forward::erfc(DualNumber{10.0, 1.0}).primal() > 0.0);
+    REQUIRE(algodiff::forward::pow(tiny, 0).primal() == 1.0);
+    REQUIRE(algodiff::forward::pow(tiny, 0).dual() == 0.0);
+
+    // Integer powers at a zero base, with negative exponents and small bases
+    const DualNumber zero{0.0, 1.0};
+    REQUIRE(algodiff::forward::pow(zero, 1).primal() == 0.0);
+    REQUIRE(algodiff::forward::pow(zero, 1).dual() == 1.0);
+    REQUIRE(algodiff::forward::pow(zero, 3).dual() == 0.0);
+    REQUIRE(algodiff::forward::pow(zero, -1).primal() ==
+            std::numeric_limits<double>::infinity());
+    REQUIRE(algodiff::forward::pow(zero, -1).dual() ==
+            -std::numeric_limits<double>::infinity());
+    const DualNumber small{1e-300, 1.0};
+    REQUIRE(algodiff::forward::pow(small, -1).primal() ==
+            Catch::Approx(1e300));
+    REQUIRE(std::isinf(algodiff::forward::pow(small, -1).dual()));
+    REQUIRE(algodiff::forward::pow(small, 2).primal() == 0.0);
+    REQUIRE(algodiff::forward::pow(small, 2).dual() == Catch::Approx(2e-300));
+    const DualNumber large{1e200, 1.0};
+    REQUIRE(algodiff::forward::pow(large, 2).dual() == Catch::Approx(2e200));
+    const DualNumber half{0.5, 1.0};
+    REQUIRE(algodiff::forward::pow(half, -3).primal() == Catch::Approx(8.0));
+    REQUIRE(algodiff::forward::pow(half, -3).dual() == Catch::Approx(-48.0));
+
+    // Any integral exponent type picks the integer overload
+    REQUIRE(algodiff::forward::pow(half, 2L).primal() == 0.25);
+    REQUIRE(algodiff::forward::pow(half, std::size_t{2}).dual() == 1.0);
+    REQUIRE(algodiff::forward::pow(half, 3U).dual() == 0.75);
+
+    // atan2 keeps track of the quadrant
+    const DualNumber y{1.0, 0.0};
+    const DualNumber x{-1.0, 1.0};
+    const DualNumber angle{algodiff::forward::atan2(y, x)};
+    REQUIRE(angle.primal() == Catch::Approx(3.0 * M_PI / 4.0));
+    REQUIRE(angle.dual() == Catch::Approx(-0.5));
+
+    const DualNumber nan{std::numeric_limits<double>::quiet_NaN(), 1.0};
+    const DualNumber low{1.0, 2.0};
+    const DualNumber high{3.0, 4.0};
+    REQUIRE(algodiff::forward::fmin(low, high).dual() == 2.0);
+    REQUIRE(algodiff::forward::fmax(low, high).dual() == 4.0);
+    REQUIRE(algodiff::forward::fmin(nan, high).dual() == 4.0);
+    REQUIRE(algodiff::forward::fmax(low, nan).dual() == 2.0);
+}
+
+TEST_CASE("Special functions against composed equivalents",
+          "[.][benchmark]")
+{
+    using algodiff::forward::DualNumber;
+    constexpr int iterations{1000000};
+    const auto time = [&](auto &&f) {
+        double sink{0.0};
+        const auto start{std::chrono::steady_clock::now()};
+        for (int i = 0; i < iterations; ++i) {
+            const DualNumber x{0.25 + 1e-7 * static_cast<double>(i), 1.0};
+            const DualNumber result{f(x)};
+            sink += result.primal() + result.dual();
+        }
+        const std::chrono::duration<double, std::nano> elapsed{
+            std::chrono::steady_clock::now() - start};
+        REQUIRE(std::isfinite(sink));
+        return elapsed.count() / iterations;
+    };
+    const auto compare = [&](const char *name, auto &&fused,
+                             auto &&composed) {
+        const double fused_ns{time(fused)};
+        const double composed_ns{time(composed)};
+        std::cout << name << ": " << fused_ns << " ns fused, " << composed_ns
+                  << " ns composed (" << composed_ns / fused_ns << "x)\n";
+    };
+
+    using namespace algodiff::forward; // NOLINT
+    const DualNumber two{2.0, 0.0};
+    compare(
+        "atan2", [&](const DualNumber &x) { return atan2(two, x); },
+        [&](const DualNumber &x) {
+            const DualNumber angle{atan(two / x)};
+            return x.primal() < 0.0 ? angle + M_PI : angle;
+        });
+    compare(
+        "hypot", [&](const DualNumber &x) { return hypot(x, two); },
+        [&](const DualNumber &x) { return sqrt(x * x + two * two); });
+    compare(
+        "expm1", [](const DualNumber &x) { return expm1(x); },
+        [](const DualNumber &x) { return exp(x) - 1.0; });
+    compare(
+        "log1p", [](const DualNumber &x) { return log1p(x); },
+        [](const DualNumber &x) { return log(1.0 + x); });
+    compare(
+        "cbrt", [](const DualNumber &x) { return cbrt(x); },
+        [](const DualNumber &x) { return pow(x, 1.0 / 3.0); });
+    compare(
+        "erfc", [](const DualNumber &x) { return erfc(x); },
+        [](const DualNumber &x) { return 1.0 - erf(x); });
+    compare(
+        "tgamma", [](const DualNumber &x) { return tgamma(x); },
+        [](const DualNumber &x) { return exp(lgamma(x)); });
+    compare(
+        "fma", [&](const DualNumber &x) { return fma(x, x, two); },
+        [&](const DualNumber &x) { return x * x + two; });
+    compare(
+        "fmax", [&](const DualNumber &x) { return fmax(x, two); },
+        [&](const DualNumber &x) { return x.primal() < 2.0 ? two : x; });
+    compare(
+        "pow(int)", [](const DualNumber &x) { return pow(x, 5); },
+        [](const DualNumber &x) { return pow(x, 5.0); });
+}
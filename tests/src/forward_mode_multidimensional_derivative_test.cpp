@@ -238,3 +238,190 @@ TEST_CASE("Jacobian", "[Multidimensional Derivative]")
     }
   }
 }
+
+TEST_CASE("Jacobian with many outputs", "[Multidimensional Derivative]")
+{
+  // Too large for a fixed-size stack column
+  static constexpr int outputs = 20000;
+  auto f = [](const Eigen::VectorX<algodiff::forward::DualNumber>& vector)
+  {
+    Eigen::VectorX<algodiff::forward::DualNumber> result(outputs);
+    for (int i = 0; i < outputs; ++i) {
+      result[i] = vector[0] * static_cast<double>(i) + vector[1] * vector[1];
+    }
+    return result;
+  };
+
+  const Eigen::VectorXd input = Eigen::Vector2d {0.5, 3.0};
+  const auto jacobian = algodiff::forward::jacobian<outputs>(f, input);
+
+  REQUIRE(jacobian.rows() == outputs);
+  REQUIRE(jacobian.cols() == 2);
+  for (int i = 0; i < outputs; i += 997) {
+    REQUIRE(jacobian(i, 0) == Catch::Approx(static_cast<double>(i)));
+    REQUIRE(jacobian(i, 1) == Catch::Approx(6.0));
+  }
+}
+
+TEST_CASE("Value and derivative", "[Multidimensional Derivative]")
+{
+  // Every entry point should take the value from the derivative passes
+  int calls {0};
+
+  SECTION("Scalar function")
+  {
+    auto f = [&](algodiff::forward::DualNumber num)
+    {
+      ++calls;
+      return algodiff::forward::pow(num, 3.0);
+    };
+    auto [value, derivative] = algodiff::forward::value_and_derivative(f, 2.5);
+    REQUIRE(Catch::Approx(value) == 15.625);
+    REQUIRE(Catch::Approx(derivative) == 18.75);
+    REQUIRE(calls == 1);
+  }
+
+  SECTION("Gradient of std::vector and Eigen inputs")
+  {
+    auto f = [&](const auto& vector)
+    {
+      ++calls;
+      return algodiff::forward::sin(vector[0] / vector[1])
+          + algodiff::forward::pow(vector[2], 3.0);
+    };
+    const double expected_value =
+        std::sin(M_PI / 0.5) + std::pow(0.9286, 3.0);
+    constexpr std::array<double, 3> expected_gradient = {
+        2.00, -12.5663706144, 2.58689388};
+
+    const std::vector<double> input = {M_PI, 0.5, 0.9286};
+    const auto result = algodiff::forward::value_and_gradient(
+        [&](const std::vector<algodiff::forward::DualNumber>& vector)
+        { return f(vector); },
+        input);
+    REQUIRE(Catch::Approx(result.value) == expected_value);
+    for (size_t i = 0; i < expected_gradient.size(); ++i) {
+      REQUIRE(Catch::Approx(result.gradient[i]) == expected_gradient.at(i));
+    }
+    REQUIRE(calls == 3);
+
+    const Eigen::Vector3d eigen_input {M_PI, 0.5, 0.9286};
+    const auto eigen_result = algodiff::forward::value_and_gradient(
+        [&](const Eigen::Vector3<algodiff::forward::DualNumber>& vector)
+        { return f(vector); },
+        eigen_input);
+    REQUIRE(Catch::Approx(eigen_result.value) == expected_value);
+    for (int i = 0; i < 3; ++i) {
+      REQUIRE(Catch::Approx(eigen_result.gradient[i])
+              == expected_gradient.at(static_cast<size_t>(i)));
+    }
+    REQUIRE(calls == 6);
+  }
+
+  SECTION("Jacobian of every function family")
+  {
+    auto f = [&](const auto& vector)
+    {
+      ++calls;
+      Eigen::Vector2<algodiff::forward::DualNumber> result;
+      result[0] = vector[0] * vector[0] * vector[1];
+      result[1] = 5.0 * vector[0] + algodiff::forward::sin(vector[1]);
+      return result;
+    };
+    const Eigen::Vector2d input {1.25, M_PI / 3};
+    const Eigen::Vector2d expected_value {1.25 * 1.25 * M_PI / 3,
+                                          6.25 + std::sin(M_PI / 3)};
+    const auto expected_jacobian = algodiff::forward::jacobian<2>(
+        [](const Eigen::VectorX<algodiff::forward::DualNumber>& vector)
+        {
+          Eigen::Vector2<algodiff::forward::DualNumber> result;
+          result[0] = vector[0] * vector[0] * vector[1];
+          result[1] = 5.0 * vector[0] + algodiff::forward::sin(vector[1]);
+          return result;
+        },
+        Eigen::VectorXd(input));
+
+    const auto dynamic = algodiff::forward::value_and_jacobian<2>(
+        [&](const Eigen::VectorX<algodiff::forward::DualNumber>& vector)
+        { return f(vector); },
+        Eigen::VectorXd(input));
+    REQUIRE(dynamic.value.isApprox(expected_value));
+    REQUIRE(dynamic.jacobian.isApprox(expected_jacobian));
+    REQUIRE(calls == 2);
+
+    const auto fixed = algodiff::forward::value_and_jacobian<2>(
+        [&](const Eigen::Vector2<algodiff::forward::DualNumber>& vector)
+        { return f(vector); },
+        input);
+    REQUIRE(fixed.value.isApprox(expected_value));
+    REQUIRE(fixed.jacobian.isApprox(expected_jacobian));
+    REQUIRE(calls == 4);
+
+    std::vector<std::function<algodiff::forward::DualNumber(
+        Eigen::VectorX<algodiff::forward::DualNumber>)>>
+        functions = {[&](const Eigen::VectorX<algodiff::forward::DualNumber>&
+                             vector) { return f(vector)[0]; },
+                     [&](const Eigen::VectorX<algodiff::forward::DualNumber>&
+                             vector) { return f(vector)[1]; }};
+    const auto rows = algodiff::forward::value_and_jacobian(
+        functions, Eigen::VectorXd(input));
+    REQUIRE(rows.value.isApprox(expected_value));
+    REQUIRE(rows.jacobian.isApprox(expected_jacobian));
+    REQUIRE(calls == 8);
+
+    std::vector<algodiff::forward::DualNumber_function> std_functions = {
+        [&](const std::vector<algodiff::forward::DualNumber>& vector)
+        { return f(vector)[0]; },
+        [&](const std::vector<algodiff::forward::DualNumber>& vector)
+        { return f(vector)[1]; }};
+    const auto std_rows = algodiff::forward::value_and_jacobian(
+        std_functions, std::vector<double> {input[0], input[1]});
+    for (int i = 0; i < 2; ++i) {
+      const auto row = static_cast<size_t>(i);
+      REQUIRE(Catch::Approx(std_rows.value[row]) == expected_value[i]);
+      for (int j = 0; j < 2; ++j) {
+        REQUIRE(Catch::Approx(std_rows.jacobian[row][static_cast<size_t>(j)])
+                == expected_jacobian(i, j));
+      }
+    }
+    REQUIRE(calls == 12);
+  }
+
+  SECTION("The value is the primal of the first pass")
+  {
+    // The primal differs on every call, so only the first one matches
+    auto f = [&](const auto& vector)
+    {
+      ++calls;
+      return vector[0] * vector[1] + static_cast<double>(calls);
+    };
+    const Eigen::Vector2d input {2.0, 3.0};
+
+    const auto gradient = algodiff::forward::value_and_gradient(
+        [&](const Eigen::Vector2<algodiff::forward::DualNumber>& vector)
+        { return f(vector); },
+        input);
+    REQUIRE(gradient.value == 7.0);
+
+    calls = 0;
+    const auto std_gradient = algodiff::forward::value_and_gradient(
+        [&](const std::vector<algodiff::forward::DualNumber>& vector)
+        { return f(vector); },
+        std::vector<double> {2.0, 3.0});
+    REQUIRE(std_gradient.value == 7.0);
+
+    calls = 0;
+    const auto dynamic = algodiff::forward::value_and_jacobian<1>(
+        [&](const Eigen::VectorX<algodiff::forward::DualNumber>& vector)
+        { return Eigen::Vector<algodiff::forward::DualNumber, 1> {f(vector)}; },
+        Eigen::VectorXd(input));
+    REQUIRE(dynamic.value[0] == 7.0);
+
+    calls = 0;
+    const auto fixed = algodiff::forward::value_and_jacobian<1>(
+        [&](const Eigen::Vector2<algodiff::forward::DualNumber>& vector)
+        { return Eigen::Vector<algodiff::forward::DualNumber, 1> {f(vector)}; },
+        input);
+    REQUIRE(fixed.value[0] == 7.0);
+  }
+}
@@ -0,0 +1,241 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "algodiff/gradient_service.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "algodiff/dual_number.hpp"
+#include "algodiff/dual_number_ops.hpp"
+#include "algodiff/forward_mode.hpp"
+#include "algodiff/model_registry.hpp"
+#include "algodiff/tape.hpp"
+#include "algodiff/tape_ops.hpp"
+
+using algodiff::GradientClient;
+using algodiff::GradientServer;
+using algodiff::ModelRegistry;
+using algodiff::ServiceOptions;
+using algodiff::forward::DualNumber;
+
+namespace
+{
+constexpr int function_size{2};
+constexpr Eigen::Index input_size{3};
+
+auto f(const Eigen::VectorX<DualNumber> &x) -> Eigen::VectorX<DualNumber>
+{
+    Eigen::VectorX<DualNumber> y(function_size);
+    y[0] = x[0] * x[1] + algodiff::forward::sin(x[2]);
+    y[1] = algodiff::forward::exp(x[0]) - x[2] * x[2];
+    return y;
+}
+
+auto tape_model() -> algodiff::Model
+{
+    auto tape{std::make_shared<algodiff::reverse::Tape>()};
+    const auto x0{tape->variable(1.0)};
+    const auto x1{tape->variable(2.0)};
+    const auto x2{tape->variable(3.0)};
+    tape->register_output(x0 * x1 + algodiff::reverse::sin(x2));
+    tape->register_output(algodiff::reverse::exp(x0) - x2 * x2);
+    return algodiff::reverse::make_tape_model(tape);
+}
+
+auto socket_path() -> std::string
+{
+    return "/tmp/algodiff_gradient_service_test_" +
+           std::to_string(::getpid()) + ".sock";
+}
+
+// Connects a socket that speaks the wire protocol directly
+auto raw_connection() -> int
+{
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    const auto path{socket_path()};
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    const int fd{::socket(AF_UNIX, SOCK_STREAM, 0)};
+    REQUIRE(fd >= 0);
+    REQUIRE(::connect(fd, reinterpret_cast<const sockaddr *>(&address),
+                      sizeof(address)) == 0);
+    return fd;
+}
+
+} // namespace
+
+TEST_CASE("Test model registry")
+{
+    ModelRegistry registry{};
+    registry.add("b", algodiff::forward::make_model<function_size>(
+                          f, input_size));
+    registry.add("a", tape_model());
+    REQUIRE(registry.names() == std::vector<std::string>{"a", "b"});
+    REQUIRE(registry.find("c") == nullptr);
+    REQUIRE_THROWS_AS(registry.add("a", tape_model()), std::invalid_argument);
+    REQUIRE_THROWS_AS(registry.add("c", algodiff::Model{}),
+                      std::invalid_argument);
+
+    // Both kinds of model agree with the forward mode jacobian
+    const Eigen::VectorXd x{{0.5, -1.5, 2.0}};
+    const auto expected{algodiff::forward::jacobian<function_size>(f, x)};
+    for (const auto &name : {"a", "b"}) {
+        const auto model{registry.find(name)};
+        REQUIRE(model->input_size == input_size);
+        REQUIRE(model->output_size == function_size);
+        Eigen::VectorXd value(function_size);
+        Eigen::MatrixXd jac(function_size, input_size);
+        model->evaluate(x.data(), value.data(), jac.data());
+        REQUIRE(value.isApprox(Eigen::Vector2d{
+            0.5 * -1.5 + std::sin(2.0), std::exp(0.5) - 4.0}));
+        REQUIRE(jac.isApprox(expected));
+    }
+
+    // The single-thread copy reuses its dual numbers across calls
+    const auto forward_model{registry.find("b")};
+    REQUIRE(forward_model->with_workspace);
+    const auto bound{forward_model->with_workspace()};
+    REQUIRE_FALSE(bound.thread_safe);
+    for (int call = 0; call < 2; ++call) {
+        Eigen::VectorXd value(function_size);
+        Eigen::MatrixXd jac(function_size, input_size);
+        bound.evaluate(x.data(), value.data(), jac.data());
+        REQUIRE(jac.isApprox(expected));
+        Eigen::VectorXd jv(function_size);
+        const Eigen::VectorXd v{{1.0, 0.0, -1.0}};
+        bound.jvp(x.data(), v.data(), value.data(), jv.data());
+        REQUIRE(jv.isApprox(expected * v));
+    }
+}
+
+TEST_CASE("Test gradient service batches concurrent clients")
+{
+    constexpr int clients{4};
+    constexpr int rounds{8};
+
+    ModelRegistry registry{};
+    registry.add("forward", algodiff::forward::make_model<function_size>(
+                                f, input_size));
+    registry.add("tape", tape_model());
+    registry.add("failing", [] {
+        auto model{
+            algodiff::forward::make_model<function_size>(f, input_size)};
+        model.evaluate = [](const double *, double *, double *) {
+            throw std::runtime_error("Model failure");
+        };
+        return model;
+    }());
+
+    ServiceOptions options{};
+    options.batch_window = std::chrono::milliseconds{50};
+    options.max_batch = clients;
+    options.threads = 2;
+    GradientServer server{socket_path(), registry, options};
+    std::thread serving{[&] { server.run(); }};
+
+    std::vector<std::thread> threads{};
+    std::vector<bool> correct(clients, false);
+    for (int c = 0; c < clients; ++c) {
+        threads.emplace_back([&, c] {
+            GradientClient client{socket_path()};
+            bool ok{true};
+            for (int r = 0; r < rounds; ++r) {
+                const Eigen::VectorXd x{{0.1 * c, 0.2 * r, 1.0 + c - r}};
+                const auto expected{
+                    algodiff::forward::jacobian<function_size>(f, x)};
+                const auto name{(c + r) % 2 == 0 ? "forward" : "tape"};
+                const auto result{client.evaluate(name, x)};
+                ok = ok && result.jacobian.isApprox(expected) &&
+                     std::abs(result.value[1] -
+                              (std::exp(x[0]) - x[2] * x[2])) < 1e-12;
+            }
+            correct[static_cast<size_t>(c)] = ok;
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    for (const bool ok : correct) {
+        REQUIRE(ok);
+    }
+
+    const auto statistics{server.statistics()};
+    REQUIRE(statistics.requests == clients * rounds);
+    REQUIRE(statistics.batches < statistics.requests);
+
+    GradientClient client{socket_path()};
+    REQUIRE_THROWS_AS(client.evaluate("missing", Eigen::VectorXd::Zero(3)),
+                      std::runtime_error);
+    REQUIRE_THROWS_AS(client.evaluate("forward", Eigen::VectorXd::Zero(2)),
+                      std::invalid_argument);
+    REQUIRE_THROWS_AS(client.evaluate("failing", Eigen::VectorXd::Zero(3)),
+                      std::runtime_error);
+
+    // The connection survives failed requests
+    const auto result{client.evaluate("forward", Eigen::VectorXd::Zero(3))};
+    REQUIRE(result.value[1] == 1.0);
+
+    server.stop();
+    serving.join();
+}
+
+TEST_CASE("Test gradient service is not blocked by stalled clients")
+{
+    ModelRegistry registry{};
+    registry.add("forward", algodiff::forward::make_model<function_size>(
+                                f, input_size));
+    ServiceOptions options{};
+    options.batch_window = std::chrono::milliseconds{1};
+    GradientServer server{socket_path(), registry, options};
+    std::thread serving{[&] { server.run(); }};
+
+    // A client that stops in the middle of a request header
+    const int stalled{raw_connection()};
+    const std::uint32_t magic{0x53474441};
+    REQUIRE(::write(stalled, &magic, sizeof(magic)) == sizeof(magic));
+
+    // A client that announces far more inputs than the model takes and never
+    // sends them is rejected without the server waiting for them
+    const int oversized{raw_connection()};
+    const std::string name{"forward"};
+    const std::uint32_t header[]{magic, 1, 7, 1U << 24U};
+    REQUIRE(::write(oversized, header, sizeof(header)) == sizeof(header));
+    REQUIRE(::write(oversized, name.data(), name.size()) ==
+            static_cast<ssize_t>(name.size()));
+    pollfd answered{oversized, POLLIN, 0};
+    REQUIRE(::poll(&answered, 1, 5000) == 1);
+    std::uint32_t response[4]{};
+    REQUIRE(::read(oversized, response, sizeof(response)) ==
+            sizeof(response));
+    REQUIRE(response[0] == 2);
+    REQUIRE(response[1] == input_size);
+
+    // Other clients are served while both connections stay open
+    {
+        GradientClient client{socket_path()};
+        const Eigen::VectorXd x{{0.5, -1.5, 2.0}};
+        const auto result{client.evaluate("forward", x)};
+        REQUIRE(result.jacobian.isApprox(
+            algodiff::forward::jacobian<function_size>(f, x)));
+    }
+    REQUIRE(server.statistics().requests == 1);
+
+    server.stop();
+    serving.join();
+    ::close(stalled);
+    ::close(oversized);
+}
@@ -0,0 +1,171 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+#include <array>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include "algodiff/interpolation_table.hpp"
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "algodiff/dual_number.hpp"
+
+using algodiff::forward::CubicSpline;
+using algodiff::forward::DualNumber;
+using algodiff::forward::InterpolationAxis;
+using algodiff::forward::LinearTable;
+using Catch::Approx;
+
+TEST_CASE("Test interpolation axis lookup")
+{
+    const InterpolationAxis uniform{{0.0, 0.5, 1.0, 1.5}};
+    const InterpolationAxis graded{{0.0, 0.1, 0.3, 0.7, 1.5}};
+    REQUIRE(uniform.is_uniform());
+    REQUIRE_FALSE(graded.is_uniform());
+    REQUIRE_THROWS_AS(InterpolationAxis{{1.0}}, std::invalid_argument);
+    REQUIRE_THROWS_AS((InterpolationAxis{{0.0, 1.0, 1.0}}),
+                      std::invalid_argument);
+
+    Eigen::Index hint{0};
+    REQUIRE(uniform.locate(0.7, hint) == 1);
+    REQUIRE(uniform.locate(-3.0, hint) == 0);
+    REQUIRE(uniform.locate(9.0, hint) == 2);
+    REQUIRE(graded.locate(0.2, hint) == 1);
+    REQUIRE(hint == 1);
+    REQUIRE(graded.locate(0.35, hint) == 2);
+    REQUIRE(graded.locate(1.2, hint) == 3);
+    REQUIRE(graded.locate(2.0, hint) == 3);
+    REQUIRE(graded.locate(-1.0, hint) == 0);
+
+    // Batches agree with single lookups, sorted or not
+    const Eigen::ArrayXd x{
+        Eigen::ArrayXd::LinSpaced(9, -0.2, 1.8).reverse().eval()};
+    for (const auto *axis : {&uniform, &graded}) {
+        Eigen::ArrayX<Eigen::Index> cells{};
+        Eigen::ArrayXd fractions{};
+        Eigen::ArrayXd inverse_widths{};
+        axis->locate(x, cells, fractions, inverse_widths);
+        for (Eigen::Index i = 0; i < x.size(); ++i) {
+            Eigen::Index single{0};
+            const auto cell{axis->locate(x[i], single)};
+            REQUIRE(cells[i] == cell);
+            REQUIRE(fractions[i] == Approx(axis->fraction(x[i], cell)));
+            REQUIRE(inverse_widths[i] == Approx(axis->inverse_width(cell)));
+        }
+    }
+}
+
+TEST_CASE("Test linear tables")
+{
+    // Bilinear functions are reproduced exactly
+    const std::vector<double> xs{0.0, 0.5, 1.0, 2.0};
+    const std::vector<double> ys{-1.0, 0.0, 1.0};
+    const auto f = [](double x, double y) {
+        return 1.0 + 2.0 * x - 3.0 * y + 0.5 * x * y;
+    };
+    Eigen::VectorXd values(12);
+    for (size_t j = 0; j < ys.size(); ++j) {
+        for (size_t i = 0; i < xs.size(); ++i) {
+            values[static_cast<Eigen::Index>(j * xs.size() + i)] =
+                f(xs[i], ys[j]);
+        }
+    }
+    const LinearTable<2> table{{xs, ys}, values};
+    REQUIRE_FALSE(table.axis(0).is_uniform());
+    REQUIRE(table.axis(1).is_uniform());
+    REQUIRE_THROWS_AS((LinearTable<2>{{xs, ys}, values.head(11)}),
+                      std::invalid_argument);
+
+    LinearTable<2>::Points<DualNumber> points(2, 5);
+    points << DualNumber{0.3, 1.0}, DualNumber{1.7, 0.5},
+        DualNumber{-0.5, 0.0}, DualNumber{2.5, 2.0}, DualNumber{1.0, 1.0},
+        DualNumber{0.2, 0.0}, DualNumber{-0.4, 1.0}, DualNumber{0.9, -1.0},
+        DualNumber{1.5, 0.5}, DualNumber{0.0, 1.0};
+    const auto batch{table.batch(points)};
+    const Eigen::VectorXd plain{table.batch(
+        LinearTable<2>::Points<double>{points.unaryExpr(
+            [](const DualNumber &d) { return d.primal(); })})};
+    algodiff::forward::InterpolationHint<2> hint{};
+    for (Eigen::Index k = 0; k < points.cols(); ++k) {
+        const DualNumber x{points(0, k)};
+        const DualNumber y{points(1, k)};
+        const double value{f(x.primal(), y.primal())};
+        const double tangent{(2.0 + 0.5 * y.primal()) * x.dual() +
+                             (-3.0 + 0.5 * x.primal()) * y.dual()};
+        const DualNumber single{table({x, y}, hint)};
+        REQUIRE(single.primal() == Approx(value));
+        REQUIRE(single.dual() == Approx(tangent));
+        REQUIRE(batch[k].primal() == Approx(value));
+        REQUIRE(batch[k].dual() == Approx(tangent));
+        REQUIRE(plain[k] == Approx(value));
+    }
+
+    // Trilinear interpolation of a piecewise function is continuous at the
+    // knots and linear along every axis between them
+    const LinearTable<3> cube{{std::vector<double>{0.0, 1.0, 3.0},
+                               std::vector<double>{0.0, 1.0},
+                               std::vector<double>{0.0, 2.0}},
+                              Eigen::VectorXd::LinSpaced(12, 0.0, 11.0)
+                                  .array()
+                                  .square()
+                                  .matrix()};
+    REQUIRE(cube({1.0, 1.0, 2.0}) == Approx(100.0));
+    REQUIRE(cube({2.0, 0.0, 0.0}) == Approx(2.5));
+    const DualNumber along{cube(std::array<DualNumber, 3>{
+        DualNumber{2.0, 1.0}, DualNumber{0.0}, DualNumber{0.0}})};
+    REQUIRE(along.dual() == Approx(1.5));
+}
+
+TEST_CASE("Test cubic splines")
+{
+    std::vector<double> knots{};
+    Eigen::VectorXd values(41);
+    for (Eigen::Index i = 0; i < values.size(); ++i) {
+        const double x{0.1 * static_cast<double>(i) +
+                       0.02 * std::sin(static_cast<double>(i))};
+        knots.push_back(x);
+        values[i] = std::sin(x);
+    }
+    const CubicSpline spline{knots, values};
+    REQUIRE_FALSE(spline.axis().is_uniform());
+    REQUIRE_THROWS_AS((CubicSpline{knots, values.head(40)}),
+                      std::invalid_argument);
+
+    Eigen::VectorX<DualNumber> x(7);
+    x << DualNumber{0.05, 1.0}, DualNumber{0.9, 2.0}, DualNumber{1.3, 1.0},
+        DualNumber{2.2, 0.5}, DualNumber{2.21, 1.0}, DualNumber{3.1, 1.0},
+        DualNumber{knots[20], 1.0};
+    const auto batch{spline.batch(x)};
+    const Eigen::VectorXd plain{spline.batch(Eigen::VectorXd{
+        x.unaryExpr([](const DualNumber &d) { return d.primal(); })})};
+    Eigen::Index hint{0};
+    for (Eigen::Index i = 0; i < x.size(); ++i) {
+        const double p{x[i].primal()};
+        const DualNumber single{spline(x[i], hint)};
+        REQUIRE(single.primal() == Approx(std::sin(p)).margin(1e-4));
+        REQUIRE(single.dual() ==
+                Approx(std::cos(p) * x[i].dual()).margin(1e-3));
+        REQUIRE(batch[i].primal() == Approx(single.primal()));
+        REQUIRE(batch[i].dual() == Approx(single.dual()));
+        REQUIRE(plain[i] == Approx(single.primal()));
+    }
+
+    // The spline interpolates the knots and has a continuous derivative
+    for (size_t i = 1; i + 1 < knots.size(); ++i) {
+        const double left{spline(DualNumber{knots[i] - 1e-12, 1.0}).dual()};
+        const double right{spline(DualNumber{knots[i], 1.0}).dual()};
+        REQUIRE(spline(knots[i]) ==
+                Approx(values[static_cast<Eigen::Index>(i)]));
+        REQUIRE(left == Approx(right).margin(1e-8));
+    }
+
+    // Two knots give a straight line
+    const CubicSpline line{{0.0, 2.0}, Eigen::Vector2d{1.0, 5.0}};
+    const DualNumber outside{line(DualNumber{3.0, 1.0})};
+    REQUIRE(outside.primal() == Approx(7.0));
+    REQUIRE(outside.dual() == Approx(2.0));
+}
@@ -0,0 +1,111 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+#include <stdexcept>
+
+#include <Eigen/IterativeLinearSolvers>
+#include <unsupported/Eigen/IterativeSolvers>
+
+#include "algodiff/jacobian_operator.hpp"
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "algodiff/reverse_mode.hpp"
+#include "algodiff/tape_ops.hpp"
+
+using algodiff::reverse::JacobianOperator;
+using algodiff::reverse::Variable;
+using Catch::Approx;
+
+namespace
+{
+// A discretized reaction-diffusion residual; its jacobian is symmetric
+// positive definite
+auto residual(const Eigen::VectorX<Variable> &x) -> Eigen::VectorX<Variable>
+{
+    const auto n{x.size()};
+    Eigen::VectorX<Variable> r(n);
+    for (Eigen::Index i = 0; i < n; ++i) {
+        r[i] = 4.0 * x[i] + 0.5 * algodiff::reverse::sin(x[i]);
+        if (i > 0) {
+            r[i] -= x[i - 1];
+        }
+        if (i + 1 < n) {
+            r[i] -= x[i + 1];
+        }
+    }
+    return r;
+}
+
+// A function with more outputs than inputs
+auto skinny(const Eigen::VectorX<Variable> &x) -> Eigen::VectorX<Variable>
+{
+    Eigen::VectorX<Variable> y(3);
+    y[0] = x[0] * x[1];
+    y[1] = algodiff::reverse::exp(x[1]) - x[0];
+    y[2] = x[0] / x[1];
+    return y;
+}
+
+} // namespace
+
+TEST_CASE("Test jacobian operator products")
+{
+    Eigen::VectorXd u(2);
+    u << 0.7, 1.3;
+    const JacobianOperator op{skinny, u};
+    const Eigen::MatrixXd jac{algodiff::reverse::jacobian(skinny, u)};
+
+    REQUIRE(op.rows() == 3);
+    REQUIRE(op.cols() == 2);
+    REQUIRE(op.value()[0] == Approx(u[0] * u[1]));
+
+    Eigen::VectorXd v(2);
+    v << -0.4, 2.5;
+    const Eigen::VectorXd jv{op * v};
+    Eigen::VectorXd w(3);
+    w << 1.0, -2.0, 0.5;
+    const Eigen::VectorXd jtw{op.vjp(w)};
+    const Eigen::VectorXd expected_jv{jac * v};
+    const Eigen::VectorXd expected_jtw{jac.transpose() * w};
+    for (Eigen::Index i = 0; i < 3; ++i) {
+        REQUIRE(jv[i] == Approx(expected_jv[i]));
+    }
+    for (Eigen::Index i = 0; i < 2; ++i) {
+        REQUIRE(jtw[i] == Approx(expected_jtw[i]));
+    }
+
+    REQUIRE_THROWS_AS(op.jvp(w), std::invalid_argument);
+    REQUIRE_THROWS_AS(op.vjp(v), std::invalid_argument);
+}
+
+TEST_CASE("Test jacobian operator with iterative solvers")
+{
+    constexpr Eigen::Index n{50};
+    const Eigen::VectorXd u{Eigen::VectorXd::LinSpaced(n, -1.0, 1.0)};
+    const JacobianOperator op{residual, u};
+    const Eigen::MatrixXd jac{algodiff::reverse::jacobian(residual, u)};
+    const Eigen::VectorXd b{Eigen::VectorXd::Ones(n)};
+
+    Eigen::BiCGSTAB<JacobianOperator, Eigen::IdentityPreconditioner> bicgstab;
+    bicgstab.compute(op);
+    const Eigen::VectorXd x_bicgstab{bicgstab.solve(b)};
+    REQUIRE(bicgstab.info() == Eigen::Success);
+    REQUIRE((jac * x_bicgstab - b).norm() < 1e-8);
+
+    Eigen::ConjugateGradient<JacobianOperator, Eigen::Lower | Eigen::Upper,
+                             Eigen::IdentityPreconditioner>
+        cg;
+    cg.compute(op);
+    const Eigen::VectorXd x_cg{cg.solve(b)};
+    REQUIRE(cg.info() == Eigen::Success);
+    REQUIRE((jac * x_cg - b).norm() < 1e-8);
+
+    Eigen::GMRES<JacobianOperator, Eigen::IdentityPreconditioner> gmres;
+    gmres.compute(op);
+    const Eigen::VectorXd x_gmres{gmres.solve(b)};
+    REQUIRE(gmres.info() == Eigen::Success);
+    REQUIRE((jac * x_gmres - b).norm() < 1e-8);
+}
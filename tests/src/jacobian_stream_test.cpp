@@ -0,0 +1,144 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+#include "algodiff/jacobian_stream.hpp"
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "algodiff/dual_number.hpp"
+#include "algodiff/dual_number_ops.hpp"
+#include "algodiff/forward_mode.hpp"
+
+namespace
+{
+constexpr int function_size{2};
+
+auto f(const Eigen::VectorX<algodiff::forward::DualNumber> &x)
+{
+    Eigen::VectorX<algodiff::forward::DualNumber> out(function_size);
+    out[0] = x.sum();
+    out[1] = algodiff::forward::sin(x[0]) * x[x.size() - 1];
+    return out;
+}
+
+auto input(Eigen::Index size) -> Eigen::VectorXd
+{
+    return Eigen::VectorXd::LinSpaced(size, 0.1, 2.0);
+}
+
+} // namespace
+
+TEST_CASE("Pull based jacobian stream", "[Jacobian Stream]")
+{
+    const Eigen::VectorXd u{input(11)};
+    const Eigen::MatrixXd expected{
+        algodiff::forward::jacobian<function_size>(f, u)};
+
+    SECTION("chunks cover every column in order")
+    {
+        algodiff::forward::JacobianStreamOptions options{};
+        options.chunk_size = 3;
+        options.capacity = 1;
+        algodiff::forward::JacobianStream<function_size> stream{f, u, options};
+
+        Eigen::Index next_column{0};
+        while (auto chunk = stream.next()) {
+            REQUIRE(chunk->first_column == next_column);
+            REQUIRE(chunk->columns.cols() <= 3);
+            for (Eigen::Index j = 0; j < chunk->columns.cols(); ++j) {
+                for (int i = 0; i < function_size; ++i) {
+                    REQUIRE(Catch::Approx(chunk->columns(i, j)) ==
+                            expected(i, next_column + j));
+                }
+            }
+            next_column += chunk->columns.cols();
+        }
+        REQUIRE(next_column == u.size());
+        REQUIRE_FALSE(stream.next().has_value());
+    }
+
+    SECTION("exceptions are rethrown by the consumer")
+    {
+        auto throwing =
+            [](const Eigen::VectorX<algodiff::forward::DualNumber> &x)
+            -> Eigen::VectorX<algodiff::forward::DualNumber> {
+            if (x[4].dual() != 0.0) {
+                throw std::runtime_error("column 4");
+            }
+            return f(x);
+        };
+        algodiff::forward::JacobianStream<function_size> stream{throwing, u};
+        int chunks{0};
+        REQUIRE_THROWS_AS(
+            [&] {
+                while (stream.next()) {
+                    ++chunks;
+                }
+            }(),
+            std::runtime_error);
+        REQUIRE(chunks == 4);
+    }
+
+    SECTION("destroying the stream early stops the producer")
+    {
+        algodiff::forward::JacobianStream<function_size> stream{f, u};
+        REQUIRE(stream.next().has_value());
+    }
+}
+
+TEST_CASE("Push based jacobian stream", "[Jacobian Stream]")
+{
+    const Eigen::VectorXd u{input(16)};
+    const Eigen::MatrixXd expected{
+        algodiff::forward::jacobian<function_size>(f, u)};
+
+    SECTION("producer stays within the buffer bound of a slow consumer")
+    {
+        std::atomic<Eigen::Index> produced{0};
+        auto counting =
+            [&](const Eigen::VectorX<algodiff::forward::DualNumber> &x) {
+            ++produced;
+            return f(x);
+        };
+
+        constexpr Eigen::Index chunk_size{2};
+        constexpr size_t capacity{1};
+        algodiff::forward::JacobianStreamOptions options{};
+        options.chunk_size = chunk_size;
+        options.capacity = capacity;
+        Eigen::Index consumed{0};
+        Eigen::MatrixXd result(function_size, u.size());
+        algodiff::forward::stream_jacobian<function_size>(
+            counting, u,
+            [&](const algodiff::forward::JacobianChunk<function_size> &chunk) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                consumed += chunk.columns.cols();
+                // One queued chunk plus the one in progress
+                REQUIRE(produced - consumed <=
+                        static_cast<Eigen::Index>(capacity + 1) * chunk_size);
+                result.middleCols(chunk.first_column, chunk.columns.cols()) =
+                    chunk.columns;
+            },
+            options);
+
+        REQUIRE(consumed == u.size());
+        REQUIRE(result.isApprox(expected));
+    }
+
+    SECTION("sink can stop the stream")
+    {
+        int calls{0};
+        algodiff::forward::stream_jacobian<function_size>(
+            f, u, [&](const algodiff::forward::JacobianChunk<function_size> &) {
+                return ++calls < 3;
+            });
+        REQUIRE(calls == 3);
+    }
+}
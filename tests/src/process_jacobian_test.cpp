@@ -0,0 +1,111 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+#include <cstdlib>
+#include <stdexcept>
+
+#include "algodiff/process_jacobian.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "algodiff/dual_number.hpp"
+#include "algodiff/dual_number_ops.hpp"
+#include "algodiff/forward_mode.hpp"
+#include "algodiff/mapped_file.hpp"
+
+using algodiff::forward::DualNumber;
+using algodiff::forward::jacobian;
+using algodiff::forward::process_jacobian;
+
+namespace
+{
+constexpr int function_size{3};
+constexpr Eigen::Index input_size{11};
+
+// Legacy style scratch space shared by every call, unsafe on threads
+Eigen::VectorX<DualNumber> scratch{}; // NOLINT
+
+auto legacy(const Eigen::VectorX<DualNumber> &x) -> Eigen::VectorX<DualNumber>
+{
+    scratch = x;
+    for (Eigen::Index i = 1; i < scratch.size(); ++i) {
+        scratch[i] += algodiff::forward::sin(scratch[i - 1]);
+    }
+    Eigen::VectorX<DualNumber> y(function_size);
+    y[0] = scratch.sum();
+    y[1] = scratch[0] * scratch[scratch.size() - 1];
+    y[2] = algodiff::forward::exp(0.1 * scratch[3]);
+    return y;
+}
+
+// Returns the seeded column of a forward pass
+auto seeded_column(const Eigen::VectorX<DualNumber> &x) -> Eigen::Index
+{
+    for (Eigen::Index i = 0; i < x.size(); ++i) {
+        if (x[i].dual() != 0.0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+} // namespace
+
+TEST_CASE("Process jacobians match the serial jacobian", "[ProcessJacobian]")
+{
+    const Eigen::VectorXd u{Eigen::VectorXd::LinSpaced(input_size, -1.0, 1.0)};
+    algodiff::forward::ProcessJacobianOptions options{};
+    options.processes = 3;
+    options.shard_columns = 2;
+
+    const Eigen::MatrixXd jac{
+        process_jacobian<function_size>(legacy, u, options)};
+    REQUIRE(jac.isApprox(jacobian<function_size>(legacy, u)));
+
+    options.shard_columns = 0;
+    REQUIRE(process_jacobian<function_size>(legacy, u, options).isApprox(jac));
+}
+
+TEST_CASE("Crashed shards are dispatched again", "[ProcessJacobian]")
+{
+    const algodiff::MappedFile visits{
+        algodiff::MappedFile::shared_memory(sizeof(int) * input_size)};
+    auto *counts{reinterpret_cast<int *>(visits.data())}; // NOLINT
+    auto crash_once = [&](const Eigen::VectorX<DualNumber> &x) {
+        const auto col{seeded_column(x)};
+        if (col == 4 && counts[col]++ == 0) {
+            std::_Exit(EXIT_FAILURE);
+        }
+        return legacy(x);
+    };
+
+    const Eigen::VectorXd u{Eigen::VectorXd::LinSpaced(input_size, 0.0, 2.0)};
+    algodiff::forward::ProcessJacobianOptions options{};
+    options.processes = 2;
+    options.shard_columns = 3;
+    const Eigen::MatrixXd jac{
+        process_jacobian<function_size>(crash_once, u, options)};
+
+    REQUIRE(counts[4] == 2);
+    REQUIRE(jac.isApprox(jacobian<function_size>(legacy, u)));
+}
+
+TEST_CASE("Shards that keep failing are reported", "[ProcessJacobian]")
+{
+    auto always_throw = [](const Eigen::VectorX<DualNumber> &x) {
+        if (seeded_column(x) == 5) {
+            throw std::domain_error("outside the table");
+        }
+        return legacy(x);
+    };
+
+    const Eigen::VectorXd u{Eigen::VectorXd::Zero(input_size)};
+    algodiff::forward::ProcessJacobianOptions options{};
+    options.processes = 2;
+    options.shard_columns = 1;
+    options.max_attempts = 2;
+    REQUIRE_THROWS_AS(
+        process_jacobian<function_size>(always_throw, u, options),
+        std::runtime_error);
+}
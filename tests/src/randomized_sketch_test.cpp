@@ -0,0 +1,147 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+#include <cmath>
+#include <stdexcept>
+
+#include "algodiff/randomized_sketch.hpp"
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "algodiff/dual_number.hpp"
+#include "algodiff/dual_number_ops.hpp"
+#include "algodiff/forward_mode.hpp"
+
+using algodiff::forward::DualNumber;
+using Catch::Approx;
+
+namespace
+{
+constexpr int size{12};
+
+// A jacobian of rank two: a sin(b^T x) + c (d^T x)
+auto low_rank(const Eigen::VectorX<DualNumber> &x) -> Eigen::VectorX<DualNumber>
+{
+    DualNumber bx{0.0};
+    DualNumber dx{0.0};
+    for (Eigen::Index i = 0; i < x.size(); ++i) {
+        bx += x[i] * (0.1 * static_cast<double>(i) - 0.5);
+        dx += x[i] * std::cos(static_cast<double>(i));
+    }
+    Eigen::VectorX<DualNumber> y(size);
+    for (Eigen::Index i = 0; i < size; ++i) {
+        const auto t{static_cast<double>(i)};
+        y[i] = algodiff::forward::sin(bx) * (1.0 + t) + dx * std::sin(t);
+    }
+    return y;
+}
+
+// A tridiagonal jacobian
+auto tridiagonal(const Eigen::VectorX<DualNumber> &x)
+    -> Eigen::VectorX<DualNumber>
+{
+    Eigen::VectorX<DualNumber> y(size);
+    for (Eigen::Index i = 0; i < size; ++i) {
+        y[i] = algodiff::forward::exp(x[i]) * static_cast<double>(i + 1);
+        if (i > 0) {
+            y[i] += x[i - 1] * x[i];
+        }
+        if (i + 1 < size) {
+            y[i] -= 2.0 * x[i + 1];
+        }
+    }
+    return y;
+}
+
+// The gradient of sum(x_i^3), whose hessian is diag(6 x_i)
+auto cubic_gradient(const Eigen::VectorX<DualNumber> &x)
+    -> Eigen::VectorX<DualNumber>
+{
+    Eigen::VectorX<DualNumber> g(x.size());
+    for (Eigen::Index i = 0; i < x.size(); ++i) {
+        g[i] = 3.0 * x[i] * x[i];
+    }
+    return g;
+}
+
+auto point() -> Eigen::VectorXd
+{
+    return Eigen::VectorXd::LinSpaced(size, -0.8, 0.9);
+}
+
+} // namespace
+
+TEST_CASE("Test jacobian sketch and range finder")
+{
+    const Eigen::VectorXd u{point()};
+    const Eigen::MatrixXd jac{algodiff::forward::jacobian<size>(low_rank, u)};
+
+    const Eigen::MatrixXd directions{Eigen::MatrixXd::Random(size, 3)};
+    const Eigen::MatrixXd sketch{
+        algodiff::forward::jacobian_sketch<size>(low_rank, u, directions)};
+    REQUIRE((sketch - jac * directions).norm() < 1e-10);
+    REQUIRE_THROWS_AS(algodiff::forward::jacobian_sketch<size>(
+                          low_rank, u, Eigen::MatrixXd::Ones(2, 1)),
+                      std::invalid_argument);
+
+    const Eigen::MatrixXd q{
+        algodiff::forward::randomized_range<size>(low_rank, u, 2, 2)};
+    REQUIRE(q.cols() == 4);
+    REQUIRE((q.transpose() * q - Eigen::MatrixXd::Identity(4, 4)).norm() <
+            1e-10);
+    REQUIRE((jac - q * (q.transpose() * jac)).norm() < 1e-8 * jac.norm());
+}
+
+TEST_CASE("Test randomized trace estimation")
+{
+    const Eigen::VectorXd u{point()};
+
+    // Random sign probes recover the trace of a diagonal matrix exactly
+    const double hessian_trace{6.0 * u.sum()};
+    REQUIRE(algodiff::forward::hutchinson_trace<size>(cubic_gradient, u, 1) ==
+            Approx(hessian_trace));
+
+    // Hutch++ is exact once its subspace captures the whole range
+    const Eigen::MatrixXd jac{algodiff::forward::jacobian<size>(low_rank, u)};
+    REQUIRE(algodiff::forward::hutchpp_trace<size>(low_rank, u, 9) ==
+            Approx(jac.trace()));
+
+    const Eigen::MatrixXd tri{
+        algodiff::forward::jacobian<size>(tridiagonal, u)};
+    const double estimate{
+        algodiff::forward::hutchinson_trace<size>(tridiagonal, u, 2000, 7)};
+    REQUIRE(std::abs(estimate - tri.trace()) < 0.1 * std::abs(tri.trace()));
+
+    REQUIRE_THROWS_AS(algodiff::forward::hutchpp_trace<size>(low_rank, u, 2),
+                      std::invalid_argument);
+    REQUIRE_THROWS_AS(algodiff::forward::hutchinson_trace<size>(
+                          low_rank, Eigen::VectorXd::Zero(3), 4),
+                      std::invalid_argument);
+}
+
+TEST_CASE("Test diagonal estimation")
+{
+    const Eigen::VectorXd u{point()};
+    const Eigen::MatrixXd tri{
+        algodiff::forward::jacobian<size>(tridiagonal, u)};
+
+    // Three probes separate the entries of a tridiagonal matrix
+    const Eigen::VectorXd probed{
+        algodiff::forward::probing_diagonal<size>(tridiagonal, u, 3)};
+    for (Eigen::Index i = 0; i < size; ++i) {
+        REQUIRE(probed[i] == Approx(tri(i, i)));
+    }
+
+    const Eigen::VectorXd hessian_diagonal{
+        algodiff::forward::stochastic_diagonal<size>(cubic_gradient, u, 1)};
+    for (Eigen::Index i = 0; i < size; ++i) {
+        REQUIRE(hessian_diagonal[i] == Approx(6.0 * u[i]));
+    }
+
+    const Eigen::VectorXd estimate{
+        algodiff::forward::stochastic_diagonal<size>(tridiagonal, u, 4000, 3)};
+    REQUIRE((estimate - tri.diagonal()).norm() <
+            0.1 * tri.diagonal().norm());
+}
@@ -0,0 +1,185 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+#include <cmath>
+#include <memory>
+
+#include <Eigen/LU>
+
+#include "algodiff/reverse_mode.hpp"
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "algodiff/dual_number.hpp"
+#include "algodiff/dual_number_ops.hpp"
+#include "algodiff/forward_mode.hpp"
+#include "algodiff/tape.hpp"
+#include "algodiff/tape_ops.hpp"
+
+using algodiff::reverse::ExternalFunction;
+using algodiff::reverse::Tape;
+using algodiff::reverse::Variable;
+
+namespace
+{
+// Exercises every recorded operation on three inputs
+template <typename T> auto mixed(const Eigen::VectorX<T> &x) -> T
+{
+    using std::abs;
+    using std::acos;
+    using std::asin;
+    using std::atan;
+    using std::cos;
+    using std::cosh;
+    using std::exp;
+    using std::log;
+    using std::pow;
+    using std::sin;
+    using std::sinh;
+    using std::sqrt;
+    using std::tan;
+    using std::tanh;
+    const T a{x[0] * x[1] - x[2] / x[0]};
+    const T b{sin(a) + cos(x[1]) * tan(x[2]) + exp(x[0]) / sqrt(x[1])};
+    const T c{log(x[1]) + pow(x[0], 3.0) + pow(x[1], x[0]) + abs(-x[2])};
+    const T d{asin(x[2]) + acos(x[2]) * atan(x[0]) + sinh(x[2]) * cosh(x[0])};
+    return (2.0 - b) * c + tanh(d) / 3.0 - 1.0 / x[1] + 4.0 * (x[0] + 1.0);
+}
+
+// Solves the 3x3 system A(x) y = b with A = diag(x) + ones, as a library
+// routine that only works on doubles would
+auto solve(const Eigen::VectorXd &x) -> Eigen::VectorXd
+{
+    const Eigen::Matrix3d A{Eigen::Matrix3d(x.head<3>().asDiagonal()) +
+                            Eigen::Matrix3d::Ones()};
+    return A.partialPivLu().solve(Eigen::Vector3d{1.0, 2.0, 3.0});
+}
+
+// dy/dx_j = -A^-1 (dA/dx_j) y = -A^-1 e_j y_j
+auto solve_jacobian(const Eigen::VectorXd &x) -> Eigen::MatrixXd
+{
+    const Eigen::Matrix3d A{Eigen::Matrix3d(x.head<3>().asDiagonal()) +
+                            Eigen::Matrix3d::Ones()};
+    const Eigen::Vector3d y{solve(x)};
+    return -A.inverse() * Eigen::Matrix3d(y.asDiagonal());
+}
+
+template <typename T>
+auto solve_objective(const Eigen::VectorX<T> &y) -> T
+{
+    return y[0] * y[0] + 2.0 * y[1] - y[2] * y[0];
+}
+
+} // namespace
+
+TEST_CASE("Reverse mode gradients match forward mode", "[Tape]")
+{
+    const Eigen::Vector3d u{0.7, 1.3, 0.4};
+    const Eigen::VectorXd grad{algodiff::reverse::gradient(
+        [](const Eigen::VectorX<Variable> &x) { return mixed(x); },
+        Eigen::VectorXd{u})};
+    const Eigen::VectorXd expected{algodiff::forward::gradient(
+        [](const Eigen::Vector3<algodiff::forward::DualNumber> &x) {
+            return mixed(Eigen::VectorX<algodiff::forward::DualNumber>{x});
+        },
+        u)};
+
+    REQUIRE(grad.isApprox(expected));
+}
+
+TEST_CASE("Tapes can be replayed at new inputs", "[Tape]")
+{
+    Tape tape{};
+    algodiff::reverse::record(
+        tape, [](const Eigen::VectorX<Variable> &x) { return mixed(x); },
+        Eigen::VectorXd{Eigen::Vector3d{0.7, 1.3, 0.4}});
+
+    const Eigen::VectorXd v{Eigen::Vector3d{0.5, 1.1, -0.2}};
+    const Eigen::VectorXd y{tape.replay(v)};
+    REQUIRE(y[0] == Catch::Approx(mixed(v)));
+
+    const Eigen::VectorXd expected{algodiff::reverse::gradient(
+        [](const Eigen::VectorX<Variable> &x) { return mixed(x); }, v)};
+    REQUIRE(tape.vjp(Eigen::VectorXd::Ones(1)).isApprox(expected));
+    REQUIRE_THROWS_AS(tape.replay(Eigen::VectorXd::Zero(2)),
+                      std::invalid_argument);
+}
+
+TEST_CASE("External functions with a jacobian record one node per output",
+          "[Tape]")
+{
+    auto function{std::make_shared<ExternalFunction>()};
+    function->primal = solve;
+    function->jacobian = solve_jacobian;
+
+    const Eigen::VectorXd u{Eigen::Vector3d{2.0, 3.0, 4.0}};
+    Tape tape{};
+    algodiff::reverse::record(
+        tape,
+        [&](const Eigen::VectorX<Variable> &x) {
+            return solve_objective(algodiff::reverse::call(function, x));
+        },
+        u);
+
+    // 3 inputs, 3 call outputs and a handful of nodes for the objective
+    REQUIRE(tape.size() < 12);
+
+    const Eigen::Vector3d y{solve(u)};
+    const Eigen::Vector3d weights{2.0 * y[0] - y[2], 2.0, -y[0]};
+    const Eigen::VectorXd expected{solve_jacobian(u).transpose() * weights};
+    REQUIRE(tape.vjp(Eigen::VectorXd::Ones(1)).isApprox(expected));
+
+    // The local jacobian is refreshed on replay
+    const Eigen::VectorXd v{Eigen::Vector3d{1.0, 5.0, 2.5}};
+    tape.replay(v);
+    const Eigen::Vector3d z{solve(v)};
+    const Eigen::Vector3d new_weights{2.0 * z[0] - z[2], 2.0, -z[0]};
+    REQUIRE(tape.vjp(Eigen::VectorXd::Ones(1))
+                .isApprox(solve_jacobian(v).transpose() * new_weights));
+}
+
+TEST_CASE("External functions with a vjp are called once per sweep",
+          "[Tape]")
+{
+    int vjp_calls{0};
+    auto function{std::make_shared<ExternalFunction>()};
+    function->primal = solve;
+    function->vjp = [&](const Eigen::VectorXd &x, const Eigen::VectorXd &y,
+                        const Eigen::VectorXd &w) -> Eigen::VectorXd {
+        ++vjp_calls;
+        REQUIRE(y.isApprox(solve(x)));
+        return solve_jacobian(x).transpose() * w;
+    };
+
+    const Eigen::VectorXd u{Eigen::Vector3d{2.0, 3.0, 4.0}};
+    const Eigen::MatrixXd jac{algodiff::reverse::jacobian(
+        [&](const Eigen::VectorX<Variable> &x) {
+            return Eigen::VectorX<Variable>{
+                2.0 * algodiff::reverse::call(function, x)};
+        },
+        u)};
+
+    REQUIRE(vjp_calls == 3);
+    REQUIRE(jac.isApprox(2.0 * solve_jacobian(u)));
+}
+
+TEST_CASE("Tapes reject foreign and incomplete inputs", "[Tape]")
+{
+    Tape first{};
+    Tape second{};
+    const Variable x{first.variable(1.0)};
+    const Variable y{second.variable(2.0)};
+
+    REQUIRE_THROWS_AS(x + y, std::invalid_argument);
+    REQUIRE_THROWS_AS(first.register_output(y), std::invalid_argument);
+    REQUIRE_THROWS_AS(first.call(std::make_shared<ExternalFunction>(), {x}),
+                      std::invalid_argument);
+
+    // Passive values record nothing
+    const Variable passive{Variable{2.0} * 3.0 + 1.0};
+    REQUIRE(passive.value() == 7.0);
+    REQUIRE_FALSE(passive.is_active());
+    REQUIRE(first.size() == 1);
+}
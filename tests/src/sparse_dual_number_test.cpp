@@ -0,0 +1,174 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+#include <cmath>
+
+#include "algodiff/sparse_dual_number.hpp"
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "algodiff/dual_number.hpp"
+#include "algodiff/dual_number_ops.hpp"
+#include "algodiff/forward_mode.hpp"
+#include "algodiff/sparse_dual_number_ops.hpp"
+#include "algodiff/sparse_forward_mode.hpp"
+
+using algodiff::forward::SparseDualNumber;
+using algodiff::forward::SparseTangent;
+
+namespace
+{
+// Sum of x_i^2 x_{i+1} + sin(x_i) exp(x_{i+1}) over neighbouring pairs
+template <typename T> auto chain(const Eigen::VectorX<T> &x) -> T
+{
+    using std::exp;
+    using std::sin;
+    T result{0.0};
+    for (Eigen::Index i = 0; i + 1 < x.size(); ++i) {
+        result += x[i] * x[i] * x[i + 1] + sin(x[i]) * exp(x[i + 1]);
+    }
+    return result;
+}
+
+// A 1D diffusion stencil with a nonlinear reaction term
+template <typename T>
+auto stencil(const Eigen::VectorX<T> &x) -> Eigen::VectorX<T>
+{
+    using std::log;
+    using std::sqrt;
+    const auto n{x.size()};
+    Eigen::VectorX<T> y(n);
+    for (Eigen::Index i = 0; i < n; ++i) {
+        y[i] = 2.0 * x[i] - sqrt(x[i]) * log(x[i]);
+        if (i > 0) {
+            y[i] -= x[i - 1];
+        }
+        if (i + 1 < n) {
+            y[i] /= x[i + 1];
+        }
+    }
+    return y;
+}
+
+} // namespace
+
+TEST_CASE("SparseTangent merges indices in order", "[SparseDualNumber]")
+{
+    const SparseTangent x{SparseTangent::combine(1.0, SparseTangent{3, 1.0},
+                                                 2.0, SparseTangent{1, 1.0})};
+    const SparseTangent y{
+        SparseTangent::combine(1.0, x, -1.0, SparseTangent{3, 1.0})};
+
+    REQUIRE(x.size() == 2);
+    REQUIRE(x.begin()->index == 1);
+    REQUIRE(x.coeff(1) == 2.0);
+    REQUIRE(x.coeff(3) == 1.0);
+    REQUIRE(x.coeff(2) == 0.0);
+
+    // Cancellation keeps the entry, so the structure is never data dependent
+    REQUIRE(y.size() == 2);
+    REQUIRE(y.coeff(3) == 0.0);
+}
+
+TEST_CASE("SparseTangent grows past its inline capacity", "[SparseDualNumber]")
+{
+    SparseDualNumber sum{0.0};
+    constexpr Eigen::Index count{100};
+    for (Eigen::Index i = count - 1; i >= 0; --i) {
+        sum += SparseDualNumber::variable(1.0, i) * static_cast<double>(i);
+    }
+
+    REQUIRE(sum.primal() == static_cast<double>(count * (count - 1) / 2));
+    REQUIRE(sum.tangent().size() == static_cast<size_t>(count));
+    for (Eigen::Index i = 0; i < count; ++i) {
+        REQUIRE(sum.tangent().coeff(i) == static_cast<double>(i));
+    }
+
+    const SparseDualNumber copy{sum};
+    SparseDualNumber moved{std::move(sum)};
+    REQUIRE(copy == moved);
+    moved = SparseDualNumber::variable(2.0, 0);
+    REQUIRE(moved.tangent().size() == 1);
+    REQUIRE(copy.tangent().size() == static_cast<size_t>(count));
+}
+
+TEST_CASE("SparseDualNumber elementary functions match DualNumber",
+          "[SparseDualNumber]")
+{
+    using algodiff::forward::DualNumber;
+    constexpr double value{0.4};
+    const SparseDualNumber x{SparseDualNumber::variable(value, 0)};
+    const DualNumber d{value, 1.0};
+
+    auto require_same = [](const SparseDualNumber &sparse,
+                           const DualNumber &dense) {
+        REQUIRE(sparse.primal() == Catch::Approx(dense.primal()));
+        REQUIRE(sparse.tangent().coeff(0) == Catch::Approx(dense.dual()));
+    };
+
+    namespace fwd = algodiff::forward;
+    require_same(fwd::abs(-x), fwd::abs(-d));
+    require_same(fwd::inverse(x), fwd::inverse(d));
+    require_same(fwd::pow(x, 3.0), fwd::pow(d, 3.0));
+    require_same(fwd::pow(x, x), fwd::pow(d, d));
+    require_same(fwd::sqrt(x), fwd::sqrt(d));
+    require_same(fwd::exp(x), fwd::exp(d));
+    require_same(fwd::exp2(x), fwd::exp2(d));
+    require_same(fwd::log(x), fwd::log(d));
+    require_same(fwd::log2(x), fwd::log2(d));
+    require_same(fwd::log10(x), fwd::log10(d));
+    require_same(fwd::log(x, 3.0), fwd::log(d, 3.0));
+    require_same(fwd::sin(x), fwd::sin(d));
+    require_same(fwd::cos(x), fwd::cos(d));
+    require_same(fwd::tan(x), fwd::tan(d));
+    require_same(fwd::asin(x), fwd::asin(d));
+    require_same(fwd::acos(x), fwd::acos(d));
+    require_same(fwd::atan(x), fwd::atan(d));
+    require_same(fwd::sinh(x), fwd::sinh(d));
+    require_same(fwd::cosh(x), fwd::cosh(d));
+    require_same(fwd::tanh(x), fwd::tanh(d));
+    require_same(fwd::asinh(x), fwd::asinh(d));
+    require_same(fwd::acosh(x + 1.0), fwd::acosh(d + 1.0));
+    require_same(fwd::atanh(x), fwd::atanh(d));
+    require_same(2.0 / x, 2.0 / d);
+    require_same(2.0 - x, 2.0 - d);
+}
+
+TEST_CASE("sparse_gradient matches the dense gradient", "[SparseDualNumber]")
+{
+    constexpr Eigen::Index size{12};
+    const Eigen::VectorXd u{Eigen::VectorXd::LinSpaced(size, 0.5, 2.0)};
+
+    const Eigen::SparseVector<double> grad{algodiff::forward::sparse_gradient(
+        [](const auto &x) { return chain(x); }, u)};
+    const Eigen::MatrixXd dense{algodiff::forward::jacobian<1>(
+        [](const auto &x) {
+            return Eigen::VectorX<algodiff::forward::DualNumber>::Constant(
+                1, chain(x));
+        },
+        u)};
+
+    REQUIRE(grad.size() == size);
+    REQUIRE(Eigen::VectorXd(grad).isApprox(dense.transpose()));
+}
+
+TEST_CASE("sparse_jacobian stores only the stencil", "[SparseDualNumber]")
+{
+    constexpr int size{10};
+    const Eigen::VectorXd u{Eigen::VectorXd::LinSpaced(size, 1.5, 3.0)};
+
+    const auto jac{algodiff::forward::sparse_jacobian<Eigen::Dynamic>(
+        [](const auto &x) { return stencil(x); }, u)};
+    const Eigen::MatrixXd dense{algodiff::forward::jacobian<size>(
+        [](const auto &x) { return stencil(x); }, u)};
+
+    REQUIRE(jac.rows() == size);
+    REQUIRE(jac.cols() == size);
+    REQUIRE(jac.nonZeros() == 3 * size - 2);
+    REQUIRE(Eigen::MatrixXd(jac).isApprox(dense));
+    REQUIRE_THROWS_AS(algodiff::forward::sparse_jacobian<3>(
+                          [](const auto &x) { return stencil(x); }, u),
+                      std::invalid_argument);
+}
@@ -0,0 +1,133 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+#include <cmath>
+#include <vector>
+
+#include "algodiff/sparse_hessian.hpp"
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "algodiff/dual_number.hpp"
+#include "algodiff/dual_number_ops.hpp"
+#include "algodiff/forward_mode.hpp"
+
+namespace
+{
+using Vector = Eigen::VectorX<algodiff::forward::DualNumber>;
+
+// Gradient of sum_i x_i^2 x_{i+1} + sin(x_i), whose hessian is tridiagonal
+auto chain_gradient(const Vector &x) -> Vector
+{
+    const auto n{x.size()};
+    Vector g(n);
+    for (Eigen::Index i = 0; i < n; ++i) {
+        g[i] = algodiff::forward::cos(x[i]);
+        if (i + 1 < n) {
+            g[i] += 2.0 * x[i] * x[i + 1];
+        }
+        if (i > 0) {
+            g[i] += x[i - 1] * x[i - 1];
+        }
+    }
+    return g;
+}
+
+// Adds x_0 * sum_{i > 0} x_i^2, which turns the pattern into an arrow
+auto arrow_gradient(const Vector &x) -> Vector
+{
+    Vector g{chain_gradient(x)};
+    for (Eigen::Index i = 1; i < x.size(); ++i) {
+        g[0] += x[i] * x[i];
+        g[i] += 2.0 * x[0] * x[i];
+    }
+    return g;
+}
+
+auto require_lower_triangle_of(const Eigen::SparseMatrix<double> &lower,
+                               const Eigen::MatrixXd &dense) -> void
+{
+    const Eigen::MatrixXd expected{
+        dense.triangularView<Eigen::Lower>().toDenseMatrix()};
+    REQUIRE(Eigen::MatrixXd(lower).isApprox(expected));
+}
+
+// A star coloring is a distance-1 coloring without two colored 4-paths
+auto require_star_coloring(const algodiff::forward::HessianColoring &coloring)
+    -> void
+{
+    const Eigen::MatrixXd adjacency{coloring.adjacency};
+    const auto n{adjacency.rows()};
+    auto color = [&](Eigen::Index v) {
+        return coloring.colors[static_cast<size_t>(v)];
+    };
+    for (Eigen::Index a = 0; a < n; ++a) {
+        for (Eigen::Index b = 0; b < n; ++b) {
+            if (adjacency(a, b) == 0.0) {
+                continue;
+            }
+            REQUIRE(color(a) != color(b));
+            for (Eigen::Index c = 0; c < n; ++c) {
+                if (c == a || adjacency(b, c) == 0.0 || color(c) != color(a)) {
+                    continue;
+                }
+                for (Eigen::Index d = 0; d < n; ++d) {
+                    if (d != b && adjacency(c, d) != 0.0) {
+                        REQUIRE(color(d) != color(b));
+                    }
+                }
+            }
+        }
+    }
+}
+
+} // namespace
+
+TEST_CASE("Sparse hessian", "[Sparse Hessian]")
+{
+    constexpr Eigen::Index n{30};
+    const Eigen::VectorXd u{Eigen::VectorXd::LinSpaced(n, -1.3, 2.1)};
+
+    SECTION("tridiagonal hessian from a detected pattern")
+    {
+        const auto pattern{
+            algodiff::forward::detect_hessian_sparsity(chain_gradient, u)};
+        REQUIRE(pattern.nonZeros() == 2 * n - 1);
+
+        const auto coloring{algodiff::forward::color_hessian(pattern)};
+        require_star_coloring(coloring);
+        REQUIRE(coloring.color_count <= 3);
+
+        const auto hessian{
+            algodiff::forward::sparse_hessian(chain_gradient, u, coloring)};
+        require_lower_triangle_of(
+            hessian, algodiff::forward::jacobian<n>(chain_gradient, u));
+    }
+
+    SECTION("arrow hessian from a full symmetric pattern")
+    {
+        std::vector<Eigen::Triplet<double>> triplets{};
+        for (Eigen::Index i = 0; i < n; ++i) {
+            triplets.emplace_back(i, i, 1.0);
+            triplets.emplace_back(0, i, 1.0);
+            triplets.emplace_back(i, 0, 1.0);
+            if (i + 1 < n) {
+                triplets.emplace_back(i, i + 1, 1.0);
+                triplets.emplace_back(i + 1, i, 1.0);
+            }
+        }
+        Eigen::SparseMatrix<double> pattern(n, n);
+        pattern.setFromTriplets(triplets.begin(), triplets.end());
+
+        const auto coloring{algodiff::forward::color_hessian(pattern)};
+        require_star_coloring(coloring);
+        REQUIRE(coloring.color_count <= 5);
+
+        const auto hessian{
+            algodiff::forward::sparse_hessian(arrow_gradient, u, pattern)};
+        require_lower_triangle_of(
+            hessian, algodiff::forward::jacobian<n>(arrow_gradient, u));
+    }
+}
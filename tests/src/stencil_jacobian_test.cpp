@@ -0,0 +1,152 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+#include "algodiff/stencil_jacobian.hpp"
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "algodiff/dual_number.hpp"
+#include "algodiff/dual_number_ops.hpp"
+#include "algodiff/forward_mode.hpp"
+
+using algodiff::forward::DualNumber;
+using algodiff::forward::StencilBoundary;
+using algodiff::forward::StencilOffsets;
+using algodiff::forward::StructuredGrid;
+using Catch::Approx;
+
+namespace
+{
+const StencilOffsets<2, 5> five_point{
+    {{0, 0}, {-1, 0}, {1, 0}, {0, -1}, {0, 1}}};
+
+// A reaction-diffusion system with two species per grid point
+const auto reaction_diffusion = [](const auto &x) {
+    using Scalar = typename std::decay_t<decltype(x)>::Scalar;
+    Eigen::Matrix<Scalar, 2, 1> r{};
+    const Scalar a_laplacian{x(0, 1) + x(0, 2) + x(0, 3) + x(0, 4) -
+                             4.0 * x(0, 0)};
+    const Scalar b_laplacian{x(1, 1) + x(1, 2) + x(1, 3) + x(1, 4) -
+                             4.0 * x(1, 0)};
+    const Scalar reaction{x(0, 0) * x(1, 0) * x(1, 0)};
+    r[0] = a_laplacian - reaction + 0.05 * (1.0 - x(0, 0));
+    r[1] = 0.5 * b_laplacian + reaction - 0.1 * sin(x(1, 0));
+    return r;
+};
+
+// The residual of the whole grid, differentiated as one function
+template <int Components, size_t Points, class R>
+auto full_residual(const R &residual, const StructuredGrid<2> &grid,
+                   const StencilOffsets<2, Points> &offsets,
+                   const Eigen::VectorX<DualNumber> &u)
+    -> Eigen::VectorX<DualNumber>
+{
+    Eigen::VectorX<DualNumber> result(u.size());
+    for (Eigen::Index point = 0; point < grid.points(); ++point) {
+        Eigen::Matrix<DualNumber, Components, static_cast<int>(Points)> x{};
+        for (size_t k = 0; k < Points; ++k) {
+            const auto n{grid.neighbour(point, offsets[k])};
+            for (int c = 0; c < Components; ++c) {
+                x(c, static_cast<Eigen::Index>(k)) =
+                    n < 0 ? DualNumber{grid.boundary_value}
+                          : u[n * Components + c];
+            }
+        }
+        result.template segment<Components>(point * Components) = residual(x);
+    }
+    return result;
+}
+
+template <int Size, int Components, size_t Points, class R>
+auto check(const R &residual, const StructuredGrid<2> &grid,
+           const StencilOffsets<2, Points> &offsets, const Eigen::VectorXd &u)
+    -> void
+{
+    algodiff::forward::StencilOptions options{};
+    options.chunk_size = 7;
+    options.threads = 3;
+    const auto jac{algodiff::forward::stencil_jacobian<Components>(
+        residual, grid, offsets, u, options)};
+    const Eigen::MatrixXd expected{algodiff::forward::jacobian<Size>(
+        [&](const Eigen::VectorX<DualNumber> &x) {
+            return full_residual<Components>(residual, grid, offsets, x);
+        },
+        u)};
+    REQUIRE(jac.rows() == Size);
+    REQUIRE(jac.isCompressed());
+    const Eigen::MatrixXd dense{jac};
+    for (Eigen::Index row = 0; row < Size; ++row) {
+        for (Eigen::Index col = 0; col < Size; ++col) {
+            REQUIRE(dense(row, col) == Approx(expected(row, col)));
+        }
+    }
+}
+
+} // namespace
+
+TEST_CASE("Test stencil jacobian on a periodic grid")
+{
+    StructuredGrid<2> grid{};
+    grid.shape = {6, 5};
+    const Eigen::VectorXd u{Eigen::VectorXd::LinSpaced(60, -1.0, 2.0)};
+    check<60, 2>(reaction_diffusion, grid, five_point, u);
+
+    // 64 bit indices by default, for grids with billions of non-zeros
+    const auto jac{algodiff::forward::stencil_jacobian<2>(
+        reaction_diffusion, grid, five_point, u)};
+    static_assert(std::is_same_v<std::decay_t<decltype(jac)>::StorageIndex,
+                                 std::int64_t>);
+    REQUIRE(jac.nonZeros() == 60 * 5 * 2);
+    const auto narrow{algodiff::forward::stencil_jacobian<2, int>(
+        reaction_diffusion, grid, five_point, u)};
+    static_assert(std::is_same_v<std::decay_t<decltype(narrow)>::StorageIndex,
+                                 int>);
+    REQUIRE(Eigen::MatrixXd{narrow}.isApprox(Eigen::MatrixXd{jac}));
+
+    const Eigen::VectorXd residual{algodiff::forward::stencil_residual<2>(
+        reaction_diffusion, grid, five_point, u)};
+    Eigen::VectorX<DualNumber> x{u.cast<DualNumber>()};
+    const auto expected{
+        full_residual<2>(reaction_diffusion, grid, five_point, x)};
+    for (Eigen::Index i = 0; i < u.size(); ++i) {
+        REQUIRE(residual[i] == Approx(expected[i].primal()));
+    }
+
+    REQUIRE_THROWS_AS(algodiff::forward::stencil_jacobian<2>(
+                          reaction_diffusion, grid, five_point,
+                          Eigen::VectorXd::Zero(59)),
+                      std::invalid_argument);
+}
+
+TEST_CASE("Test stencil jacobian boundaries")
+{
+    const Eigen::VectorXd u{Eigen::VectorXd::LinSpaced(6, 0.5, 1.5)};
+    const auto poisson = [](const auto &x) {
+        using Scalar = typename std::decay_t<decltype(x)>::Scalar;
+        return Eigen::Matrix<Scalar, 1, 1>{x(0, 1) + x(0, 2) + x(0, 3) +
+                                           x(0, 4) - 4.0 * x(0, 0) +
+                                           exp(x(0, 0))};
+    };
+
+    // Along the first axis both neighbours are the same point
+    StructuredGrid<2> periodic{};
+    periodic.shape = {2, 3};
+    check<6, 1>(poisson, periodic, five_point, u);
+
+    StructuredGrid<2> constant{};
+    constant.shape = {2, 3};
+    constant.boundary = StencilBoundary::Constant;
+    constant.boundary_value = 1.0;
+    check<6, 1>(poisson, constant, five_point, u);
+    const auto jac{algodiff::forward::stencil_jacobian<1>(
+        poisson, constant, five_point, u)};
+    // Every point has one neighbour along the first axis and one or two along
+    // the second
+    REQUIRE(jac.nonZeros() == 6 * 2 + 4 * 1 + 2 * 2);
+}
@@ -0,0 +1,154 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+
+#include "algodiff/tape_batch.hpp"
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "algodiff/reverse_mode.hpp"
+#include "algodiff/tape.hpp"
+#include "algodiff/tape_ops.hpp"
+
+using algodiff::reverse::Tape;
+using algodiff::reverse::TapeBatch;
+using algodiff::reverse::Variable;
+using Catch::Approx;
+
+namespace
+{
+// A piecewise function of every recorded operation
+auto piecewise(const Eigen::VectorX<Variable> &x) -> Eigen::VectorX<Variable>
+{
+    Eigen::VectorX<Variable> y(2);
+    if (algodiff::reverse::branch(x[0] - x[1])) {
+        y[0] = x[0] * sin(x[1]) + exp(x[0]) / sqrt(x[1]) - tan(x[2]);
+    } else {
+        y[0] = log(x[1]) * x[0] * x[0] + pow(x[1], x[0]) - 2.0 / x[1];
+    }
+    y[1] = asin(x[2]) + acos(x[2]) * atan(x[0]) + sinh(x[2]) * cosh(x[0]) +
+           tanh(x[1] - x[0]) + abs(-x[2]) + pow(x[0], 3.0) + cos(x[2]) +
+           (4.0 - x[0]) * 0.5;
+    return y;
+}
+
+auto points(Eigen::Index count) -> Eigen::MatrixXd
+{
+    Eigen::MatrixXd result(3, count);
+    for (Eigen::Index k = 0; k < count; ++k) {
+        const double t{static_cast<double>(k) / static_cast<double>(count)};
+        result.col(k) << 0.2 + 1.5 * t, 1.4 - t, 0.8 * t - 0.35;
+    }
+    return result;
+}
+
+} // namespace
+
+TEST_CASE("Test guards")
+{
+    Tape tape{};
+    const auto x{tape.variable(2.0)};
+    const auto y{tape.variable(3.0)};
+    REQUIRE(algodiff::reverse::branch(x - y) == false);
+    REQUIRE(algodiff::reverse::branch(y - x) == true);
+    REQUIRE(algodiff::reverse::branch(Variable{1.0}) == true);
+    REQUIRE(tape.guards().size() == 2);
+    REQUIRE(tape.guards()[0].positive == false);
+    REQUIRE(tape.guards()[1].positive == true);
+    tape.clear();
+    REQUIRE(tape.guards().empty());
+}
+
+TEST_CASE("Test batched replays")
+{
+    const Eigen::Vector3d u{1.2, 0.5, 0.1};
+    TapeBatch batch{piecewise, u, 8};
+    REQUIRE(batch.input_count() == 3);
+    REQUIRE(batch.output_count() == 2);
+    REQUIRE(batch.lanes() == 8);
+    REQUIRE(batch.tape().guards().size() == 1);
+
+    // 21 points, so the last block is only partly filled
+    const Eigen::MatrixXd x{points(21)};
+    Eigen::MatrixXd weights(2, x.cols());
+    weights.row(0).setLinSpaced(1.0, 2.0);
+    weights.row(1).setLinSpaced(-1.0, 0.5);
+    const Eigen::MatrixXd y{batch.replay(x)};
+    const Eigen::MatrixXd g{batch.vjp(x, weights)};
+
+    Eigen::Index other{0};
+    for (Eigen::Index k = 0; k < x.cols(); ++k) {
+        Tape tape{};
+        algodiff::reverse::record(tape, piecewise, x.col(k));
+        other += x(0, k) > x(1, k) ? 0 : 1;
+        const Eigen::VectorXd expected{tape.vjp(weights.col(k))};
+        for (std::size_t i = 0; i < 2; ++i) {
+            REQUIRE(y(static_cast<Eigen::Index>(i), k) ==
+                    Approx(tape.values()[tape.outputs()[i]]));
+        }
+        for (Eigen::Index i = 0; i < 3; ++i) {
+            REQUIRE(g(i, k) == Approx(expected[i]));
+        }
+    }
+    REQUIRE(other > 0);
+    REQUIRE(other < x.cols());
+    REQUIRE(batch.fallbacks() == other);
+
+    REQUIRE_THROWS_AS(batch.replay(Eigen::MatrixXd::Zero(2, 4)),
+                      std::invalid_argument);
+    REQUIRE_THROWS_AS(batch.vjp(x, Eigen::MatrixXd::Zero(2, 4)),
+                      std::invalid_argument);
+    REQUIRE_THROWS_AS((TapeBatch{piecewise, u, 0}), std::invalid_argument);
+
+    // External calls are not batched
+    auto function{std::make_shared<algodiff::reverse::ExternalFunction>()};
+    function->primal = [](const Eigen::VectorXd &z) { return z; };
+    function->jacobian = [](const Eigen::VectorXd &z) {
+        return Eigen::MatrixXd::Identity(z.size(), z.size());
+    };
+    const auto external = [&](const Eigen::VectorX<Variable> &z) {
+        return algodiff::reverse::call(function, z);
+    };
+    REQUIRE_THROWS_AS((TapeBatch{external, u}), std::invalid_argument);
+}
+
+TEST_CASE("Batched replays against Tape::replay", "[.][benchmark]")
+{
+    // Every point takes the recorded branch, so nothing falls back
+    Eigen::MatrixXd x{points(4096)};
+    x.row(0).array() += 1.5;
+    const Eigen::MatrixXd weights{Eigen::MatrixXd::Ones(2, x.cols())};
+    TapeBatch batch{piecewise, Eigen::Vector3d{1.2, 0.5, 0.1}};
+    Tape tape{};
+    algodiff::reverse::record(tape, piecewise, Eigen::Vector3d{1.2, 0.5, 0.1});
+
+    const auto time = [&](auto &&run) {
+        const auto start{std::chrono::steady_clock::now()};
+        const double sink{run()};
+        const std::chrono::duration<double, std::nano> elapsed{
+            std::chrono::steady_clock::now() - start};
+        REQUIRE(std::isfinite(sink));
+        return elapsed.count() / static_cast<double>(x.cols());
+    };
+    const double baseline{time([&] {
+        double sum{0.0};
+        for (Eigen::Index k = 0; k < x.cols(); ++k) {
+            sum += tape.replay(x.col(k)).sum() +
+                   tape.vjp(weights.col(k)).sum();
+        }
+        return sum;
+    })};
+    const double batched{time(
+        [&] { return batch.replay(x).sum() + batch.vjp(x, weights).sum(); })};
+    std::cout << "Tape::replay and vjp: " << baseline
+              << " ns per point\nTapeBatch::replay and vjp: " << batched
+              << " ns per point (" << baseline / batched << "x, "
+              << batch.fallbacks() << " fallbacks)\n";
+}
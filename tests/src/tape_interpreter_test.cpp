@@ -0,0 +1,156 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+
+#include "algodiff/tape_interpreter.hpp"
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "algodiff/reverse_mode.hpp"
+#include "algodiff/tape.hpp"
+#include "algodiff/tape_ops.hpp"
+
+using algodiff::reverse::OpCode;
+using algodiff::reverse::ProgramOp;
+using algodiff::reverse::Tape;
+using algodiff::reverse::TapeProgram;
+using algodiff::reverse::Variable;
+using Catch::Approx;
+
+namespace
+{
+// Exercises every recorded operation and the fused pairs
+auto mixed(const Eigen::VectorX<Variable> &x) -> Eigen::VectorX<Variable>
+{
+    const Variable a{x[0] * x[1] + x[2]};
+    const Variable s{sin(a)};
+    const Variable t{cos(a)};
+    const Variable b{s + t * tan(x[2]) + exp(x[0]) / sqrt(x[1])};
+    const Variable c{log(x[1]) + pow(x[0], 3.0) + pow(x[1], x[0]) +
+                     abs(-x[2]) + x[0] * x[0]};
+    const Variable d{asin(x[2]) + acos(x[2]) * atan(x[0]) +
+                     sinh(x[2]) * cosh(x[0])};
+    Eigen::VectorX<Variable> y(2);
+    y[0] = (2.0 - b) * c + tanh(d) / 3.0 - 1.0 / x[1] + 4.0 * (x[0] - 1.0);
+    const Variable e{cos(x[0])};
+    const Variable f{sin(x[0])};
+    y[1] = e * f + d / c;
+    return y;
+}
+
+auto count(const TapeProgram &program, ProgramOp op) -> std::ptrdiff_t
+{
+    const auto &instructions{program.instructions()};
+    return std::count_if(instructions.begin(), instructions.end(),
+                         [&](const auto &ins) { return ins.op == op; });
+}
+
+// A long chain of the operations of a small neural network layer
+auto layer(const Eigen::VectorX<Variable> &x) -> Eigen::VectorX<Variable>
+{
+    Eigen::VectorX<Variable> h{x};
+    for (int layer = 0; layer < 200; ++layer) {
+        Eigen::VectorX<Variable> next(h.size());
+        for (Eigen::Index i = 0; i < h.size(); ++i) {
+            Variable sum{h[(i + 1) % h.size()] * 0.5};
+            for (Eigen::Index j = 0; j < h.size(); ++j) {
+                sum = h[j] * h[(i + j) % h.size()] + sum;
+            }
+            next[i] = tanh(sum * 0.01) + sin(h[i]) * cos(h[i]);
+        }
+        h = next;
+    }
+    return h;
+}
+
+} // namespace
+
+TEST_CASE("Test tape programs")
+{
+    const Eigen::Vector3d u{0.7, 1.3, 0.2};
+    Tape tape{};
+    algodiff::reverse::record(tape, mixed, u);
+
+    // Operations on constant nodes become operations on constants
+    const auto two{tape.record(OpCode::Constant, 0, 0, 2.0)};
+    const auto a{tape.inputs()[0]};
+    tape.register_output(tape.record(OpCode::Pow, two.index(), a));
+    tape.register_output(tape.record(OpCode::Subtract, a, two.index()));
+    tape.register_output(tape.record(OpCode::Divide, two.index(), a));
+
+    TapeProgram program{tape};
+    REQUIRE(count(program, ProgramOp::MultiplyAdd) >= 1);
+    REQUIRE(count(program, ProgramOp::SinCos) == 1);
+    REQUIRE(count(program, ProgramOp::CosSin) == 1);
+    REQUIRE(count(program, ProgramOp::Square) >= 1);
+    REQUIRE(count(program, ProgramOp::ConstantPow) >= 1);
+    REQUIRE(count(program, ProgramOp::SubtractConstant) >= 1);
+    REQUIRE(count(program, ProgramOp::ConstantDivide) >= 1);
+    REQUIRE(program.instructions().back().op == ProgramOp::Halt);
+    REQUIRE(program.instructions().size() < tape.size());
+    REQUIRE(TapeProgram::is_threaded() ==
+            (program.instructions().front().handler != nullptr));
+
+    for (const Eigen::Vector3d &v :
+         {Eigen::Vector3d{0.7, 1.3, 0.2}, Eigen::Vector3d{1.1, 0.4, -0.5},
+          Eigen::Vector3d{-0.3, 2.0, 0.9}}) {
+        const Eigen::VectorXd expected{tape.replay(v)};
+        const Eigen::VectorXd actual{program.replay(v)};
+        REQUIRE(actual.size() == expected.size());
+        for (Eigen::Index i = 0; i < actual.size(); ++i) {
+            REQUIRE(actual[i] == Approx(expected[i]));
+        }
+        for (std::size_t i = 0; i < tape.size(); ++i) {
+            REQUIRE(program.values()[i] == Approx(tape.values()[i]));
+        }
+    }
+    REQUIRE_THROWS_AS(program.replay(Eigen::VectorXd::Zero(2)),
+                      std::invalid_argument);
+
+    // External calls are not translated
+    Tape external{};
+    auto function{std::make_shared<algodiff::reverse::ExternalFunction>()};
+    function->primal = [](const Eigen::VectorXd &x) { return x; };
+    function->jacobian = [](const Eigen::VectorXd &x) {
+        return Eigen::MatrixXd::Identity(x.size(), x.size());
+    };
+    external.call(function, {external.variable(1.0)});
+    REQUIRE_THROWS_AS(TapeProgram{external}, std::invalid_argument);
+}
+
+TEST_CASE("Tape programs against Tape::replay", "[.][benchmark]")
+{
+    const Eigen::VectorXd u{Eigen::VectorXd::LinSpaced(8, -0.5, 0.5)};
+    Tape tape{};
+    algodiff::reverse::record(tape, layer, u);
+    TapeProgram program{tape};
+    constexpr int replays{50};
+    const auto time = [&](auto &&replay) {
+        double sink{0.0};
+        const auto start{std::chrono::steady_clock::now()};
+        for (int i = 0; i < replays; ++i) {
+            sink += replay(u * (1.0 + 1e-3 * static_cast<double>(i))).sum();
+        }
+        const std::chrono::duration<double, std::nano> elapsed{
+            std::chrono::steady_clock::now() - start};
+        REQUIRE(std::isfinite(sink));
+        return elapsed.count() / (replays * static_cast<double>(tape.size()));
+    };
+    const double baseline{
+        time([&](const Eigen::VectorXd &x) { return tape.replay(x); })};
+    const double threaded{
+        time([&](const Eigen::VectorXd &x) { return program.replay(x); })};
+    std::cout << tape.size() << " nodes, " << program.instructions().size()
+              << " instructions (threaded: " << TapeProgram::is_threaded()
+              << ")\nTape::replay: " << baseline
+              << " ns per node\nTapeProgram::replay: " << threaded
+              << " ns per node (" << baseline / threaded << "x)\n";
+}
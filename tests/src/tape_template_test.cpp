@@ -0,0 +1,142 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+
+#include "algodiff/tape_template.hpp"
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "algodiff/reverse_mode.hpp"
+#include "algodiff/tape.hpp"
+#include "algodiff/tape_ops.hpp"
+
+using algodiff::reverse::Tape;
+using algodiff::reverse::TapeTemplate;
+using algodiff::reverse::Variable;
+using Catch::Approx;
+
+namespace
+{
+constexpr std::size_t steps{200};
+
+// One explicit Euler step of a damped pendulum with a nonlinear spring
+const auto step = [](const Eigen::VectorX<Variable> &x) {
+    constexpr double dt{0.01};
+    Eigen::VectorX<Variable> next(2);
+    next[0] = x[0] + dt * x[1];
+    next[1] = x[1] - dt * (sin(x[0]) + 0.1 * x[1] + 0.5 * x[0] * x[0] * x[0]);
+    return next;
+};
+
+auto unrolled(const Eigen::VectorX<Variable> &x) -> Eigen::VectorX<Variable>
+{
+    Eigen::VectorX<Variable> state{x};
+    for (std::size_t i = 0; i < steps; ++i) {
+        state = step(state);
+    }
+    return state;
+}
+
+auto looped(const Eigen::VectorX<Variable> &x) -> Eigen::VectorX<Variable>
+{
+    return algodiff::reverse::record_loop(step, x, steps);
+}
+
+auto require_equal(const Eigen::MatrixXd &actual,
+                   const Eigen::MatrixXd &expected) -> void
+{
+    REQUIRE(actual.rows() == expected.rows());
+    REQUIRE(actual.cols() == expected.cols());
+    for (Eigen::Index i = 0; i < actual.rows(); ++i) {
+        for (Eigen::Index j = 0; j < actual.cols(); ++j) {
+            REQUIRE(actual(i, j) == Approx(expected(i, j)));
+        }
+    }
+}
+
+} // namespace
+
+TEST_CASE("Test recorded loops")
+{
+    const Eigen::Vector2d u{0.8, -0.3};
+    Tape full{};
+    algodiff::reverse::record(full, unrolled, u);
+    Tape compressed{};
+    algodiff::reverse::record(compressed, looped, u);
+
+    // Two inputs and two outputs per iteration instead of every operation
+    REQUIRE(compressed.size() == 2 + 2 * steps);
+    REQUIRE(full.size() > 5 * compressed.size());
+
+    require_equal(compressed.jacobian(), full.jacobian());
+    const Eigen::Vector2d weights{0.5, -2.0};
+    require_equal(compressed.vjp(weights), full.vjp(weights));
+
+    const Eigen::Vector2d v{-0.4, 1.1};
+    require_equal(compressed.replay(v), full.replay(v));
+    require_equal(compressed.jacobian(), full.jacobian());
+
+    // Every entry of the jacobian agrees with the reverse mode helpers
+    require_equal(compressed.jacobian(),
+                  algodiff::reverse::jacobian(unrolled, v));
+}
+
+TEST_CASE("Test tape template calls")
+{
+    // A subroutine with a parameter that changes between calls
+    const TapeTemplate scaled_norm{
+        [](const Eigen::VectorX<Variable> &x) {
+            Eigen::VectorX<Variable> y(1);
+            y[0] = x[2] * sqrt(x[0] * x[0] + x[1] * x[1]);
+            return y;
+        },
+        Eigen::Vector3d{1.0, 1.0, 1.0}};
+    REQUIRE(scaled_norm.input_count() == 3);
+    REQUIRE(scaled_norm.output_count() == 1);
+
+    const auto f = [&](const Eigen::VectorX<Variable> &x) {
+        Variable total{0.0};
+        for (int k = 1; k <= 4; ++k) {
+            Eigen::VectorX<Variable> arguments(3);
+            arguments << x[0] * static_cast<double>(k), x[1],
+                Variable{1.0 / static_cast<double>(k)};
+            total += scaled_norm(arguments)[0];
+        }
+        return total;
+    };
+    const Eigen::Vector2d u{0.6, 0.8};
+    const Eigen::VectorXd gradient{algodiff::reverse::gradient(f, u)};
+    Eigen::Vector2d expected{Eigen::Vector2d::Zero()};
+    for (int k = 1; k <= 4; ++k) {
+        const double a{u[0] * static_cast<double>(k)};
+        const double r{std::hypot(a, u[1])};
+        expected[0] += a / r;
+        expected[1] += u[1] / r / static_cast<double>(k);
+    }
+    require_equal(gradient, expected);
+
+    // Passive calls only evaluate the template
+    Eigen::VectorX<Variable> passive(3);
+    passive << Variable{3.0}, Variable{4.0}, Variable{2.0};
+    const auto value{scaled_norm(passive)};
+    REQUIRE_FALSE(value[0].is_active());
+    REQUIRE(value[0].value() == Approx(10.0));
+
+    REQUIRE_THROWS_AS(scaled_norm(passive.head(2)), std::invalid_argument);
+    Tape tape{};
+    Eigen::VectorX<Variable> x(1);
+    x[0] = tape.variable(1.0);
+    REQUIRE_THROWS_AS(algodiff::reverse::record_loop(
+                          [](const Eigen::VectorX<Variable> &y) {
+                              Eigen::VectorX<Variable> z(2);
+                              z << y[0], y[0];
+                              return z;
+                          },
+                          x, 3),
+                      std::invalid_argument);
+}
@@ -0,0 +1,139 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+#include <atomic>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include "algodiff/trajectory_jacobian.hpp"
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "algodiff/dual_number.hpp"
+#include "algodiff/dual_number_ops.hpp"
+#include "algodiff/forward_mode.hpp"
+
+namespace
+{
+constexpr int state_size{2};
+constexpr int control_size{1};
+constexpr double dt{0.1};
+
+// Explicit Euler step of a damped pendulum driven by a torque
+auto pendulum(const Eigen::Vector<algodiff::forward::DualNumber,
+                                  state_size + control_size> &z)
+{
+    Eigen::Vector<algodiff::forward::DualNumber, state_size> next{};
+    next[0] = z[0] + dt * z[1];
+    next[1] = z[1] + dt * (-9.81 * algodiff::forward::sin(z[0]) -
+                           0.5 * z[1] + z[2]);
+    return next;
+}
+
+} // namespace
+
+TEST_CASE("Trajectory jacobian", "[Trajectory Jacobian]")
+{
+    constexpr size_t horizon{6};
+    std::vector<Eigen::Vector<double, state_size>> states{};
+    std::vector<Eigen::Vector<double, control_size>> controls{};
+    for (size_t k = 0; k <= horizon; ++k) {
+        const auto t{static_cast<double>(k)};
+        states.emplace_back(0.3 * t, 1.0 - 0.1 * t);
+        if (k < horizon) {
+            controls.emplace_back(Eigen::Vector<double, 1>{0.2 * t});
+        }
+    }
+
+    const auto jac{
+        algodiff::forward::trajectory_jacobian<state_size, control_size>(
+            pendulum, states, controls, 3)};
+    REQUIRE(jac.horizon() == static_cast<Eigen::Index>(horizon));
+
+    SECTION("stage blocks match the analytic linearization")
+    {
+        for (size_t k = 0; k < horizon; ++k) {
+            const auto &stage{jac.stages[k]};
+            REQUIRE(Catch::Approx(stage.A(0, 0)) == 1.0);
+            REQUIRE(Catch::Approx(stage.A(0, 1)) == dt);
+            REQUIRE(Catch::Approx(stage.A(1, 0)) ==
+                    -dt * 9.81 * std::cos(states[k][0]));
+            REQUIRE(Catch::Approx(stage.A(1, 1)) == 1.0 - 0.5 * dt);
+            REQUIRE(Catch::Approx(stage.B(0, 0)).margin(1e-12) == 0.0);
+            REQUIRE(Catch::Approx(stage.B(1, 0)) == dt);
+
+            const double next_velocity{
+                states[k][1] + dt * (-9.81 * std::sin(states[k][0]) -
+                                     0.5 * states[k][1] + controls[k][0])};
+            REQUIRE(Catch::Approx(stage.defect[1]) ==
+                    next_velocity - states[k + 1][1]);
+        }
+    }
+
+    SECTION("assembled matrix matches a dense differentiation")
+    {
+        constexpr Eigen::Index stride{state_size + control_size};
+        const auto n{static_cast<Eigen::Index>(horizon)};
+        Eigen::VectorXd z(n * stride + state_size);
+        for (Eigen::Index k = 0; k < n; ++k) {
+            z.segment<state_size>(k * stride) = states[static_cast<size_t>(k)];
+            z.segment<control_size>(k * stride + state_size) =
+                controls[static_cast<size_t>(k)];
+        }
+        z.tail<state_size>() = states.back();
+
+        auto constraints =
+            [&](const Eigen::VectorX<algodiff::forward::DualNumber> &v) {
+                Eigen::VectorX<algodiff::forward::DualNumber> c(n *
+                                                                state_size);
+                for (Eigen::Index k = 0; k < n; ++k) {
+                    const Eigen::Vector<algodiff::forward::DualNumber, stride>
+                        stage{v.segment<stride>(k * stride)};
+                    c.segment<state_size>(k * state_size) =
+                        pendulum(stage) -
+                        v.segment<state_size>((k + 1) * stride);
+                }
+                return c;
+            };
+        const Eigen::MatrixXd dense{
+            algodiff::forward::jacobian<static_cast<int>(horizon) *
+                                        state_size>(constraints, z)};
+
+        const Eigen::MatrixXd assembled{jac.to_sparse()};
+        REQUIRE(assembled.rows() == dense.rows());
+        REQUIRE(assembled.cols() == dense.cols());
+        REQUIRE(assembled.isApprox(dense));
+    }
+
+    SECTION("each stage costs one pass per stage input")
+    {
+        std::atomic<int> evaluations{0};
+        auto counting =
+            [&](const Eigen::Vector<algodiff::forward::DualNumber,
+                                    state_size + control_size> &z) {
+                ++evaluations;
+                return pendulum(z);
+            };
+        const auto counted{
+            algodiff::forward::trajectory_jacobian<state_size, control_size>(
+                counting, states, controls, 2)};
+        REQUIRE(evaluations ==
+                static_cast<int>(horizon) * (state_size + control_size));
+        for (size_t k = 0; k < horizon; ++k) {
+            REQUIRE(counted.stages[k].defect.isApprox(jac.stages[k].defect));
+        }
+    }
+
+    SECTION("mismatched trajectory sizes are rejected")
+    {
+        controls.pop_back();
+        controls.pop_back();
+        REQUIRE_THROWS_AS(
+            (algodiff::forward::trajectory_jacobian<state_size, control_size>(
+                pendulum, states, controls)),
+            std::invalid_argument);
+    }
+}
@@ -0,0 +1,117 @@
+/* This file is part of the algodiff project.
+ * Copyright (c) 2023 kajananchinniah
+ * SPDX-License-Identifier: MIT
+ */
+#include <memory>
+
+#include "algodiff/vertex_elimination.hpp"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "algodiff/reverse_mode.hpp"
+#include "algodiff/tape.hpp"
+#include "algodiff/tape_ops.hpp"
+
+using algodiff::reverse::EliminationOrder;
+using algodiff::reverse::Tape;
+using algodiff::reverse::Variable;
+
+namespace
+{
+// Wide -> narrow -> wide: every output depends on every input only through
+// the scalar t, so the jacobian is an outer product
+auto bottleneck(const Eigen::VectorX<Variable> &x) -> Eigen::VectorX<Variable>
+{
+    using algodiff::reverse::cos;
+    using algodiff::reverse::exp;
+    using algodiff::reverse::sin;
+    Variable s{0.0};
+    for (Eigen::Index i = 0; i < x.size(); ++i) {
+        s += sin(x[i]) * x[i];
+    }
+    const Variable t{exp(0.1 * s)};
+
+    Eigen::VectorX<Variable> y(x.size());
+    for (Eigen::Index j = 0; j < y.size(); ++j) {
+        const Variable scaled{t * static_cast<double>(j + 1)};
+        y[j] = cos(scaled) * scaled + sin(scaled) / (1.0 + t);
+    }
+    return y;
+}
+
+} // namespace
+
+TEST_CASE("Vertex elimination reproduces the tape jacobian",
+          "[VertexElimination]")
+{
+    Tape tape{};
+    algodiff::reverse::record(
+        tape,
+        [](const Eigen::VectorX<Variable> &x) {
+            using algodiff::reverse::log;
+            Eigen::VectorX<Variable> y(3);
+            y[0] = x[0] * x[0] + x[1];
+            // Outputs may feed other outputs or be inputs themselves
+            y[1] = log(y[0]) / x[2];
+            y[2] = x[1];
+            return y;
+        },
+        Eigen::VectorXd{Eigen::Vector3d{1.5, 0.5, 2.0}});
+
+    const Eigen::MatrixXd expected{tape.jacobian()};
+    for (const auto order :
+         {EliminationOrder::Forward, EliminationOrder::Reverse,
+          EliminationOrder::Markowitz}) {
+        REQUIRE(algodiff::reverse::accumulate_jacobian(tape, order)
+                    .jacobian.isApprox(expected));
+    }
+}
+
+TEST_CASE("Markowitz elimination beats both modes across a bottleneck",
+          "[VertexElimination]")
+{
+    constexpr Eigen::Index size{16};
+    Tape tape{};
+    algodiff::reverse::record(
+        tape, bottleneck, Eigen::VectorXd::LinSpaced(size, -1.0, 1.0));
+
+    using algodiff::reverse::accumulate_jacobian;
+    const auto forward{accumulate_jacobian(tape, EliminationOrder::Forward)};
+    const auto reverse{accumulate_jacobian(tape, EliminationOrder::Reverse)};
+    const auto markowitz{accumulate_jacobian(tape)};
+
+    const Eigen::MatrixXd expected{tape.jacobian()};
+    REQUIRE(forward.jacobian.isApprox(expected));
+    REQUIRE(reverse.jacobian.isApprox(expected));
+    REQUIRE(markowitz.jacobian.isApprox(expected));
+    REQUIRE(2 * markowitz.multiplications < forward.multiplications);
+    REQUIRE(2 * markowitz.multiplications < reverse.multiplications);
+}
+
+TEST_CASE("Vertex elimination uses the local jacobians of external calls",
+          "[VertexElimination]")
+{
+    auto function{std::make_shared<algodiff::reverse::ExternalFunction>()};
+    function->primal = [](const Eigen::VectorXd &x) -> Eigen::VectorXd {
+        return Eigen::Vector2d{x[0] * x[1], x[0] + x[1]};
+    };
+    function->vjp = [](const Eigen::VectorXd &x, const Eigen::VectorXd &,
+                       const Eigen::VectorXd &w) -> Eigen::VectorXd {
+        return Eigen::Vector2d{x[1] * w[0] + w[1], x[0] * w[0] + w[1]};
+    };
+
+    Tape tape{};
+    algodiff::reverse::record(
+        tape,
+        [&](const Eigen::VectorX<Variable> &x) {
+            const Eigen::VectorX<Variable> y{
+                algodiff::reverse::call(function, x)};
+            return Eigen::VectorX<Variable>{y * 2.0};
+        },
+        Eigen::VectorXd{Eigen::Vector2d{3.0, 4.0}});
+
+    Eigen::Matrix2d expected{};
+    expected << 8.0, 6.0, 2.0, 2.0;
+    REQUIRE(algodiff::reverse::accumulate_jacobian(tape).jacobian.isApprox(
+        expected));
+}